@@ -0,0 +1,90 @@
+/**
+ * @file BenchmarkCorpus.h
+ * @brief Loads recorded feed messages used as benchmark input
+ *
+ * The corpus is read from $BENCH_CORPUS if set, otherwise from the bundled
+ * corpus/coinbase_ticker.jsonl. Both JSON-lines files and binary captures
+ * written by FeedCapture (--capture) are accepted.
+ */
+
+#ifndef BENCHMARKCORPUS_H
+#define BENCHMARKCORPUS_H
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "FeedCapture.h"
+
+#ifndef BENCH_CORPUS_DIR
+#define BENCH_CORPUS_DIR "corpus"
+#endif
+
+namespace BenchmarkCorpus {
+
+/**
+ * @brief Load all messages of a corpus file
+ * @param path JSON-lines file or FeedCapture file
+ * @return Messages (empty on error)
+ */
+inline std::vector<std::string> loadFile(const std::string& path) {
+    std::vector<std::string> messages;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open benchmark corpus: " << path << std::endl;
+        return messages;
+    }
+
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+#ifdef __linux__
+    const size_t magicSize = sizeof(FeedCaptureFormat::MAGIC);
+    if (contents.size() >= magicSize &&
+        std::memcmp(contents.data(), FeedCaptureFormat::MAGIC, magicSize) == 0) {
+        size_t offset = magicSize;
+        FeedCaptureFormat::FrameHeader header;
+        while (offset + sizeof(header) <= contents.size()) {
+            std::memcpy(&header, contents.data() + offset, sizeof(header));
+            offset += sizeof(header);
+            if (offset + header.length > contents.size()) {
+                break;
+            }
+            messages.emplace_back(contents.data() + offset, header.length);
+            offset += header.length;
+        }
+        return messages;
+    }
+#endif
+
+    size_t start = 0;
+    while (start < contents.size()) {
+        size_t end = contents.find('\n', start);
+        if (end == std::string::npos) {
+            end = contents.size();
+        }
+        if (end > start) {
+            messages.emplace_back(contents, start, end - start);
+        }
+        start = end + 1;
+    }
+    return messages;
+}
+
+/**
+ * @brief Get the benchmark corpus (loaded once)
+ * @return Messages of $BENCH_CORPUS or the bundled corpus
+ */
+inline const std::vector<std::string>& messages() {
+    static const std::vector<std::string> corpus = [] {
+        const char* override = std::getenv("BENCH_CORPUS");
+        return loadFile(override ? override : BENCH_CORPUS_DIR "/coinbase_ticker.jsonl");
+    }();
+    return corpus;
+}
+
+} // namespace BenchmarkCorpus
+
+#endif // BENCHMARKCORPUS_H
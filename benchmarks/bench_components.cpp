@@ -0,0 +1,507 @@
+/**
+ * @file bench_components.cpp
+ * @brief Google Benchmark microbenchmarks for the hot-path components
+ *
+ * Run with --benchmark_out=results.json --benchmark_out_format=json to keep
+ * results for release-to-release comparison. --pin-cpu <n> pins the benchmark
+ * thread (and the ping-pong echo thread to <n>+1, or --pin-echo-cpu <m>).
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+#include "BenchmarkCorpus.h"
+#include "JSONParser.h"
+#include "TickerData.h"
+#include "EMACalculator.h"
+#include "OrderBook.h"
+#include "BookSignals.h"
+#include "RollingVWAP.h"
+#include "IndicatorGraph.h"
+#include "IndicatorPipeline.h"
+#include "LockFreeRingBuffer.h"
+#include "AsyncCSVLogger.h"
+#include "HighResTimer.h"
+#include "ThreadUtils.h"
+
+namespace {
+
+int g_pinCpu = -1;      ///< CPU for the benchmark thread (--pin-cpu), -1 = not pinned
+int g_pinEchoCpu = -1;  ///< CPU for the ping-pong echo thread (--pin-echo-cpu), -1 = not pinned
+
+/**
+ * @brief Ticker messages of the corpus parsed once up front
+ */
+const std::vector<TickerData>& parsedTickers() {
+    static const std::vector<TickerData> tickers = [] {
+        std::vector<TickerData> out;
+        for (const std::string& message : BenchmarkCorpus::messages()) {
+            TickerData data;
+            if (JSONParser::parseTickerMessage(message, data)) {
+                out.push_back(data);
+            }
+        }
+        return out;
+    }();
+    return tickers;
+}
+
+/**
+ * @brief Spin-wait step: pause, and yield now and then so the benchmark still
+ *        makes progress when both threads share one core
+ */
+inline void spinWait(uint32_t& spins) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+    if (UNLIKELY(++spins % 1024 == 0)) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// JSONParser
+// ---------------------------------------------------------------------------
+
+static void BM_JSONParser_ParseTickerMessage(benchmark::State& state) {
+    const std::vector<std::string>& corpus = BenchmarkCorpus::messages();
+    if (corpus.empty()) {
+        state.SkipWithError("empty corpus");
+        return;
+    }
+
+    size_t index = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const std::string& message = corpus[index];
+        TickerData data;
+        benchmark::DoNotOptimize(JSONParser::parseTickerMessage(message, data));
+        benchmark::DoNotOptimize(data);
+        bytes += static_cast<int64_t>(message.size());
+        index = (index + 1 == corpus.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_JSONParser_ParseTickerMessage);
+
+static void BM_JSONParser_ParseTimestampNanos(benchmark::State& state) {
+    const std::vector<TickerData>& tickers = parsedTickers();
+    if (tickers.empty()) {
+        state.SkipWithError("no ticker messages in corpus");
+        return;
+    }
+
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JSONParser::parseTimestampNanos(tickers[index].time));
+        index = (index + 1 == tickers.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JSONParser_ParseTimestampNanos);
+
+// ---------------------------------------------------------------------------
+// TickerData
+// ---------------------------------------------------------------------------
+
+static void BM_TickerData_CalculateMidPrice(benchmark::State& state) {
+    const std::vector<TickerData>& tickers = parsedTickers();
+    if (tickers.empty()) {
+        state.SkipWithError("no ticker messages in corpus");
+        return;
+    }
+
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tickers[index].calculateMidPrice());
+        index = (index + 1 == tickers.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TickerData_CalculateMidPrice);
+
+// ---------------------------------------------------------------------------
+// EMACalculator
+// ---------------------------------------------------------------------------
+
+static void BM_EMACalculator_Update(benchmark::State& state) {
+    const std::vector<TickerData>& tickers = parsedTickers();
+    if (tickers.empty()) {
+        state.SkipWithError("no ticker messages in corpus");
+        return;
+    }
+
+    EMACalculator calculator(5);
+    // Ticks 250 ms apart: most updates fall inside the 5 s interval, as live
+    auto timestamp = std::chrono::system_clock::now();
+    const auto step = std::chrono::milliseconds(250);
+
+    size_t index = 0;
+    for (auto _ : state) {
+        const TickerData& data = tickers[index];
+        timestamp += step;
+        benchmark::DoNotOptimize(calculator.updatePriceEMA(std::stod(data.price), timestamp));
+        benchmark::DoNotOptimize(calculator.updateMidPriceEMA(data.mid_price, timestamp));
+        index = (index + 1 == tickers.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EMACalculator_Update);
+
+// ---------------------------------------------------------------------------
+// LockFreeRingBuffer
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Cross-thread round trip: push to an echo thread and wait for the reply
+ */
+template<typename T>
+static void BM_LockFreeRingBuffer_PingPong(benchmark::State& state, T item) {
+    using Queue = LockFreeRingBuffer<T, 1024>;
+    auto ping = std::make_unique<Queue>();
+    auto pong = std::make_unique<Queue>();
+    std::atomic<bool> running{true};
+
+    std::thread echo([&] {
+        if (g_pinEchoCpu >= 0) {
+            ThreadUtils::pinToCpu(g_pinEchoCpu);
+        }
+        T received;
+        uint32_t spins = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (ping->pop(received)) {
+                while (!pong->push(received)) {
+                    spinWait(spins);
+                }
+            } else {
+                spinWait(spins);
+            }
+        }
+    });
+
+    uint32_t spins = 0;
+    for (auto _ : state) {
+        while (!ping->push(item)) {
+            spinWait(spins);
+        }
+        while (!pong->pop(item)) {
+            spinWait(spins);
+        }
+    }
+
+    running.store(false);
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel("round trip");
+}
+BENCHMARK_CAPTURE(BM_LockFreeRingBuffer_PingPong, uint64, uint64_t{42})->UseRealTime();
+BENCHMARK_CAPTURE(BM_LockFreeRingBuffer_PingPong, TickerData,
+                  parsedTickers().empty() ? TickerData() : parsedTickers().front())->UseRealTime();
+
+static void BM_LockFreeRingBuffer_PushPop(benchmark::State& state) {
+    auto queue = std::make_unique<LockFreeRingBuffer<TickerData, 4096>>();
+    TickerData item = parsedTickers().empty() ? TickerData() : parsedTickers().front();
+    TickerData out;
+    for (auto _ : state) {
+        queue->push(item);
+        queue->pop(out);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockFreeRingBuffer_PushPop);
+
+// ---------------------------------------------------------------------------
+// AsyncCSVLogger
+// ---------------------------------------------------------------------------
+
+static void BM_AsyncCSVLogger_FormatToCSV(benchmark::State& state) {
+    std::vector<TickerData> tickers = parsedTickers();
+    if (tickers.empty()) {
+        state.SkipWithError("no ticker messages in corpus");
+        return;
+    }
+
+    // Fill the computed fields so every column is formatted, as in production
+    const uint64_t now = HighResTimer::nowCycles();
+    for (TickerData& data : tickers) {
+        data.price_ema = data.mid_price;
+        data.mid_price_ema = data.mid_price;
+        data.stamps.receive_tsc = now;
+        data.stamps.parsed_tsc = now + 2000;
+        data.stamps.dequeued_tsc = now + 4000;
+        data.stamps.processed_tsc = now + 5000;
+        data.stamps.written_tsc = now + 30000;
+    }
+
+    // Heap-allocated: the logger embeds its (multi-megabyte) ring buffer
+    auto logger = std::make_unique<AsyncCSVLogger>("/dev/null");
+    size_t index = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        std::string line = logger->formatToCSV(tickers[index]);
+        bytes += static_cast<int64_t>(line.size());
+        benchmark::DoNotOptimize(line);
+        index = (index + 1 == tickers.size()) ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_AsyncCSVLogger_FormatToCSV);
+
+// ---------------------------------------------------------------------------
+// OrderBook
+// ---------------------------------------------------------------------------
+
+namespace {
+
+/**
+ * @brief Book with <levels> bids and asks one tick apart around 50000.00
+ */
+void fillBook(OrderBook& book, int64_t levels) {
+    const int64_t tick = OrderBook::SCALE / 100;
+    const int64_t mid = 50000 * OrderBook::SCALE;
+    for (int64_t i = 1; i <= levels; ++i) {
+        book.apply(BookSide::Bid, mid - i * tick, OrderBook::SCALE);
+        book.apply(BookSide::Ask, mid + i * tick, OrderBook::SCALE);
+    }
+}
+
+} // namespace
+
+/// Level2 traffic is concentrated near the touch: update a level within 16 ticks
+static void BM_OrderBook_ApplyNearTouch(benchmark::State& state) {
+    OrderBook book;
+    fillBook(book, state.range(0));
+    const int64_t tick = OrderBook::SCALE / 100;
+    const int64_t mid = 50000 * OrderBook::SCALE;
+
+    uint64_t step = 0;
+    for (auto _ : state) {
+        const int64_t offset = static_cast<int64_t>(step % 16) + 1;
+        const BookSide side = (step & 16) ? BookSide::Ask : BookSide::Bid;
+        const int64_t price = side == BookSide::Bid ? mid - offset * tick : mid + offset * tick;
+        // Alternate removing and restoring so the book keeps its shape
+        const int64_t size = ((step >> 5) & 1) ? OrderBook::SCALE : 0;
+        benchmark::DoNotOptimize(book.apply(side, price, size));
+        step++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBook_ApplyNearTouch)->Arg(100)->Arg(10000);
+
+/// Full side: every new level drops the far end; insert 16 levels above it (new orders deep in the book)
+static void BM_OrderBook_InsertFullSideFar(benchmark::State& state) {
+    OrderBook book;
+    const int64_t levels = static_cast<int64_t>(OrderBook::DEFAULT_MAX_LEVELS);
+    fillBook(book, levels);
+    const int64_t tick = OrderBook::SCALE / 100;
+    const int64_t anchor = 50000 * OrderBook::SCALE - (levels - 16) * tick;
+
+    int64_t step = 0;
+    for (auto _ : state) {
+        // Each price lands just above the previous one, so 16 levels stay below it
+        if (UNLIKELY(step == tick - 1)) {
+            state.PauseTiming();
+            book.clear();
+            fillBook(book, levels);
+            step = 0;
+            state.ResumeTiming();
+        }
+        step++;
+        benchmark::DoNotOptimize(book.apply(BookSide::Bid, anchor + step, OrderBook::SCALE));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBook_InsertFullSideFar);
+
+static void BM_OrderBook_Top(benchmark::State& state) {
+    OrderBook book;
+    fillBook(book, 10000);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.top());
+    }
+}
+BENCHMARK(BM_OrderBook_Top);
+
+/// Per-delta cost on the book path: apply, adjust the top-N sums, compute the signals
+static void BM_BookSignals_ApplyAndCompute(benchmark::State& state) {
+    OrderBook book;
+    fillBook(book, 1000);
+    BookSignals signals;
+    signals.rebuild(book);
+    const int64_t tick = OrderBook::SCALE / 100;
+    const int64_t mid = 50000 * OrderBook::SCALE;
+
+    uint64_t step = 0;
+    for (auto _ : state) {
+        const int64_t price = mid - (static_cast<int64_t>(step % 8) + 1) * tick;
+        const int64_t size = ((step >> 3) & 1) ? OrderBook::SCALE : 0;
+        int64_t previousSize;
+        const int distance = book.apply(BookSide::Bid, price, size, previousSize);
+        signals.onApply(book, BookSide::Bid, price, previousSize, size, distance);
+        benchmark::DoNotOptimize(signals.compute(book));
+        step++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BookSignals_ApplyAndCompute);
+
+// ---------------------------------------------------------------------------
+// RollingVWAP
+// ---------------------------------------------------------------------------
+
+/// Steady state: every trade appends one prefix-sum entry and expires one per window
+static void BM_RollingVWAP_AddTrade(benchmark::State& state) {
+    const int64_t second = 1000000000LL;
+    RollingVWAP vwap;
+    vwap.setWindows({60 * second, 300 * second, 900 * second});
+    // 50 trades per second, so the longest window holds 45000 trades and wraps the ring
+    int64_t time = 0;
+    uint64_t step = 0;
+    for (auto _ : state) {
+        time += second / 50;
+        vwap.addTrade(time, (50000 + static_cast<int64_t>(step % 7)) * OrderBook::SCALE, OrderBook::SCALE / 10);
+        benchmark::DoNotOptimize(vwap.window(0));
+        step++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RollingVWAP_AddTrade);
+
+// ---------------------------------------------------------------------------
+// Indicators: runtime graph vs compile-time pipeline, same indicator set
+// ---------------------------------------------------------------------------
+
+/// Per-tick cost of the config-driven graph (one switch per node)
+static void BM_IndicatorGraph_Update(benchmark::State& state) {
+    IndicatorGraph graph;
+    graph.configure("ema(5),ema(20),macd(12,26,9),rsi(14),bb(20,2),atr(14)");
+    uint64_t step = 0;
+    for (auto _ : state) {
+        const double price = 50000.0 + static_cast<double>(step % 13) * 0.25;
+        graph.update(price, price, price);
+        // Keep every node's update observable, not just the first output
+        benchmark::DoNotOptimize(graph);
+        benchmark::ClobberMemory();
+        step++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IndicatorGraph_Update);
+
+/// Same indicators fused into one inlined update by the template pipeline
+static void BM_IndicatorPipeline_Update(benchmark::State& state) {
+    Pipeline<EMA<5>, EMA<20>, MACD<12, 26, 9>, RSI<14>, Bollinger<20, 2>, ATR<14>> pipeline;
+    uint64_t step = 0;
+    for (auto _ : state) {
+        const double price = 50000.0 + static_cast<double>(step % 13) * 0.25;
+        pipeline.update(PipelineInput::fromTick(price, price - 0.5, price + 0.5));
+        // The pipeline is a local: without this the unread stages could be dropped
+        benchmark::DoNotOptimize(pipeline);
+        benchmark::ClobberMemory();
+        step++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IndicatorPipeline_Update);
+
+// ---------------------------------------------------------------------------
+// HighResTimer
+// ---------------------------------------------------------------------------
+
+static void BM_HighResTimer_NowNanos(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(HighResTimer::nowNanos());
+    }
+}
+BENCHMARK(BM_HighResTimer_NowNanos);
+
+static void BM_HighResTimer_NowCycles(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(HighResTimer::nowCycles());
+    }
+}
+BENCHMARK(BM_HighResTimer_NowCycles);
+
+static void BM_HighResTimer_CyclesToWallNanos(benchmark::State& state) {
+    uint64_t cycles = HighResTimer::nowCycles();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(HighResTimer::cyclesToWallNanos(cycles++));
+    }
+}
+BENCHMARK(BM_HighResTimer_CyclesToWallNanos);
+
+/// Reference point: what nowNanos() saves over a vDSO clock read
+static void BM_ClockGettime_MonotonicRaw(benchmark::State& state) {
+    struct timespec ts;
+    for (auto _ : state) {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        benchmark::DoNotOptimize(ts);
+    }
+}
+BENCHMARK(BM_ClockGettime_MonotonicRaw);
+
+/**
+ * @brief Remove "--<name>=<value>" / "--<name> <value>" from argv
+ * @return Parsed integer value, or -1 if the flag is absent
+ */
+static int takeIntFlag(int& argc, char** argv, const std::string& name) {
+    const std::string flag = "--" + name;
+    int value = -1;
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, flag.size() + 1, flag + "=") == 0) {
+            value = std::atoi(arg.c_str() + flag.size() + 1);
+        } else if (arg == flag && i + 1 < argc) {
+            value = std::atoi(argv[++i]);
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    return value;
+}
+
+int main(int argc, char** argv) {
+    // Pinning flags are ours; strip them before Google Benchmark sees argv
+    g_pinCpu = takeIntFlag(argc, argv, "pin-cpu");
+    g_pinEchoCpu = takeIntFlag(argc, argv, "pin-echo-cpu");
+    if (g_pinCpu >= 0 && g_pinEchoCpu < 0) {
+        g_pinEchoCpu = g_pinCpu + 1; // Ping-pong needs a second core
+    }
+
+    if (g_pinCpu >= 0 && !ThreadUtils::pinToCpu(g_pinCpu)) {
+        std::cerr << "Error: Could not pin benchmark thread to CPU " << g_pinCpu << std::endl;
+        return 1;
+    }
+
+    // Calibrate the TSC before any benchmark reads it
+    HighResTimer::initialize();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("corpus_messages", std::to_string(BenchmarkCorpus::messages().size()));
+    benchmark::AddCustomContext("corpus_tickers", std::to_string(parsedTickers().size()));
+    benchmark::AddCustomContext("tsc_invariant", HighResTimer::isInvariantTSC() ? "true" : "false");
+    benchmark::AddCustomContext("pin_cpu", std::to_string(g_pinCpu));
+    benchmark::AddCustomContext("pin_echo_cpu", std::to_string(g_pinEchoCpu));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
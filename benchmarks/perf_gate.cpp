@@ -0,0 +1,222 @@
+/**
+ * @file perf_gate.cpp
+ * @brief Compares two Google Benchmark JSON result files and fails on regression
+ *
+ * Usage:
+ * @code
+ *   perf_gate <baseline.json> <current.json> [--metric real_time|cpu_time]
+ *             [--threshold <pct>] [--threshold <name-substring>=<pct>]...
+ * @endcode
+ *
+ * Uses the median aggregate when the runs were repeated
+ * (--benchmark_repetitions), otherwise the median of the iteration runs.
+ * Exit codes: 0 = no regression, 1 = regression, 2 = usage or input error.
+ */
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Timing of one benchmark in a result file
+ */
+struct BenchmarkTiming {
+    double nanos = 0.0;     ///< Median time per iteration (nanoseconds)
+    double cv = -1.0;       ///< Coefficient of variation across repetitions (-1 if unknown)
+};
+
+double toNanos(double value, const std::string& unit) {
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s")  return value * 1e9;
+    return value; // "ns"
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const size_t n = values.size();
+    return (n % 2 == 1) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+/**
+ * @brief Load timings keyed by benchmark (run) name
+ * @param path Google Benchmark JSON output
+ * @param metric "real_time" or "cpu_time"
+ * @param timings Output map
+ * @return False if the file cannot be read
+ */
+bool loadTimings(const std::string& path, const std::string& metric,
+                 std::map<std::string, BenchmarkTiming>& timings) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open " << path << std::endl;
+        return false;
+    }
+
+    nlohmann::json results;
+    try {
+        file >> results;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Could not parse " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    std::map<std::string, std::vector<double>> iterations;
+    for (const auto& entry : results.value("benchmarks", nlohmann::json::array())) {
+        if (entry.value("error_occurred", false)) {
+            continue;
+        }
+        const std::string runName = entry.value("run_name", entry.value("name", ""));
+        const std::string unit = entry.value("time_unit", "ns");
+        const std::string runType = entry.value("run_type", "iteration");
+
+        if (runType == "aggregate") {
+            const std::string aggregate = entry.value("aggregate_name", "");
+            if (aggregate == "median") {
+                timings[runName].nanos = toNanos(entry.value(metric, 0.0), unit);
+            } else if (aggregate == "cv") {
+                // Reported as a fraction, unit-less
+                timings[runName].cv = entry.value(metric, 0.0);
+            }
+        } else {
+            iterations[runName].push_back(toNanos(entry.value(metric, 0.0), unit));
+        }
+    }
+
+    // Files without aggregates: median of the individual runs
+    for (auto& [name, values] : iterations) {
+        if (timings.find(name) == timings.end() || timings[name].nanos == 0.0) {
+            timings[name].nanos = median(values);
+        }
+    }
+    return true;
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " <baseline.json> <current.json> [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --metric <m>                 real_time (default) or cpu_time" << std::endl;
+    std::cout << "  --threshold <pct>            Allowed slowdown in percent (default: 10)" << std::endl;
+    std::cout << "  --threshold <substr>=<pct>   Allowed slowdown for benchmarks whose name contains <substr>" << std::endl;
+    std::cout << "  --fail-on-missing            Fail if a baseline benchmark is missing from the current run" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    std::string metric = "real_time";
+    double defaultThreshold = 10.0;
+    std::vector<std::pair<std::string, double>> thresholds;
+    bool failOnMissing = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--metric" && i + 1 < argc) {
+            metric = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            std::string value = argv[++i];
+            size_t equals = value.rfind('=');
+            if (equals == std::string::npos) {
+                defaultThreshold = std::atof(value.c_str());
+            } else {
+                thresholds.emplace_back(value.substr(0, equals), std::atof(value.c_str() + equals + 1));
+            }
+        } else if (arg == "--fail-on-missing") {
+            failOnMissing = true;
+        } else if (!arg.empty() && arg[0] != '-') {
+            files.push_back(arg);
+        } else {
+            std::cerr << "Error: Unknown argument " << arg << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (files.size() != 2 || (metric != "real_time" && metric != "cpu_time")) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::map<std::string, BenchmarkTiming> baseline, current;
+    if (!loadTimings(files[0], metric, baseline) || !loadTimings(files[1], metric, current)) {
+        return 2;
+    }
+
+    int regressions = 0;
+    int missing = 0;
+    std::cout << std::left << std::setw(56) << "benchmark"
+              << std::right << std::setw(14) << "baseline ns"
+              << std::setw(14) << "current ns"
+              << std::setw(10) << "change"
+              << std::setw(10) << "limit" << "  status" << std::endl;
+
+    for (const auto& [name, base] : baseline) {
+        auto it = current.find(name);
+        if (it == current.end()) {
+            std::cout << std::left << std::setw(56) << name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(1) << base.nanos
+                      << std::setw(14) << "-" << std::setw(10) << "-" << std::setw(10) << "-"
+                      << "  MISSING" << std::endl;
+            missing++;
+            continue;
+        }
+
+        // Most specific (longest) matching override wins
+        double limit = defaultThreshold;
+        size_t matchLength = 0;
+        for (const auto& [pattern, pct] : thresholds) {
+            if (name.find(pattern) != std::string::npos && pattern.size() >= matchLength) {
+                limit = pct;
+                matchLength = pattern.size();
+            }
+        }
+
+        const BenchmarkTiming& now = it->second;
+        const double change = base.nanos > 0.0 ? (now.nanos - base.nanos) / base.nanos * 100.0 : 0.0;
+        std::string status = "ok";
+        if (change > limit) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (change < -limit) {
+            status = "improved";
+        }
+        // Run-to-run spread larger than the limit makes the verdict unreliable
+        if (now.cv * 100.0 > limit) {
+            status += " (noisy, cv " + std::to_string(static_cast<int>(now.cv * 100.0 + 0.5)) + "%)";
+        }
+
+        std::cout << std::left << std::setw(56) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(14) << base.nanos
+                  << std::setw(14) << now.nanos
+                  << std::showpos << std::setw(9) << change << "%" << std::noshowpos
+                  << std::setw(9) << limit << "%"
+                  << "  " << status << std::endl;
+    }
+
+    for (const auto& [name, timing] : current) {
+        if (baseline.find(name) == baseline.end()) {
+            std::cout << std::left << std::setw(56) << name << std::right << std::setw(14) << "-"
+                      << std::setw(14) << std::fixed << std::setprecision(1) << timing.nanos
+                      << "  (new, not in baseline)" << std::endl;
+        }
+    }
+
+    std::cout << std::endl << regressions << " regression(s), " << missing << " missing" << std::endl;
+    if (regressions > 0 || (failOnMissing && missing > 0)) {
+        return 1;
+    }
+    return 0;
+}
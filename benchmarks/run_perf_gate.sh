@@ -0,0 +1,73 @@
+#!/bin/bash
+
+# Performance regression gate for Coinbase Ticker Analyzer
+#
+# Runs the benchmarks pinned to a CPU with repetitions, then compares the
+# medians against a stored baseline and exits non-zero on regression.
+#
+# Usage: benchmarks/run_perf_gate.sh [options] [-- extra benchmark flags]
+#   --build-dir <dir>      Build directory (default: build)
+#   --baseline <file>      Baseline JSON (default: benchmarks/baselines/<hostname>.json)
+#   --cpu <n>              CPU to pin the benchmark thread to (default: 2)
+#   --repetitions <n>      Repetitions per benchmark (default: 10)
+#   --threshold <spec>     Passed to perf_gate, e.g. 10 or PingPong=25 (repeatable)
+#   --update-baseline      Store this run as the new baseline instead of comparing
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="build"
+BASELINE="$SCRIPT_DIR/baselines/$(hostname).json"
+CPU=2
+REPETITIONS=10
+UPDATE_BASELINE=0
+GATE_ARGS=()
+BENCH_ARGS=()
+
+while [[ $# -gt 0 ]]; do
+    case "$1" in
+        --build-dir)       BUILD_DIR="$2"; shift 2 ;;
+        --baseline)        BASELINE="$2"; shift 2 ;;
+        --cpu)             CPU="$2"; shift 2 ;;
+        --repetitions)     REPETITIONS="$2"; shift 2 ;;
+        --threshold)       GATE_ARGS+=(--threshold "$2"); shift 2 ;;
+        --update-baseline) UPDATE_BASELINE=1; shift ;;
+        --)                shift; BENCH_ARGS=("$@"); break ;;
+        *) echo "Unknown argument: $1"; exit 2 ;;
+    esac
+done
+
+BENCH="$BUILD_DIR/benchmarks/benchmarks"
+GATE="$BUILD_DIR/benchmarks/perf_gate"
+if [ ! -x "$BENCH" ] || [ ! -x "$GATE" ]; then
+    echo "Benchmarks not built: expected $BENCH and $GATE"
+    exit 2
+fi
+
+RESULTS="$BUILD_DIR/benchmark_results.json"
+echo "Running benchmarks on CPU $CPU with $REPETITIONS repetitions..."
+"$BENCH" \
+    --pin-cpu "$CPU" \
+    --benchmark_repetitions="$REPETITIONS" \
+    --benchmark_report_aggregates_only=true \
+    --benchmark_enable_random_interleaving=true \
+    --benchmark_out="$RESULTS" \
+    --benchmark_out_format=json \
+    "${BENCH_ARGS[@]}"
+
+if [ "$UPDATE_BASELINE" -eq 1 ]; then
+    mkdir -p "$(dirname "$BASELINE")"
+    cp "$RESULTS" "$BASELINE"
+    echo "Baseline updated: $BASELINE"
+    exit 0
+fi
+
+if [ ! -f "$BASELINE" ]; then
+    echo "No baseline at $BASELINE"
+    echo "Record one on this machine first: $0 --update-baseline"
+    exit 2
+fi
+
+echo
+echo "Comparing against $BASELINE"
+"$GATE" "$BASELINE" "$RESULTS" "${GATE_ARGS[@]}"
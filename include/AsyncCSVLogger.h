@@ -22,6 +22,7 @@
 #include "TickerData.h"
 #include "LockFreeRingBuffer.h"
 #include "HighResTimer.h"
+#include "LatencyHistogram.h"
 #include "NUMAUtils.h"
 
 #ifdef __linux__
@@ -58,6 +59,9 @@ private:
     int m_logThreadCpu;                                        ///< CPU core for logging thread
     int m_logThreadNumaNode;                                    ///< NUMA node for logging thread
     
+    // Latency tracking (optional, owned by caller)
+    std::atomic<LatencyHistogram*> m_writeLatency{nullptr};    ///< EMA->write latency histogram
+    
     /**
      * @brief Write CSV headers to file
      */
@@ -79,18 +83,6 @@ private:
      * - NUMA memory policy
      */
     void logThreadFunction();
-    
-    /**
-     * @brief Write CSV headers to file
-     */
-    void writeHeaders();
-    
-    /**
-     * @brief Format TickerData to CSV string (optimized)
-     * @param data Ticker data to format
-     * @return CSV formatted string
-     */
-    std::string formatToCSV(const TickerData& data) const;
 
 public:
     /**
@@ -125,6 +117,24 @@ public:
      */
     bool logTickerDataWithTimestamp(const TickerData& data, int64_t timestampMicros);
     
+    /**
+     * @brief Format TickerData to CSV string (optimized)
+     * @param data Ticker data to format
+     * @return CSV formatted string
+     * 
+     * Called by the logging thread; public so it can be benchmarked in isolation.
+     */
+    std::string formatToCSV(const TickerData& data) const;
+    
+    /**
+     * @brief Set histogram receiving processing->write latency of each record
+     * @param histogram Histogram (must outlive the logger), or nullptr to disable
+     * 
+     * Latency is measured from PipelineStamps::processed_tsc to the moment the
+     * record has been written to the file stream by the logging thread.
+     */
+    void setWriteLatencyHistogram(LatencyHistogram* histogram);
+    
     /**
      * @brief Check if logger is ready for writing
      * @return True if logger is ready
@@ -0,0 +1,179 @@
+/**
+ * @file BarLogger.h
+ * @brief Asynchronous CSV writer for bars
+ *
+ * Bars close a few times a second at most, so unlike AsyncCSVLogger the
+ * writer thread is neither pinned nor real-time: it sleeps between checks
+ * and stays off the cores of the latency-critical threads.
+ */
+
+#ifndef BARLOGGER_H
+#define BARLOGGER_H
+
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include "LockFreeRingBuffer.h"
+#include "HighResTimer.h"
+#include "BranchPrediction.h"
+#ifdef __linux__
+#include "ThreadUtils.h"
+#include "NUMAUtils.h"
+#endif
+
+/**
+ * @brief Writes completed bars to their own CSV file
+ *
+ * Producer: processing thread pushes bars (SPSC, never blocks)
+ * Consumer: writer thread appends to the file
+ *
+ * @tparam Bar Bar type providing static csvHeader() and toCSV()
+ */
+template<typename Bar>
+class BarLogger {
+private:
+    static constexpr size_t QUEUE_SIZE = 1024;         ///< Bars buffered for the writer (power of 2)
+
+    std::string m_filename;                             ///< Output CSV filename
+    std::ofstream m_file;                               ///< Output file stream
+    LockFreeRingBuffer<Bar, QUEUE_SIZE> m_queue;        ///< SPSC: processing thread -> writer thread
+    std::thread m_thread;                               ///< Writer thread
+    std::atomic<bool> m_running{false};                 ///< Writer running status
+    std::atomic<uint64_t> m_written{0};                 ///< Bars written
+
+    /**
+     * @brief Writer thread function (consumer)
+     */
+    void writerThread() {
+        #ifdef __linux__
+        ThreadUtils::setThreadName("BarLogger");
+        #endif
+
+        Bar bar;
+        while (LIKELY(m_running.load(std::memory_order_acquire))) {
+            bool hadData = false;
+            while (m_queue.pop(bar)) {
+                m_file << bar.toCSV() << '\n';
+                m_written.fetch_add(1, std::memory_order_relaxed);
+                hadData = true;
+            }
+            if (hadData) {
+                m_file.flush();
+            } else {
+                // Bars are rare: a millisecond of delay costs nothing
+                HighResTimer::sleepMicros(1000);
+            }
+        }
+
+        // Write bars queued before shutdown
+        while (m_queue.pop(bar)) {
+            m_file << bar.toCSV() << '\n';
+            m_written.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_file.flush();
+    }
+
+public:
+    /**
+     * @brief Constructor - opens the file (appending) and starts the writer
+     * @param filename Output CSV filename
+     */
+    explicit BarLogger(const std::string& filename)
+        : m_filename(filename) {
+        m_file.open(filename, std::ios::out | std::ios::app);
+        // File open success is likely
+        if (UNLIKELY(!m_file.is_open())) {
+            std::cerr << "Error: Could not open bars file: " << filename << std::endl;
+            return;
+        }
+        // New file: header first (appending runs share one header)
+        if (m_file.tellp() == 0) {
+            m_file << Bar::csvHeader() << '\n';
+        }
+
+        #ifdef __linux__
+        // Fault in the queue before the writer starts
+        NUMAUtils::touchMemory(&m_queue, sizeof(m_queue));
+        #endif
+
+        m_running.store(true);
+        m_thread = std::thread(&BarLogger::writerThread, this);
+    }
+
+    /**
+     * @brief Destructor - writes queued bars and closes the file
+     */
+    ~BarLogger() {
+        close();
+    }
+
+    /**
+     * @brief Queue a completed bar (non-blocking)
+     * @param bar Bar to write
+     * @return True if queued, false if the queue is full
+     */
+    bool log(const Bar& bar) {
+        if (UNLIKELY(!m_running.load(std::memory_order_relaxed))) {
+            return false;
+        }
+        return LIKELY(m_queue.push(bar));
+    }
+
+    /**
+     * @brief Check if the file is open and the writer running
+     * @return True if bars can be logged
+     */
+    bool isReady() const {
+        return m_running.load() && m_file.is_open();
+    }
+
+    /**
+     * @brief Write queued bars, close the file and stop the writer
+     */
+    void close() {
+        bool expected = true;
+        if (!m_running.compare_exchange_strong(expected, false)) {
+            return; // Already closed
+        }
+
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+
+        if (m_file.is_open()) {
+            m_file.close();
+        }
+    }
+
+    /**
+     * @brief Get the output filename
+     * @return Filename
+     */
+    std::string getFilename() const { return m_filename; }
+
+    /**
+     * @brief Get the number of bars written
+     * @return Written count
+     */
+    uint64_t getWritten() const { return m_written.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Derive a bars filename from the main CSV filename
+     * @param csvFilename Main CSV filename (e.g., "ticker_data.csv")
+     * @param suffix Suffix for this bar stream (e.g., "bars")
+     * @return Bars filename (e.g., "ticker_data_bars.csv")
+     */
+    static std::string barsFilename(const std::string& csvFilename, const std::string& suffix) {
+        const std::string extension = ".csv";
+        if (csvFilename.size() > extension.size() &&
+            csvFilename.compare(csvFilename.size() - extension.size(), extension.size(), extension) == 0) {
+            return csvFilename.substr(0, csvFilename.size() - extension.size()) + "_" + suffix + ".csv";
+        }
+        return csvFilename + "_" + suffix + ".csv";
+    }
+};
+
+#endif // BARLOGGER_H
@@ -0,0 +1,110 @@
+/**
+ * @file BookSignals.h
+ * @brief Microstructure signals maintained incrementally from order book deltas
+ *
+ * Keeps running size and notional sums over the top N levels of each side.
+ * Every book change adjusts them by the level that changed plus, when the
+ * top-N set shifts, the one level that entered or left it, so signals cost
+ * O(1) per delta instead of a rescan of the book.
+ */
+
+#ifndef BOOKSIGNALS_H
+#define BOOKSIGNALS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "OrderBook.h"
+
+/**
+ * @brief Signals derived from the book, copied out for other threads
+ */
+struct BookSignalValues {
+    double microprice = 0.0;        ///< Touch prices weighted by the opposite side's size
+    double imbalance = 0.0;         ///< (bid - ask) / (bid + ask) size over the top N levels, -1..1
+    double depth_weighted_mid = 0.0; ///< Mean of the size-weighted bid and ask prices over the top N levels
+    double spread_bps = 0.0;        ///< Touch spread in basis points of the mid
+    bool valid = false;             ///< Both sides have levels
+};
+
+/**
+ * @brief Incremental top-N aggregates of one book
+ *
+ * Call onApply() after every OrderBook::apply() with the values it reported,
+ * or rebuild() after changes that were not tracked (e.g. a snapshot).
+ * Sums are exact (fixed-point, 128-bit notional), so they never drift.
+ * Single-threaded: owned by the processing thread.
+ */
+class BookSignals {
+public:
+    static constexpr size_t DEFAULT_TOP_LEVELS = 5;   ///< Levels per side in the depth signals
+
+private:
+    using Notional = __int128;  ///< price * size needs more than 64 bits in fixed point
+
+    /**
+     * @brief Running sums over the top N levels of one side
+     */
+    struct SideSums {
+        int64_t size = 0;       ///< Total size
+        Notional notional = 0;  ///< Sum of price * size
+    };
+
+    size_t m_topLevels;     ///< N
+    SideSums m_sums[2];     ///< Indexed by BookSide
+
+    /**
+     * @brief Add (sign = 1) or remove (sign = -1) a level from a side's sums
+     */
+    void adjust(BookSide side, int64_t price, int64_t size, int sign) {
+        SideSums& sums = m_sums[static_cast<size_t>(side)];
+        sums.size += sign * size;
+        sums.notional += static_cast<Notional>(sign * size) * price;
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param topLevels Levels per side in the depth signals (N, at least 1)
+     */
+    explicit BookSignals(size_t topLevels = DEFAULT_TOP_LEVELS);
+
+    /**
+     * @brief Account for one applied change
+     * @param book Book after the change
+     * @param side Side of the change
+     * @param price Level price
+     * @param previousSize Size before the change (0 = new level)
+     * @param size Size after the change (0 = removed)
+     * @param distance Distance from the touch returned by OrderBook::apply() (-1 = no change)
+     */
+    void onApply(const OrderBook& book, BookSide side, int64_t price,
+                 int64_t previousSize, int64_t size, int distance);
+
+    /**
+     * @brief Recompute the sums from the book (after a snapshot)
+     * @param book Book to scan
+     */
+    void rebuild(const OrderBook& book);
+
+    /**
+     * @brief Compute the signals from the sums and the touch
+     * @param book Book the sums belong to
+     * @return Current signals (valid = false if a side is empty)
+     */
+    BookSignalValues compute(const OrderBook& book) const;
+
+    /**
+     * @brief Get the total size of the top N levels of a side
+     * @param side Book side
+     * @return Fixed-point size
+     */
+    int64_t getTopSize(BookSide side) const { return m_sums[static_cast<size_t>(side)].size; }
+
+    /**
+     * @brief Get N
+     * @return Levels per side in the depth signals
+     */
+    size_t getTopLevels() const { return m_topLevels; }
+};
+
+#endif // BOOKSIGNALS_H
@@ -10,52 +10,275 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <vector>
 #include "WebSocketClient.h"
 #include "JSONParser.h"
 #include "EMACalculator.h"
 #include "AsyncCSVLogger.h"
 #include "TickerData.h"
 #include "LockFreeRingBuffer.h"
+#include "LatencyHistogram.h"
+#include "FeedCapture.h"
+#include "FeedReplayer.h"
+#include "SequenceTracker.h"
+#include "FeedArbiter.h"
+#include "OrderBook.h"
+#include "BookSignals.h"
+#include "RollingVWAP.h"
+#include "TradeBars.h"
+#include "BarLogger.h"
+#include "TimeBars.h"
+#include "RollingStats.h"
+#include "IndicatorGraph.h"
+#include "CorrelationMatrix.h"
+#include "SeqLock.h"
+#include "ProductSnapshot.h"
+#include "MetricsRegistry.h"
+#include "MetricsServer.h"
+#include "ConsoleMonitor.h"
+#include "TraceRing.h"
+#include "ThreadPlacement.h"
+#include "NicLocality.h"
+#include "MemoryLock.h"
 
 /**
  * @brief Main application class for Coinbase ticker analysis
  * 
  * This class orchestrates the entire ticker analysis process:
- * - WebSocket connection to Coinbase
+ * - WebSocket connection(s) to Coinbase, arbitrated when redundant
  * - JSON message parsing
- * - EMA calculations
+ * - Level2 order books (when a level2 channel is subscribed)
+ * - Per-product EMA calculations, rolling price statistics and technical indicators
+ * - Rolling VWAP and volume/dollar bars from the matches channel
+ * - Rolling cross-product correlations and betas (several products)
+ * - OHLCV time bars at several timeframes from the ticker channel
  * - CSV logging
  * - Multithreaded data processing
  */
 class CoinbaseTickerAnalyzer {
 private:
+    static constexpr size_t DATA_BUFFER_SIZE = 4096;     ///< Size of data buffer (power of 2)
+    static constexpr size_t BOOK_BUFFER_SIZE = 4096;     ///< Book update chunks per line (power of 2)
+    static constexpr size_t TRADE_BUFFER_SIZE = 4096;    ///< Trades per line (power of 2)
+    
+    /**
+     * @brief One feed connection and the queues its I/O thread fills
+     */
+    struct FeedLine {
+        std::unique_ptr<WebSocketClient> client;          ///< WebSocket connection (null in replay mode)
+        LockFreeRingBuffer<TickerData, DATA_BUFFER_SIZE> queue; ///< SPSC: line I/O thread -> processing thread
+        LockFreeRingBuffer<BookUpdate, BOOK_BUFFER_SIZE> bookQueue; ///< SPSC: level2 chunks (line 0 only)
+        LockFreeRingBuffer<TradeData, TRADE_BUFFER_SIZE> tradeQueue; ///< SPSC: parsed matches
+        MetricsShard metrics;                             ///< Counters written by this line's I/O thread only
+        PipelineLatency latency;                          ///< Receive/parse/enqueue latencies (this line's I/O thread only)
+    };
+    
+    /**
+     * @brief Per-line hot-path counters (MetricsShard indices, registered in this order)
+     */
+    enum LineCounter : size_t {
+        FramesReceived = 0,     ///< Frames received on the line
+        ParseFailures,          ///< Ticker, level2 or match frames that failed to parse
+        TicksEnqueued,          ///< Ticks pushed to the processing queue
+        TicksDropped,           ///< Ticks dropped because the queue was full
+        BookChunksEnqueued,     ///< Book chunks pushed to the book queue
+        BookQueueStalls,        ///< Times the I/O thread waited for book queue space
+        TradesEnqueued,         ///< Trades pushed to the trade queue
+        TradesDropped,          ///< Trades dropped because the trade queue was full
+        LineCounterCount        ///< Number of counters
+    };
+    
+    /**
+     * @brief Per-product analysis state
+     */
+    struct ProductContext {
+        std::string productId;                            ///< Trading pair
+        EMACalculator ema{5};                             ///< Price / mid-price EMAs (5-second interval)
+        RollingStats priceStats;                          ///< Rolling price mean/deviation/range (processing thread only)
+        RollingStats returnStats;                         ///< Rolling tick log returns (processing thread only)
+        double lastPrice = 0.0;                           ///< Previous tick price (processing thread only)
+        SeqLocked<PriceStats> latestStats;                ///< Price statistics published for other threads
+        IndicatorGraph indicators;                        ///< MACD/RSI/Bollinger/ATR per tick (processing thread only)
+        SeqLocked<IndicatorSnapshot> latestIndicators;    ///< Indicator outputs published for other threads
+        OrderBook book;                                   ///< Level2 book (processing thread only)
+        bool bookLoading = false;                         ///< Snapshot chunks are being applied (processing thread only)
+        bool bookReady = false;                           ///< A complete snapshot was applied (processing thread only)
+        SeqLocked<BookTop> top;                           ///< Top of book published for other threads
+        BookSignals signals;                              ///< Incremental top-N aggregates (processing thread only)
+        SeqLocked<BookSignalValues> latestSignals;        ///< Signals published for other threads
+        IntervalEMA micropriceEma{5};                     ///< EMA of the microprice
+        IntervalEMA imbalanceEma{5};                      ///< EMA of the top-N imbalance
+        RollingVWAP vwap;                                 ///< Rolling VWAP windows (processing thread only)
+        SeqLocked<VwapSnapshot> latestVwap;               ///< VWAP windows published for other threads
+        BarBuilder volumeBars{BarType::Volume};           ///< Volume bars (processing thread only)
+        BarBuilder dollarBars{BarType::Dollar};           ///< Dollar bars (processing thread only)
+        ProductSnapshot state;                            ///< Live state being built (processing thread only)
+        SeqLocked<ProductSnapshot> snapshot;              ///< Live state published for other threads
+    };
+    
     // Core components
-    std::unique_ptr<WebSocketClient> m_websocketClient;    ///< WebSocket client
-    std::unique_ptr<EMACalculator> m_emaCalculator;       ///< EMA calculator
+    std::vector<std::unique_ptr<FeedLine>> m_lines;       ///< Feed lines (one unless redundant lines are enabled)
+    std::unique_ptr<FeedArbiter> m_arbiter;               ///< First-copy-wins deduplication (null with one line)
+    std::unique_ptr<FeedArbiter> m_tradeArbiter;          ///< Same for matches, which share sequence numbers with tickers
+    std::vector<std::unique_ptr<ProductContext>> m_products; ///< One context per subscribed product
     std::unique_ptr<AsyncCSVLogger> m_csvLogger;          ///< Async CSV logger
+    std::unique_ptr<BarLogger<TradeBar>> m_barLogger;     ///< Volume/dollar bar writer (matches channel only)
+    std::unique_ptr<TimeBarEngine> m_timeBars;            ///< OHLCV bars per product and timeframe (null = off)
+    std::vector<std::unique_ptr<BarLogger<OhlcvBar>>> m_ohlcvLoggers; ///< One writer per timeframe
+    std::unique_ptr<ReturnSynchronizer> m_returnSync;     ///< Aligns product returns into buckets (null = off)
+    std::unique_ptr<RollingCovariance> m_covariance;      ///< Rolling covariance of the aligned returns
+    SeqLocked<CorrelationSnapshot> m_latestCorrelation;   ///< Correlations/betas published for other threads
+#ifdef __linux__
+    std::unique_ptr<FeedCapture> m_feedCapture;           ///< Raw frame recorder (capture mode)
+    std::unique_ptr<FeedReplayer> m_feedReplayer;         ///< Recorded feed source (replay mode)
+    PlacementPlan m_placement;                            ///< CPUs of the pipeline threads (set in initializeComponents)
+#endif
     
     // Threading components
     std::thread m_dataProcessingThread;                   ///< Data processing thread
-    static constexpr size_t DATA_BUFFER_SIZE = 4096;     ///< Size of data buffer (power of 2)
-    LockFreeRingBuffer<TickerData, DATA_BUFFER_SIZE> m_dataQueue; ///< Lock-free queue for ticker data
     std::atomic<bool> m_running;                          ///< Application running status
     std::atomic<bool> m_processingEnabled;                ///< Data processing enabled flag
+    std::atomic<uint64_t> m_ticksProcessed{0};            ///< Ticks processed by the processing thread
+    std::atomic<uint64_t> m_ticksIgnored{0};              ///< Ticks for products that were not configured
+    std::atomic<uint64_t> m_bookChunksApplied{0};         ///< Book chunks applied by the processing thread
+    std::atomic<uint64_t> m_bookChanges{0};               ///< Level changes applied to the books
+    std::atomic<uint64_t> m_tradesProcessed{0};           ///< Trades processed by the processing thread
+    
+    // Instrumentation
+    std::unique_ptr<MetricsRegistry> m_metrics;           ///< Line counters and sampled metrics
+    std::unique_ptr<ConsoleMonitor> m_monitor;            ///< Console output for the processing thread, status table
+#ifdef __linux__
+    std::unique_ptr<MetricsServer> m_metricsServer;       ///< /metrics endpoint (null = off)
+#endif
+    PipelineLatency m_latency;                            ///< Processing thread stages, plus the logger's write stage
+    SequenceTracker m_sequenceTracker;                    ///< Sequence anomalies, resumptions and time to recover
+    uint64_t m_lastEpoch;                                 ///< Feed epoch of the last tick (processing thread only)
+    std::atomic<uint32_t> m_linesUp{0};                   ///< Lines currently connected
+    std::atomic<uint64_t> m_feedEpoch{0};                 ///< Bumped when the feed comes back with no line up before
+    std::atomic<uint64_t> m_feedDownTsc{0};               ///< TSC stamp of the last time every line was down
     
     // Configuration
-    std::string m_productId;                              ///< Product ID to analyze
+    std::vector<std::string> m_productIds;                ///< Product IDs to analyze
+    std::vector<std::string> m_channels;                  ///< Channels to subscribe to
     std::string m_csvFilename;                            ///< CSV output filename
+    std::string m_endpoint;                               ///< WebSocket feed URI
+    bool m_allowSelfSigned;                               ///< Accept self-signed TLS certificates
+    std::string m_captureFilename;                        ///< Raw feed capture file (empty = off)
+    std::string m_replayFilename;                         ///< Raw feed replay file (empty = live feed)
+    double m_replaySpeed;                                 ///< Replay speed (0 = max, 1 = real time)
+    bool m_replayMode;                                    ///< Pipeline is fed from a capture file
+    int64_t m_staleTimeoutMillis;                         ///< Feed silence that forces a reconnect (0 = off)
+    size_t m_lineCount;                                   ///< Redundant feed lines to open
+    std::vector<std::string> m_lineInterfaces;            ///< Local interface per line (empty = any)
+    std::vector<int64_t> m_vwapWindowSeconds;             ///< Rolling VWAP windows
+    double m_volumeBarSize;                               ///< Volume per volume bar (0 = off)
+    double m_dollarBarSize;                               ///< Notional per dollar bar (0 = off)
+    std::vector<int64_t> m_timeBarSeconds;                ///< OHLCV bar timeframes (empty = off)
+    int64_t m_statsWindowSeconds;                         ///< Rolling price statistics window
+    std::string m_indicatorSpec;                          ///< Indicator graph config (empty = off)
+    int64_t m_correlationBucketMillis;                    ///< Return bucket for correlations (0 = off)
+    size_t m_correlationWindow;                           ///< Buckets in the correlation window
+    int m_metricsPort;                                    ///< Localhost port of the /metrics endpoint (0 = off)
+    int64_t m_monitorIntervalMillis;                      ///< Console status table period (0 = off)
+    int64_t m_traceThresholdNanos;                        ///< Receive->processed latency that requests a trace dump (0 = off)
+    bool m_irqPlan;                                       ///< Print a suggested NIC RX interrupt affinity at startup
+    bool m_lockMemory;                                    ///< mlockall() in the startup memory phase
+#ifdef __linux__
+    MemoryUsage m_startupMemory;                          ///< Residency and fault counts once startup finished
+#endif
     
     /**
      * @brief Handle incoming WebSocket message
      * @param message Received message string
+     * @param receiveTsc TSC cycles when the frame was received from the socket
+     * @param line Feed line the frame arrived on
+     */
+    void handleWebSocketMessage(const std::string& message, uint64_t receiveTsc, size_t line);
+    
+    /**
+     * @brief Parse a level2 message and queue it in chunks (I/O thread)
+     * @param message Received message string
+     * @param receiveTsc TSC cycles when the frame was received from the socket
+     * @param line Feed line the frame arrived on
+     */
+    void handleBookMessage(const std::string& message, uint64_t receiveTsc, size_t line);
+    
+    /**
+     * @brief Apply one chunk of book changes (processing thread)
+     * @param update Dequeued chunk
+     */
+    void applyBookUpdate(const BookUpdate& update);
+    
+    /**
+     * @brief Stamp and publish a product's live state (processing thread)
+     * @param context Product whose state changed
+     * @param tsc TSC stamp of the update
+     */
+    void publishSnapshot(ProductContext& context, uint64_t tsc);
+    
+    /**
+     * @brief Parse a match message and queue it (I/O thread)
+     * @param message Received message string
+     * @param receiveTsc TSC cycles when the frame was received from the socket
+     * @param line Feed line the frame arrived on
+     */
+    void handleTradeMessage(const std::string& message, uint64_t receiveTsc, size_t line);
+    
+    /**
+     * @brief Arbitrate a dequeued trade and update VWAP and bars (processing thread)
+     * @param trade Dequeued trade
+     * @param line Feed line the trade was queued by
      */
-    void handleWebSocketMessage(const std::string& message);
+    void processTrade(const TradeData& trade, size_t line);
+    
+    /**
+     * @brief Find the context of a product
+     * @param productId Trading pair
+     * @return Index into m_products, or -1 if the product is not configured
+     */
+    int findProduct(const std::string& productId) const;
+    
+    /**
+     * @brief Track how many lines are up (called on the lines' I/O threads)
+     * @param connected True when a line connected, false when it dropped
+     */
+    void onLineConnectionChange(bool connected);
+    
+    /**
+     * @brief Build the metrics registry for the current lines and products
+     */
+    void registerMetrics();
+    
+    /**
+     * @brief Fault in the line queues, product state and console queue (before their threads start)
+     */
+    void prefaultComponents();
+    
+    /**
+     * @brief Sum a line counter over every line
+     * @param counter Counter
+     * @return Total (0 before start())
+     */
+    uint64_t lineTotal(LineCounter counter) const;
+    
+    /**
+     * @brief Track sequence numbers and recovery after reconnects
+     * @param data Dequeued ticker data
+     */
+    void trackSequence(const TickerData& data);
     
     /**
      * @brief Process ticker data in separate thread
      */
     void processDataThread();
     
+    /**
+     * @brief Arbitrate, track and process one dequeued tick
+     * @param data Dequeued ticker data
+     * @param line Feed line the tick was queued by
+     */
+    void processDequeued(TickerData& data, size_t line);
+    
     /**
      * @brief Process single ticker data item
      * @param data Ticker data to process
@@ -76,7 +299,7 @@ private:
 public:
     /**
      * @brief Constructor
-     * @param productId Product ID to analyze (e.g., "BTC-USD")
+     * @param productId Product ID(s) to analyze, comma separated (e.g., "BTC-USD,ETH-USD")
      * @param csvFilename Output CSV filename
      */
     CoinbaseTickerAnalyzer(const std::string& productId = "BTC-USD", 
@@ -105,17 +328,30 @@ public:
     bool isRunning() const;
     
     /**
-     * @brief Get current product ID
-     * @return Current product ID
+     * @brief Get current product ID(s)
+     * @return Current product IDs, comma separated
      */
     std::string getProductId() const;
     
     /**
-     * @brief Set product ID
-     * @param productId New product ID
+     * @brief Set product ID(s)
+     * @param productId New product ID, or several comma separated
      */
     void setProductId(const std::string& productId);
     
+    /**
+     * @brief Get subscribed channels
+     * @return Channel names, comma separated
+     */
+    std::string getChannels() const;
+    
+    /**
+     * @brief Set channels to subscribe to
+     * @param channels Comma-separated channel names (e.g., "ticker,level2_batch")
+     * @note Must be called before start(); books are kept when a level2 channel is included
+     */
+    void setChannels(const std::string& channels);
+    
     /**
      * @brief Get current CSV filename
      * @return Current CSV filename
@@ -128,11 +364,162 @@ public:
      */
     void setCsvFilename(const std::string& filename);
     
+    /**
+     * @brief Get WebSocket feed endpoint
+     * @return Feed URI
+     */
+    std::string getEndpoint() const;
+    
+    /**
+     * @brief Set WebSocket feed endpoint (e.g., a local mock exchange)
+     * @param uri Feed URI (ws:// or wss://)
+     * @param allowSelfSigned Accept self-signed TLS certificates
+     * @note Must be called before start()
+     */
+    void setEndpoint(const std::string& uri, bool allowSelfSigned = false);
+    
+    /**
+     * @brief Open several redundant connections with the same subscriptions
+     * @param count Number of lines (1 = single connection, at most FeedArbiter::MAX_LINES)
+     * @param interfaces Local interface or IP per line (missing entries = any)
+     * @note Must be called before start(); lines are deduplicated by (product, sequence)
+     */
+    void setFeedLines(size_t count, const std::vector<std::string>& interfaces = {});
+    
+    /**
+     * @brief Configure the analytics computed from the matches channel
+     * @param vwapWindowSeconds Rolling VWAP windows in seconds (at most VwapSnapshot::MAX_WINDOWS)
+     * @param volumeBarSize Base-currency volume per volume bar (0 = off)
+     * @param dollarBarSize Quote-currency notional per dollar bar (0 = off)
+     * @note Must be called before start(); bars go to "<csv name>_bars.csv"
+     */
+    void setTradeAnalytics(const std::vector<int64_t>& vwapWindowSeconds, double volumeBarSize, double dollarBarSize);
+    
+    /**
+     * @brief Configure the OHLCV time bars built from ticker prices
+     * @param timeframeSeconds Bar lengths in seconds (empty = off, at most TimeBarEngine::MAX_TIMEFRAMES)
+     * @note Must be called before start(); each timeframe goes to "<csv name>_ohlcv_<timeframe>.csv"
+     */
+    void setTimeBars(const std::vector<int64_t>& timeframeSeconds);
+    
+    /**
+     * @brief Set the window of the rolling price statistics (volatility, z-score, min/max)
+     * @param seconds Window in seconds
+     * @note Must be called before start()
+     */
+    void setStatsWindow(int64_t seconds);
+    
+    /**
+     * @brief Set the technical indicators computed on every tick
+     * @param spec Comma-separated indicators, e.g. "macd(12,26,9),rsi(14),bb(20,2),atr(14)" (empty = off)
+     * @note Must be called before start(); an invalid spec makes start() fail
+     */
+    void setIndicators(const std::string& spec);
+    
+    /**
+     * @brief Configure rolling correlations and betas between products
+     * @param bucketMillis Return bucket length in milliseconds (0 = off)
+     * @param windowBuckets Buckets in the rolling window
+     * @note Must be called before start(); needs at least two products, betas are
+     *       against the first, at most CorrelationSnapshot::MAX_PRODUCTS are included
+     */
+    void setCorrelation(int64_t bucketMillis, size_t windowBuckets);
+    
+    /**
+     * @brief Reconnect when the feed stays silent for too long
+     * @param millis Silence in milliseconds (0 = only reconnect on close/error)
+     * @note Must be called before start()
+     */
+    void setStaleTimeout(int64_t millis);
+    
+    /**
+     * @brief Print a per-product status table to the console periodically
+     * @param millis Table period in milliseconds (0 = off)
+     * @note Must be called before start()
+     */
+    void setMonitorInterval(int64_t millis);
+    
+    /**
+     * @brief Request a trace dump when a tick's receive->processed latency exceeds a threshold
+     * @param micros Threshold in microseconds (0 = off); the dump itself is written by
+     *        whoever polls TraceRecorder::takeDumpRequest() (the main loop)
+     * @note Must be called before start()
+     */
+    void setTraceThreshold(int64_t micros);
+    
+    /**
+     * @brief Print suggested smp_affinity_list settings for the feed NIC's RX interrupts at startup
+     * @param enabled True to print the suggestion (live feed only)
+     * @note Must be called before start()
+     */
+    void setIrqPlan(bool enabled);
+    
+    /**
+     * @brief Enable or disable mlockall() at startup (pre-faulting always runs)
+     * @param enabled True to lock all current and future memory (default)
+     * @note Must be called before start()
+     */
+    void setMemoryLock(bool enabled);
+    
+    /**
+     * @brief Serve Prometheus metrics on http://127.0.0.1:<port>/metrics
+     * @param port TCP port (0 = off)
+     * @note Must be called before start()
+     */
+    void setMetricsPort(int port);
+    
+    /**
+     * @brief Record every raw frame received from the live feed
+     * @param filename Capture filename (empty to disable)
+     * @note Must be called before start()
+     */
+    void setCaptureFile(const std::string& filename);
+    
+    /**
+     * @brief Feed the pipeline from a capture file instead of the live WebSocket
+     * @param filename Capture file written in capture mode (empty for live feed)
+     * @param speed Replay speed (0 = as fast as possible, 1 = real time, N = N x real time)
+     * @note Must be called before start()
+     */
+    void setReplaySource(const std::string& filename, double speed = 0.0);
+    
+    /**
+     * @brief Check if a replay has delivered every frame and the pipeline has drained
+     * @return True once replay is complete (always false for the live feed)
+     */
+    bool isSourceExhausted() const;
+    
     /**
      * @brief Get statistics about processed data
      * @return String containing statistics
      */
     std::string getStatistics() const;
+    
+    /**
+     * @brief Render every metric in the Prometheus text format (what /metrics serves)
+     * @return Exposition text (empty before start())
+     */
+    std::string getMetrics() const;
+    
+    /**
+     * @brief Get a consistent copy of a product's live state (any thread, lock-free)
+     * @param productId Trading pair
+     * @param snapshot Receives the state (all fields from the same update)
+     * @return False if the product is not configured
+     */
+    bool getProductSnapshot(const std::string& productId, ProductSnapshot& snapshot) const;
+    
+    /**
+     * @brief Get per-stage latency histograms, merged over every recording thread
+     * @return Merged copy of the pipeline latency histograms
+     */
+    std::unique_ptr<PipelineLatency> getPipelineLatency() const;
+    
+    /**
+     * @brief Get p50/p99/p99.9/max report for every pipeline stage
+     * @return Formatted latency report
+     */
+    std::string getLatencyReport() const;
 };
 
 #endif // COINBASETICKERANALYZER_H
@@ -0,0 +1,123 @@
+/**
+ * @file ConsoleMonitor.h
+ * @brief Rate-limited console status display that keeps stdio off the hot path
+ *
+ * The processing thread never writes to std::cout or std::cerr: stdio takes a
+ * lock, flushes on std::endl and makes a write syscall per line. Instead it
+ * posts short, pre-formatted events (sequence anomalies, recoveries, errors) into an
+ * SPSC queue, and the monitor thread prints them together with a periodic
+ * per-product summary table read from the published ProductSnapshots.
+ */
+
+#ifndef CONSOLEMONITOR_H
+#define CONSOLEMONITOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LockFreeRingBuffer.h"
+#include "ProductSnapshot.h"
+
+/**
+ * @brief One console line posted by the processing thread
+ */
+struct ConsoleEvent {
+    static constexpr size_t MAX_TEXT = 184;     ///< Longest line kept (longer lines are truncated)
+
+    bool error = false;                         ///< Print to std::cerr instead of std::cout
+    char text[MAX_TEXT] = {};                   ///< NUL-terminated line, without the newline
+};
+
+/**
+ * @brief Console thread: posted events plus a periodic per-product table
+ */
+class ConsoleMonitor {
+public:
+    /// Reads the latest published state of a product (called on the monitor thread)
+    using SnapshotReader = std::function<ProductSnapshot(size_t)>;
+
+private:
+    static constexpr size_t EVENT_QUEUE_SIZE = 256;    ///< Pending events (power of 2)
+
+    std::vector<std::string> m_productIds;             ///< Table rows, by product index
+    SnapshotReader m_reader;                           ///< Source of the table
+    int64_t m_intervalMillis;                          ///< Table period (0 = events only)
+
+    LockFreeRingBuffer<ConsoleEvent, EVENT_QUEUE_SIZE> m_events;  ///< SPSC: processing thread -> monitor
+    std::atomic<uint64_t> m_eventsDropped{0};          ///< Events lost to a full queue
+
+    std::thread m_thread;                              ///< Monitor thread
+    std::atomic<bool> m_running{false};                ///< Monitor running status
+    std::vector<uint64_t> m_lastTicks;                 ///< Ticks per product at the previous table (monitor thread only)
+    int64_t m_lastTableNanos;                          ///< Time of the previous table (monitor thread only)
+
+    /**
+     * @brief Monitor thread loop
+     */
+    void monitorLoop();
+
+    /**
+     * @brief Print every queued event
+     */
+    void drainEvents();
+
+    /**
+     * @brief Print the per-product table
+     */
+    void printTable();
+
+public:
+    /**
+     * @brief Constructor
+     * @param productIds Products, in the order the reader indexes them
+     * @param reader Returns a product's latest snapshot
+     * @param intervalMillis Table period in milliseconds (0 = only print events)
+     */
+    ConsoleMonitor(const std::vector<std::string>& productIds, SnapshotReader reader, int64_t intervalMillis);
+
+    /**
+     * @brief Destructor - stops the thread
+     */
+    ~ConsoleMonitor();
+
+    /**
+     * @brief Start the monitor thread
+     */
+    void start();
+
+    /**
+     * @brief Print what is still queued and stop the thread
+     */
+    void stop();
+
+    /**
+     * @brief Queue a printf-style line (single producer: the processing thread)
+     *
+     * Formats into a fixed slot with vsnprintf: no allocation, no locks, no
+     * syscalls. The line is dropped if the monitor has fallen 256 lines behind.
+     * @param error Print to std::cerr instead of std::cout
+     * @param format printf format
+     * @return False if the queue was full
+     */
+    bool post(bool error, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+    /**
+     * @brief Get the number of events dropped because the queue was full
+     * @return Dropped events
+     */
+    uint64_t getEventsDropped() const { return m_eventsDropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Render the per-product table (also used by the monitor thread)
+     * @param snapshots One snapshot per product
+     * @param rates Ticks per second per product
+     * @return Table text, one line per product after the header
+     */
+    std::string formatTable(const std::vector<ProductSnapshot>& snapshots, const std::vector<double>& rates) const;
+};
+
+#endif // CONSOLEMONITOR_H
@@ -0,0 +1,186 @@
+/**
+ * @file CorrelationMatrix.h
+ * @brief Rolling cross-product correlations and betas on time-aligned returns
+ *
+ * Products tick at different times, so prices are first sampled into common
+ * time buckets: when a bucket closes, every product contributes the log return
+ * of its last price over the bucket (0 if it did not trade). The return
+ * vectors feed a rolling covariance matrix kept as running sums: adding a
+ * bucket is a rank-1 update of the cross-product matrix, and the bucket that
+ * leaves the window is a rank-1 downdate. Both are one pass over contiguous
+ * rows that the compiler vectorizes across products.
+ */
+
+#ifndef CORRELATIONMATRIX_H
+#define CORRELATIONMATRIX_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Correlation matrix and betas, copied out for other threads
+ */
+struct CorrelationSnapshot {
+    static constexpr size_t MAX_PRODUCTS = 16;                      ///< Products per matrix
+
+    size_t count = 0;                                               ///< Products in the matrix
+    size_t benchmark = 0;                                           ///< Product the betas are against
+    uint64_t samples = 0;                                           ///< Return buckets in the window
+    int64_t bucket_end_ns = 0;                                      ///< End of the newest bucket included
+    std::array<double, MAX_PRODUCTS * MAX_PRODUCTS> correlation{};  ///< Row-major, [i * MAX_PRODUCTS + j]
+    std::array<double, MAX_PRODUCTS> beta{};                        ///< Beta of each product vs the benchmark
+    std::array<double, MAX_PRODUCTS> volatility{};                  ///< Standard deviation of bucket returns
+
+    /**
+     * @brief Get one correlation
+     * @param i Row product
+     * @param j Column product
+     * @return Correlation (0 if either product has no variance)
+     */
+    double get(size_t i, size_t j) const { return correlation[i * MAX_PRODUCTS + j]; }
+};
+
+/**
+ * @brief Samples product prices into common time buckets and emits aligned returns
+ *
+ * Single-threaded: owned by the processing thread.
+ */
+class ReturnSynchronizer {
+private:
+    int64_t m_bucketNanos;              ///< Bucket length
+    std::vector<double> m_last;         ///< Last price per product (0 = none yet)
+    std::vector<double> m_previous;     ///< Price per product at the previous bucket close
+    std::vector<double> m_returns;      ///< Return vector being emitted
+    int64_t m_bucket;                   ///< Index of the open bucket (time / length)
+    bool m_started;                     ///< A price has been seen
+
+public:
+    /**
+     * @brief Constructor
+     * @param products Number of products
+     * @param bucketNanos Bucket length in nanoseconds
+     */
+    ReturnSynchronizer(size_t products, int64_t bucketNanos);
+
+    /**
+     * @brief Add a price; closes the open bucket first if the price is past its end
+     * @param product Product index
+     * @param timeNanos Price time
+     * @param price Price
+     * @param onReturns Called as onReturns(const double* returns, int64_t bucketEndNanos) per closed bucket
+     * @param maxBuckets Most buckets emitted for one gap (later empty buckets are skipped)
+     * @return Number of buckets emitted
+     */
+    template<typename Fn>
+    size_t onPrice(size_t product, int64_t timeNanos, double price, Fn&& onReturns, size_t maxBuckets) {
+        const int64_t bucket = timeNanos / m_bucketNanos;
+        size_t emitted = 0;
+        if (!m_started) {
+            m_bucket = bucket;
+            m_started = true;
+        } else if (bucket > m_bucket) {
+            // Returns need a price at both ends: nothing is emitted until every product has ticked
+            if (computeReturns()) {
+                onReturns(static_cast<const double*>(m_returns.data()), (m_bucket + 1) * m_bucketNanos);
+                emitted++;
+                // Buckets nobody traded in: every return is 0
+                std::fill(m_returns.begin(), m_returns.end(), 0.0);
+                for (int64_t empty = m_bucket + 1; empty < bucket && emitted < maxBuckets; ++empty) {
+                    onReturns(static_cast<const double*>(m_returns.data()), (empty + 1) * m_bucketNanos);
+                    emitted++;
+                }
+            }
+            m_bucket = bucket;
+        }
+        // Late prices (older bucket) count toward the open bucket
+        m_last[product] = price;
+        return emitted;
+    }
+
+    /**
+     * @brief Get the bucket length
+     * @return Bucket length in nanoseconds
+     */
+    int64_t getBucketNanos() const { return m_bucketNanos; }
+
+private:
+    /**
+     * @brief Fill m_returns from the last and previous prices and roll previous forward
+     * @return False while some product has no price yet
+     */
+    bool computeReturns();
+};
+
+/**
+ * @brief Rolling covariance matrix over the last N return vectors
+ *
+ * Single-threaded: owned by the processing thread; publish snapshot() for
+ * other threads.
+ */
+class RollingCovariance {
+private:
+    size_t m_products;              ///< Products (matrix dimension)
+    size_t m_window;                ///< Return vectors kept
+    std::vector<double> m_ring;     ///< Return vectors, [slot * products + product]
+    std::vector<double> m_sum;      ///< Sum of returns per product
+    std::vector<double> m_cross;    ///< Sum of r * r^T, row-major
+    size_t m_count;                 ///< Vectors in the window
+    size_t m_pos;                   ///< Next ring slot
+    int64_t m_lastBucketEnd;        ///< End time of the newest vector
+
+    /**
+     * @brief Recompute the sums from the ring (bounds rounding drift)
+     */
+    void resum();
+
+public:
+    /**
+     * @brief Constructor - allocates the ring and matrix
+     * @param products Number of products (at most CorrelationSnapshot::MAX_PRODUCTS)
+     * @param window Return vectors in the window
+     */
+    RollingCovariance(size_t products, size_t window);
+
+    /**
+     * @brief Add a return vector, dropping the oldest once the window is full
+     * @param returns One return per product
+     * @param bucketEndNanos End time of the bucket the returns cover
+     */
+    void add(const double* returns, int64_t bucketEndNanos);
+
+    /**
+     * @brief Get the sample covariance of two products
+     * @return Covariance (0 with fewer than 2 vectors)
+     */
+    double covariance(size_t i, size_t j) const;
+
+    /**
+     * @brief Get the correlation of two products
+     * @return Correlation (0 if either has no variance)
+     */
+    double correlation(size_t i, size_t j) const;
+
+    /**
+     * @brief Get the beta of a product against a benchmark product
+     * @return cov(i, benchmark) / var(benchmark) (0 if the benchmark has no variance)
+     */
+    double beta(size_t i, size_t benchmark) const;
+
+    /**
+     * @brief Get the number of vectors in the window
+     * @return Vector count
+     */
+    size_t count() const { return m_count; }
+
+    /**
+     * @brief Get the full matrix, betas and volatilities
+     * @param benchmark Product the betas are against
+     * @return Snapshot
+     */
+    CorrelationSnapshot snapshot(size_t benchmark) const;
+};
+
+#endif // CORRELATIONMATRIX_H
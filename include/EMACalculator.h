@@ -10,47 +10,73 @@
 #include <atomic>
 
 /**
- * @brief Class for calculating Exponential Moving Average (EMA)
+ * @brief Time-gated EMA of a single series
  * 
- * This class provides lock-free EMA calculations for price and mid-price data
- * with a configurable time interval. Uses atomic operations for thread safety
- * without blocking. Uses a 5-second interval by default.
+ * The building block of EMACalculator: a sample only updates the average once
+ * the interval has passed since the last accepted sample. Updates must come
+ * from one thread; the value may be read from any thread. A reader that sees
+ * isInitialized() also sees the seeded value. The value and flag are separate
+ * atomics, so read several EMAs together from a published ProductSnapshot.
  */
-class EMACalculator {
+class IntervalEMA {
 private:
     std::chrono::seconds m_interval;                       ///< EMA calculation interval
+    std::atomic<double> m_value;                           ///< Current EMA
+    double m_alpha;                                        ///< Smoothing factor (2/(n+1))
+    std::atomic<bool> m_initialized;                       ///< Whether the EMA has been initialized (set after the value)
+    std::chrono::system_clock::time_point m_lastUpdate;    ///< Last accepted sample timestamp (updating thread only)
+
+public:
+    /**
+     * @brief Constructor
+     * @param intervalSeconds Time interval for EMA calculation (default: 5 seconds)
+     */
+    explicit IntervalEMA(int intervalSeconds = 5);
     
-    // EMA values
-    std::atomic<double> m_priceEMA;                        ///< EMA of price field
-    std::atomic<double> m_midPriceEMA;                     ///< EMA of mid-price
+    /**
+     * @brief Update EMA with a new sample
+     * @param value New sample
+     * @param currentTime Sample timestamp
+     * @return Updated EMA value
+     */
+    double update(double value, const std::chrono::system_clock::time_point& currentTime);
     
-    // EMA parameters
-    double m_alpha;                                        ///< Smoothing factor (2/(n+1))
-    bool m_priceInitialized;                               ///< Whether price EMA has been initialized
-    bool m_midPriceInitialized;                            ///< Whether mid-price EMA has been initialized
-    std::chrono::system_clock::time_point m_priceLastUpdate;    ///< Last price EMA update timestamp
-    std::chrono::system_clock::time_point m_midPriceLastUpdate; ///< Last mid-price EMA update timestamp
+    /**
+     * @brief Get current EMA
+     * @return Current EMA value
+     */
+    double get() const { return m_value.load(); }
     
     /**
-     * @brief Calculate smoothing factor alpha based on interval
-     * @param intervalSeconds Time interval in seconds
-     * @return Smoothing factor alpha
+     * @brief Reset EMA calculation
      */
-    double calculateAlpha(int intervalSeconds) const;
+    void reset();
     
     /**
-     * @brief Check if enough time has passed for price EMA update
-     * @param currentTime Current timestamp
-     * @return True if update should be performed
+     * @brief Check if EMA is initialized
+     * @return True if the EMA has been initialized with data
      */
-    bool shouldUpdatePrice(const std::chrono::system_clock::time_point& currentTime) const;
+    bool isInitialized() const { return m_initialized.load(std::memory_order_acquire); }
     
     /**
-     * @brief Check if enough time has passed for mid-price EMA update
-     * @param currentTime Current timestamp
-     * @return True if update should be performed
+     * @brief Calculate smoothing factor alpha based on interval
+     * @param intervalSeconds Time interval in seconds
+     * @return Smoothing factor alpha
      */
-    bool shouldUpdateMidPrice(const std::chrono::system_clock::time_point& currentTime) const;
+    static double calculateAlpha(int intervalSeconds);
+};
+
+/**
+ * @brief Class for calculating Exponential Moving Average (EMA)
+ * 
+ * This class provides lock-free EMA calculations for price and mid-price data
+ * with a configurable time interval. Uses atomic operations for thread safety
+ * without blocking. Uses a 5-second interval by default.
+ */
+class EMACalculator {
+private:
+    IntervalEMA m_priceEMA;                                ///< EMA of price field
+    IntervalEMA m_midPriceEMA;                             ///< EMA of mid-price
 
 public:
     /**
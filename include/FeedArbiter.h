@@ -0,0 +1,121 @@
+/**
+ * @file FeedArbiter.h
+ * @brief A/B line arbitration: forwards the first copy of every sequenced message
+ *
+ * With several WebSocket connections ("lines") carrying the same subscriptions,
+ * every message arrives once per line. The arbiter keeps a small sliding
+ * window of recent sequence numbers per product, forwards the first copy and
+ * drops the rest, and measures how far each line trailed the winner.
+ */
+
+#ifndef FEEDARBITER_H
+#define FEEDARBITER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "LatencyHistogram.h"
+
+/**
+ * @brief Deduplicates messages from redundant feed lines by (product, sequence)
+ *
+ * accept() must be called from a single thread (the processing thread); the
+ * statistics may be read from any thread.
+ */
+class FeedArbiter {
+public:
+    static constexpr size_t WINDOW_SIZE = 64;  ///< Recent messages remembered per product (power of 2)
+    static constexpr size_t MAX_LINES = 8;     ///< Maximum number of feed lines
+
+private:
+    static constexpr size_t WINDOW_MASK = WINDOW_SIZE - 1;
+
+    /**
+     * @brief Recently forwarded messages of one product (ring, oldest overwritten)
+     */
+    struct Window {
+        std::array<uint64_t, WINDOW_SIZE> sequences{};  ///< Sequence numbers
+        std::array<uint64_t, WINDOW_SIZE> receiveTsc{}; ///< Earliest receive stamp of each sequence
+        std::array<uint8_t, WINDOW_SIZE> lines{};       ///< Line that delivered the earliest copy
+        size_t head = 0;                                ///< Next slot to write
+        size_t count = 0;                               ///< Valid entries
+        uint64_t newest = 0;                            ///< Highest sequence forwarded
+    };
+
+    /**
+     * @brief Per-line counters
+     */
+    struct LineStats {
+        std::atomic<uint64_t> copies{0};    ///< Sequenced messages received on this line
+        std::atomic<uint64_t> wins{0};      ///< Messages this line delivered first
+        LatencyHistogram lag;               ///< How far behind the winner this line's copies were (ns)
+    };
+
+    std::unordered_map<std::string, Window> m_windows;      ///< Per-product windows (processing thread only)
+    size_t m_lineCount;                                     ///< Number of lines
+    std::array<std::unique_ptr<LineStats>, MAX_LINES> m_lineStats; ///< Per-line statistics
+
+    std::atomic<uint64_t> m_forwarded{0};   ///< Messages forwarded downstream
+    std::atomic<uint64_t> m_duplicates{0};  ///< Copies dropped as duplicates
+    std::atomic<uint64_t> m_stale{0};       ///< Copies older than the window, dropped
+
+    /**
+     * @brief Remember a forwarded sequence
+     */
+    static void insert(Window& window, uint64_t sequence, size_t line, uint64_t receiveTsc);
+
+public:
+    /**
+     * @brief Constructor
+     * @param lineCount Number of feed lines (1..MAX_LINES)
+     */
+    explicit FeedArbiter(size_t lineCount);
+
+    /**
+     * @brief Decide whether a received copy is forwarded
+     * @param productId Product the sequence belongs to
+     * @param sequence Exchange sequence number (0 = unsequenced, always forwarded)
+     * @param line Line the copy arrived on
+     * @param receiveTsc TSC stamp taken when the line received the frame
+     * @return true for the first copy of a message, false for duplicates
+     */
+    bool accept(const std::string& productId, uint64_t sequence, size_t line, uint64_t receiveTsc);
+
+    /**
+     * @brief Get the number of lines
+     * @return Line count
+     */
+    size_t getLineCount() const { return m_lineCount; }
+
+    /**
+     * @brief Get the messages a line delivered first
+     * @param line Line index
+     * @return Win count
+     */
+    uint64_t getWins(size_t line) const;
+
+    /**
+     * @brief Get the lag distribution of a line behind the winning copy
+     * @param line Line index
+     * @return Histogram in nanoseconds
+     */
+    const LatencyHistogram& getLagHistogram(size_t line) const;
+
+    /**
+     * @brief Get the number of forwarded messages
+     * @return Forwarded count
+     */
+    uint64_t getForwarded() const;
+
+    /**
+     * @brief Get per-line win rates and lag percentiles
+     * @return Formatted multi-line summary
+     */
+    std::string getSummary() const;
+};
+
+#endif // FEEDARBITER_H
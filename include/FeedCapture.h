@@ -0,0 +1,132 @@
+/**
+ * @file FeedCapture.h
+ * @brief Asynchronous raw feed recorder for offline replay
+ *
+ * Records every WebSocket frame exactly as received, together with its
+ * receive time, so a session can later be replayed through the full
+ * pipeline by FeedReplayer. Recording is SPSC and never blocks the I/O thread.
+ */
+
+#ifndef FEEDCAPTURE_H
+#define FEEDCAPTURE_H
+
+#include <string>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include "LockFreeRingBuffer.h"
+
+#ifdef __linux__
+
+/**
+ * @brief On-disk layout of a capture file
+ *
+ * File := MAGIC, then repeated { FrameHeader, payload[length] }.
+ * All integers are little-endian (native x86 layout).
+ */
+namespace FeedCaptureFormat {
+    static constexpr char MAGIC[8] = {'C', 'B', 'F', 'E', 'E', 'D', '0', '1'}; ///< File signature
+
+    /**
+     * @brief Per-frame header preceding the raw payload
+     */
+    struct FrameHeader {
+        int64_t receiveWallNanos;  ///< Receive time, nanoseconds since the Unix epoch
+        uint32_t length;           ///< Payload length in bytes
+        uint32_t reserved;         ///< Padding (zero)
+    };
+    static_assert(sizeof(FrameHeader) == 16, "FrameHeader must be 16 bytes");
+}
+
+/**
+ * @brief Asynchronous recorder of raw feed frames
+ *
+ * Producer: WebSocket I/O thread calls record() for every frame.
+ * Consumer: Dedicated writer thread appends frames to the capture file.
+ */
+class FeedCapture {
+private:
+    /**
+     * @brief Frame in flight between the I/O thread and the writer thread
+     */
+    struct CapturedFrame {
+        uint64_t receiveTsc = 0;   ///< TSC cycles at socket receive
+        std::string payload;       ///< Raw frame payload
+    };
+
+    std::string m_filename;                                        ///< Capture filename
+    std::ofstream m_file;                                          ///< Capture file stream
+
+    static constexpr size_t CAPTURE_BUFFER_SIZE = 8192;           ///< Size of capture queue (power of 2)
+    LockFreeRingBuffer<CapturedFrame, CAPTURE_BUFFER_SIZE> m_queue; ///< SPSC queue of frames
+
+    std::thread m_writerThread;                                    ///< Dedicated writer thread
+    std::atomic<bool> m_running{false};                            ///< Writer running status
+    std::atomic<uint64_t> m_framesRecorded{0};                     ///< Frames written to disk
+    std::atomic<uint64_t> m_framesDropped{0};                      ///< Frames dropped (queue full)
+
+    /**
+     * @brief Writer thread function (consumer)
+     */
+    void writerThreadFunction();
+
+    /**
+     * @brief Append one frame to the file
+     * @param frame Frame to write
+     */
+    void writeFrame(const CapturedFrame& frame);
+
+public:
+    /**
+     * @brief Constructor - opens the file and starts the writer thread
+     * @param filename Capture filename (truncated if it exists)
+     */
+    explicit FeedCapture(const std::string& filename);
+
+    /**
+     * @brief Destructor - drains the queue and closes the file
+     */
+    ~FeedCapture();
+
+    /**
+     * @brief Record a raw frame (non-blocking, producer thread only)
+     * @param payload Raw frame payload
+     * @param receiveTsc TSC cycles at socket receive (from HighResTimer::nowCycles())
+     * @return True if queued, false if the queue was full (frame dropped)
+     */
+    bool record(const std::string& payload, uint64_t receiveTsc);
+
+    /**
+     * @brief Check if the capture file is open and the writer is running
+     * @return True if ready
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Drain pending frames, stop the writer thread and close the file
+     */
+    void close();
+
+    /**
+     * @brief Get number of frames written to disk
+     * @return Frames recorded
+     */
+    uint64_t getFramesRecorded() const;
+
+    /**
+     * @brief Get number of frames dropped because the queue was full
+     * @return Frames dropped
+     */
+    uint64_t getFramesDropped() const;
+
+    /**
+     * @brief Get the capture filename
+     * @return Capture filename
+     */
+    std::string getFilename() const;
+};
+
+#endif // __linux__
+
+#endif // FEEDCAPTURE_H
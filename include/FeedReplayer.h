@@ -0,0 +1,120 @@
+/**
+ * @file FeedReplayer.h
+ * @brief Replays recorded raw feed files through the processing pipeline
+ *
+ * Reads a file written by FeedCapture and hands every frame to a callback
+ * with the same signature as the live WebSocket message callback, either
+ * as fast as possible (throughput benchmark) or paced at real time / N x speed.
+ */
+
+#ifndef FEEDREPLAYER_H
+#define FEEDREPLAYER_H
+
+#include <string>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+
+/**
+ * @brief Replay source for recorded feed files
+ *
+ * The file is memory-mapped, so replay speed is not limited by read syscalls.
+ * The replay thread takes the place of the WebSocket I/O thread as producer.
+ */
+class FeedReplayer {
+public:
+    /// Frame handler: frame payload and TSC cycles at (replayed) receive
+    using FrameCallback = std::function<void(const std::string&, uint64_t)>;
+
+private:
+    std::string m_filename;                 ///< Capture file to replay
+    double m_speed;                         ///< Pacing: 0 = max speed, 1 = real time, N = N x speed
+
+    const char* m_data;                     ///< Memory-mapped file contents
+    size_t m_size;                          ///< Mapped size in bytes
+
+    std::thread m_replayThread;             ///< Replay (producer) thread
+    std::atomic<bool> m_running{false};     ///< Replay running status
+    std::atomic<bool> m_finished{false};    ///< All frames replayed (or stopped)
+    int m_cpuCore;                          ///< CPU core for the replay thread
+
+    std::atomic<uint64_t> m_framesReplayed{0};  ///< Frames handed to the callback
+    std::atomic<uint64_t> m_bytesReplayed{0};   ///< Payload bytes handed to the callback
+    std::atomic<int64_t> m_elapsedNanos{0};     ///< Wall time spent replaying
+
+    /**
+     * @brief Replay thread function
+     * @param callback Frame handler
+     */
+    void replayThreadFunction(FrameCallback callback);
+
+    /**
+     * @brief Wait until the paced release time of a frame
+     * @param targetNanos Release time (HighResTimer::nowNanos() base)
+     */
+    void waitUntil(int64_t targetNanos) const;
+
+public:
+    /**
+     * @brief Constructor
+     * @param filename Capture file written by FeedCapture
+     * @param speed Replay speed (0 = as fast as possible, 1 = real time, N = N x real time)
+     */
+    explicit FeedReplayer(const std::string& filename, double speed = 0.0);
+
+    /**
+     * @brief Destructor - stops replay and unmaps the file
+     */
+    ~FeedReplayer();
+
+    /**
+     * @brief Map the file and validate its header
+     * @return True if the file is a valid capture
+     */
+    bool open();
+
+    /**
+     * @brief Start replaying on a dedicated thread
+     * @param callback Frame handler (called from the replay thread)
+     * @param cpuCore CPU core for the replay thread (-1 for no pinning)
+     * @return True if started
+     */
+    bool start(FrameCallback callback, int cpuCore = -1);
+
+    /**
+     * @brief Stop replay and join the replay thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if all frames have been replayed
+     * @return True once the replay thread has finished
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief Get number of frames replayed so far
+     * @return Frames replayed
+     */
+    uint64_t getFramesReplayed() const;
+
+    /**
+     * @brief Get number of payload bytes replayed so far
+     * @return Bytes replayed
+     */
+    uint64_t getBytesReplayed() const;
+
+    /**
+     * @brief Get throughput summary (frames, bytes, elapsed time, rate)
+     * @return Summary string
+     */
+    std::string getSummary() const;
+};
+
+#endif // __linux__
+
+#endif // FEEDREPLAYER_H
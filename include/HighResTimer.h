@@ -12,6 +12,8 @@
 
 #include <cstdint>
 #include <chrono>
+#include <atomic>
+#include "SeqLock.h"
 
 #ifdef __linux__
 #include <time.h>
@@ -22,27 +24,85 @@
 #include <x86intrin.h>
 #endif
 
+class LatencyHistogram;
+
 /**
  * @brief HFT-grade high-resolution timer with RDTSC support
  * 
  * Provides cycle-accurate, nanosecond-precision timestamps using:
- * - RDTSC on x86/x86_64 (fastest, no system call overhead)
- * - CLOCK_MONOTONIC_RAW on Linux (fallback)
+ * - RDTSC on x86/x86_64 when CPUID reports an invariant TSC (fastest, no system call)
+ * - CLOCK_MONOTONIC_RAW via the vDSO otherwise (fallback)
  * - std::chrono on other platforms
  * 
- * RDTSC is calibrated at startup to convert cycles to nanoseconds.
+ * RDTSC is calibrated at startup against CLOCK_MONOTONIC_RAW. An optional
+ * background thread keeps re-measuring the TSC frequency and slews the
+ * conversion so nowNanos() tracks the reference clock all day. The
+ * conversion parameters are published through a seqlock, so nowNanos()
+ * stays lock-free and never makes a system call.
  */
 class HighResTimer {
 private:
-    static bool s_initialized;
-    static double s_tscFrequencyGHz;  // TSC frequency in GHz
-    static int64_t s_tscOffset;      // Offset for calibration
+    /**
+     * @brief TSC-to-nanosecond conversion parameters
+     */
+    struct TscCalibration {
+        uint64_t baseTsc;        ///< TSC value at the calibration point
+        int64_t baseNanos;       ///< Reference nanoseconds at baseTsc
+        double nanosPerCycle;    ///< Conversion slope (includes any slew correction)
+        int64_t wallOffsetNanos; ///< Wall clock minus reference time
+    };
+    
+    static std::atomic<bool> s_initialized;             // Set (release) once calibration is published
+    static int s_wallClockId;                           // CLOCK_REALTIME or CLOCK_TAI
+    static std::atomic<bool> s_invariantTsc;            // CPUID reports invariant TSC
+    static std::atomic<bool> s_useTsc;                  // RDTSC fast path enabled
+    static std::atomic<double> s_tscFrequencyGHz;       // Smoothed TSC frequency in GHz
+    static SeqLocked<TscCalibration> s_calibration;     // Current conversion parameters
+    static std::atomic<int64_t> s_lastErrorNanos;       // Reference minus TSC time at last recalibration
     
     /**
      * @brief Initialize RDTSC calibration (called once at startup)
      */
     static void initializeRDTSC();
     
+    /**
+     * @brief Check CPUID for an invariant (constant rate, non-stop) TSC
+     * @return True if the TSC is invariant
+     */
+    static bool detectInvariantTSC();
+    
+    /**
+     * @brief Read the reference clock (CLOCK_MONOTONIC_RAW)
+     * @return Reference time in nanoseconds
+     */
+    static int64_t readReferenceNanos();
+    
+    /**
+     * @brief Read the configured wall clock (CLOCK_REALTIME or CLOCK_TAI)
+     * @return Nanoseconds since the epoch
+     */
+    static int64_t readWallNanos();
+    
+    /**
+     * @brief Measure wall clock minus local time base for a calibration
+     * @param calibration Calibration used to convert TSC to local time
+     * @return Wall clock offset in nanoseconds
+     */
+    static int64_t measureWallOffset(const TscCalibration& calibration);
+    
+    /**
+     * @brief Sample a tightly bracketed (TSC, reference nanoseconds) pair
+     * @param tsc Output TSC value (midpoint of the bracket)
+     * @param nanos Output reference time in nanoseconds
+     */
+    static void sampleClockPair(uint64_t& tsc, int64_t& nanos);
+    
+    /**
+     * @brief Background recalibration loop
+     * @param intervalMillis Recalibration interval in milliseconds
+     */
+    static void recalibrationLoop(int64_t intervalMillis);
+    
     /**
      * @brief Read TSC register (x86/x86_64 only)
      * @return TSC value (cycles)
@@ -56,13 +116,29 @@ private:
     }
     
 public:
+    /**
+     * @brief Wall clocks that TSC stamps can be mapped to
+     */
+    enum class WallClock {
+        Realtime,   ///< CLOCK_REALTIME (UTC, NTP-disciplined)
+        TAI         ///< CLOCK_TAI (no leap seconds; requires the kernel TAI offset to be set)
+    };
+    
     /**
      * @brief Initialize timer (call once at startup for RDTSC calibration)
+     * 
+     * Thread-safe: concurrent first callers wait for a single calibration.
      */
     static void initialize();
+    
+    /**
+     * @brief Select the wall clock used by nowWallNanos() (call before initialize())
+     * @param clock Wall clock to map to
+     */
+    static void setWallClock(WallClock clock);
     /**
      * @brief Get current timestamp in nanoseconds
-     * @return Timestamp in nanoseconds since an arbitrary point
+     * @return Timestamp in nanoseconds on the CLOCK_MONOTONIC_RAW time base
      * 
      * Uses RDTSC on x86/x86_64 for maximum performance (no system call).
      * Falls back to clock_gettime(CLOCK_MONOTONIC_RAW) on Linux.
@@ -70,14 +146,76 @@ public:
     static int64_t nowNanos();
     
     /**
-     * @brief Get current TSC value (cycles) - x86/x86_64 only
-     * @return TSC cycles, or 0 if not available
+     * @brief Get current wall-clock time in nanoseconds since the Unix epoch
+     * @return Wall-clock nanoseconds (comparable across hosts and with exchange times)
+     * 
+     * Same RDTSC fast path as nowNanos() plus a calibrated wall clock offset;
+     * no system call.
+     */
+    static int64_t nowWallNanos();
+    
+    /**
+     * @brief Convert an absolute stamp from nowCycles() to wall-clock time
+     * @param cycles Value previously returned by nowCycles()
+     * @return Nanoseconds since the Unix epoch at which the stamp was taken
+     */
+    static int64_t cyclesToWallNanos(uint64_t cycles);
+    
+    /**
+     * @brief Start background TSC recalibration
+     * @param intervalMillis Recalibration interval in milliseconds
+     * 
+     * Each step re-measures the TSC frequency against CLOCK_MONOTONIC_RAW,
+     * smooths it, and slews the conversion so the accumulated error is
+     * absorbed over the next interval without nowNanos() ever stepping back.
+     * The wall clock offset is refreshed on every step (also without RDTSC)
+     * so nowWallNanos() follows NTP adjustments.
+     */
+    static void startRecalibration(int64_t intervalMillis = 1000);
+    
+    /**
+     * @brief Stop background TSC recalibration and join its thread
+     */
+    static void stopRecalibration();
+    
+    /**
+     * @brief Perform a single recalibration step
+     */
+    static void recalibrate();
+    
+    /**
+     * @brief Check whether CPUID reports an invariant TSC
+     * @return True if the TSC is invariant
+     */
+    static bool isInvariantTSC();
+    
+    /**
+     * @brief Check whether the RDTSC fast path is in use
+     * @return True if nowNanos() is derived from RDTSC
+     */
+    static bool isUsingTSC();
+    
+    /**
+     * @brief Get the current (smoothed) TSC frequency
+     * @return TSC frequency in GHz, or 0 if RDTSC is not used
+     */
+    static double getTscFrequencyGHz();
+    
+    /**
+     * @brief Get the TSC drift measured at the last recalibration
+     * @return Reference clock minus TSC-derived time, in nanoseconds
+     */
+    static int64_t getClockErrorNanos();
+    
+    /**
+     * @brief Get current TSC value (cycles)
+     * @return TSC cycles on x86/x86_64, nanoseconds (from nowNanos()) otherwise
      */
     static uint64_t nowCycles();
     
     /**
      * @brief Convert TSC cycles to nanoseconds
-     * @param cycles TSC cycles
+     * @param cycles TSC cycles (or nanoseconds where RDTSC is unavailable)
      * @return Nanoseconds
      */
     static int64_t cyclesToNanos(uint64_t cycles);
@@ -147,11 +285,15 @@ public:
 
 /**
  * @brief RAII timer for measuring code block latency
+ * 
+ * Either prints the elapsed time on destruction (label mode, for ad-hoc
+ * debugging only) or records it into a LatencyHistogram (hot-path safe).
  */
 class ScopedTimer {
 private:
     int64_t m_start;
     const char* m_label;
+    LatencyHistogram* m_histogram;
     
 public:
     /**
@@ -161,7 +303,13 @@ public:
     explicit ScopedTimer(const char* label = nullptr);
     
     /**
-     * @brief Destructor - logs elapsed time
+     * @brief Constructor - starts timer that records into a histogram
+     * @param histogram Histogram receiving the elapsed nanoseconds (no I/O)
+     */
+    explicit ScopedTimer(LatencyHistogram& histogram);
+    
+    /**
+     * @brief Destructor - records or logs elapsed time
      */
     ~ScopedTimer();
     
@@ -0,0 +1,167 @@
+/**
+ * @file IndicatorGraph.h
+ * @brief Technical indicators (MACD, RSI, Bollinger, ATR, ...) as one shared computation graph
+ *
+ * Indicators are built from a config string out of primitive nodes (EMA,
+ * Wilder smoothing, SMA, difference, ...). Identical nodes are created once,
+ * so an EMA used by both MACD and a crossover is computed once per tick. A
+ * node is only added after its inputs, so the node array is already in
+ * topological order and a tick is one pass over flat arrays of values and
+ * state.
+ */
+
+#ifndef INDICATORGRAPH_H
+#define INDICATORGRAPH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Primitive node operations
+ */
+enum class IndicatorOp : uint8_t {
+    Close,      ///< Input: close (last price)
+    High,       ///< Input: high
+    Low,        ///< Input: low
+    Ema,        ///< EMA of a, alpha = 2 / (period + 1), seeded with the first value
+    Wilder,     ///< Wilder smoothing of a, alpha = 1 / period, seeded with the first value
+    Sma,        ///< Simple moving average of a over period samples
+    StdDev,     ///< Population standard deviation over the window of Sma node a
+    Delta,      ///< a minus its previous value (0 on the first sample)
+    Gain,       ///< max(a, 0)
+    Loss,       ///< max(-a, 0)
+    Sub,        ///< a - b
+    AddScaled,  ///< a + param * b
+    Rsi,        ///< 100 - 100 / (1 + a / b) from average gain a and average loss b
+    TrueRange,  ///< max(high a, previous close c) - min(low b, previous close c)
+    Sign        ///< -1, 0 or +1 by the sign of a
+};
+
+/**
+ * @brief Indicator outputs, copied out for other threads
+ */
+struct IndicatorSnapshot {
+    static constexpr size_t MAX_OUTPUTS = 16;       ///< Outputs per graph
+    size_t count = 0;                               ///< Valid entries in values
+    std::array<double, MAX_OUTPUTS> values{};       ///< Output values, in getOutputName() order
+    std::array<bool, MAX_OUTPUTS> ready{};          ///< Output has seen enough samples to be meaningful
+};
+
+/**
+ * @brief Indicator graph over one series
+ *
+ * Periods count samples (ticks), not time. Configure before use; update()
+ * and snapshot() are for the processing thread only.
+ */
+class IndicatorGraph {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;    ///< Unused node input
+
+private:
+    /**
+     * @brief One node
+     */
+    struct Node {
+        IndicatorOp op;         ///< Operation
+        uint32_t a;             ///< First input node
+        uint32_t b;             ///< Second input node
+        uint32_t c;             ///< Third input node
+        uint32_t period;        ///< Smoothing / window length (0 if unused)
+        double param;           ///< Scale factor (AddScaled only)
+        uint32_t state;         ///< Offset of the node's state in m_state
+        uint32_t warmup;        ///< Samples before the value is meaningful
+    };
+
+    /**
+     * @brief One named output
+     */
+    struct Output {
+        std::string name;       ///< Name (e.g., "macd(12,26,9).signal")
+        uint32_t node;          ///< Node holding the value
+    };
+
+    std::vector<Node> m_nodes;          ///< Nodes in topological order
+    std::vector<double> m_values;       ///< Current value per node
+    std::vector<double> m_state;        ///< Per-node state (EMA seeds, SMA rings, previous values)
+    std::vector<Output> m_outputs;      ///< Named outputs
+    uint64_t m_samples;                 ///< Samples seen
+
+    /**
+     * @brief Find or add a node (identical nodes are shared)
+     * @return Node index
+     */
+    uint32_t node(IndicatorOp op, uint32_t a = NONE, uint32_t b = NONE, uint32_t c = NONE,
+                  uint32_t period = 0, double param = 0.0);
+
+    /**
+     * @brief Add the nodes and outputs of one indicator
+     * @param name Indicator name (e.g., "macd")
+     * @param args Arguments (empty = defaults)
+     * @return True if the indicator is known and its arguments valid
+     */
+    bool addIndicator(const std::string& name, const std::vector<double>& args);
+
+    /**
+     * @brief Add a named output
+     */
+    void output(const std::string& name, uint32_t node);
+
+public:
+    /**
+     * @brief Constructor - empty graph
+     */
+    IndicatorGraph();
+
+    /**
+     * @brief Build the graph from a config string (replaces any previous graph)
+     * @param spec Comma-separated indicators, e.g. "macd(12,26,9),rsi(14),bb(20,2),atr(14)".
+     *             Known: ema(n), sma(n), macd(fast,slow,signal), rsi(n), bb(n,k), atr(n), cross(fast,slow)
+     * @return True on success (errors are printed to std::cerr)
+     */
+    bool configure(const std::string& spec);
+
+    /**
+     * @brief Evaluate every node for one sample
+     * @param high Sample high (the price for a tick)
+     * @param low Sample low (the price for a tick)
+     * @param close Sample close (the price for a tick)
+     */
+    void update(double high, double low, double close);
+
+    /**
+     * @brief Get the current outputs
+     * @return Snapshot of every output
+     */
+    IndicatorSnapshot snapshot() const;
+
+    /**
+     * @brief Get an output value by index
+     * @param index Output index (< getOutputCount())
+     * @return Current value
+     */
+    double value(size_t index) const { return m_values[m_outputs[index].node]; }
+
+    /**
+     * @brief Get an output name by index
+     * @param index Output index (< getOutputCount())
+     * @return Name
+     */
+    const std::string& getOutputName(size_t index) const { return m_outputs[index].name; }
+
+    /**
+     * @brief Get the number of outputs
+     * @return Output count
+     */
+    size_t getOutputCount() const { return m_outputs.size(); }
+
+    /**
+     * @brief Get the number of nodes evaluated per sample (after sharing)
+     * @return Node count
+     */
+    size_t getNodeCount() const { return m_nodes.size(); }
+};
+
+#endif // INDICATORGRAPH_H
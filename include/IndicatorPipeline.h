@@ -0,0 +1,278 @@
+/**
+ * @file IndicatorPipeline.h
+ * @brief Compile-time indicator pipelines: Pipeline<EMA<5>, EMA<20>, MidPrice, Spread>
+ *
+ * The fixed-set counterpart of IndicatorGraph. Stages are plain value types
+ * held in a std::tuple, and update() expands to one inlined call per stage,
+ * so a tick has no virtual calls, no node array to walk and no pointers to
+ * chase. Periods are template parameters, which makes smoothing factors
+ * constexpr. Use it when the indicator set is known at build time; stages
+ * do not share state, so list a shared sub-indicator once.
+ */
+
+#ifndef INDICATORPIPELINE_H
+#define INDICATORPIPELINE_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include "BranchPrediction.h"
+
+/**
+ * @brief One sample fed to every stage
+ */
+struct PipelineInput {
+    double high = 0.0;      ///< Sample high (the price for a tick)
+    double low = 0.0;       ///< Sample low (the price for a tick)
+    double close = 0.0;     ///< Sample close (the price for a tick)
+    double bid = 0.0;       ///< Best bid
+    double ask = 0.0;       ///< Best ask
+
+    /**
+     * @brief Input for one tick, which is its own high, low and close
+     */
+    static PipelineInput fromTick(double price, double bid, double ask) {
+        return PipelineInput{price, price, price, bid, ask};
+    }
+};
+
+/**
+ * @brief Exponential smoothing with a compile-time factor, seeded with the first value
+ * @tparam Numerator Alpha numerator
+ * @tparam Denominator Alpha denominator
+ */
+template<int Numerator, int Denominator>
+class Smoother {
+    static_assert(Numerator > 0 && Numerator <= Denominator, "alpha must be in (0, 1]");
+
+public:
+    static constexpr double ALPHA = static_cast<double>(Numerator) / Denominator; ///< Smoothing factor
+
+    void step(double x) {
+        // Seeded once (unlikely after the first sample)
+        if (UNLIKELY(!m_seeded)) {
+            m_value = x;
+            m_seeded = true;
+        } else {
+            m_value += ALPHA * (x - m_value);
+        }
+    }
+    double value() const { return m_value; }
+
+private:
+    double m_value = 0.0;   ///< Current average
+    bool m_seeded = false;  ///< First sample seen
+};
+
+/**
+ * @brief EMA of the close, alpha = 2 / (Period + 1)
+ */
+template<int Period>
+class EMA {
+    static_assert(Period >= 1, "period must be positive");
+    Smoother<2, Period + 1> m_ema;  ///< Smoothed close
+
+public:
+    void update(const PipelineInput& in) { m_ema.step(in.close); }
+    double value() const { return m_ema.value(); }
+};
+
+/**
+ * @brief Simple moving average and population deviation of the close over Period samples
+ *
+ * Values are kept relative to the first sample and resummed once per period,
+ * like the graph's SMA node, so the sums stay well conditioned.
+ */
+template<int Period>
+class SMA {
+    static_assert(Period >= 1, "period must be positive");
+    std::array<double, Period> m_ring{};    ///< Last Period samples minus the reference
+    double m_sum = 0.0;                     ///< Sum of the ring
+    double m_sumSq = 0.0;                   ///< Sum of squares of the ring
+    double m_reference = 0.0;               ///< First sample
+    int m_count = 0;                        ///< Samples in the ring
+    int m_pos = 0;                          ///< Next ring slot
+
+public:
+    void update(const PipelineInput& in) {
+        if (UNLIKELY(m_count == 0)) {
+            m_reference = in.close;
+        }
+        const double x = in.close - m_reference;
+        if (LIKELY(m_count == Period)) {
+            m_sum -= m_ring[m_pos];
+            m_sumSq -= m_ring[m_pos] * m_ring[m_pos];
+        } else {
+            m_count++;
+        }
+        m_ring[m_pos] = x;
+        m_sum += x;
+        m_sumSq += x * x;
+        m_pos = m_pos + 1 == Period ? 0 : m_pos + 1;
+        if (UNLIKELY(m_pos == 0)) {
+            m_sum = 0.0;
+            m_sumSq = 0.0;
+            for (double value : m_ring) {
+                m_sum += value;
+                m_sumSq += value * value;
+            }
+        }
+    }
+    double value() const { return m_count == 0 ? 0.0 : m_reference + m_sum / m_count; }
+    double stddev() const {
+        if (m_count == 0) {
+            return 0.0;
+        }
+        const double mean = m_sum / m_count;
+        return std::sqrt(std::max(m_sumSq / m_count - mean * mean, 0.0));
+    }
+};
+
+/**
+ * @brief Mid-price (bid + ask) / 2
+ */
+class MidPrice {
+    double m_value = 0.0;   ///< Current mid-price
+
+public:
+    void update(const PipelineInput& in) { m_value = (in.bid + in.ask) * 0.5; }
+    double value() const { return m_value; }
+};
+
+/**
+ * @brief Quoted spread ask - bid
+ */
+class Spread {
+    double m_value = 0.0;   ///< Current spread
+
+public:
+    void update(const PipelineInput& in) { m_value = in.ask - in.bid; }
+    double value() const { return m_value; }
+};
+
+/**
+ * @brief MACD line, signal and histogram
+ */
+template<int Fast, int Slow, int Signal>
+class MACD {
+    EMA<Fast> m_fast;                   ///< Fast EMA of the close
+    EMA<Slow> m_slow;                   ///< Slow EMA of the close
+    Smoother<2, Signal + 1> m_signal;   ///< EMA of the MACD line
+
+public:
+    void update(const PipelineInput& in) {
+        m_fast.update(in);
+        m_slow.update(in);
+        m_signal.step(value());
+    }
+    double value() const { return m_fast.value() - m_slow.value(); }
+    double signal() const { return m_signal.value(); }
+    double histogram() const { return value() - m_signal.value(); }
+};
+
+/**
+ * @brief RSI with Wilder smoothing of gains and losses
+ */
+template<int Period>
+class RSI {
+    static_assert(Period >= 1, "period must be positive");
+    Smoother<1, Period> m_gain;     ///< Average gain
+    Smoother<1, Period> m_loss;     ///< Average loss
+    double m_previous = 0.0;        ///< Previous close
+    bool m_hasPrevious = false;     ///< A close was seen
+
+public:
+    void update(const PipelineInput& in) {
+        const double change = LIKELY(m_hasPrevious) ? in.close - m_previous : 0.0;
+        m_previous = in.close;
+        m_hasPrevious = true;
+        m_gain.step(std::max(change, 0.0));
+        m_loss.step(std::max(-change, 0.0));
+    }
+    double value() const {
+        const double loss = m_loss.value();
+        const double gain = m_gain.value();
+        return loss > 0.0 ? 100.0 - 100.0 / (1.0 + gain / loss) : (gain > 0.0 ? 100.0 : 50.0);
+    }
+};
+
+/**
+ * @brief Bollinger bands: SMA +/- Width standard deviations
+ */
+template<int Period, int Width>
+class Bollinger {
+    SMA<Period> m_sma;  ///< Middle band and deviation
+
+public:
+    void update(const PipelineInput& in) { m_sma.update(in); }
+    double value() const { return m_sma.value(); }
+    double upper() const { return m_sma.value() + Width * m_sma.stddev(); }
+    double lower() const { return m_sma.value() - Width * m_sma.stddev(); }
+};
+
+/**
+ * @brief Average true range with Wilder smoothing
+ */
+template<int Period>
+class ATR {
+    static_assert(Period >= 1, "period must be positive");
+    Smoother<1, Period> m_range;    ///< Smoothed true range
+    double m_previousClose = 0.0;   ///< Previous close
+    bool m_hasPrevious = false;     ///< A close was seen
+
+public:
+    void update(const PipelineInput& in) {
+        const double previous = LIKELY(m_hasPrevious) ? m_previousClose : in.close;
+        m_range.step(std::max(in.high, previous) - std::min(in.low, previous));
+        m_previousClose = in.close;
+        m_hasPrevious = true;
+    }
+    double value() const { return m_range.value(); }
+};
+
+/**
+ * @brief Fixed indicator set updated in one inlined pass
+ * @tparam Stages Stage types, each with update(const PipelineInput&) and value()
+ */
+template<typename... Stages>
+class Pipeline {
+    std::tuple<Stages...> m_stages;     ///< Stages, stored inline
+
+public:
+    static constexpr size_t STAGES = sizeof...(Stages);    ///< Number of stages
+
+    /**
+     * @brief Update every stage with one sample (a fold expression: no loop, no dispatch)
+     * @param in Sample
+     */
+    void update(const PipelineInput& in) {
+        std::apply([&in](Stages&... stage) { (stage.update(in), ...); }, m_stages);
+    }
+
+    /**
+     * @brief Get a stage by position
+     * @tparam Index Stage position
+     */
+    template<size_t Index>
+    const auto& get() const { return std::get<Index>(m_stages); }
+
+    /**
+     * @brief Get a stage by type (the type must appear once)
+     * @tparam Stage Stage type
+     */
+    template<typename Stage>
+    const Stage& get() const { return std::get<Stage>(m_stages); }
+
+    /**
+     * @brief Copy every stage's value() into an array, in stage order
+     * @return Stage values
+     */
+    std::array<double, STAGES> values() const {
+        return std::apply([](const Stages&... stage) { return std::array<double, STAGES>{stage.value()...}; },
+                          m_stages);
+    }
+};
+
+#endif // INDICATORPIPELINE_H
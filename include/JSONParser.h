@@ -7,8 +7,36 @@
 #define JSONPARSER_H
 
 #include <string>
+#include <cstdint>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "TickerData.h"
+#include "OrderBook.h"
+#include "TradeData.h"
+
+/**
+ * @brief Feed message types the pipeline routes on
+ */
+enum class FeedMessageType : uint8_t {
+    Ticker,         ///< "ticker"
+    Snapshot,       ///< "snapshot" (level2 book image)
+    L2Update,       ///< "l2update" (level2 changes)
+    Match,          ///< "match" / "last_match"
+    Heartbeat,      ///< "heartbeat"
+    Subscriptions,  ///< "subscriptions" (subscribe acknowledgement)
+    Error,          ///< "error"
+    Other           ///< Anything else, or no type field
+};
+
+/**
+ * @brief Parsed level2 message (snapshot or l2update)
+ */
+struct Level2Message {
+    std::string product_id;         ///< Trading pair
+    bool snapshot = false;          ///< Full book image rather than changes
+    int64_t exchange_time_ns = 0;   ///< Exchange "time" field (0 if absent)
+    std::vector<BookChange> changes; ///< Levels (fixed point); reused between messages
+};
 
 /**
  * @brief JSON parser for Coinbase ticker messages
@@ -26,6 +54,51 @@ public:
      */
     static bool parseTickerMessage(const std::string& jsonString, TickerData& tickerData);
     
+    /**
+     * @brief Determine the message type without a full parse
+     * @param message Raw feed message
+     * @return Message type from the "type" field
+     * 
+     * Only scans for the "type" key, so non-ticker traffic can be routed
+     * or skipped before paying for a full JSON parse.
+     */
+    static FeedMessageType getMessageType(const std::string& message);
+    
+    /**
+     * @brief Parse a level2 snapshot or l2update message
+     * @param jsonString JSON string to parse
+     * @param message Output message (its change vector keeps its capacity)
+     * @return True if parsing was successful
+     */
+    static bool parseLevel2Message(const std::string& jsonString, Level2Message& message);
+    
+    /**
+     * @brief Parse a match / last_match message
+     * @param jsonString JSON string to parse
+     * @param trade Output trade
+     * @return True if parsing was successful
+     */
+    static bool parseTradeMessage(const std::string& jsonString, TradeData& trade);
+    
+    /**
+     * @brief Parse a decimal string to fixed point with 8 decimals (OrderBook::SCALE)
+     * @param text Decimal digits, optional sign and fraction (e.g. "50000.12")
+     * @param length Text length
+     * @param value Output fixed-point value; extra decimals are truncated
+     * @return True if the text is a valid decimal
+     */
+    static bool parseFixedPoint(const char* text, size_t length, int64_t& value);
+    
+    /**
+     * @brief Parse an ISO 8601 UTC timestamp to nanoseconds since the Unix epoch
+     * @param timeString Timestamp such as "2024-01-01T12:00:00.123456Z"
+     * @return Nanoseconds since the epoch, or 0 if the string is malformed
+     * 
+     * Hand-written fixed-format parser (no locale, no timezone lookup) so it
+     * can run for every message on the receive path.
+     */
+    static int64_t parseTimestampNanos(const std::string& timeString);
+    
     /**
      * @brief Create subscription message JSON
      * @param productId Product ID to subscribe to (e.g., "BTC-USD")
@@ -33,6 +106,15 @@ public:
      */
     static std::string createSubscriptionMessage(const std::string& productId);
     
+    /**
+     * @brief Create subscription message JSON for several products and channels
+     * @param productIds Product IDs to subscribe to
+     * @param channels Channel names (e.g., "ticker", "level2_batch")
+     * @return JSON subscription message string
+     */
+    static std::string createSubscriptionMessage(const std::vector<std::string>& productIds,
+                                                 const std::vector<std::string>& channels);
+    
     /**
      * @brief Validate if JSON string is a ticker message
      * @param jsonString JSON string to validate
@@ -61,6 +143,17 @@ public:
     static double getDoubleValue(const nlohmann::json& json, 
                                const std::string& key, 
                                double defaultValue = 0.0);
+    
+    /**
+     * @brief Extract unsigned integer value from JSON with error handling
+     * @param json JSON object
+     * @param key Key to extract
+     * @param defaultValue Default value if key not found
+     * @return Extracted value or default
+     */
+    static uint64_t getUInt64Value(const nlohmann::json& json, 
+                                   const std::string& key, 
+                                   uint64_t defaultValue = 0);
 
 private:
     /**
@@ -0,0 +1,232 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Fixed-memory, lock-free log-linear latency histogram (HDR-style)
+ *
+ * Designed for recording on the hot path:
+ * - No allocation after construction (fixed bucket array)
+ * - Relaxed atomic increments only (no locks, no syscalls)
+ * - ~3% relative precision over 1 ns .. ~36 minutes
+ * - Percentiles are computed on the reader side only
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "LockFreeRingBuffer.h"
+#include "BranchPrediction.h"
+
+/**
+ * @brief Summary statistics extracted from a LatencyHistogram
+ *
+ * All values are in the unit that was recorded (nanoseconds in this application).
+ */
+struct LatencySummary {
+    uint64_t count = 0;     ///< Number of recorded samples
+    double mean = 0.0;      ///< Mean value
+    uint64_t p50 = 0;       ///< 50th percentile
+    uint64_t p99 = 0;       ///< 99th percentile
+    uint64_t p999 = 0;      ///< 99.9th percentile
+    uint64_t max = 0;       ///< Maximum recorded value
+};
+
+/**
+ * @brief Lock-free log-linear histogram for latency recording
+ *
+ * Values are bucketed by their power of two (exponent) and then linearly
+ * into SUB_BUCKET_COUNT sub-buckets within that power of two. Values below
+ * SUB_BUCKET_COUNT are recorded exactly.
+ *
+ * Any number of threads may call record() concurrently with readers; all
+ * counters use relaxed atomics so recording never blocks.
+ */
+class ALIGN_CACHE_LINE LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;                                  ///< log2 of sub-buckets per power of two
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;      ///< Sub-buckets per power of two
+    static constexpr int MAX_EXPONENT = 40;                                    ///< Largest tracked power of two (2^41 ns ~ 36 min)
+    static constexpr size_t BUCKET_COUNT =
+        static_cast<size_t>(MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT; ///< Total number of buckets
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts; ///< Per-bucket sample counts
+    std::atomic<uint64_t> m_totalCount{0};                    ///< Total number of samples
+    std::atomic<uint64_t> m_sum{0};                           ///< Sum of all samples (for mean)
+    std::atomic<uint64_t> m_max{0};                           ///< Maximum recorded value
+
+public:
+    /**
+     * @brief Constructor - zeroes all buckets
+     */
+    LatencyHistogram();
+
+    // Non-copyable, non-movable (contains atomics, referenced by pointer)
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Map a value to its bucket index
+     * @param value Value to map
+     * @return Bucket index in [0, BUCKET_COUNT)
+     */
+    static inline size_t bucketIndex(uint64_t value) noexcept {
+        // Small values are recorded exactly
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value);
+        }
+
+        const int exponent = 63 - __builtin_clzll(value);
+        // Values beyond the tracked range are unlikely (clamped to last bucket)
+        if (UNLIKELY(exponent > MAX_EXPONENT)) {
+            return BUCKET_COUNT - 1;
+        }
+
+        const int shift = exponent - SUB_BUCKET_BITS;
+        const uint64_t mantissa = value >> shift; // In [SUB_BUCKET_COUNT, 2 * SUB_BUCKET_COUNT)
+        return static_cast<size_t>(shift + 1) * SUB_BUCKET_COUNT +
+               static_cast<size_t>(mantissa - SUB_BUCKET_COUNT);
+    }
+
+    /**
+     * @brief Get the highest value that maps to a bucket
+     * @param index Bucket index
+     * @return Highest equivalent value of the bucket
+     */
+    static uint64_t bucketUpperBound(size_t index) noexcept;
+
+    /**
+     * @brief Record a value (hot path, lock-free, wait-free except for a new max)
+     * @param value Value to record (nanoseconds)
+     */
+    inline void record(uint64_t value) noexcept {
+        m_counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        m_totalCount.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+
+        // New maximum is unlikely once warmed up
+        uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+        while (UNLIKELY(value > currentMax) &&
+               !m_max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Record a signed value, clamping negative values to zero
+     * @param value Value to record (nanoseconds)
+     */
+    inline void recordSigned(int64_t value) noexcept {
+        record(value > 0 ? static_cast<uint64_t>(value) : 0);
+    }
+
+    /**
+     * @brief Get total number of recorded samples
+     * @return Sample count
+     */
+    uint64_t getCount() const noexcept;
+
+    /**
+     * @brief Get maximum recorded value
+     * @return Maximum value
+     */
+    uint64_t getMax() const noexcept;
+
+    /**
+     * @brief Get value at a given percentile
+     * @param percentile Percentile in [0, 100]
+     * @return Highest equivalent value of the bucket containing the percentile
+     */
+    uint64_t getPercentile(double percentile) const;
+
+    /**
+     * @brief Compute count, mean, p50, p99, p99.9 and max in a single pass
+     * @return Latency summary
+     */
+    LatencySummary summarize() const;
+
+    /**
+     * @brief Add another histogram's samples to this one (reader side)
+     *
+     * The source may still be recording; the result is then as consistent
+     * as a summarize() of it would be.
+     * @param other Histogram to add
+     */
+    void merge(const LatencyHistogram& other) noexcept;
+
+    /**
+     * @brief Reset all buckets (only safe while no thread is recording)
+     */
+    void reset() noexcept;
+};
+
+/**
+ * @brief Pipeline stages whose latency is tracked
+ */
+enum class LatencyStage : size_t {
+    ExchangeToReceive = 0,  ///< Exchange "time" -> socket receive (wall clock, cross-host)
+    ReceiveToParse,         ///< Socket receive -> JSON parsed
+    ParseToEnqueue,         ///< JSON parsed -> pushed to processing queue
+    DequeueToEMA,           ///< Popped by processing thread -> EMAs computed
+    EMAToLogWrite,          ///< EMAs computed -> written to CSV by logger thread
+    ReceiveToBook,          ///< Socket receive -> level2 changes applied to the book
+    Count                   ///< Number of stages
+};
+
+/**
+ * @brief Set of per-stage latency histograms for the ticker pipeline
+ *
+ * Each recording thread keeps its own set, so no two threads write the same
+ * counters; readers merge() the sets before reporting.
+ */
+class PipelineLatency {
+private:
+    std::array<LatencyHistogram, static_cast<size_t>(LatencyStage::Count)> m_stages; ///< One histogram per stage
+
+public:
+    /**
+     * @brief Get histogram for a stage
+     * @param stage Pipeline stage
+     * @return Histogram reference
+     */
+    LatencyHistogram& stage(LatencyStage stage) noexcept {
+        return m_stages[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Get histogram for a stage (const)
+     * @param stage Pipeline stage
+     * @return Histogram reference
+     */
+    const LatencyHistogram& stage(LatencyStage stage) const noexcept {
+        return m_stages[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Get printable name of a stage
+     * @param stage Pipeline stage
+     * @return Stage name
+     */
+    static const char* stageName(LatencyStage stage) noexcept;
+
+    /**
+     * @brief Build a p50/p99/p99.9/max report for all stages
+     * @return Multi-line report string (values in microseconds)
+     */
+    std::string report() const;
+
+    /**
+     * @brief Add another set's samples stage by stage (reader side)
+     * @param other Set to add
+     */
+    void merge(const PipelineLatency& other) noexcept;
+
+    /**
+     * @brief Reset all histograms (only safe while no thread is recording)
+     */
+    void reset() noexcept;
+};
+
+#endif // LATENCYHISTOGRAM_H
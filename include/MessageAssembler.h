@@ -0,0 +1,95 @@
+/**
+ * @file MessageAssembler.h
+ * @brief Joins the receive chunks of a WebSocket message into one payload
+ *
+ * libwebsockets hands a message to the receive callback in pieces of at
+ * most the protocol rx buffer size, and a single frame can itself be one
+ * fragment of a larger message. A Coinbase level2 snapshot is hundreds of
+ * KB, so it always arrives in many chunks; only the joined message parses.
+ */
+
+#ifndef MESSAGEASSEMBLER_H
+#define MESSAGEASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "BranchPrediction.h"
+
+/**
+ * @brief Per-connection reassembly buffer (single thread: the I/O thread)
+ *
+ * @code
+ *   if (assembler.append(in, len, isLast, nowCycles)) {
+ *       handle(assembler.message(), assembler.receiveTsc());
+ *   }
+ * @endcode
+ */
+class MessageAssembler {
+private:
+    std::string m_buffer;       ///< Chunks of the message in progress (capacity kept across messages)
+    uint64_t m_receiveTsc = 0;  ///< TSC cycles at the first chunk of the message
+    bool m_inProgress = false;  ///< A message has started but not finished
+
+public:
+    /**
+     * @brief Constructor
+     * @param reserveBytes Capacity reserved up front (the largest expected message)
+     */
+    explicit MessageAssembler(size_t reserveBytes = DEFAULT_RESERVE_BYTES) {
+        m_buffer.reserve(reserveBytes);
+    }
+
+    /**
+     * @brief Add the next chunk of the current message
+     * @param data Chunk bytes
+     * @param len Chunk length (may be 0 for an empty final fragment)
+     * @param last True if this chunk completes the message
+     * @param receiveTsc TSC cycles taken when the chunk was received
+     * @return True if the message is complete; message() and receiveTsc() are then valid until the next append()
+     */
+    inline bool append(const char* data, size_t len, bool last, uint64_t receiveTsc) {
+        if (!m_inProgress) {
+            // The message was received when its first byte was
+            m_buffer.clear();
+            m_receiveTsc = receiveTsc;
+            m_inProgress = true;
+        }
+        if (len > 0) {
+            m_buffer.append(data, len);
+        }
+        // Ticker and l2update messages fit in one chunk
+        if (LIKELY(last)) {
+            m_inProgress = false;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drop a partially received message (the connection it came from is gone)
+     */
+    inline void reset() noexcept {
+        m_buffer.clear();
+        m_inProgress = false;
+    }
+
+    /**
+     * @brief Get the last completed message
+     */
+    inline const std::string& message() const noexcept { return m_buffer; }
+
+    /**
+     * @brief Get the receive stamp of the last completed message (its first chunk)
+     */
+    inline uint64_t receiveTsc() const noexcept { return m_receiveTsc; }
+
+    /**
+     * @brief Check whether a message is partially received
+     */
+    inline bool inProgress() const noexcept { return m_inProgress; }
+
+    static constexpr size_t DEFAULT_RESERVE_BYTES = 1 << 20; ///< Fits a deep level2 snapshot without regrowing
+};
+
+#endif // MESSAGEASSEMBLER_H
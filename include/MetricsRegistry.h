@@ -0,0 +1,188 @@
+/**
+ * @file MetricsRegistry.h
+ * @brief Per-thread metric shards aggregated off the hot path into Prometheus text
+ *
+ * Hot-path counters live in cache-line aligned shards, one per writing thread.
+ * A shard has a single writer, so an increment is a relaxed load and store to a
+ * line no other thread writes: no lock prefix, no false sharing. Everything else
+ * (queue depths, values other components already track, latency histograms) is
+ * sampled by callbacks when the metrics are rendered. Rendering runs on the
+ * scraping thread and only reads, so a scrape never stalls a producer.
+ */
+
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "LockFreeRingBuffer.h"
+#include "LatencyHistogram.h"
+
+/**
+ * @brief Counters written by one thread
+ */
+class ALIGN_CACHE_LINE MetricsShard {
+public:
+    static constexpr size_t MAX_COUNTERS = 16;     ///< Counters per shard
+
+private:
+    std::array<std::atomic<uint64_t>, MAX_COUNTERS> m_values;  ///< Counter values
+
+public:
+    /**
+     * @brief Constructor - zeroes all counters
+     */
+    MetricsShard();
+
+    // Non-copyable, non-movable (registered by pointer)
+    MetricsShard(const MetricsShard&) = delete;
+    MetricsShard& operator=(const MetricsShard&) = delete;
+
+    /**
+     * @brief Add to a counter (owning thread only; hot path)
+     * @param counter Counter index
+     * @param amount Amount to add
+     */
+    inline void add(size_t counter, uint64_t amount = 1) noexcept {
+        // Single writer: a plain read-modify-write cannot lose updates
+        std::atomic<uint64_t>& value = m_values[counter];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Read a counter (any thread)
+     * @param counter Counter index
+     * @return Counter value
+     */
+    uint64_t get(size_t counter) const noexcept {
+        return m_values[counter].load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Prometheus metric type
+ */
+enum class MetricType {
+    Counter,    ///< Monotonic total
+    Gauge,      ///< Current value
+    Summary     ///< Latency quantiles, sum and count
+};
+
+/**
+ * @brief Metric definitions and the shards and sources that feed them
+ *
+ * Register everything before the writing threads and the metrics server start;
+ * after that the registry is read-only and render() may run on any thread.
+ */
+class MetricsRegistry {
+private:
+    /**
+     * @brief One labelled time series
+     */
+    struct Series {
+        std::string labels;                     ///< Prometheus labels, e.g. line="0" (empty = none)
+        std::function<double()> sample;         ///< Sampled value (sampled metrics)
+        std::vector<const LatencyHistogram*> histograms; ///< Source histograms, merged on render (summaries)
+    };
+
+    /**
+     * @brief Metrics sharing a name, help text and type
+     */
+    struct Family {
+        std::string name;                       ///< Metric name
+        std::string help;                       ///< HELP text
+        MetricType type;                        ///< TYPE
+        size_t counter;                         ///< Shard counter index (SIZE_MAX = not sharded)
+        std::vector<Series> series;             ///< Sampled series
+    };
+
+    /**
+     * @brief A registered shard
+     */
+    struct ShardEntry {
+        std::string label;                      ///< Writing thread, rendered as thread="..."
+        const MetricsShard* shard;              ///< Counter storage (owned by the writer)
+    };
+
+    std::vector<Family> m_families;             ///< Metrics in registration order
+    std::vector<ShardEntry> m_shards;           ///< Shards summed into the counters
+    size_t m_counterCount;                      ///< Shard counters registered so far
+
+    /**
+     * @brief Find or create a family
+     * @return Family reference
+     */
+    Family& family(const std::string& name, const std::string& help, MetricType type);
+
+public:
+    /**
+     * @brief Constructor
+     */
+    MetricsRegistry();
+
+    /**
+     * @brief Register a hot-path counter kept in every shard
+     * @param name Metric name (conventionally ending in _total)
+     * @param help HELP text
+     * @return Counter index for MetricsShard::add(), or SIZE_MAX when every slot is used
+     */
+    size_t addCounter(const std::string& name, const std::string& help);
+
+    /**
+     * @brief Register a writer's shard
+     * @param thread Label of the writing thread
+     * @param shard Shard that outlives the registry's readers
+     */
+    void addShard(const std::string& thread, const MetricsShard* shard);
+
+    /**
+     * @brief Register a value sampled on each render
+     * @param name Metric name
+     * @param help HELP text
+     * @param type Counter or Gauge
+     * @param labels Prometheus labels (empty = none)
+     * @param sample Called on the rendering thread; must only read
+     */
+    void addSampled(const std::string& name, const std::string& help, MetricType type,
+                    const std::string& labels, std::function<double()> sample);
+
+    /**
+     * @brief Register a nanosecond latency histogram, rendered as a summary in seconds
+     * @param name Metric name
+     * @param help HELP text
+     * @param labels Prometheus labels (empty = none)
+     * @param histogram Histogram that outlives the registry's readers
+     */
+    void addLatency(const std::string& name, const std::string& help, const std::string& labels,
+                    const LatencyHistogram& histogram);
+
+    /**
+     * @brief Register one latency series recorded into several histograms (one per writing thread)
+     * @param name Metric name
+     * @param help HELP text
+     * @param labels Prometheus labels (empty = none)
+     * @param histograms Histograms merged on each render; they outlive the registry's readers
+     */
+    void addLatency(const std::string& name, const std::string& help, const std::string& labels,
+                    std::vector<const LatencyHistogram*> histograms);
+
+    /**
+     * @brief Sum a counter over every shard
+     * @param counter Counter index
+     * @return Total
+     */
+    uint64_t total(size_t counter) const;
+
+    /**
+     * @brief Render every metric in the Prometheus text exposition format
+     * @return Exposition text
+     */
+    std::string render() const;
+};
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,85 @@
+/**
+ * @file MetricsServer.h
+ * @brief Minimal localhost HTTP endpoint serving /metrics for Prometheus
+ *
+ * One low-priority, unpinned thread accepts a connection, renders the
+ * registry and answers. It handles one client at a time, which is plenty
+ * for a scraper polling every few seconds, and keeps it away from the cores
+ * the feed and processing threads are pinned to.
+ */
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+
+class MetricsRegistry;
+
+/**
+ * @brief HTTP server for the Prometheus text exposition of a registry
+ */
+class MetricsServer {
+private:
+    const MetricsRegistry& m_registry;      ///< Metrics rendered on each scrape
+    std::thread m_thread;                   ///< Accept/serve thread
+    std::atomic<bool> m_running{false};     ///< Server running status
+    int m_listenFd;                         ///< Listening socket (-1 = closed)
+    uint16_t m_port;                        ///< Bound port
+    std::atomic<uint64_t> m_scrapes{0};     ///< /metrics requests served
+
+    /**
+     * @brief Accept loop (server thread)
+     */
+    void serveLoop();
+
+    /**
+     * @brief Read one request and write the response
+     * @param clientFd Accepted connection
+     */
+    void serveClient(int clientFd);
+
+public:
+    /**
+     * @brief Constructor
+     * @param registry Registry to serve; must outlive the server
+     */
+    explicit MetricsServer(const MetricsRegistry& registry);
+
+    /**
+     * @brief Destructor - stops the server
+     */
+    ~MetricsServer();
+
+    /**
+     * @brief Bind 127.0.0.1:port and start serving
+     * @param port TCP port (0 = pick a free port, see getPort())
+     * @return True if the socket is listening
+     */
+    bool start(uint16_t port);
+
+    /**
+     * @brief Stop serving and close the socket
+     */
+    void stop();
+
+    /**
+     * @brief Get the bound port
+     * @return Port (0 before start())
+     */
+    uint16_t getPort() const { return m_port; }
+
+    /**
+     * @brief Get the number of scrapes served
+     * @return Scrape count
+     */
+    uint64_t getScrapeCount() const { return m_scrapes.load(std::memory_order_relaxed); }
+};
+
+#endif // __linux__
+
+#endif // METRICSSERVER_H
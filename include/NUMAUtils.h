@@ -125,7 +125,9 @@ public:
     static bool setMemoryPolicy(int nodeId);
     
     /**
-     * @brief Touch memory to ensure it's allocated on the correct node
+     * @brief Fault in memory by writing each page (contents are preserved)
+     *
+     * Pages are allocated on the calling thread's memory policy node.
      * @param ptr Pointer to memory
      * @param size Size in bytes
      */
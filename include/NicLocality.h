@@ -0,0 +1,104 @@
+/**
+ * @file NicLocality.h
+ * @brief NIC NUMA locality and interrupt affinity report (Linux-only)
+ *
+ * Socket receive latency depends on where the NIC's interrupts are serviced:
+ * an RX interrupt on the I/O thread's own core preempts it, and one on another
+ * NUMA node moves every packet across the interconnect. This reads the NIC's
+ * node from sysfs, and its interrupts with their per-CPU counts and effective
+ * affinity from /proc. It then checks the feed I/O threads against them and
+ * can suggest an smp_affinity layout that keeps RX interrupts on the NIC's
+ * node but off the hot cores.
+ */
+
+#ifndef NICLOCALITY_H
+#define NICLOCALITY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ThreadPlacement.h"
+
+#ifdef __linux__
+
+/**
+ * @brief One interrupt line of the NIC
+ */
+struct NicIrq {
+    int irq = -1;                       ///< IRQ number
+    std::string name;                   ///< Device column of /proc/interrupts (e.g. eth0-TxRx-3)
+    bool rx = false;                    ///< Services a receive queue
+    std::vector<uint64_t> perCpu;       ///< Interrupts per CPU since boot, indexed by CPU id
+    uint64_t total = 0;                 ///< Sum of perCpu
+    std::vector<int> effectiveCpus;     ///< CPUs the kernel currently delivers it to (empty = unknown)
+};
+
+/**
+ * @brief Locality of the NIC behind a feed interface
+ */
+struct NicReport {
+    std::string interface;              ///< Interface name (empty = not found)
+    int numaNode = -1;                  ///< NIC NUMA node (-1 = unknown or virtual)
+    std::vector<NicIrq> irqs;           ///< NIC interrupt lines
+    std::vector<uint64_t> rxPerCpu;     ///< RX interrupts per CPU id, summed over the RX lines
+
+    /**
+     * @brief CPUs that serviced at least a given share of the RX interrupts
+     * @param minShare Minimum share of the RX total (0-1)
+     * @return CPU ids, ascending
+     */
+    std::vector<int> rxCpus(double minShare = 0.01) const;
+
+    /**
+     * @brief Render the report (interface, node, RX interrupt CPUs)
+     * @return Report text
+     */
+    std::string format() const;
+};
+
+/**
+ * @brief Builds and checks NIC locality reports
+ */
+class NicLocality {
+public:
+    /// Share of the RX interrupts above which a CPU counts as busy with them
+    static constexpr double HEAVY_IRQ_SHARE = 0.10;
+
+    /**
+     * @brief Read the NIC's node and interrupts
+     * @param interfaceOrAddress Interface name or local IP address (empty = default route)
+     * @param procRoot procfs root (overridable for tests)
+     * @param netRoot sysfs network class directory (overridable for tests)
+     * @return Report (interface empty if it could not be resolved)
+     */
+    static NicReport inspect(const std::string& interfaceOrAddress,
+                             const std::string& procRoot = "/proc",
+                             const std::string& netRoot = "/sys/class/net");
+
+    /**
+     * @brief Check an I/O thread's placement against the NIC
+     * @param report NIC report
+     * @param io I/O thread assignment
+     * @param topology CPU topology (for hyperthread siblings)
+     * @return Warnings, empty if the placement looks right
+     */
+    static std::vector<std::string> checkPlacement(const NicReport& report, const ThreadAssignment& io,
+                                                   const CpuTopology& topology);
+
+    /**
+     * @brief Suggest smp_affinity_list settings for the NIC's RX interrupts
+     *
+     * RX interrupts are spread round-robin over CPUs on the NIC's node that no
+     * hot thread (or its hyperthread sibling) uses.
+     * @param report NIC report
+     * @param plan Thread placement
+     * @param topology CPU topology
+     * @return Shell commands, one per RX interrupt (or a note if no CPU is spare)
+     */
+    static std::string recommendAffinity(const NicReport& report, const PlacementPlan& plan,
+                                         const CpuTopology& topology);
+};
+
+#endif // __linux__
+
+#endif // NICLOCALITY_H
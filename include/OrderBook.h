@@ -0,0 +1,232 @@
+/**
+ * @file OrderBook.h
+ * @brief Level2 price-level order book with fixed-point prices in flat sorted arrays
+ *
+ * Prices and sizes are int64 fixed point (1e-8 units), parsed straight from
+ * the feed's decimal strings. Each side is a contiguous sorted vector with the
+ * best level at the back, so top-of-book reads are a single load and the
+ * frequent updates near the touch only move a few trailing elements. On a
+ * full side a new level moves the levels between it and the far end instead.
+ */
+
+#ifndef ORDERBOOK_H
+#define ORDERBOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BranchPrediction.h"
+
+/**
+ * @brief Book side
+ */
+enum class BookSide : uint8_t {
+    Bid = 0,    ///< Buy side
+    Ask = 1     ///< Sell side
+};
+
+/**
+ * @brief One price level (fixed point, 1e-8 units)
+ */
+struct BookLevel {
+    int64_t price;  ///< Level price
+    int64_t size;   ///< Aggregate size at the price
+};
+
+/**
+ * @brief One level change from a snapshot or l2update (fixed point)
+ */
+struct BookChange {
+    int64_t price;  ///< Level price
+    int64_t size;   ///< New aggregate size (0 removes the level)
+    BookSide side;  ///< Side of the level
+};
+
+/**
+ * @brief Best levels of a book, copied out for other threads
+ */
+struct BookTop {
+    int64_t bid_price = 0;      ///< Best bid price (0 if no bids)
+    int64_t bid_size = 0;       ///< Size at the best bid
+    int64_t ask_price = 0;      ///< Best ask price (0 if no asks)
+    int64_t ask_size = 0;       ///< Size at the best ask
+    uint32_t bid_depth = 0;     ///< Bid levels in the book
+    uint32_t ask_depth = 0;     ///< Ask levels in the book
+};
+
+/**
+ * @brief Fixed-size chunk of book changes passed from the I/O thread to the processing thread
+ *
+ * Plain data so it can travel through a LockFreeRingBuffer; large snapshots
+ * are split over several chunks.
+ */
+struct BookUpdate {
+    static constexpr size_t MAX_CHANGES = 32;       ///< Changes per chunk
+    static constexpr uint8_t SNAPSHOT_BEGIN = 1;    ///< First chunk of a snapshot (clear the book)
+    static constexpr uint8_t SNAPSHOT_END = 2;      ///< Last chunk of a snapshot (book is complete)
+
+    uint64_t receive_tsc = 0;       ///< TSC stamp of the frame
+    int64_t exchange_time_ns = 0;   ///< Exchange "time" field (0 for snapshots)
+    uint16_t product_index = 0;     ///< Index of the product in the analyzer's product list
+    uint8_t flags = 0;              ///< SNAPSHOT_BEGIN / SNAPSHOT_END
+    uint8_t count = 0;              ///< Valid entries in changes
+    BookChange changes[MAX_CHANGES];
+};
+
+/**
+ * @brief Price-level book for one product
+ *
+ * Bids are kept in ascending and asks in descending price order, so the
+ * best level of either side is the last element. Lookups are binary
+ * searches; both vectors are reserved up front, so updates never allocate.
+ * When a side is full the level furthest from the touch is dropped by
+ * shifting the far end down over it, never the whole side.
+ * Single-threaded: owned by the processing thread.
+ */
+class OrderBook {
+public:
+    static constexpr int64_t SCALE = 100000000;             ///< Fixed-point units per 1.0
+    static constexpr size_t DEFAULT_MAX_LEVELS = 32768;     ///< Levels kept per side
+
+private:
+    std::vector<BookLevel> m_bids;  ///< Ascending by price, best bid at the back
+    std::vector<BookLevel> m_asks;  ///< Descending by price, best ask at the back
+    size_t m_maxLevels;             ///< Capacity per side
+    uint64_t m_updates;             ///< Changes applied
+    uint64_t m_truncated;           ///< Levels dropped because a side was full
+
+public:
+    /**
+     * @brief Constructor - reserves both sides
+     * @param maxLevelsPerSide Levels kept per side
+     */
+    explicit OrderBook(size_t maxLevelsPerSide = DEFAULT_MAX_LEVELS);
+
+    /**
+     * @brief Remove all levels (start of a snapshot)
+     */
+    void clear();
+
+    /**
+     * @brief Fault in the reserved level storage of both sides (startup, before any level is applied)
+     *
+     * reserve() only maps the capacity; without this the first snapshot takes
+     * a page fault every 256 levels.
+     */
+    void prefault();
+
+    /**
+     * @brief Set the size of a price level
+     * @param side Book side
+     * @param price Level price (fixed point)
+     * @param size New size (fixed point, 0 removes the level)
+     * @param previousSize Output size of the level before the change (0 if it was not in the book)
+     * @return Distance of the level from the touch (0 = best), or -1 if nothing changed
+     */
+    int apply(BookSide side, int64_t price, int64_t size, int64_t& previousSize);
+    
+    /**
+     * @brief Set the size of a price level
+     * @param side Book side
+     * @param price Level price (fixed point)
+     * @param size New size (fixed point, 0 removes the level)
+     * @return Distance of the level from the touch (0 = best), or -1 if nothing changed
+     */
+    int apply(BookSide side, int64_t price, int64_t size) {
+        int64_t previousSize;
+        return apply(side, price, size, previousSize);
+    }
+
+    /**
+     * @brief Apply a change
+     * @param change Level change
+     * @return Distance of the level from the touch, or -1 if nothing changed
+     */
+    int apply(const BookChange& change) { return apply(change.side, change.price, change.size); }
+
+    /**
+     * @brief Check if the bid side has levels
+     * @return true if there is a best bid
+     */
+    bool hasBid() const { return !m_bids.empty(); }
+
+    /**
+     * @brief Check if the ask side has levels
+     * @return true if there is a best ask
+     */
+    bool hasAsk() const { return !m_asks.empty(); }
+
+    /**
+     * @brief Best bid (bid side must not be empty)
+     * @return Highest bid level
+     */
+    const BookLevel& bestBid() const { return m_bids.back(); }
+
+    /**
+     * @brief Best ask (ask side must not be empty)
+     * @return Lowest ask level
+     */
+    const BookLevel& bestAsk() const { return m_asks.back(); }
+
+    /**
+     * @brief Copy out the best levels and depths
+     * @return Top of book (zeros for an empty side)
+     */
+    BookTop top() const {
+        BookTop result;
+        if (LIKELY(!m_bids.empty())) {
+            result.bid_price = m_bids.back().price;
+            result.bid_size = m_bids.back().size;
+        }
+        if (LIKELY(!m_asks.empty())) {
+            result.ask_price = m_asks.back().price;
+            result.ask_size = m_asks.back().size;
+        }
+        result.bid_depth = static_cast<uint32_t>(m_bids.size());
+        result.ask_depth = static_cast<uint32_t>(m_asks.size());
+        return result;
+    }
+
+    /**
+     * @brief Number of levels on a side
+     * @param side Book side
+     * @return Level count
+     */
+    size_t depth(BookSide side) const {
+        return side == BookSide::Bid ? m_bids.size() : m_asks.size();
+    }
+
+    /**
+     * @brief Level by distance from the touch
+     * @param side Book side
+     * @param index 0 = best (must be < depth(side))
+     * @return Price level
+     */
+    const BookLevel& level(BookSide side, size_t index) const {
+        const std::vector<BookLevel>& levels = side == BookSide::Bid ? m_bids : m_asks;
+        return levels[levels.size() - 1 - index];
+    }
+
+    /**
+     * @brief Get the number of applied changes
+     * @return Update count
+     */
+    uint64_t getUpdateCount() const { return m_updates; }
+
+    /**
+     * @brief Get the number of levels dropped because a side was full
+     * @return Truncated level count
+     */
+    uint64_t getTruncatedCount() const { return m_truncated; }
+
+    /**
+     * @brief Convert a fixed-point value to double
+     * @param value Fixed-point value
+     * @return Value as double
+     */
+    static double toDouble(int64_t value) {
+        return static_cast<double>(value) / static_cast<double>(SCALE);
+    }
+};
+
+#endif // ORDERBOOK_H
@@ -0,0 +1,48 @@
+/**
+ * @file ProductSnapshot.h
+ * @brief Per-product live state published to reader threads
+ *
+ * The processing thread is the only writer of a product's state. After each
+ * tick or book update it copies the state into a ProductSnapshot published
+ * through SeqLocked, so any number of readers (statistics, a stats endpoint,
+ * strategies) get a consistent copy - price, EMAs and signals from the same
+ * update - without locks and without writing to the writer's cache lines.
+ */
+
+#ifndef PRODUCTSNAPSHOT_H
+#define PRODUCTSNAPSHOT_H
+
+#include <cstdint>
+
+/**
+ * @brief Live state of one product (trivially copyable)
+ */
+struct ProductSnapshot {
+    // Last tick
+    uint64_t ticks = 0;                 ///< Ticks processed for the product
+    uint64_t sequence = 0;              ///< Sequence number of the last tick
+    int64_t exchange_time_ns = 0;       ///< Exchange time of the last tick (0 if unparsed)
+    double price = 0.0;                 ///< Last trade price
+    double best_bid = 0.0;              ///< Best bid from the ticker
+    double best_ask = 0.0;              ///< Best ask from the ticker
+    double mid_price = 0.0;             ///< Mid-price from the ticker
+
+    // EMAs and rolling statistics
+    double price_ema = 0.0;             ///< Price EMA
+    double mid_price_ema = 0.0;         ///< Mid-price EMA
+    bool emas_ready = false;            ///< The EMAs have been seeded
+    double price_zscore = 0.0;          ///< Price vs price EMA in rolling standard deviations
+    double price_volatility = 0.0;      ///< Rolling standard deviation of tick log returns
+
+    // Order book signals (level2 subscription only)
+    bool book_ready = false;            ///< A complete book backs the fields below
+    double microprice = 0.0;            ///< Size-weighted mid of the top level
+    double microprice_ema = 0.0;        ///< Microprice EMA
+    double imbalance = 0.0;             ///< Top-N depth imbalance
+    double imbalance_ema = 0.0;         ///< Imbalance EMA
+    double spread_bps = 0.0;            ///< Book spread in basis points
+
+    uint64_t published_tsc = 0;         ///< TSC stamp of the update that published it
+};
+
+#endif // PRODUCTSNAPSHOT_H
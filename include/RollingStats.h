@@ -0,0 +1,165 @@
+/**
+ * @file RollingStats.h
+ * @brief Rolling mean, variance, min and max over a time window in O(1) per sample
+ *
+ * Samples live in a preallocated ring. Mean and variance follow Welford's
+ * update when a sample enters and its inverse when it leaves. Min and max come
+ * from monotonic deques of ring indices, each in its own preallocated ring, so
+ * a sample is pushed and popped at most once per deque and nothing allocates
+ * after construction.
+ */
+
+#ifndef ROLLINGSTATS_H
+#define ROLLINGSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Statistics of the window, copied out for other threads
+ */
+struct RollingStatsSnapshot {
+    int64_t window_ns = 0;  ///< Window length
+    uint64_t count = 0;     ///< Samples in the window
+    double mean = 0.0;      ///< Mean (0 if empty)
+    double stddev = 0.0;    ///< Sample standard deviation (0 with fewer than 2 samples)
+    double min = 0.0;       ///< Smallest sample (0 if empty)
+    double max = 0.0;       ///< Largest sample (0 if empty)
+};
+
+/**
+ * @brief Per-product price statistics published by the processing thread
+ */
+struct PriceStats {
+    RollingStatsSnapshot price;     ///< Rolling price mean, deviation and range
+    double volatility = 0.0;        ///< Standard deviation of tick log returns in the window
+    double zscore = 0.0;            ///< Last price minus the price EMA, in window standard deviations
+};
+
+/**
+ * @brief Rolling statistics over one time window
+ *
+ * The window ages by sample time: adding a sample expires every sample at or
+ * before time - window. If the window holds more samples than the ring, the
+ * oldest are dropped early (counted by getTruncatedCount()).
+ * Single-threaded: owned by the processing thread.
+ */
+class RollingStats {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 8192;    ///< Samples kept in the ring (power of 2)
+
+private:
+    /**
+     * @brief One sample
+     */
+    struct Sample {
+        int64_t time_ns;    ///< Sample time
+        double value;       ///< Value minus the reference
+    };
+
+    /**
+     * @brief Monotonic deque of absolute sample indices over ring storage
+     */
+    struct IndexDeque {
+        std::vector<uint64_t> ring; ///< Indices, addressed by position & mask
+        uint64_t front = 0;         ///< Position of the first index
+        uint64_t back = 0;          ///< Position after the last index
+    };
+
+    std::vector<Sample> m_ring;     ///< Samples, indexed by sample count & mask
+    size_t m_mask;                  ///< Ring size - 1
+    uint64_t m_head;                ///< Samples added (absolute index of the next sample)
+    uint64_t m_tail;                ///< Absolute index of the oldest sample inside the window
+    int64_t m_window_ns;            ///< Window length
+    double m_reference;             ///< First value seen, subtracted to keep the moments well conditioned
+    double m_mean;                  ///< Welford mean (relative to the reference)
+    double m_m2;                    ///< Welford sum of squared deviations
+    IndexDeque m_min;               ///< Increasing values: front is the window minimum
+    IndexDeque m_max;               ///< Decreasing values: front is the window maximum
+    uint64_t m_truncated;           ///< Samples dropped from the window early
+
+    /**
+     * @brief Remove the oldest sample from the moments and the deques
+     */
+    void expireOldest();
+
+public:
+    /**
+     * @brief Constructor - allocates the rings
+     * @param windowNanos Window length in nanoseconds
+     * @param capacity Samples kept (rounded up to a power of 2)
+     */
+    explicit RollingStats(int64_t windowNanos = 60000000000LL, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Change the window length (clears all samples)
+     * @param windowNanos Window length in nanoseconds
+     */
+    void setWindow(int64_t windowNanos);
+
+    /**
+     * @brief Add a sample and expire samples that left the window
+     * @param timeNanos Sample time
+     * @param value Sample value
+     */
+    void add(int64_t timeNanos, double value);
+
+    /**
+     * @brief Get the number of samples in the window
+     * @return Sample count
+     */
+    uint64_t count() const { return m_head - m_tail; }
+
+    /**
+     * @brief Get the window mean
+     * @return Mean (0 if empty)
+     */
+    double mean() const;
+
+    /**
+     * @brief Get the sample variance of the window
+     * @return Variance (0 with fewer than 2 samples)
+     */
+    double variance() const;
+
+    /**
+     * @brief Get the sample standard deviation of the window
+     * @return Standard deviation (0 with fewer than 2 samples)
+     */
+    double stddev() const;
+
+    /**
+     * @brief Get the smallest sample in the window
+     * @return Minimum (0 if empty)
+     */
+    double min() const;
+
+    /**
+     * @brief Get the largest sample in the window
+     * @return Maximum (0 if empty)
+     */
+    double max() const;
+
+    /**
+     * @brief Standardize a value against the window
+     * @param value Value to standardize
+     * @param center Value subtracted first (e.g., an EMA)
+     * @return (value - center) / stddev, or 0 when the deviation is 0
+     */
+    double zScore(double value, double center) const;
+
+    /**
+     * @brief Get all statistics of the window
+     * @return Snapshot
+     */
+    RollingStatsSnapshot snapshot() const;
+
+    /**
+     * @brief Get the number of samples dropped early because the ring was full
+     * @return Truncated sample count
+     */
+    uint64_t getTruncatedCount() const { return m_truncated; }
+};
+
+#endif // ROLLINGSTATS_H
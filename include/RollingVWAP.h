@@ -0,0 +1,129 @@
+/**
+ * @file RollingVWAP.h
+ * @brief Rolling VWAP over several time windows from ring-buffered prefix sums
+ *
+ * Every trade appends the running volume and notional totals as they were
+ * before it. A window's volume and notional are then the current totals
+ * minus the entry of its oldest trade, and expiring a trade is a single
+ * index increment, so each trade costs O(1) per window regardless of how
+ * many trades the window holds.
+ */
+
+#ifndef ROLLINGVWAP_H
+#define ROLLINGVWAP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Statistics of one window
+ */
+struct VwapWindowStats {
+    int64_t window_ns = 0;  ///< Window length
+    double vwap = 0.0;      ///< Volume-weighted average price (0 if no trades)
+    double volume = 0.0;    ///< Traded volume
+    double notional = 0.0;  ///< Traded notional (price * size)
+    uint64_t trades = 0;    ///< Trades in the window
+};
+
+/**
+ * @brief Statistics of all windows, copied out for other threads
+ */
+struct VwapSnapshot {
+    static constexpr size_t MAX_WINDOWS = 4;            ///< Windows per product
+    size_t count = 0;                                   ///< Valid entries in windows
+    std::array<VwapWindowStats, MAX_WINDOWS> windows{}; ///< Shortest window first
+};
+
+/**
+ * @brief Rolling VWAP and volume over configurable time windows
+ *
+ * All windows share one ring of prefix sums; each window only keeps the index
+ * of its oldest trade. Windows age by trade time, so they advance when trades
+ * arrive. If the longest window holds more trades than the ring, its oldest
+ * trades are dropped early (counted by getTruncatedCount()).
+ * Single-threaded: owned by the processing thread.
+ */
+class RollingVWAP {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 32768;   ///< Trades kept in the ring (power of 2)
+
+private:
+    using Notional = __int128;  ///< price * size needs more than 64 bits in fixed point
+
+    /**
+     * @brief Running totals before one trade
+     */
+    struct Entry {
+        int64_t time_ns;            ///< Trade time
+        int64_t volumeBefore;       ///< Total volume before the trade
+        Notional notionalBefore;    ///< Total notional before the trade
+    };
+
+    /**
+     * @brief One window: its length and its oldest trade
+     */
+    struct Window {
+        int64_t length_ns = 0;  ///< Window length
+        uint64_t tail = 0;      ///< Absolute index of the oldest trade inside
+    };
+
+    std::vector<Entry> m_ring;                                  ///< Prefix sums, indexed by trade count & mask
+    size_t m_mask;                                              ///< Ring size - 1
+    uint64_t m_count;                                           ///< Trades added
+    int64_t m_volume;                                           ///< Total volume (fixed point)
+    Notional m_notional;                                        ///< Total notional (fixed point squared)
+    std::array<Window, VwapSnapshot::MAX_WINDOWS> m_windows;    ///< Configured windows
+    size_t m_windowCount;                                       ///< Valid entries in m_windows
+    uint64_t m_truncated;                                       ///< Trades dropped from a window early
+
+public:
+    /**
+     * @brief Constructor - allocates the ring
+     * @param capacity Trades kept (rounded up to a power of 2)
+     */
+    explicit RollingVWAP(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Configure the windows (clears all trades)
+     * @param windowNanos Window lengths in nanoseconds (at most MAX_WINDOWS used)
+     */
+    void setWindows(const std::vector<int64_t>& windowNanos);
+
+    /**
+     * @brief Add a trade and expire trades that left each window
+     * @param timeNanos Trade time
+     * @param price Trade price (fixed point)
+     * @param size Trade size (fixed point)
+     */
+    void addTrade(int64_t timeNanos, int64_t price, int64_t size);
+
+    /**
+     * @brief Get the statistics of one window
+     * @param index Window index (< getWindowCount())
+     * @return Window statistics
+     */
+    VwapWindowStats window(size_t index) const;
+
+    /**
+     * @brief Get the statistics of every window
+     * @return Snapshot of all windows
+     */
+    VwapSnapshot snapshot() const;
+
+    /**
+     * @brief Get the number of configured windows
+     * @return Window count
+     */
+    size_t getWindowCount() const { return m_windowCount; }
+
+    /**
+     * @brief Get the number of trades dropped early because the ring was full
+     * @return Truncated trade count
+     */
+    uint64_t getTruncatedCount() const { return m_truncated; }
+};
+
+#endif // ROLLINGVWAP_H
@@ -0,0 +1,149 @@
+/**
+ * @file SeqLock.h
+ * @brief Single-writer sequence lock for torn-free, lock-free reads
+ *
+ * Readers never block the writer and never write shared memory, so any
+ * number of reader threads can poll published state without adding cache
+ * line contention to the (hot) writer thread.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "LockFreeRingBuffer.h"
+#include "BranchPrediction.h"
+
+/**
+ * @brief Sequence counter guarding externally stored data
+ *
+ * Writer (single thread only):
+ * @code
+ *   lock.writeBegin(); ...modify data...; lock.writeEnd();
+ * @endcode
+ * Reader (any thread):
+ * @code
+ *   uint64_t seq;
+ *   do { seq = lock.readBegin(); ...copy data...; } while (lock.readRetry(seq));
+ * @endcode
+ */
+class SeqLock {
+private:
+    ALIGN_CACHE_LINE std::atomic<uint64_t> m_sequence{0}; ///< Even = stable, odd = write in progress
+
+public:
+    /**
+     * @brief Start a write (sequence becomes odd)
+     */
+    inline void writeBegin() noexcept {
+        const uint64_t seq = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(seq + 1, std::memory_order_relaxed);
+        // Keep the data stores after the odd sequence store
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /**
+     * @brief Finish a write (sequence becomes even again)
+     */
+    inline void writeEnd() noexcept {
+        const uint64_t seq = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(seq + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Start a read, spinning while a write is in progress
+     * @return Sequence value to pass to readRetry()
+     */
+    inline uint64_t readBegin() const noexcept {
+        uint64_t seq = m_sequence.load(std::memory_order_acquire);
+        // Writes are short and rare relative to reads
+        while (UNLIKELY(seq & 1)) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+            seq = m_sequence.load(std::memory_order_acquire);
+        }
+        return seq;
+    }
+
+    /**
+     * @brief Check whether the data read since readBegin() may be torn
+     * @param seq Value returned by readBegin()
+     * @return True if the read must be retried
+     */
+    inline bool readRetry(uint64_t seq) const noexcept {
+        // Keep the data loads before the sequence re-check
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return UNLIKELY(m_sequence.load(std::memory_order_relaxed) != seq);
+    }
+
+    /**
+     * @brief Number of completed writes
+     * @return Completed write count
+     */
+    inline uint64_t version() const noexcept {
+        return m_sequence.load(std::memory_order_acquire) >> 1;
+    }
+};
+
+/**
+ * @brief Value of trivially copyable type published through a SeqLock
+ *
+ * @tparam T Trivially copyable value type
+ */
+template<typename T>
+class SeqLocked {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLocked requires a trivially copyable type");
+
+private:
+    SeqLock m_lock;   ///< Sequence counter
+    T m_value;        ///< Published value
+
+public:
+    /**
+     * @brief Constructor
+     * @param initial Initial value
+     */
+    explicit SeqLocked(const T& initial = T{}) : m_value(initial) {}
+
+    // Non-copyable, non-movable (readers hold references)
+    SeqLocked(const SeqLocked&) = delete;
+    SeqLocked& operator=(const SeqLocked&) = delete;
+
+    /**
+     * @brief Publish a new value (single writer thread only)
+     * @param value Value to publish
+     */
+    inline void store(const T& value) noexcept {
+        m_lock.writeBegin();
+        std::memcpy(static_cast<void*>(&m_value), &value, sizeof(T));
+        m_lock.writeEnd();
+    }
+
+    /**
+     * @brief Read a consistent copy of the value (any thread, lock-free)
+     * @return Copy of the last published value
+     */
+    inline T load() const noexcept {
+        T out;
+        uint64_t seq;
+        do {
+            seq = m_lock.readBegin();
+            std::memcpy(static_cast<void*>(&out), &m_value, sizeof(T));
+        } while (m_lock.readRetry(seq));
+        return out;
+    }
+
+    /**
+     * @brief Number of values published so far
+     * @return Publication count
+     */
+    inline uint64_t version() const noexcept {
+        return m_lock.version();
+    }
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,113 @@
+/**
+ * @file SequenceTracker.h
+ * @brief Per-product sequence number tracking for reordering and reconnect detection
+ *
+ * Coinbase stamps every message with a per-product sequence number. The
+ * tracked "ticker" channel only carries a subset of the product's messages,
+ * so jumps are normal both inside a connection and across a reconnect. A
+ * jump across a reconnect is reported as how far the product advanced while
+ * the feed was down. It is an upper bound on the ticks missed, not a loss count.
+ */
+
+#ifndef SEQUENCETRACKER_H
+#define SEQUENCETRACKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Classification of one sequenced message
+ */
+enum class SequenceResult : uint8_t {
+    First,          ///< First message seen for the product
+    InOrder,        ///< Newer than the last sequence seen, on the same connection
+    Duplicate,      ///< Same sequence as the previous message
+    OutOfOrder,     ///< Older than the last sequence seen
+    Resumed         ///< First in-order message after a reconnect
+};
+
+/**
+ * @brief Counters kept by SequenceTracker
+ */
+struct SequenceStats {
+    uint64_t messages = 0;          ///< Sequenced messages observed
+    uint64_t duplicates = 0;        ///< Repeated sequence numbers
+    uint64_t outOfOrder = 0;        ///< Sequence numbers older than the last seen
+    uint64_t resumptions = 0;       ///< Products that resumed after a reconnect
+    uint64_t reconnectAdvance = 0;  ///< Sequence numbers products advanced while disconnected
+    uint64_t recoveries = 0;        ///< Recorded disconnect-to-first-message recoveries
+    uint64_t lastRecoveryNanos = 0; ///< Most recent time to recover
+    uint64_t maxRecoveryNanos = 0;  ///< Worst time to recover
+};
+
+/**
+ * @brief Detects duplicates, reordering and reconnect resumptions in per-product sequence numbers
+ *
+ * onMessage() and recordRecovery() must be called from a single thread (the
+ * processing thread); getStats() may be called from any thread.
+ */
+class SequenceTracker {
+private:
+    /**
+     * @brief Last observed position of one product
+     */
+    struct ProductState {
+        uint64_t lastSequence = 0;  ///< Highest sequence seen
+        uint64_t epoch = 0;         ///< Connection epoch of lastSequence (stale frames never advance it)
+    };
+
+    std::unordered_map<std::string, ProductState> m_products; ///< Per-product state (processing thread only)
+    uint64_t m_lastSkipped;                                     ///< Sequence numbers skipped by the last message
+
+    std::atomic<uint64_t> m_messages{0};          ///< Sequenced messages observed
+    std::atomic<uint64_t> m_duplicates{0};        ///< Repeated sequence numbers
+    std::atomic<uint64_t> m_outOfOrder{0};        ///< Sequence numbers older than the last seen
+    std::atomic<uint64_t> m_resumptions{0};       ///< Products that resumed after a reconnect
+    std::atomic<uint64_t> m_reconnectAdvance{0};  ///< Sequence numbers advanced while disconnected
+    std::atomic<uint64_t> m_recoveries{0};        ///< Recorded recoveries
+    std::atomic<uint64_t> m_lastRecoveryNanos{0}; ///< Most recent time to recover
+    std::atomic<uint64_t> m_maxRecoveryNanos{0};  ///< Worst time to recover
+
+public:
+    /**
+     * @brief Constructor
+     */
+    SequenceTracker();
+
+    /**
+     * @brief Observe one message
+     * @param productId Product the sequence belongs to
+     * @param sequence Exchange sequence number (0 = unsequenced, ignored)
+     * @param epoch Connection epoch the message arrived on
+     * @return Classification of the message
+     */
+    SequenceResult onMessage(const std::string& productId, uint64_t sequence, uint64_t epoch);
+
+    /**
+     * @brief Get the number of sequence numbers the last onMessage() call jumped over
+     * @return Skipped count (0 for duplicate and out-of-order messages)
+     */
+    uint64_t getLastSkipped() const { return m_lastSkipped; }
+
+    /**
+     * @brief Record the time from a disconnect to the first message after reconnecting
+     * @param nanos Time to recover in nanoseconds
+     */
+    void recordRecovery(uint64_t nanos);
+
+    /**
+     * @brief Get a snapshot of the counters
+     * @return Current counters
+     */
+    SequenceStats getStats() const;
+
+    /**
+     * @brief Get a one-line summary for statistics output
+     * @return Formatted summary
+     */
+    std::string getSummary() const;
+};
+
+#endif // SEQUENCETRACKER_H
@@ -0,0 +1,134 @@
+/**
+ * @file ThreadPlacement.h
+ * @brief Topology-aware CPU placement of the pipeline threads (Linux-only)
+ *
+ * Reads the CPU topology from /sys/devices/system/cpu (physical cores and their
+ * hyperthread siblings, packages, NUMA nodes, isolcpus) together with the
+ * process cpuset, and assigns each pipeline thread a CPU:
+ * - Hot threads (feed I/O, processing) get a physical core each, with the
+ *   sibling hyperthreads left idle. Isolated cores come first, then cores
+ *   other than CPU 0. The I/O threads stay on their NIC's node, and the
+ *   processing thread stays next to line 0's I/O thread so the queue between
+ *   them stays in one L3.
+ * - The logger gets a spare core away from the hot ones, on another node
+ *   when there is one.
+ * When there are not enough cores, threads fall back to single hyperthreads
+ * and then to shared CPUs. Such entries are marked in the plan, which is
+ * printed at startup.
+ */
+
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+
+/**
+ * @brief One logical CPU
+ */
+struct CpuInfo {
+    int cpu = -1;                   ///< Logical CPU id
+    int core = -1;                  ///< Physical core index in CpuTopology::cores
+    int node = 0;                   ///< NUMA node
+    int package = 0;                ///< Physical package (socket)
+    bool isolated = false;          ///< Listed in isolcpus
+    bool allowed = true;            ///< In the process cpuset/affinity mask
+};
+
+/**
+ * @brief Online CPUs grouped into physical cores
+ */
+struct CpuTopology {
+    std::vector<CpuInfo> cpus;                  ///< Online CPUs, ascending
+    std::vector<std::vector<int>> cores;        ///< Logical CPUs of each physical core (hyperthread siblings)
+    int numNodes = 1;                           ///< NUMA nodes seen
+
+    /**
+     * @brief Find a CPU by id
+     * @param cpu Logical CPU id
+     * @return CPU, or nullptr if it is not online
+     */
+    const CpuInfo* find(int cpu) const;
+};
+
+/**
+ * @brief CPU chosen for one thread
+ */
+struct ThreadAssignment {
+    std::string thread;             ///< Thread name
+    int cpu = -1;                   ///< CPU to pin to (-1 = no usable CPU)
+    int node = 0;                   ///< NUMA node of the CPU
+    bool hot = false;               ///< Latency-critical thread
+    bool dedicated = false;         ///< Whole physical core, siblings left idle
+    bool shared = false;            ///< CPU also assigned to another thread
+    std::string note;               ///< Why the CPU was chosen
+};
+
+/**
+ * @brief Placement of every pipeline thread
+ */
+struct PlacementPlan {
+    std::vector<ThreadAssignment> feedIo;       ///< One per feed line (the replay thread in replay mode)
+    ThreadAssignment processing;                ///< Data processing thread
+    ThreadAssignment logger;                    ///< Async CSV logger thread
+
+    /**
+     * @brief Render the plan, one thread per line
+     * @return Plan text
+     */
+    std::string format() const;
+};
+
+/**
+ * @brief Builds thread placement plans from the machine topology
+ */
+class ThreadPlacement {
+public:
+    /**
+     * @brief Read the CPU topology
+     * @param cpuRoot sysfs CPU directory (overridable for tests)
+     * @return Topology; CPUs outside the calling thread's affinity mask are marked not allowed
+     */
+    static CpuTopology readTopology(const std::string& cpuRoot = "/sys/devices/system/cpu");
+
+    /**
+     * @brief Assign CPUs to the pipeline threads
+     * @param topology Machine topology
+     * @param lineNodes NUMA node of each feed line's NIC (-1 = unknown), one entry per line
+     * @param ioThreadName Name prefix of the I/O threads ("WebSocketIO" or "FeedReplay")
+     * @return Plan
+     */
+    static PlacementPlan plan(const CpuTopology& topology, const std::vector<int>& lineNodes,
+                              const std::string& ioThreadName);
+
+    /**
+     * @brief Find the NUMA node of the NIC behind an interface
+     * @param interfaceOrAddress Interface name or local IP address (empty = default route)
+     * @param netRoot sysfs network class directory (overridable for tests)
+     * @return NUMA node, or -1 if unknown (virtual NIC, single node)
+     */
+    static int nicNumaNode(const std::string& interfaceOrAddress,
+                           const std::string& netRoot = "/sys/class/net");
+
+    /**
+     * @brief Resolve an interface name or local IP address to an interface name
+     * @param interfaceOrAddress Interface name or local IP address (empty = default route)
+     * @param netRoot sysfs network class directory
+     * @return Interface name, or empty if not found
+     */
+    static std::string resolveInterface(const std::string& interfaceOrAddress,
+                                        const std::string& netRoot = "/sys/class/net");
+
+    /**
+     * @brief Parse a kernel CPU list such as "0-3,8,10-11"
+     * @param list CPU list
+     * @return CPU ids in the order listed
+     */
+    static std::vector<int> parseCpuList(const std::string& list);
+};
+
+#endif // __linux__
+
+#endif // THREADPLACEMENT_H
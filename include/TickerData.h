@@ -8,6 +8,21 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
+
+/**
+ * @brief TSC stamps taken as a tick moves through the pipeline
+ * 
+ * All values are raw HighResTimer::nowCycles() readings; 0 means "not stamped".
+ * Carried with the tick so every hop can be reconstructed offline.
+ */
+struct PipelineStamps {
+    uint64_t receive_tsc = 0;   ///< Frame received from the socket (I/O thread)
+    uint64_t parsed_tsc = 0;    ///< JSON parsed (I/O thread)
+    uint64_t dequeued_tsc = 0;  ///< Popped by the processing thread
+    uint64_t processed_tsc = 0; ///< EMAs computed (processing thread)
+    uint64_t written_tsc = 0;   ///< Picked up for writing by the logger thread
+};
 
 /**
  * @brief Structure to hold ticker data from Coinbase WebSocket
@@ -36,14 +51,22 @@ struct TickerData {
     double price_ema;           ///< EMA of price field
     double mid_price_ema;       ///< EMA of mid-price (best_bid + best_ask) / 2
     double mid_price;           ///< Current mid-price
+    double price_zscore;        ///< Price minus price EMA, in rolling standard deviations
+    double price_volatility;    ///< Rolling standard deviation of tick log returns
     
     // Timestamp for internal use
     std::chrono::system_clock::time_point timestamp;
+    int64_t exchange_time_ns;   ///< Exchange "time" field in nanoseconds since the epoch (0 if unparsed)
+    uint64_t sequence_number;   ///< Numeric sequence (0 if absent)
+    uint64_t connection_epoch;  ///< WebSocket connection the tick arrived on (0 = replay)
+    PipelineStamps stamps;      ///< Per-hop TSC stamps from receive to disk write
     
     /**
      * @brief Default constructor
      */
-    TickerData() : price_ema(0.0), mid_price_ema(0.0), mid_price(0.0) {}
+    TickerData() : price_ema(0.0), mid_price_ema(0.0), mid_price(0.0), price_zscore(0.0),
+                   price_volatility(0.0), exchange_time_ns(0),
+                   sequence_number(0), connection_epoch(0) {}
     
     /**
      * @brief Calculate mid-price from best bid and ask
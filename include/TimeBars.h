@@ -0,0 +1,136 @@
+/**
+ * @file TimeBars.h
+ * @brief OHLCV bars at several timeframes, updated per tick and closed by a timer wheel
+ *
+ * Each product keeps one open bar per timeframe in a contiguous array, so a
+ * tick updates every timeframe in a single pass. Bars close on clock
+ * boundaries (multiples of the timeframe since the epoch) when the timer
+ * wheel reaches them, even if no further tick arrives.
+ */
+
+#ifndef TIMEBARS_H
+#define TIMEBARS_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "TimerWheel.h"
+
+/**
+ * @brief One completed time bar
+ */
+struct OhlcvBar {
+    std::string product_id;     ///< Trading pair
+    int64_t timeframe_s = 0;    ///< Bar length in seconds
+    int64_t start_time_ns = 0;  ///< Bar start (inclusive)
+    int64_t end_time_ns = 0;    ///< Bar end (exclusive)
+    int64_t open = 0;           ///< First price (fixed point)
+    int64_t high = 0;           ///< Highest price (fixed point)
+    int64_t low = 0;            ///< Lowest price (fixed point)
+    int64_t close = 0;          ///< Last price (fixed point)
+    int64_t volume = 0;         ///< Traded size (fixed point)
+    uint32_t ticks = 0;         ///< Ticks in the bar
+
+    /**
+     * @brief Get the CSV header line matching toCSV()
+     * @return Column names
+     */
+    static const char* csvHeader();
+
+    /**
+     * @brief Convert to CSV string for logging
+     * @return CSV formatted string
+     */
+    std::string toCSV() const;
+};
+
+/**
+ * @brief Multi-timeframe OHLCV aggregator
+ *
+ * onTick() and advance() must be called from one thread (the processing
+ * thread); completed bars are passed to the sink on that thread.
+ */
+class TimeBarEngine {
+public:
+    static constexpr size_t MAX_TIMEFRAMES = 8;                     ///< Timeframes per engine
+    static constexpr int64_t WHEEL_RESOLUTION_NS = 1000000000LL;    ///< Timer wheel tick (timeframes are whole seconds)
+    static constexpr size_t WHEEL_SLOTS = 512;                      ///< Timer wheel slots (one revolution = 512 s)
+
+    using Sink = std::function<void(const OhlcvBar& bar, size_t timeframeIndex)>;
+
+private:
+    /**
+     * @brief Bar being built
+     */
+    struct OpenBar {
+        int64_t start = 0;      ///< Start time
+        int64_t end = 0;        ///< End time (timer deadline)
+        int64_t open = 0;       ///< First price
+        int64_t high = 0;       ///< Highest price
+        int64_t low = 0;        ///< Lowest price
+        int64_t close = 0;      ///< Last price
+        int64_t volume = 0;     ///< Traded size
+        uint32_t ticks = 0;     ///< Ticks so far (0 = no bar open)
+    };
+
+    std::vector<std::string> m_products;    ///< Product IDs by index
+    std::vector<int64_t> m_timeframes;      ///< Timeframe lengths in nanoseconds
+    std::vector<OpenBar> m_bars;            ///< [product * timeframes + timeframe]
+    TimerWheel m_wheel;                     ///< One timer per open bar, same index as m_bars
+    Sink m_sink;                            ///< Receives completed bars
+    uint64_t m_completed;                   ///< Bars completed
+
+    /**
+     * @brief Emit and reset an open bar
+     */
+    void closeBar(size_t index);
+
+public:
+    /**
+     * @brief Constructor
+     * @param products Product IDs (indices are used in onTick())
+     * @param timeframeSeconds Bar lengths in seconds (at most MAX_TIMEFRAMES used)
+     * @param sink Receives every completed bar
+     */
+    TimeBarEngine(const std::vector<std::string>& products,
+                  const std::vector<int64_t>& timeframeSeconds,
+                  Sink sink);
+
+    /**
+     * @brief Add a tick to every timeframe of a product
+     * @param product Product index
+     * @param price Tick price (fixed point)
+     * @param size Tick size (fixed point)
+     * @param timeNanos Tick time in nanoseconds since the epoch
+     */
+    void onTick(size_t product, int64_t price, int64_t size, int64_t timeNanos);
+
+    /**
+     * @brief Close every bar whose end has passed
+     * @param nowNanos Current time in nanoseconds since the epoch
+     */
+    void advance(int64_t nowNanos);
+
+    /**
+     * @brief Get the configured timeframes
+     * @return Timeframe lengths in seconds
+     */
+    std::vector<int64_t> getTimeframeSeconds() const;
+
+    /**
+     * @brief Get the number of completed bars
+     * @return Completed count
+     */
+    uint64_t getCompletedCount() const { return m_completed; }
+
+    /**
+     * @brief Format a timeframe for file names and output (e.g., "1s", "5m", "1h")
+     * @param seconds Timeframe in seconds
+     * @return Label
+     */
+    static std::string timeframeLabel(int64_t seconds);
+};
+
+#endif // TIMEBARS_H
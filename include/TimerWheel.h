@@ -0,0 +1,115 @@
+/**
+ * @file TimerWheel.h
+ * @brief Hashed timer wheel over a fixed pool of timers
+ *
+ * Timers are identified by index into a pool sized up front and linked
+ * into the slot of their deadline tick, so scheduling, cancelling and
+ * expiring never allocate. Deadlines further out than one revolution stay
+ * in their slot until the wheel comes round to them again.
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BranchPrediction.h"
+
+/**
+ * @brief Hashed timer wheel
+ *
+ * A timer fires from the first advance() whose tick is at or past its
+ * deadline tick. Single-threaded.
+ */
+class TimerWheel {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;    ///< Null timer / list end
+
+private:
+    /**
+     * @brief One pooled timer (doubly linked into its slot)
+     */
+    struct Node {
+        int64_t deadlineTick = 0;   ///< Deadline in wheel ticks
+        int64_t deadlineSlot = 0;   ///< Tick whose slot holds the timer (later than the deadline if scheduled late)
+        uint32_t prev = NONE;       ///< Previous timer in the slot
+        uint32_t next = NONE;       ///< Next timer in the slot
+        bool armed = false;         ///< Linked into a slot
+    };
+
+    std::vector<Node> m_nodes;      ///< Timer pool
+    std::vector<uint32_t> m_slots;  ///< Head timer of each slot
+    int64_t m_resolutionNanos;      ///< Nanoseconds per tick
+    size_t m_mask;                  ///< Slot count - 1
+    int64_t m_currentTick;          ///< Last tick processed
+    bool m_started;                 ///< advance() has been called
+
+    void link(uint32_t timer, size_t slot);
+    void unlink(uint32_t timer);
+
+public:
+    /**
+     * @brief Constructor
+     * @param timers Timers in the pool (indices 0..timers-1)
+     * @param resolutionNanos Tick length in nanoseconds
+     * @param slots Slots in the wheel (rounded up to a power of 2)
+     */
+    TimerWheel(size_t timers, int64_t resolutionNanos, size_t slots);
+
+    /**
+     * @brief Arm a timer, moving it if it is already armed
+     * @param timer Timer index
+     * @param deadlineNanos Expiry time in nanoseconds
+     */
+    void schedule(uint32_t timer, int64_t deadlineNanos);
+
+    /**
+     * @brief Disarm a timer (no-op if not armed)
+     * @param timer Timer index
+     */
+    void cancel(uint32_t timer);
+
+    /**
+     * @brief Check if a timer is armed
+     * @param timer Timer index
+     * @return True if armed
+     */
+    bool isArmed(uint32_t timer) const { return m_nodes[timer].armed; }
+
+    /**
+     * @brief Move the wheel to a time and fire every timer due by then
+     * @param nowNanos Current time in nanoseconds
+     * @param onExpire Called as onExpire(timer) for each expired timer (may reschedule it)
+     */
+    template<typename Fn>
+    void advance(int64_t nowNanos, Fn&& onExpire) {
+        const int64_t nowTick = nowNanos / m_resolutionNanos;
+        if (UNLIKELY(!m_started)) {
+            // First call: look at every slot once
+            m_currentTick = nowTick - static_cast<int64_t>(m_slots.size());
+            m_started = true;
+        }
+        // Same tick as last time is the common case
+        if (LIKELY(nowTick <= m_currentTick)) {
+            return;
+        }
+        // One revolution visits every slot, so larger jumps need no more steps
+        const int64_t steps = std::min<int64_t>(nowTick - m_currentTick, static_cast<int64_t>(m_slots.size()));
+        for (int64_t i = 1; i <= steps; ++i) {
+            uint32_t timer = m_slots[static_cast<size_t>(m_currentTick + i) & m_mask];
+            while (timer != NONE) {
+                const uint32_t next = m_nodes[timer].next;
+                if (m_nodes[timer].deadlineTick <= nowTick) {
+                    unlink(timer);
+                    onExpire(timer);
+                }
+                timer = next;
+            }
+        }
+        m_currentTick = nowTick;
+    }
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,207 @@
+/**
+ * @file TraceRing.h
+ * @brief Always-on per-thread binary event rings for post-mortem tracing
+ *
+ * Every thread that records gets its own fixed-size ring of 32-byte records
+ * (TSC, event id, two payload words). Recording is a few plain stores and
+ * one release store of the ring head: no locks, no allocation after the
+ * thread's first event, no shared cache lines. The rings keep the last
+ * CAPACITY events per thread, so after a latency spike the events around it
+ * are still there. A dump (on SIGUSR1 or a latency threshold breach) copies
+ * every ring to a binary file, which convertToChromeTrace() turns into JSON
+ * for chrome://tracing or Perfetto.
+ */
+
+#ifndef TRACERING_H
+#define TRACERING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LockFreeRingBuffer.h"
+#include "HighResTimer.h"
+#include "BranchPrediction.h"
+
+/**
+ * @brief Traced pipeline points (payload words in parentheses)
+ */
+enum class TraceEvent : uint32_t {
+    Receive = 1,        ///< Frame received from the socket (line, frame bytes)
+    Parse,              ///< Ticker parsed (sequence, line)
+    Enqueue,            ///< Ticker pushed to the processing queue (sequence, line)
+    Dequeue,            ///< Ticker popped by the processing thread (sequence, line)
+    Process,            ///< Ticker processed (sequence, receive->processed ns)
+    LogWrite,           ///< Ticker written to the CSV (sequence, processed->written ns)
+    BookApply,          ///< Book chunk applied (product index, changes)
+    Connect,            ///< A feed line connected (lines up, 0)
+    Disconnect,         ///< A feed line dropped (lines up, 0)
+    LatencyBreach,      ///< Receive->processed over the threshold (sequence, ns)
+    Count               ///< Number of event ids + 1
+};
+
+/**
+ * @brief One traced event (two per cache line)
+ */
+struct TraceRecord {
+    uint64_t tsc;       ///< TSC cycles (HighResTimer::nowCycles() base)
+    uint32_t event;     ///< TraceEvent
+    uint32_t reserved;  ///< Padding (0)
+    uint64_t a;         ///< First payload word
+    uint64_t b;         ///< Second payload word
+};
+
+/**
+ * @brief Fixed-size event ring written by one thread
+ */
+class ALIGN_CACHE_LINE TraceRing {
+public:
+    static constexpr size_t CAPACITY = 16384;  ///< Records kept (power of 2)
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of 2");
+
+private:
+    std::array<TraceRecord, CAPACITY> m_records;    ///< Record storage
+    ALIGN_CACHE_LINE std::atomic<uint64_t> m_head;  ///< Records ever written (owning thread writes)
+    std::string m_name;                             ///< Thread name at registration
+
+public:
+    /**
+     * @brief Constructor
+     * @param name Thread name shown in the trace
+     */
+    explicit TraceRing(const std::string& name);
+
+    /**
+     * @brief Record an event at a given time (owning thread only; hot path)
+     */
+    inline void record(TraceEvent event, uint64_t tsc, uint64_t a, uint64_t b) noexcept {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        TraceRecord& slot = m_records[head & (CAPACITY - 1)];
+        slot.tsc = tsc;
+        slot.event = static_cast<uint32_t>(event);
+        slot.reserved = 0;
+        slot.a = a;
+        slot.b = b;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy the records still in the ring, oldest first (any thread)
+     *
+     * Records the writer may have overwritten during the copy are left out, so a
+     * wrapped ring yields at most CAPACITY - 1 records.
+     * @param out Receives the records
+     */
+    void copy(std::vector<TraceRecord>& out) const;
+
+    /**
+     * @brief Get the thread name
+     * @return Name
+     */
+    const std::string& getName() const { return m_name; }
+};
+
+/**
+ * @brief Process-wide access to the per-thread rings, dumps and conversion
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Record an event now in the calling thread's ring
+     * @param event Event id
+     * @param a First payload word
+     * @param b Second payload word
+     */
+    static inline void record(TraceEvent event, uint64_t a = 0, uint64_t b = 0) noexcept {
+        local().record(event, HighResTimer::nowCycles(), a, b);
+    }
+
+    /**
+     * @brief Record an event with a TSC stamp taken earlier
+     */
+    static inline void recordAt(TraceEvent event, uint64_t tsc, uint64_t a = 0, uint64_t b = 0) noexcept {
+        local().record(event, tsc, a, b);
+    }
+
+    /**
+     * @brief Get the calling thread's ring, creating it on the first call
+     *
+     * Threads that record on the hot path call attachThread() at startup, so
+     * the allocation never lands on their first event.
+     * @return Ring (never freed, so it can be dumped after the thread exits)
+     */
+    static TraceRing& local() noexcept {
+        // One TLS load after the first event
+        TraceRing*& ring = localSlot();
+        if (UNLIKELY(ring == nullptr)) {
+            ring = createLocal(std::string());
+        }
+        return *ring;
+    }
+
+    /**
+     * @brief Create the calling thread's ring now (thread startup, off the hot path)
+     *
+     * Allocates and touches the ring and registers it for dumps. A thread that
+     * already has a ring keeps it.
+     * @param name Thread name shown in dumps (empty = the OS thread name)
+     * @return The thread's ring
+     */
+    static TraceRing& attachThread(const std::string& name);
+
+    /**
+     * @brief Ask for a dump (async-signal-safe)
+     */
+    static void requestDump() noexcept;
+
+    /**
+     * @brief Check for a pending dump request, at most once per minimum interval
+     * @return True if a dump should be written now (the request is consumed)
+     */
+    static bool takeDumpRequest();
+
+    /**
+     * @brief Write every ring to <prefix>_<n>.trace
+     * @param prefix File path prefix
+     * @return Path written (empty on failure)
+     */
+    static std::string dump(const std::string& prefix);
+
+    /**
+     * @brief Write every ring to a file
+     * @param filename Output file
+     * @return True on success
+     */
+    static bool dumpTo(const std::string& filename);
+
+    /**
+     * @brief Convert a dump to the Chrome trace event format (chrome://tracing, Perfetto)
+     * @param input Dump written by dump()
+     * @param output JSON file to write
+     * @return True on success
+     */
+    static bool convertToChromeTrace(const std::string& input, const std::string& output);
+
+    /**
+     * @brief Get the printable name of an event
+     * @param event Event id
+     * @return Name
+     */
+    static const char* eventName(uint32_t event) noexcept;
+
+private:
+    static TraceRing* createLocal(const std::string& name);
+
+    static TraceRing*& localSlot() noexcept {
+        static thread_local TraceRing* ring = nullptr;
+        return ring;
+    }
+
+    static std::atomic<bool> s_dumpRequested;   // Set by requestDump()
+    static int64_t s_lastDumpNanos;             // Time of the last dump (dumping thread only)
+    static uint64_t s_dumpCount;                // Dumps written (dumping thread only)
+};
+
+#endif // TRACERING_H
@@ -0,0 +1,93 @@
+/**
+ * @file TradeBars.h
+ * @brief Volume and dollar bars built from trades
+ *
+ * A bar closes once its traded volume (volume bars) or notional (dollar
+ * bars) reaches the threshold, so bars sample the market by activity
+ * rather than by clock time. The trade that crosses the threshold closes
+ * the bar and is not split across bars.
+ */
+
+#ifndef TRADEBARS_H
+#define TRADEBARS_H
+
+#include <string>
+#include <cstdint>
+#include "TradeData.h"
+
+/**
+ * @brief What closes a bar
+ */
+enum class BarType : uint8_t {
+    Volume,     ///< Traded size reaches the threshold
+    Dollar      ///< Traded notional reaches the threshold
+};
+
+/**
+ * @brief One completed bar
+ */
+struct TradeBar {
+    std::string product_id;     ///< Trading pair
+    BarType type = BarType::Volume; ///< Bar type
+    int64_t open = 0;           ///< First trade price (fixed point)
+    int64_t high = 0;           ///< Highest trade price (fixed point)
+    int64_t low = 0;            ///< Lowest trade price (fixed point)
+    int64_t close = 0;          ///< Last trade price (fixed point)
+    int64_t volume = 0;         ///< Traded size (fixed point)
+    double notional = 0.0;      ///< Traded notional
+    uint32_t trades = 0;        ///< Trades in the bar
+    int64_t start_time_ns = 0;  ///< Time of the first trade
+    int64_t end_time_ns = 0;    ///< Time of the last trade
+
+    /**
+     * @brief Get the CSV header line matching toCSV()
+     * @return Column names
+     */
+    static const char* csvHeader();
+
+    /**
+     * @brief Convert to CSV string for logging
+     * @return CSV formatted string
+     */
+    std::string toCSV() const;
+};
+
+/**
+ * @brief Accumulates trades of one product into bars of one type
+ */
+class BarBuilder {
+private:
+    BarType m_type;         ///< Bar type
+    double m_threshold;     ///< Volume or notional that closes a bar (0 = off)
+    TradeBar m_current;     ///< Bar being built (trades == 0 if none)
+
+public:
+    /**
+     * @brief Constructor
+     * @param type Bar type
+     * @param threshold Volume (base units) or notional (quote units) per bar, 0 = off
+     */
+    explicit BarBuilder(BarType type = BarType::Volume, double threshold = 0.0);
+
+    /**
+     * @brief Change the threshold (discards the bar being built)
+     * @param threshold Volume or notional per bar, 0 = off
+     */
+    void setThreshold(double threshold);
+
+    /**
+     * @brief Check if bars are being built
+     * @return True if the threshold is set
+     */
+    bool isEnabled() const { return m_threshold > 0.0; }
+
+    /**
+     * @brief Add a trade
+     * @param trade Trade to add
+     * @param completed Output bar when this trade closed one
+     * @return True if a bar was completed
+     */
+    bool add(const TradeData& trade, TradeBar& completed);
+};
+
+#endif // TRADEBARS_H
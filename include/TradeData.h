@@ -0,0 +1,30 @@
+/**
+ * @file TradeData.h
+ * @brief Trade (match) data from the Coinbase matches channel
+ */
+
+#ifndef TRADEDATA_H
+#define TRADEDATA_H
+
+#include <string>
+#include <cstdint>
+#include "OrderBook.h"
+
+/**
+ * @brief One executed trade from a "match" / "last_match" message
+ *
+ * Price and size are fixed point (OrderBook::SCALE), parsed straight from
+ * the feed's decimal strings.
+ */
+struct TradeData {
+    std::string product_id;             ///< Trading pair (e.g., "BTC-USD")
+    uint64_t trade_id = 0;              ///< Exchange trade ID
+    uint64_t sequence_number = 0;       ///< Product sequence number (0 if absent)
+    int64_t price = 0;                  ///< Trade price (fixed point)
+    int64_t size = 0;                   ///< Trade size (fixed point)
+    BookSide maker_side = BookSide::Bid; ///< Side of the resting order ("sell" = buyer-initiated trade)
+    int64_t exchange_time_ns = 0;       ///< Exchange "time" field in nanoseconds since the epoch (0 if unparsed)
+    uint64_t receive_tsc = 0;           ///< TSC stamp of the frame
+};
+
+#endif // TRADEDATA_H
@@ -14,6 +14,10 @@
 #include <atomic>
 #include <mutex>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "MessageAssembler.h"
 
 /**
  * @class WebSocketClient
@@ -21,10 +25,18 @@
  * 
  * This class provides a reliable WebSocket client for connecting to
  * Coinbase's WebSocket feed and handling real-time ticker data.
+ * 
+ * A dropped connection is re-established from the I/O thread with
+ * exponential backoff, and every subscription sent so far is replayed
+ * once the new connection is up. Each established connection gets a new
+ * epoch number so consumers can tell which messages span a reconnect.
  */
 class WebSocketClient {
 public:
-    using MessageCallback = std::function<void(const std::string&)>;
+    /// Message handler: frame payload and TSC cycles taken at socket receive
+    using MessageCallback = std::function<void(const std::string&, uint64_t)>;
+    /// Connection state handler: true when established, false when an established connection drops
+    using ConnectionCallback = std::function<void(bool)>;
 
     /**
      * @brief Constructor
@@ -42,10 +54,53 @@ public:
      */
     void setMessageCallback(MessageCallback callback);
 
+    /**
+     * @brief Set connection state callback function
+     * @param callback Function to call (on the I/O thread) when the connection goes up or down
+     */
+    void setConnectionCallback(ConnectionCallback callback);
+
+    /**
+     * @brief Bind outgoing connections to a local interface
+     * @param iface Interface name or local IP address (empty = any, routing decides)
+     * @note Must be called before connect()
+     */
+    void setInterface(const std::string& iface);
+
+    /**
+     * @brief Set the name and CPU of the I/O thread
+     * @param threadName Thread name (max 15 characters on Linux)
+     * @param cpuCore CPU core to bind to (-1 for automatic selection)
+     * @note Must be called before connect()
+     */
+    void setIoThread(const std::string& threadName, int cpuCore);
+
+    /**
+     * @brief Accept self-signed / hostname-mismatched server certificates
+     * @param allow True to skip certificate verification (local test servers only)
+     * @note Must be called before connect()
+     */
+    void setAllowSelfSigned(bool allow);
+
+    /**
+     * @brief Set the reconnect backoff bounds
+     * @param initialMillis Delay before the second attempt (the first retry is immediate)
+     * @param maxMillis Upper bound of the exponentially growing delay
+     */
+    void setReconnectBackoff(int64_t initialMillis, int64_t maxMillis);
+
+    /**
+     * @brief Force a reconnect when nothing is received for a while
+     * @param millis Silence that marks the connection as dead (0 = disabled)
+     * @note Catches half-open TCP connections that never report a close
+     */
+    void setStaleTimeout(int64_t millis);
+
     /**
      * @brief Connect to WebSocket server
-     * @param uri WebSocket URI (e.g., "wss://ws-feed.exchange.coinbase.com")
+     * @param uri WebSocket URI (e.g., "wss://ws-feed.exchange.coinbase.com" or "ws://localhost:8080")
      * @return true if connection successful, false otherwise
+     * @note Waits up to CONNECT_TIMEOUT_MILLIS for the first connection
      */
     bool connect(const std::string& uri);
 
@@ -77,24 +132,101 @@ public:
      * @brief Subscribe to ticker channel
      * @param productId Product ID to subscribe to (e.g., "BTC-USD")
      * @return true if subscription successful, false otherwise
+     * @note The subscription is remembered and replayed after every reconnect
      */
     bool subscribeToTicker(const std::string& productId);
 
+    /**
+     * @brief Subscribe to channels for several products
+     * @param productIds Product IDs to subscribe to
+     * @param channels Channel names (e.g., "ticker", "level2_batch")
+     * @return true if subscription successful, false otherwise
+     * @note The subscription is remembered and replayed after every reconnect
+     */
+    bool subscribe(const std::vector<std::string>& productIds, const std::vector<std::string>& channels);
+
+    /**
+     * @brief Get the current connection epoch
+     * @return Number of connections established so far (0 = never connected)
+     */
+    uint64_t getConnectionEpoch() const;
+
+    /**
+     * @brief Get the number of successful reconnects
+     * @return Reconnect count
+     */
+    uint64_t getReconnectCount() const;
+
+    /**
+     * @brief Get the TSC stamp of the most recent disconnect
+     * @return HighResTimer::nowCycles() at the last disconnect (0 if none)
+     */
+    uint64_t getLastDisconnectTsc() const;
+
+    /**
+     * @brief Get the disconnect-to-established time of the last reconnect
+     * @return Nanoseconds (0 if never reconnected)
+     */
+    int64_t getLastReconnectNanos() const;
+
+    /**
+     * @brief Get the worst disconnect-to-established time
+     * @return Nanoseconds (0 if never reconnected)
+     */
+    int64_t getMaxReconnectNanos() const;
+
     /**
      * @brief Static callback for libwebsockets
      */
     static int callback(struct lws* wsi, enum lws_callback_reasons reason,
                        void* user, void* in, size_t len);
 
+    static constexpr int64_t CONNECT_TIMEOUT_MILLIS = 5000;  ///< Wait for the first connection
+    static constexpr int64_t DEFAULT_BACKOFF_MILLIS = 100;   ///< Initial reconnect delay
+    static constexpr int64_t DEFAULT_MAX_BACKOFF_MILLIS = 5000; ///< Reconnect delay cap
+
 private:
     struct lws_context* m_context;
-    struct lws* m_wsi;
+    struct lws* m_wsi;                          ///< Current connection (I/O thread only once started)
     std::thread m_ioThread;
     std::atomic<bool> m_connected;
     std::atomic<bool> m_running;
+    bool m_allowSelfSigned;
     MessageCallback m_messageCallback;
-    std::mutex m_sendMutex;
-    std::string m_pendingMessage;
+    ConnectionCallback m_connectionCallback;
+    std::string m_interface;                    ///< Local interface to bind (empty = any)
+    std::string m_ioThreadName;                 ///< I/O thread name
+    int m_ioCpuCore;                            ///< I/O thread CPU (-1 = automatic)
+    
+    // Target, kept for reconnecting
+    std::string m_host;                         ///< Server host name
+    std::string m_path;                         ///< Request path
+    int m_port;                                 ///< Server port
+    bool m_useSsl;                              ///< wss:// endpoint
+    
+    // Outgoing messages (any thread -> I/O thread)
+    std::mutex m_sendMutex;                     ///< Guards the members below
+    std::deque<std::string> m_pendingMessages;  ///< Messages waiting for a writeable socket
+    std::vector<std::string> m_subscriptions;   ///< Replayed after every reconnect
+    std::atomic<bool> m_writeRequested;         ///< Pending messages were queued
+    
+    MessageAssembler m_assembler;               ///< Joins received chunks into messages (I/O thread only)
+    
+    // Reconnect state (I/O thread only)
+    int64_t m_backoffMillis;                    ///< Initial reconnect delay
+    int64_t m_maxBackoffMillis;                 ///< Reconnect delay cap
+    int64_t m_staleTimeoutMillis;               ///< Silence before forcing a reconnect (0 = off)
+    uint32_t m_failedAttempts;                  ///< Consecutive failed connection attempts
+    int64_t m_nextAttemptNanos;                 ///< When to try again (0 = no attempt scheduled)
+    uint64_t m_lastReceiveTsc;                  ///< Last frame received on this connection
+    bool m_closeRequested;                      ///< Drop the current connection at the next callback
+    
+    // Connection statistics
+    std::atomic<uint64_t> m_connectionEpoch;    ///< Connections established so far
+    std::atomic<uint64_t> m_reconnects;         ///< Successful reconnects
+    std::atomic<uint64_t> m_lastDisconnectTsc;  ///< TSC stamp of the last disconnect
+    std::atomic<int64_t> m_lastReconnectNanos;  ///< Disconnect-to-established of the last reconnect
+    std::atomic<int64_t> m_maxReconnectNanos;   ///< Worst disconnect-to-established time
 
     /**
      * @brief I/O thread function
@@ -102,9 +234,26 @@ private:
     void runIO();
 
     /**
-     * @brief Get instance from user data
+     * @brief Start a connection attempt to the stored target
+     * @return true if the attempt was started
+     */
+    bool openConnection();
+
+    /**
+     * @brief Handle a closed or failed connection and schedule the next attempt
+     * @param wasConnected True if the connection had been established
+     */
+    void scheduleReconnect(bool wasConnected);
+
+    /**
+     * @brief Mark a freshly established connection up and queue the stored subscriptions on it
+     */
+    void replaySubscriptions();
+
+    /**
+     * @brief Get the client owning a connection (stored as the context user)
      */
-    static WebSocketClient* getInstance(void* user);
+    static WebSocketClient* getInstance(struct lws* wsi);
 };
 
 #endif // WEBSOCKETCLIENT_H
\ No newline at end of file
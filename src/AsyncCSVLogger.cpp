@@ -6,6 +6,9 @@
 #include "AsyncCSVLogger.h"
 #include "ThreadUtils.h"
 #include "BranchPrediction.h"
+#include "TraceRing.h"
+#include "MemoryLock.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -59,6 +62,9 @@ AsyncCSVLogger::AsyncCSVLogger(const std::string& filename,
         return;
     }
     
+    // Fault in the queue before its consumer starts (the queue slots' strings keep their capacity)
+    NUMAUtils::touchMemory(&m_logQueue, sizeof(m_logQueue));
+    
     // Start logging thread
     m_running.store(true);
     m_logThread = std::thread(&AsyncCSVLogger::logThreadFunction, this);
@@ -94,7 +100,10 @@ void AsyncCSVLogger::writeHeaders() {
     
     m_file << "type,sequence,product_id,price,open_24h,volume_24h,low_24h,high_24h,"
            << "volume_30d,best_bid,best_ask,side,time,trade_id,last_size,"
-           << "price_ema,mid_price_ema,mid_price,timestamp_us" << std::endl;
+           << "price_ema,mid_price_ema,mid_price,price_zscore,price_volatility,timestamp_us,"
+           << "recv_to_parse_ns,parse_to_dequeue_ns,dequeue_to_ema_ns,ema_to_write_ns,recv_to_write_ns,"
+           << "recv_wall_ns,exchange_to_recv_ns"
+           << std::endl;
     
     m_file.flush();
 }
@@ -127,6 +136,13 @@ void AsyncCSVLogger::logThreadFunction() {
         NUMAUtils::setMemoryPolicy(m_logThreadNumaNode);
     }
     
+    #ifdef __linux__
+    // Ring and pre-faulted pages come from the logger's node, not the first write's
+    TraceRecorder::attachThread("AsyncCSVLogger");
+    MemoryLock::prefaultStack(MemoryLock::STACK_PREFAULT_BYTES);
+    MemoryLock::prefaultHeap(MemoryLock::THREAD_HEAP_PREFAULT_BYTES);
+    #endif
+    
     m_ready.store(true);
     
     // Pre-allocate string buffer to avoid allocations in hot path
@@ -139,6 +155,7 @@ void AsyncCSVLogger::logThreadFunction() {
     while (LIKELY(m_running.load())) {
         TickerData data;
         bool hadData = false;
+        LatencyHistogram* writeLatency = m_writeLatency.load(std::memory_order_acquire);
         
         // Process all available data (batch processing for efficiency)
         // Likely to have data when actively logging
@@ -153,9 +170,21 @@ void AsyncCSVLogger::logThreadFunction() {
             }
             
             // Format and write data
+            data.stamps.written_tsc = HighResTimer::nowCycles();
             csvLine = formatToCSV(data);
             m_file << csvLine << '\n'; // Use '\n' instead of std::endl for performance
             
+            // Record processing->write latency if tracking is enabled
+            if (LIKELY(data.stamps.processed_tsc != 0)) {
+                const int64_t writeNanos = HighResTimer::cyclesToNanos(
+                    HighResTimer::nowCycles() - data.stamps.processed_tsc);
+                if (writeLatency) {
+                    writeLatency->recordSigned(writeNanos);
+                }
+                TraceRecorder::recordAt(TraceEvent::LogWrite, data.stamps.written_tsc, data.sequence_number,
+                                        static_cast<uint64_t>(std::max<int64_t>(writeNanos, 0)));
+            }
+            
             hadData = true;
         }
         
@@ -184,6 +213,7 @@ void AsyncCSVLogger::logThreadFunction() {
             if (UNLIKELY(!m_headersWritten.load())) {
                 writeHeaders();
             }
+            data.stamps.written_tsc = HighResTimer::nowCycles();
             csvLine = formatToCSV(data);
             m_file << csvLine << '\n';
         }
@@ -231,8 +261,36 @@ std::string AsyncCSVLogger::formatToCSV(const TickerData& data) const {
         << data.price_ema << ","
         << data.mid_price_ema << ","
         << data.mid_price << ","
+        << data.price_zscore << ","
+        << data.price_volatility << ","
         << HighResTimer::nowMicros(); // Add microsecond timestamp
     
+    // Per-hop pipeline latency (empty when either stamp is missing)
+    auto hop = [&oss](uint64_t fromTsc, uint64_t toTsc) {
+        oss << ',';
+        if (LIKELY(fromTsc != 0 && toTsc != 0)) {
+            oss << HighResTimer::cyclesToNanos(toTsc - fromTsc);
+        }
+    };
+    const PipelineStamps& stamps = data.stamps;
+    hop(stamps.receive_tsc, stamps.parsed_tsc);
+    hop(stamps.parsed_tsc, stamps.dequeued_tsc);
+    hop(stamps.dequeued_tsc, stamps.processed_tsc);
+    hop(stamps.processed_tsc, stamps.written_tsc);
+    hop(stamps.receive_tsc, stamps.written_tsc);
+    
+    // Receive time on the wall clock, comparable across hosts and with the exchange time
+    oss << ',';
+    if (LIKELY(stamps.receive_tsc != 0)) {
+        const int64_t receiveWallNanos = HighResTimer::cyclesToWallNanos(stamps.receive_tsc);
+        oss << receiveWallNanos << ',';
+        if (LIKELY(data.exchange_time_ns != 0)) {
+            oss << (receiveWallNanos - data.exchange_time_ns);
+        }
+    } else {
+        oss << ',';
+    }
+    
     return oss.str();
 }
 
@@ -259,6 +317,10 @@ bool AsyncCSVLogger::logTickerDataWithTimestamp(const TickerData& data, int64_t
     return logTickerData(data);
 }
 
+void AsyncCSVLogger::setWriteLatencyHistogram(LatencyHistogram* histogram) {
+    m_writeLatency.store(histogram, std::memory_order_release);
+}
+
 bool AsyncCSVLogger::isReady() const {
     return m_ready.load() && m_file.is_open();
 }
@@ -0,0 +1,81 @@
+/**
+ * @file BookSignals.cpp
+ * @brief Implementation of incremental book signals
+ */
+
+#include "BookSignals.h"
+#include <algorithm>
+#include "BranchPrediction.h"
+
+BookSignals::BookSignals(size_t topLevels)
+    : m_topLevels(std::max<size_t>(topLevels, 1)) {
+}
+
+void BookSignals::onApply(const OrderBook& book, BookSide side, int64_t price,
+                          int64_t previousSize, int64_t size, int distance) {
+    // Most changes land outside the top N and leave the sums alone
+    if (distance < 0 || static_cast<size_t>(distance) >= m_topLevels) {
+        return;
+    }
+
+    const size_t depth = book.depth(side);
+    if (LIKELY(previousSize != 0 && size != 0)) {
+        // Size change in place
+        adjust(side, price, size - previousSize, 1);
+    } else if (size != 0) {
+        // New level inside the top N pushes the Nth level out
+        adjust(side, price, size, 1);
+        if (depth > m_topLevels) {
+            const BookLevel& out = book.level(side, m_topLevels);
+            adjust(side, out.price, out.size, -1);
+        }
+    } else {
+        // Removed level: the first level beyond the top N moves in
+        adjust(side, price, previousSize, -1);
+        if (depth >= m_topLevels) {
+            const BookLevel& in = book.level(side, m_topLevels - 1);
+            adjust(side, in.price, in.size, 1);
+        }
+    }
+}
+
+void BookSignals::rebuild(const OrderBook& book) {
+    for (BookSide side : {BookSide::Bid, BookSide::Ask}) {
+        m_sums[static_cast<size_t>(side)] = SideSums{};
+        const size_t levels = std::min(m_topLevels, book.depth(side));
+        for (size_t i = 0; i < levels; ++i) {
+            const BookLevel& level = book.level(side, i);
+            adjust(side, level.price, level.size, 1);
+        }
+    }
+}
+
+BookSignalValues BookSignals::compute(const OrderBook& book) const {
+    BookSignalValues values;
+    // One-sided books only occur during startup or in very thin markets (unlikely)
+    if (UNLIKELY(!book.hasBid() || !book.hasAsk())) {
+        return values;
+    }
+
+    const double bidPrice = OrderBook::toDouble(book.bestBid().price);
+    const double askPrice = OrderBook::toDouble(book.bestAsk().price);
+    const double bidSize = OrderBook::toDouble(book.bestBid().size);
+    const double askSize = OrderBook::toDouble(book.bestAsk().size);
+    const double mid = (bidPrice + askPrice) / 2.0;
+
+    // Leans towards the side with less size, where the next trade is likelier to move the price
+    values.microprice = (bidPrice * askSize + askPrice * bidSize) / (bidSize + askSize);
+    values.spread_bps = (askPrice - bidPrice) / mid * 10000.0;
+
+    const SideSums& bids = m_sums[static_cast<size_t>(BookSide::Bid)];
+    const SideSums& asks = m_sums[static_cast<size_t>(BookSide::Ask)];
+    values.imbalance = static_cast<double>(bids.size - asks.size) / static_cast<double>(bids.size + asks.size);
+
+    // notional / size is a fixed-point price; divide in double to keep the sub-unit part
+    const double bidWeighted = static_cast<double>(bids.notional) / bids.size / OrderBook::SCALE;
+    const double askWeighted = static_cast<double>(asks.notional) / asks.size / OrderBook::SCALE;
+    values.depth_weighted_mid = (bidWeighted + askWeighted) / 2.0;
+
+    values.valid = true;
+    return values;
+}
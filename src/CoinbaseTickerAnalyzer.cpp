@@ -7,6 +7,9 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
 #include "ThreadUtils.h"
 #include "HighResTimer.h"
 #include "BranchPrediction.h"
@@ -14,12 +17,63 @@
 #include "NUMAUtils.h"
 #endif
 
+namespace {
+    const char* const COINBASE_FEED_URI = "wss://ws-feed.exchange.coinbase.com";
+    
+    /**
+     * @brief Split a comma-separated list, skipping empty entries
+     */
+    std::vector<std::string> splitList(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+    
+    /**
+     * @brief Join a list with commas
+     */
+    std::string joinList(const std::vector<std::string>& items) {
+        std::string list;
+        for (const auto& item : items) {
+            list += (list.empty() ? "" : ",") + item;
+        }
+        return list;
+    }
+}
+
 CoinbaseTickerAnalyzer::CoinbaseTickerAnalyzer(const std::string& productId, 
                                              const std::string& csvFilename)
     : m_running(false)
     , m_processingEnabled(false)
-    , m_productId(productId)
-    , m_csvFilename(csvFilename) {
+    , m_lastEpoch(0)
+    , m_productIds(splitList(productId))
+    , m_channels{"ticker"}
+    , m_csvFilename(csvFilename)
+    , m_endpoint(COINBASE_FEED_URI)
+    , m_allowSelfSigned(false)
+    , m_replaySpeed(0.0)
+    , m_replayMode(false)
+    , m_staleTimeoutMillis(0)
+    , m_lineCount(1)
+    , m_vwapWindowSeconds{60, 300, 900}
+    , m_volumeBarSize(10.0)
+    , m_dollarBarSize(1000000.0)
+    , m_timeBarSeconds{1, 60, 300}
+    , m_statsWindowSeconds(60)
+    , m_indicatorSpec("macd(12,26,9),rsi(14),bb(20,2),atr(14)")
+    , m_correlationBucketMillis(1000)
+    , m_correlationWindow(300)
+    , m_metricsPort(0)
+    , m_monitorIntervalMillis(1000)
+    , m_traceThresholdNanos(0)
+    , m_irqPlan(false)
+    , m_lockMemory(true) {
 }
 
 CoinbaseTickerAnalyzer::~CoinbaseTickerAnalyzer() {
@@ -33,19 +87,160 @@ bool CoinbaseTickerAnalyzer::initializeComponents() {
         NUMAUtils::initialize();
         #endif
         
-        // Initialize WebSocket client
-        m_websocketClient = std::make_unique<WebSocketClient>();
-        m_websocketClient->setMessageCallback([this](const std::string& message) {
-            handleWebSocketMessage(message);
-        });
+        // Lines from a previous run are idle (their threads were joined in cleanupComponents)
+        m_lines.clear();
+        m_arbiter.reset();
+        m_tradeArbiter.reset();
+        
+        #ifdef __linux__
+        // Place every pipeline thread from the machine topology; I/O threads follow their NIC
+        std::vector<NicReport> nics;
+        std::vector<int> lineNodes;
+        for (size_t i = 0; i < (m_replayMode ? 1 : m_lineCount); ++i) {
+            if (!m_replayMode) {
+                nics.push_back(NicLocality::inspect(i < m_lineInterfaces.size() ? m_lineInterfaces[i] : std::string()));
+            }
+            lineNodes.push_back(m_replayMode ? -1 : nics.back().numaNode);
+        }
+        const CpuTopology topology = ThreadPlacement::readTopology();
+        m_placement = ThreadPlacement::plan(topology, lineNodes, m_replayMode ? "FeedReplay" : "WebSocketIO");
+        std::cout << m_placement.format();
         
-        // Initialize EMA calculator
-        m_emaCalculator = std::make_unique<EMACalculator>(5); // 5-second interval
+        // NIC interrupts against the I/O threads (each interface reported once, every line checked)
+        for (size_t i = 0; i < nics.size(); ++i) {
+            const bool firstUse = std::none_of(nics.begin(), nics.begin() + static_cast<std::ptrdiff_t>(i),
+                [&](const NicReport& other) { return other.interface == nics[i].interface; });
+            if (firstUse) {
+                std::cout << nics[i].format();
+                if (m_irqPlan) {
+                    std::cout << NicLocality::recommendAffinity(nics[i], m_placement, topology);
+                }
+            }
+            for (const std::string& warning : NicLocality::checkPlacement(nics[i], m_placement.feedIo[i], topology)) {
+                std::cerr << "Warning: " << warning << std::endl;
+            }
+        }
         
+        if (m_replayMode) {
+            // Replay mode: the capture file stands in for the WebSocket (single line)
+            m_lines.push_back(std::make_unique<FeedLine>());
+            m_feedReplayer = std::make_unique<FeedReplayer>(m_replayFilename, m_replaySpeed);
+            if (!m_feedReplayer->open()) {
+                std::cerr << "Failed to open replay file" << std::endl;
+                return false;
+            }
+        } else {
+            if (!m_captureFilename.empty()) {
+                m_feedCapture = std::make_unique<FeedCapture>(m_captureFilename);
+                if (!m_feedCapture->isReady()) {
+                    std::cerr << "Failed to initialize feed capture" << std::endl;
+                    return false;
+                }
+            }
+        #endif
+            // One WebSocket client per line, each with its own I/O thread and queue
+            for (size_t i = 0; i < m_lineCount; ++i) {
+                auto line = std::make_unique<FeedLine>();
+                line->client = std::make_unique<WebSocketClient>();
+                line->client->setAllowSelfSigned(m_allowSelfSigned);
+                line->client->setStaleTimeout(m_staleTimeoutMillis);
+                if (i < m_lineInterfaces.size()) {
+                    line->client->setInterface(m_lineInterfaces[i]);
+                }
+                #ifdef __linux__
+                line->client->setIoThread(m_placement.feedIo[i].thread, m_placement.feedIo[i].cpu);
+                #endif
+                line->client->setConnectionCallback([this](bool connected) {
+                    onLineConnectionChange(connected);
+                });
+                line->client->setMessageCallback([this, i](const std::string& message, uint64_t receiveTsc) {
+                    #ifdef __linux__
+                    // Record before parsing so the capture holds every frame, not just tickers
+                    // (primary line only, so a capture replays like a single connection)
+                    if (m_feedCapture && i == 0) {
+                        m_feedCapture->record(message, receiveTsc);
+                    }
+                    #endif
+                    handleWebSocketMessage(message, receiveTsc, i);
+                });
+                m_lines.push_back(std::move(line));
+            }
+            if (m_lineCount > 1) {
+                m_arbiter = std::make_unique<FeedArbiter>(m_lineCount);
+                m_tradeArbiter = std::make_unique<FeedArbiter>(m_lineCount);
+            }
         #ifdef __linux__
-        // Initialize async CSV logger with NUMA awareness
-        // Auto-select CPU and NUMA node for logging thread
-        m_csvLogger = std::make_unique<AsyncCSVLogger>(m_csvFilename, -1, -1);
+        }
+        #endif
+        
+        // One context (EMAs, book) per product, looked up by index on the hot path
+        m_products.clear();
+        std::vector<int64_t> vwapWindowNanos;
+        for (int64_t seconds : m_vwapWindowSeconds) {
+            vwapWindowNanos.push_back(seconds * 1000000000LL);
+        }
+        for (const auto& productId : m_productIds) {
+            auto context = std::make_unique<ProductContext>();
+            context->productId = productId;
+            context->priceStats.setWindow(m_statsWindowSeconds * 1000000000LL);
+            context->returnStats.setWindow(m_statsWindowSeconds * 1000000000LL);
+            if (!context->indicators.configure(m_indicatorSpec)) {
+                std::cerr << "Failed to configure indicators: " << m_indicatorSpec << std::endl;
+                return false;
+            }
+            context->vwap.setWindows(vwapWindowNanos);
+            context->volumeBars.setThreshold(m_volumeBarSize);
+            context->dollarBars.setThreshold(m_dollarBarSize);
+            m_products.push_back(std::move(context));
+        }
+        
+        // Correlations only mean something across products; returns are bucketed by exchange time
+        m_returnSync.reset();
+        m_covariance.reset();
+        if (m_productIds.size() > 1 && m_correlationBucketMillis > 0) {
+            if (m_productIds.size() > CorrelationSnapshot::MAX_PRODUCTS) {
+                std::cerr << "Correlation matrix limited to the first " << CorrelationSnapshot::MAX_PRODUCTS
+                          << " products" << std::endl;
+            }
+            m_returnSync = std::make_unique<ReturnSynchronizer>(m_productIds.size(), m_correlationBucketMillis * 1000000LL);
+            m_covariance = std::make_unique<RollingCovariance>(m_productIds.size(), m_correlationWindow);
+        }
+        
+        // Bars have their own file next to the CSV, opened only when trades are subscribed
+        m_barLogger.reset();
+        if (std::find(m_channels.begin(), m_channels.end(), "matches") != m_channels.end() &&
+            (m_volumeBarSize > 0.0 || m_dollarBarSize > 0.0)) {
+            m_barLogger = std::make_unique<BarLogger<TradeBar>>(BarLogger<TradeBar>::barsFilename(m_csvFilename, "bars"));
+            if (!m_barLogger->isReady()) {
+                std::cerr << "Failed to initialize bar logger" << std::endl;
+                return false;
+            }
+        }
+        
+        // Time bars come from ticker prices, so they need no extra subscription; one file per timeframe
+        m_timeBars.reset();
+        m_ohlcvLoggers.clear();
+        if (!m_timeBarSeconds.empty()) {
+            m_timeBars = std::make_unique<TimeBarEngine>(m_productIds, m_timeBarSeconds,
+                [this](const OhlcvBar& bar, size_t timeframeIndex) {
+                    BarLogger<OhlcvBar>& logger = *m_ohlcvLoggers[timeframeIndex];
+                    while (!logger.log(bar) && m_replayMode && logger.isReady()) {
+                        HighResTimer::sleepMicros(1);
+                    }
+                });
+            for (int64_t seconds : m_timeBars->getTimeframeSeconds()) {
+                m_ohlcvLoggers.push_back(std::make_unique<BarLogger<OhlcvBar>>(BarLogger<OhlcvBar>::barsFilename(
+                    m_csvFilename, "ohlcv_" + TimeBarEngine::timeframeLabel(seconds))));
+                if (!m_ohlcvLoggers.back()->isReady()) {
+                    std::cerr << "Failed to initialize OHLCV bar logger" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        #ifdef __linux__
+        // Logger on the core the plan keeps away from the hot threads
+        m_csvLogger = std::make_unique<AsyncCSVLogger>(m_csvFilename, m_placement.logger.cpu, m_placement.logger.node);
         #else
         m_csvLogger = std::make_unique<AsyncCSVLogger>(m_csvFilename);
         #endif
@@ -54,7 +249,14 @@ bool CoinbaseTickerAnalyzer::initializeComponents() {
             std::cerr << "Failed to initialize CSV logger" << std::endl;
             return false;
         }
+        m_csvLogger->setWriteLatencyHistogram(&m_latency.stage(LatencyStage::EMAToLogWrite));
+        
+        // Console output from the processing thread goes through the monitor; it also prints the status table
+        m_monitor = std::make_unique<ConsoleMonitor>(m_productIds,
+            [this](size_t productIndex) { return m_products[productIndex]->snapshot.load(); },
+            m_monitorIntervalMillis);
         
+        registerMetrics();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to initialize components: " << e.what() << std::endl;
@@ -63,6 +265,21 @@ bool CoinbaseTickerAnalyzer::initializeComponents() {
 }
 
 void CoinbaseTickerAnalyzer::cleanupComponents() {
+    #ifdef __linux__
+    // The server samples the components below; it goes first
+    if (m_metricsServer) {
+        m_metricsServer->stop();
+        m_metricsServer.reset();
+    }
+    #endif
+    
+    #ifdef __linux__
+    // Stop the replay producer first; it may be waiting on the processing thread for queue space
+    if (m_feedReplayer) {
+        m_feedReplayer->stop();
+    }
+    #endif
+    
     m_processingEnabled.store(false);
     
     // Wait for processing thread to finish
@@ -70,52 +287,455 @@ void CoinbaseTickerAnalyzer::cleanupComponents() {
         m_dataProcessingThread.join();
     }
     
+    // After the processing thread, so its last events are printed
+    if (m_monitor) {
+        m_monitor->stop();
+    }
+    
     // Clean up components
-    if (m_websocketClient) {
-        m_websocketClient->disconnect();
+    for (auto& line : m_lines) {
+        if (line->client) {
+            line->client->disconnect();
+        }
     }
     
+    #ifdef __linux__
+    if (m_feedCapture) {
+        m_feedCapture->close();
+    }
+    #endif
+    
     if (m_csvLogger) {
         m_csvLogger->close();
     }
+    
+    if (m_barLogger) {
+        m_barLogger->close();
+    }
+    
+    for (auto& logger : m_ohlcvLoggers) {
+        logger->close();
+    }
 }
 
-void CoinbaseTickerAnalyzer::handleWebSocketMessage(const std::string& message) {
+void CoinbaseTickerAnalyzer::onLineConnectionChange(bool connected) {
+    TraceRecorder::record(connected ? TraceEvent::Connect : TraceEvent::Disconnect,
+                          m_linesUp.load(std::memory_order_relaxed));
+    if (connected) {
+        // First line back after a full outage starts a new feed epoch
+        if (m_linesUp.fetch_add(1) == 0) {
+            m_feedEpoch.fetch_add(1);
+        }
+    } else if (m_linesUp.fetch_sub(1) == 1) {
+        // Last line down: the outage time to recover is measured from here
+        m_feedDownTsc.store(HighResTimer::nowCycles(), std::memory_order_release);
+    }
+}
+
+void CoinbaseTickerAnalyzer::registerMetrics() {
+    static_assert(LineCounterCount <= MetricsShard::MAX_COUNTERS, "too many line counters");
+    m_metrics = std::make_unique<MetricsRegistry>();
+    MetricsRegistry& metrics = *m_metrics;
+    
+    // Hot-path counters, registered in LineCounter order; each line's I/O thread owns its shard
+    metrics.addCounter("coinbase_frames_received_total", "Feed frames received");
+    metrics.addCounter("coinbase_parse_failures_total", "Ticker, level2 and match frames that failed to parse");
+    metrics.addCounter("coinbase_ticks_enqueued_total", "Ticks pushed to the processing queue");
+    metrics.addCounter("coinbase_ticks_dropped_total", "Ticks dropped because the processing queue was full");
+    metrics.addCounter("coinbase_book_chunks_enqueued_total", "Level2 chunks pushed to the book queue");
+    metrics.addCounter("coinbase_book_queue_stalls_total", "Times an I/O thread waited for book queue space");
+    metrics.addCounter("coinbase_trades_enqueued_total", "Trades pushed to the trade queue");
+    metrics.addCounter("coinbase_trades_dropped_total", "Trades dropped because the trade queue was full");
+    for (size_t i = 0; i < m_lines.size(); ++i) {
+        metrics.addShard("line" + std::to_string(i), &m_lines[i]->metrics);
+    }
+    
+    // Processing thread totals: single-writer atomics, only read here
+    const struct {
+        const char* name;
+        const char* help;
+        const std::atomic<uint64_t>* value;
+    } processed[] = {
+        {"coinbase_ticks_processed_total", "Ticks processed", &m_ticksProcessed},
+        {"coinbase_ticks_ignored_total", "Ticks for products that were not configured", &m_ticksIgnored},
+        {"coinbase_book_chunks_applied_total", "Level2 chunks applied to the books", &m_bookChunksApplied},
+        {"coinbase_book_changes_total", "Level changes applied to the books", &m_bookChanges},
+        {"coinbase_trades_processed_total", "Trades processed", &m_tradesProcessed},
+    };
+    for (const auto& counter : processed) {
+        const std::atomic<uint64_t>* value = counter.value;
+        metrics.addSampled(counter.name, counter.help, MetricType::Counter, "",
+            [value]() { return static_cast<double>(value->load(std::memory_order_relaxed)); });
+    }
+    
+    // Queue depths
+    for (size_t i = 0; i < m_lines.size(); ++i) {
+        const FeedLine* line = m_lines[i].get();
+        const std::string labels = "line=\"" + std::to_string(i) + "\",queue=";
+        metrics.addSampled("coinbase_queue_depth", "Entries waiting in a queue", MetricType::Gauge,
+            labels + "\"ticker\"", [line]() { return static_cast<double>(line->queue.size()); });
+        metrics.addSampled("coinbase_queue_depth", "Entries waiting in a queue", MetricType::Gauge,
+            labels + "\"book\"", [line]() { return static_cast<double>(line->bookQueue.size()); });
+        metrics.addSampled("coinbase_queue_depth", "Entries waiting in a queue", MetricType::Gauge,
+            labels + "\"trade\"", [line]() { return static_cast<double>(line->tradeQueue.size()); });
+    }
+    const AsyncCSVLogger* csvLogger = m_csvLogger.get();
+    metrics.addSampled("coinbase_queue_depth", "Entries waiting in a queue", MetricType::Gauge,
+        "queue=\"csv\"", [csvLogger]() { return static_cast<double>(csvLogger->getQueueSize()); });
+    
+    // Connectivity (replay has no clients)
+    metrics.addSampled("coinbase_lines_up", "Feed lines currently connected", MetricType::Gauge, "",
+        [this]() { return static_cast<double>(m_linesUp.load(std::memory_order_relaxed)); });
+    for (size_t i = 0; i < m_lines.size(); ++i) {
+        const WebSocketClient* client = m_lines[i]->client.get();
+        if (!client) {
+            continue;
+        }
+        const std::string labels = "line=\"" + std::to_string(i) + "\"";
+        metrics.addSampled("coinbase_reconnects_total", "Successful reconnects", MetricType::Counter, labels,
+            [client]() { return static_cast<double>(client->getReconnectCount()); });
+        metrics.addSampled("coinbase_reconnect_seconds", "Disconnect to established time of the last reconnect",
+            MetricType::Gauge, labels,
+            [client]() { return static_cast<double>(client->getLastReconnectNanos()) * 1e-9; });
+    }
+    
+    // Clock: drift of the TSC conversion against CLOCK_MONOTONIC_RAW at the last recalibration
+    metrics.addSampled("coinbase_tsc_drift_seconds", "Reference clock minus TSC-derived time", MetricType::Gauge, "",
+        []() { return static_cast<double>(HighResTimer::getClockErrorNanos()) * 1e-9; });
+    metrics.addSampled("coinbase_tsc_frequency_hertz", "Calibrated TSC frequency (0 without RDTSC)",
+        MetricType::Gauge, "", []() { return HighResTimer::getTscFrequencyGHz() * 1e9; });
+    
+    #ifdef __linux__
+    // Memory: steady state should hold RSS flat and add no major faults
+    metrics.addSampled("coinbase_process_resident_bytes", "Resident set size", MetricType::Gauge, "",
+        []() { return static_cast<double>(MemoryLock::usage().residentBytes); });
+    metrics.addSampled("coinbase_process_locked_bytes", "Memory locked by mlockall", MetricType::Gauge, "",
+        []() { return static_cast<double>(MemoryLock::usage().lockedBytes); });
+    metrics.addSampled("coinbase_process_major_faults_total", "Page faults that needed I/O", MetricType::Counter, "",
+        []() { return static_cast<double>(MemoryLock::usage().majorFaults); });
+    #endif
+    
+    // Stage latencies: each recording thread has its own histograms, merged when rendered
+    for (size_t i = 0; i < static_cast<size_t>(LatencyStage::Count); ++i) {
+        const LatencyStage stage = static_cast<LatencyStage>(i);
+        std::vector<const LatencyHistogram*> histograms{&m_latency.stage(stage)};
+        for (const auto& line : m_lines) {
+            histograms.push_back(&line->latency.stage(stage));
+        }
+        metrics.addLatency("coinbase_stage_latency_seconds", "Pipeline stage latency",
+            std::string("stage=\"") + PipelineLatency::stageName(stage) + "\"", std::move(histograms));
+    }
+}
+
+void CoinbaseTickerAnalyzer::prefaultComponents() {
+    #ifdef __linux__
+    // The queues and per-product state are stored inline; nothing reads or writes them yet
+    for (const auto& line : m_lines) {
+        NUMAUtils::touchMemory(line.get(), sizeof(FeedLine));
+    }
+    for (const auto& product : m_products) {
+        NUMAUtils::touchMemory(product.get(), sizeof(ProductContext));
+        // Owned heap storage: the book levels are only reserved (rolling windows are resized, so already written)
+        product->book.prefault();
+    }
+    if (m_monitor) {
+        NUMAUtils::touchMemory(m_monitor.get(), sizeof(ConsoleMonitor));
+    }
+    #endif
+}
+
+uint64_t CoinbaseTickerAnalyzer::lineTotal(LineCounter counter) const {
+    return m_metrics ? m_metrics->total(counter) : 0;
+}
+
+int CoinbaseTickerAnalyzer::findProduct(const std::string& productId) const {
+    // A handful of products: a linear scan beats hashing
+    for (size_t i = 0; i < m_products.size(); ++i) {
+        if (m_products[i]->productId == productId) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void CoinbaseTickerAnalyzer::handleWebSocketMessage(const std::string& message, uint64_t receiveTsc, size_t line) {
+    MetricsShard& metrics = m_lines[line]->metrics;
+    PipelineLatency& latency = m_lines[line]->latency;
+    metrics.add(FramesReceived);
+    TraceRecorder::recordAt(TraceEvent::Receive, receiveTsc, line, message.size());
+    
+    // Level2 frames take their own path; other non-ticker frames are skipped unparsed
+    const FeedMessageType type = JSONParser::getMessageType(message);
+    if (UNLIKELY(type != FeedMessageType::Ticker)) {
+        if (type == FeedMessageType::Snapshot || type == FeedMessageType::L2Update) {
+            handleBookMessage(message, receiveTsc, line);
+        } else if (type == FeedMessageType::Match) {
+            handleTradeMessage(message, receiveTsc, line);
+        }
+        return;
+    }
+    
     TickerData tickerData;
+    LockFreeRingBuffer<TickerData, DATA_BUFFER_SIZE>& queue = m_lines[line]->queue;
     
     // Parse success is likely for valid ticker messages
     if (LIKELY(JSONParser::parseTickerMessage(message, tickerData))) {
+        const uint64_t parsedTsc = HighResTimer::nowCycles();
+        tickerData.stamps.receive_tsc = receiveTsc;
+        tickerData.stamps.parsed_tsc = parsedTsc;
+        TraceRecorder::recordAt(TraceEvent::Parse, parsedTsc, tickerData.sequence_number, line);
+        // Feed epoch, not the line's own: a single line reconnecting loses nothing while another is up
+        tickerData.connection_epoch = m_feedEpoch.load(std::memory_order_relaxed);
+        
         // Non-blocking push to lock-free queue
         // Push success is likely in normal operation
-        if (UNLIKELY(!m_dataQueue.push(tickerData))) {
-            // Queue full - drop oldest entry to make space (unlikely)
-            TickerData dummy;
-            m_dataQueue.pop(dummy);
-            m_dataQueue.push(tickerData);
+        if (UNLIKELY(!queue.push(tickerData))) {
+            if (m_replayMode) {
+                // Replay must be lossless: apply backpressure to the replay thread instead
+                // Yield rather than spin: both threads may run SCHED_FIFO on a shared core
+                while (!queue.push(tickerData) && LIKELY(m_processingEnabled.load(std::memory_order_relaxed))) {
+                    std::this_thread::yield();
+                }
+            } else {
+                // Queue full - drop oldest entry to make space (unlikely)
+                TickerData dummy;
+                queue.pop(dummy);
+                queue.push(tickerData);
+                metrics.add(TicksDropped);
+            }
         }
+        metrics.add(TicksEnqueued);
+        
+        const uint64_t enqueuedTsc = HighResTimer::nowCycles();
+        TraceRecorder::recordAt(TraceEvent::Enqueue, enqueuedTsc, tickerData.sequence_number, line);
+        latency.stage(LatencyStage::ReceiveToParse).recordSigned(
+            HighResTimer::cyclesToNanos(parsedTsc - receiveTsc));
+        latency.stage(LatencyStage::ParseToEnqueue).recordSigned(
+            HighResTimer::cyclesToNanos(enqueuedTsc - parsedTsc));
+    } else {
+        metrics.add(ParseFailures);
     }
 }
 
+void CoinbaseTickerAnalyzer::handleBookMessage(const std::string& message, uint64_t receiveTsc, size_t line) {
+    // Level2 carries no sequence numbers to arbitrate on, so books follow the primary line
+    if (line != 0) {
+        return;
+    }
+    
+    // Reused so the change vector keeps its capacity (one instance per I/O thread)
+    static thread_local Level2Message parsed;
+    MetricsShard& metrics = m_lines[line]->metrics;
+    if (UNLIKELY(!JSONParser::parseLevel2Message(message, parsed))) {
+        metrics.add(ParseFailures);
+        return;
+    }
+    const int productIndex = findProduct(parsed.product_id);
+    if (UNLIKELY(productIndex < 0)) {
+        return;
+    }
+    
+    LockFreeRingBuffer<BookUpdate, BOOK_BUFFER_SIZE>& queue = m_lines[line]->bookQueue;
+    BookUpdate update;
+    update.receive_tsc = receiveTsc;
+    update.exchange_time_ns = parsed.exchange_time_ns;
+    update.product_index = static_cast<uint16_t>(productIndex);
+    
+    // Snapshots are split over several chunks; an l2update usually fits in one
+    const size_t total = parsed.changes.size();
+    size_t offset = 0;
+    do {
+        const size_t count = std::min(total - offset, BookUpdate::MAX_CHANGES);
+        update.flags = 0;
+        if (parsed.snapshot && offset == 0) {
+            update.flags |= BookUpdate::SNAPSHOT_BEGIN;
+        }
+        if (parsed.snapshot && offset + count == total) {
+            update.flags |= BookUpdate::SNAPSHOT_END;
+        }
+        update.count = static_cast<uint8_t>(count);
+        std::memcpy(update.changes, parsed.changes.data() + offset, count * sizeof(BookChange));
+        
+        // A lost change corrupts the book until the next snapshot: wait for space instead
+        // of dropping (only a large snapshot is likely to fill the queue)
+        if (UNLIKELY(!queue.push(update))) {
+            metrics.add(BookQueueStalls);
+            while (!queue.push(update) && LIKELY(m_processingEnabled.load(std::memory_order_relaxed))) {
+                std::this_thread::yield();
+            }
+        }
+        metrics.add(BookChunksEnqueued);
+        offset += count;
+    } while (offset < total);
+}
+
+void CoinbaseTickerAnalyzer::handleTradeMessage(const std::string& message, uint64_t receiveTsc, size_t line) {
+    TradeData trade;
+    MetricsShard& metrics = m_lines[line]->metrics;
+    if (UNLIKELY(!JSONParser::parseTradeMessage(message, trade))) {
+        metrics.add(ParseFailures);
+        return;
+    }
+    trade.receive_tsc = receiveTsc;
+    
+    // Lossless in replay; live, a full queue drops the new trade (the processing thread is the only consumer)
+    LockFreeRingBuffer<TradeData, TRADE_BUFFER_SIZE>& queue = m_lines[line]->tradeQueue;
+    if (UNLIKELY(!queue.push(trade))) {
+        if (m_replayMode) {
+            while (!queue.push(trade) && LIKELY(m_processingEnabled.load(std::memory_order_relaxed))) {
+                std::this_thread::yield();
+            }
+        } else {
+            metrics.add(TradesDropped);
+            return;
+        }
+    }
+    metrics.add(TradesEnqueued);
+}
+
+void CoinbaseTickerAnalyzer::processTrade(const TradeData& trade, size_t line) {
+    // Matches carry sequence numbers, so redundant lines are deduplicated like tickers
+    if (m_tradeArbiter && !m_tradeArbiter->accept(trade.product_id, trade.sequence_number, line, trade.receive_tsc)) {
+        return;
+    }
+    const int productIndex = findProduct(trade.product_id);
+    if (UNLIKELY(productIndex < 0)) {
+        return;
+    }
+    ProductContext& context = *m_products[productIndex];
+    
+    context.vwap.addTrade(trade.exchange_time_ns, trade.price, trade.size);
+    context.latestVwap.store(context.vwap.snapshot());
+    
+    // Bars close rarely; the bar logger may not exist without a matches subscription
+    TradeBar bar;
+    for (BarBuilder* builder : {&context.volumeBars, &context.dollarBars}) {
+        if (UNLIKELY(builder->add(trade, bar)) && m_barLogger) {
+            while (!m_barLogger->log(bar) && m_replayMode && m_barLogger->isReady()) {
+                HighResTimer::sleepMicros(1);
+            }
+        }
+    }
+}
+
+void CoinbaseTickerAnalyzer::applyBookUpdate(const BookUpdate& update) {
+    ProductContext& context = *m_products[update.product_index];
+    
+    if (UNLIKELY(update.flags & BookUpdate::SNAPSHOT_BEGIN)) {
+        context.book.clear();
+        context.bookLoading = true;
+        context.bookReady = false;
+    }
+    // Updates from before the first snapshot have no book to apply to (unlikely)
+    if (UNLIKELY(!context.bookReady && !context.bookLoading)) {
+        return;
+    }
+    
+    for (uint8_t i = 0; i < update.count; ++i) {
+        const BookChange& change = update.changes[i];
+        int64_t previousSize;
+        const int distance = context.book.apply(change.side, change.price, change.size, previousSize);
+        // Signals follow deltas once the book is complete; a snapshot is summed in one pass at its end
+        if (LIKELY(!context.bookLoading)) {
+            context.signals.onApply(context.book, change.side, change.price, previousSize, change.size, distance);
+        }
+    }
+    m_bookChanges.fetch_add(update.count, std::memory_order_relaxed);
+    
+    if (UNLIKELY(update.flags & BookUpdate::SNAPSHOT_END)) {
+        context.bookLoading = false;
+        context.bookReady = true;
+        context.signals.rebuild(context.book);
+    }
+    // Publish only complete books
+    if (LIKELY(context.bookReady)) {
+        context.top.store(context.book.top());
+        const BookSignalValues signals = context.signals.compute(context.book);
+        if (LIKELY(signals.valid)) {
+            // Exchange time drives the EMA interval like the ticker path (snapshots carry none)
+            const auto timestamp = update.exchange_time_ns != 0
+                ? std::chrono::system_clock::time_point(
+                      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                          std::chrono::nanoseconds(update.exchange_time_ns)))
+                : std::chrono::system_clock::now();
+            context.micropriceEma.update(signals.microprice, timestamp);
+            context.imbalanceEma.update(signals.imbalance, timestamp);
+        }
+        context.latestSignals.store(signals);
+        TraceRecorder::record(TraceEvent::BookApply, update.product_index, update.count);
+        ProductSnapshot& state = context.state;
+        state.book_ready = signals.valid;
+        state.microprice = signals.microprice;
+        state.microprice_ema = context.micropriceEma.get();
+        state.imbalance = signals.imbalance;
+        state.imbalance_ema = context.imbalanceEma.get();
+        state.spread_bps = signals.spread_bps;
+        publishSnapshot(context, HighResTimer::nowCycles());
+        m_latency.stage(LatencyStage::ReceiveToBook).recordSigned(
+            HighResTimer::cyclesToNanos(HighResTimer::nowCycles() - update.receive_tsc));
+    }
+}
+
+void CoinbaseTickerAnalyzer::publishSnapshot(ProductContext& context, uint64_t tsc) {
+    context.state.published_tsc = tsc;
+    context.snapshot.store(context.state);
+}
+
 void CoinbaseTickerAnalyzer::processDataThread() {
-    // Optimize thread for HFT with NUMA awareness
-    // Use CPU 2 (or auto-select based on NUMA topology)
-    ThreadUtils::optimizeForHFT("DataProcessor", 2, 99);
+    // Optimize thread for HFT on the core the placement plan gave it
+    #ifdef __linux__
+    ThreadUtils::optimizeForHFT(m_placement.processing.thread, m_placement.processing.cpu, 99,
+                                m_placement.processing.node);
+    // Under the NUMA policy just set, so the ring and the touched pages are local
+    TraceRecorder::attachThread(m_placement.processing.thread);
+    MemoryLock::prefaultStack(MemoryLock::STACK_PREFAULT_BYTES);
+    MemoryLock::prefaultHeap(MemoryLock::THREAD_HEAP_PREFAULT_BYTES);
+    #endif
     
     while (LIKELY(m_processingEnabled.load())) {
         TickerData data;
+        BookUpdate bookUpdate;
+        TradeData trade;
         bool hadData = false;
         
-        // Batch process for efficiency
-        while (LIKELY(m_processingEnabled.load())) {
-            // Pop success is likely when actively processing
-            if (LIKELY(m_dataQueue.pop(data))) {
-                processTickerData(data);
-                hadData = true;
-            } else {
-                break;
+        // Batch process for efficiency; with redundant lines, take one tick per line per
+        // round so neither line's copies wait behind the other's backlog
+        bool popped = true;
+        while (LIKELY(m_processingEnabled.load()) && popped) {
+            popped = false;
+            for (size_t line = 0; line < m_lines.size(); ++line) {
+                // Pop success is likely when actively processing
+                if (LIKELY(m_lines[line]->queue.pop(data))) {
+                    data.stamps.dequeued_tsc = HighResTimer::nowCycles();
+                    TraceRecorder::recordAt(TraceEvent::Dequeue, data.stamps.dequeued_tsc, data.sequence_number, line);
+                    processDequeued(data, line);
+                    m_ticksProcessed.fetch_add(1, std::memory_order_release);
+                    popped = true;
+                    hadData = true;
+                }
+                // Book chunks only arrive with a level2 subscription
+                if (UNLIKELY(m_lines[line]->bookQueue.pop(bookUpdate))) {
+                    applyBookUpdate(bookUpdate);
+                    m_bookChunksApplied.fetch_add(1, std::memory_order_release);
+                    popped = true;
+                    hadData = true;
+                }
+                // Trades only arrive with a matches subscription
+                if (UNLIKELY(m_lines[line]->tradeQueue.pop(trade))) {
+                    processTrade(trade, line);
+                    m_tradesProcessed.fetch_add(1, std::memory_order_release);
+                    popped = true;
+                    hadData = true;
+                }
             }
         }
         
+        // Live time bars close on the wall clock even when no tick arrives
+        // (replay drives them from tick times instead)
+        if (m_timeBars && !m_replayMode) {
+            m_timeBars->advance(HighResTimer::cyclesToWallNanos(HighResTimer::nowCycles()));
+        }
+        
         // Brief pause if no data to prevent busy waiting (unlikely when busy)
         if (UNLIKELY(!hadData)) {
             // Use high-resolution sleep for microsecond precision
@@ -128,26 +748,160 @@ void CoinbaseTickerAnalyzer::processDataThread() {
     }
 }
 
+void CoinbaseTickerAnalyzer::processDequeued(TickerData& data, size_t line) {
+    // Redundant lines: only the first copy of each message goes on (duplicates are likely here)
+    if (m_arbiter && !m_arbiter->accept(data.product_id, data.sequence_number, line, data.stamps.receive_tsc)) {
+        return;
+    }
+    
+    // Exchange->receive needs both sides on the wall clock (exchange time parsed is likely)
+    // Taken after arbitration, so with redundant lines this is the effective (fastest line) latency
+    // Meaningless for replayed frames, whose receive time is the replay time
+    if (LIKELY(data.exchange_time_ns != 0) && !m_replayMode) {
+        m_latency.stage(LatencyStage::ExchangeToReceive).recordSigned(
+            HighResTimer::cyclesToWallNanos(data.stamps.receive_tsc) - data.exchange_time_ns);
+    }
+    
+    trackSequence(data);
+    processTickerData(data);
+    // Not stamped if processing failed (unlikely)
+    if (LIKELY(data.stamps.processed_tsc != 0)) {
+        m_latency.stage(LatencyStage::DequeueToEMA).recordSigned(
+            HighResTimer::cyclesToNanos(data.stamps.processed_tsc - data.stamps.dequeued_tsc));
+        const int64_t receiveToProcessed = HighResTimer::cyclesToNanos(data.stamps.processed_tsc - data.stamps.receive_tsc);
+        TraceRecorder::recordAt(TraceEvent::Process, data.stamps.processed_tsc, data.sequence_number,
+                                static_cast<uint64_t>(std::max<int64_t>(receiveToProcessed, 0)));
+        // A spike (unlikely): keep the rings' view of it before it is overwritten
+        if (UNLIKELY(m_traceThresholdNanos > 0 && receiveToProcessed > m_traceThresholdNanos)) {
+            TraceRecorder::record(TraceEvent::LatencyBreach, data.sequence_number,
+                                  static_cast<uint64_t>(receiveToProcessed));
+            TraceRecorder::requestDump();
+        }
+    }
+}
+
+void CoinbaseTickerAnalyzer::trackSequence(const TickerData& data) {
+    // New connection (unlikely): time from the disconnect to the first tick it delivered
+    if (UNLIKELY(data.connection_epoch != m_lastEpoch)) {
+        if (m_lastEpoch != 0) {
+            const uint64_t disconnectTsc = m_feedDownTsc.load(std::memory_order_acquire);
+            if (disconnectTsc != 0 && data.stamps.receive_tsc > disconnectTsc) {
+                const int64_t recoveryNanos = HighResTimer::cyclesToNanos(data.stamps.receive_tsc - disconnectTsc);
+                m_sequenceTracker.recordRecovery(static_cast<uint64_t>(recoveryNanos));
+                m_monitor->post(false, "Feed recovered in %lld ms", static_cast<long long>(recoveryNanos / 1000000));
+            }
+        }
+        m_lastEpoch = data.connection_epoch;
+    }
+    
+    const SequenceResult result = m_sequenceTracker.onMessage(
+        data.product_id, data.sequence_number, data.connection_epoch);
+    // In-order is likely; anything else is worth a line in the log
+    if (UNLIKELY(result == SequenceResult::Resumed)) {
+        m_monitor->post(false, "%s resumed after reconnect, %llu sequence numbers later",
+                        data.product_id.c_str(),
+                        static_cast<unsigned long long>(m_sequenceTracker.getLastSkipped()));
+    } else if (UNLIKELY(result == SequenceResult::Duplicate || result == SequenceResult::OutOfOrder)) {
+        m_monitor->post(true, "Sequence %s: %s %llu",
+                        result == SequenceResult::Duplicate ? "duplicate" : "out of order",
+                        data.product_id.c_str(), static_cast<unsigned long long>(data.sequence_number));
+    }
+}
+
 void CoinbaseTickerAnalyzer::processTickerData(TickerData& data) {
+    const int productIndex = findProduct(data.product_id);
+    // Products are fixed at startup; strays only come from replaying another capture (unlikely)
+    if (UNLIKELY(productIndex < 0)) {
+        m_ticksIgnored.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ProductContext& context = *m_products[productIndex];
+    
     try {
         // Calculate EMAs
-        data.price_ema = m_emaCalculator->updatePriceEMA(
-            std::stod(data.price), data.timestamp);
-        data.mid_price_ema = m_emaCalculator->updateMidPriceEMA(
+        const double price = std::stod(data.price);
+        data.price_ema = context.ema.updatePriceEMA(price, data.timestamp);
+        data.mid_price_ema = context.ema.updateMidPriceEMA(
             data.mid_price, data.timestamp);
         
-        // Log to CSV
-        m_csvLogger->logTickerData(data);
+        // Rolling statistics age by exchange time when there is one (likely)
+        const int64_t timeNanos = LIKELY(data.exchange_time_ns != 0) ? data.exchange_time_ns :
+            std::chrono::duration_cast<std::chrono::nanoseconds>(data.timestamp.time_since_epoch()).count();
+        context.priceStats.add(timeNanos, price);
+        if (LIKELY(context.lastPrice > 0.0 && price > 0.0)) {
+            context.returnStats.add(timeNanos, std::log(price / context.lastPrice));
+        }
+        context.lastPrice = price;
+        PriceStats stats;
+        stats.price = context.priceStats.snapshot();
+        stats.volatility = context.returnStats.stddev();
+        stats.zscore = context.priceStats.zScore(price, data.price_ema);
+        context.latestStats.store(stats);
+        data.price_zscore = stats.zscore;
+        data.price_volatility = stats.volatility;
+        
+        // A bucket closes about once per bucket length; the matrix is republished only then
+        if (m_returnSync) {
+            const size_t closed = m_returnSync->onPrice(static_cast<size_t>(productIndex), timeNanos, price,
+                [this](const double* returns, int64_t bucketEndNanos) {
+                    m_covariance->add(returns, bucketEndNanos);
+                }, m_correlationWindow);
+            if (UNLIKELY(closed > 0)) {
+                m_latestCorrelation.store(m_covariance->snapshot(0));
+            }
+        }
+        
+        // One pass over the shared indicator nodes; a tick is its own high, low and close
+        if (LIKELY(context.indicators.getOutputCount() > 0)) {
+            context.indicators.update(price, price, price);
+            context.latestIndicators.store(context.indicators.snapshot());
+        }
         
-        // Print to console for monitoring
-        std::cout << "Processed: " << data.product_id 
-                  << " Price: " << data.price
-                  << " Price EMA: " << data.price_ema
-                  << " Mid-Price EMA: " << data.mid_price_ema << std::endl;
-                  
+        // Time bars need an exchange time to bucket by (parsed is likely)
+        int64_t fixedPrice;
+        if (m_timeBars && LIKELY(data.exchange_time_ns != 0) &&
+            LIKELY(JSONParser::parseFixedPoint(data.price.data(), data.price.size(), fixedPrice))) {
+            int64_t size;
+            if (!JSONParser::parseFixedPoint(data.last_size.data(), data.last_size.size(), size)) {
+                size = 0;
+            }
+            // Replay has no wall clock to close bars on: the feed clock is the clock
+            if (m_replayMode) {
+                m_timeBars->advance(data.exchange_time_ns);
+            }
+            m_timeBars->onTick(static_cast<size_t>(productIndex), fixedPrice, size, data.exchange_time_ns);
+        }
+        data.stamps.processed_tsc = HighResTimer::nowCycles();
+        
+        // Readers get this tick's price, EMAs and statistics together or not at all
+        ProductSnapshot& state = context.state;
+        state.ticks++;
+        state.sequence = data.sequence_number;
+        state.exchange_time_ns = data.exchange_time_ns;
+        state.price = price;
+        int64_t fixedQuote;
+        if (LIKELY(JSONParser::parseFixedPoint(data.best_bid.data(), data.best_bid.size(), fixedQuote))) {
+            state.best_bid = OrderBook::toDouble(fixedQuote);
+        }
+        if (LIKELY(JSONParser::parseFixedPoint(data.best_ask.data(), data.best_ask.size(), fixedQuote))) {
+            state.best_ask = OrderBook::toDouble(fixedQuote);
+        }
+        state.mid_price = data.mid_price;
+        state.price_ema = data.price_ema;
+        state.mid_price_ema = data.mid_price_ema;
+        state.emas_ready = true;
+        state.price_zscore = stats.zscore;
+        state.price_volatility = stats.volatility;
+        publishSnapshot(context, data.stamps.processed_tsc);
+        
+        // Log to CSV (replay waits for the logger so the output file is complete)
+        while (UNLIKELY(!m_csvLogger->logTickerData(data)) && m_replayMode &&
+               m_csvLogger->isReady()) {
+            HighResTimer::sleepMicros(1);
+        }
     } catch (const std::exception& e) {
         // Exceptions are unlikely in normal operation
-        std::cerr << "Error processing ticker data: " << e.what() << std::endl;
+        m_monitor->post(true, "Error processing ticker data: %s", e.what());
     }
 }
 
@@ -158,43 +912,113 @@ bool CoinbaseTickerAnalyzer::start() {
         return true;
     }
     
+    #ifdef __linux__
+    // Startup memory phase: lock and keep freed heap resident before anything is allocated
+    const MemoryUsage memoryBefore = MemoryLock::usage();
+    MemoryLock::retainHeap();
+    if (m_lockMemory) {
+        MemoryLock::lockAll();
+    }
+    #endif
+    
     // Initialization success is likely
     if (UNLIKELY(!initializeComponents())) {
         return false;
     }
     
+    #ifdef __linux__
+    // Fault in queues and heap now so the first ticks do not pay for it (threads do their own stacks)
+    prefaultComponents();
+    MemoryLock::prefaultHeap(MemoryLock::MAIN_HEAP_PREFAULT_BYTES);
+    m_startupMemory = MemoryLock::usage();
+    std::cout << MemoryLock::formatStartup(memoryBefore, m_startupMemory);
+    #endif
+    
+    #ifdef __linux__
+    if (m_metricsPort > 0) {
+        m_metricsServer = std::make_unique<MetricsServer>(*m_metrics);
+        if (!m_metricsServer->start(static_cast<uint16_t>(m_metricsPort))) {
+            std::cerr << "Failed to start metrics server" << std::endl;
+            m_metricsServer.reset();
+            cleanupComponents();
+            return false;
+        }
+        std::cout << "Metrics: http://127.0.0.1:" << m_metricsServer->getPort() << "/metrics" << std::endl;
+    }
+    #endif
+    
     // Start data processing thread
+    m_monitor->start();
     m_processingEnabled.store(true);
     m_dataProcessingThread = std::thread(&CoinbaseTickerAnalyzer::processDataThread, this);
     
-    // Connect to Coinbase WebSocket
-    const std::string coinbaseUri = "wss://ws-feed.exchange.coinbase.com";
-    // Connection success is likely
-    if (UNLIKELY(!m_websocketClient->connect(coinbaseUri))) {
-        std::cerr << "Failed to connect to Coinbase WebSocket" << std::endl;
-        cleanupComponents();
-        return false;
-    }
-    
-    // Wait a moment for connection to establish
     #ifdef __linux__
-    HighResTimer::sleepMicros(1000000); // 1 second in microseconds
-    #else
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    if (m_replayMode) {
+        // Replay thread takes the I/O thread's place in the plan
+        if (UNLIKELY(!m_feedReplayer->start([this](const std::string& message, uint64_t receiveTsc) {
+                handleWebSocketMessage(message, receiveTsc, 0);
+            }, m_placement.feedIo[0].cpu))) {
+            std::cerr << "Failed to start feed replay" << std::endl;
+            cleanupComponents();
+            return false;
+        }
+        
+        m_running.store(true);
+        std::cout << "Coinbase Ticker Analyzer started in replay mode" << std::endl;
+        std::cout << "Replaying: " << m_replayFilename;
+        if (m_replaySpeed > 0.0) {
+            std::cout << " at " << m_replaySpeed << "x real time" << std::endl;
+        } else {
+            std::cout << " at maximum speed" << std::endl;
+        }
+        std::cout << "Logging to: " << m_csvFilename << std::endl;
+        return true;
+    }
     #endif
     
-    // Subscribe to ticker channel
-    // Subscription success is likely
-    if (UNLIKELY(!m_websocketClient->subscribeToTicker(m_productId))) {
-        std::cerr << "Failed to subscribe to ticker channel" << std::endl;
+    // Connect every line to the feed WebSocket (Coinbase unless overridden)
+    // Lines that miss the first attempt keep retrying on their I/O thread
+    size_t connectedLines = 0;
+    for (size_t i = 0; i < m_lines.size(); ++i) {
+        // Connection success is likely
+        if (LIKELY(m_lines[i]->client->connect(m_endpoint))) {
+            connectedLines++;
+        } else if (m_lines.size() > 1) {
+            std::cerr << "Feed line " << i << " not connected yet, retrying in the background" << std::endl;
+        }
+    }
+    if (UNLIKELY(connectedLines == 0)) {
+        std::cerr << "Failed to connect to WebSocket feed: " << m_endpoint << std::endl;
         cleanupComponents();
         return false;
     }
     
+    // Subscribe to the channels (stored per line and replayed on every reconnect)
+    // Subscription success is likely
+    for (auto& line : m_lines) {
+        if (UNLIKELY(!line->client->subscribe(m_productIds, m_channels) && line->client->isConnected())) {
+            std::cerr << "Failed to subscribe to channels: " << joinList(m_channels) << std::endl;
+            cleanupComponents();
+            return false;
+        }
+    }
+    
     m_running.store(true);
     std::cout << "Coinbase Ticker Analyzer started successfully" << std::endl;
-    std::cout << "Monitoring product: " << m_productId << std::endl;
+    std::cout << "Monitoring product" << (m_productIds.size() > 1 ? "s" : "") << ": "
+              << joinList(m_productIds) << std::endl;
+    std::cout << "Channels: " << joinList(m_channels) << std::endl;
+    std::cout << "Feed: " << m_endpoint;
+    if (m_lines.size() > 1) {
+        std::cout << " (" << m_lines.size() << " lines, " << connectedLines << " connected)";
+    }
+    std::cout << std::endl;
     std::cout << "Logging to: " << m_csvFilename << std::endl;
+    #ifdef __linux__
+    if (m_feedCapture) {
+        std::cout << "Capturing raw feed to: " << m_captureFilename << std::endl;
+    }
+    #endif
     
     return true;
 }
@@ -218,11 +1042,19 @@ bool CoinbaseTickerAnalyzer::isRunning() const {
 }
 
 std::string CoinbaseTickerAnalyzer::getProductId() const {
-    return m_productId;
+    return joinList(m_productIds);
 }
 
 void CoinbaseTickerAnalyzer::setProductId(const std::string& productId) {
-    m_productId = productId;
+    m_productIds = splitList(productId);
+}
+
+std::string CoinbaseTickerAnalyzer::getChannels() const {
+    return joinList(m_channels);
+}
+
+void CoinbaseTickerAnalyzer::setChannels(const std::string& channels) {
+    m_channels = splitList(channels);
 }
 
 std::string CoinbaseTickerAnalyzer::getCsvFilename() const {
@@ -233,17 +1065,260 @@ void CoinbaseTickerAnalyzer::setCsvFilename(const std::string& filename) {
     m_csvFilename = filename;
 }
 
+std::string CoinbaseTickerAnalyzer::getEndpoint() const {
+    return m_endpoint;
+}
+
+void CoinbaseTickerAnalyzer::setEndpoint(const std::string& uri, bool allowSelfSigned) {
+    m_endpoint = uri;
+    m_allowSelfSigned = allowSelfSigned;
+}
+
+void CoinbaseTickerAnalyzer::setFeedLines(size_t count, const std::vector<std::string>& interfaces) {
+    m_lineInterfaces = interfaces;
+    m_lineCount = std::min(std::max({count, interfaces.size(), static_cast<size_t>(1)}), FeedArbiter::MAX_LINES);
+}
+
+void CoinbaseTickerAnalyzer::setTradeAnalytics(const std::vector<int64_t>& vwapWindowSeconds,
+                                               double volumeBarSize, double dollarBarSize) {
+    m_vwapWindowSeconds = vwapWindowSeconds;
+    m_volumeBarSize = volumeBarSize;
+    m_dollarBarSize = dollarBarSize;
+}
+
+void CoinbaseTickerAnalyzer::setTimeBars(const std::vector<int64_t>& timeframeSeconds) {
+    m_timeBarSeconds = timeframeSeconds;
+}
+
+void CoinbaseTickerAnalyzer::setStatsWindow(int64_t seconds) {
+    m_statsWindowSeconds = seconds;
+}
+
+void CoinbaseTickerAnalyzer::setIndicators(const std::string& spec) {
+    m_indicatorSpec = spec;
+}
+
+void CoinbaseTickerAnalyzer::setCorrelation(int64_t bucketMillis, size_t windowBuckets) {
+    m_correlationBucketMillis = bucketMillis;
+    m_correlationWindow = windowBuckets;
+}
+
+void CoinbaseTickerAnalyzer::setIrqPlan(bool enabled) {
+    m_irqPlan = enabled;
+}
+
+void CoinbaseTickerAnalyzer::setMemoryLock(bool enabled) {
+    m_lockMemory = enabled;
+}
+
+void CoinbaseTickerAnalyzer::setTraceThreshold(int64_t micros) {
+    m_traceThresholdNanos = micros > 0 ? micros * 1000 : 0;
+}
+
+void CoinbaseTickerAnalyzer::setMonitorInterval(int64_t millis) {
+    m_monitorIntervalMillis = millis;
+}
+
+void CoinbaseTickerAnalyzer::setMetricsPort(int port) {
+    m_metricsPort = port;
+}
+
+void CoinbaseTickerAnalyzer::setStaleTimeout(int64_t millis) {
+    m_staleTimeoutMillis = millis;
+}
+
+void CoinbaseTickerAnalyzer::setCaptureFile(const std::string& filename) {
+    m_captureFilename = filename;
+}
+
+void CoinbaseTickerAnalyzer::setReplaySource(const std::string& filename, double speed) {
+    m_replayFilename = filename;
+    m_replaySpeed = speed;
+    m_replayMode = !filename.empty();
+}
+
+bool CoinbaseTickerAnalyzer::isSourceExhausted() const {
+    #ifdef __linux__
+    if (!m_feedReplayer || !m_feedReplayer->isFinished()) {
+        return false;
+    }
+    // Replay is lossless, so every enqueued tick, book chunk and trade must also have been processed
+    return m_ticksProcessed.load(std::memory_order_acquire) >= lineTotal(TicksEnqueued) &&
+           m_bookChunksApplied.load(std::memory_order_acquire) >= lineTotal(BookChunksEnqueued) &&
+           m_tradesProcessed.load(std::memory_order_acquire) >= lineTotal(TradesEnqueued);
+    #else
+    return false;
+    #endif
+}
+
 std::string CoinbaseTickerAnalyzer::getStatistics() const {
     std::ostringstream oss;
-    oss << "Product ID: " << m_productId << std::endl;
+    oss << "Product ID: " << joinList(m_productIds) << std::endl;
+    oss << "Channels: " << joinList(m_channels) << std::endl;
     oss << "CSV File: " << m_csvFilename << std::endl;
+    oss << "Endpoint: " << (m_replayMode ? m_replayFilename : m_endpoint) << std::endl;
     oss << "Running: " << (m_running.load() ? "Yes" : "No") << std::endl;
-    oss << "Connected: " << (m_websocketClient && m_websocketClient->isConnected() ? "Yes" : "No") << std::endl;
+    oss << "Connected: " << (m_linesUp.load() > 0 ? "Yes" : "No") << std::endl;
+    for (size_t i = 0; i < m_lines.size(); ++i) {
+        const WebSocketClient* client = m_lines[i]->client.get();
+        if (!client) {
+            continue;
+        }
+        oss << (m_lines.size() > 1 ? "Line " + std::to_string(i) + " " : std::string())
+            << "Connection Epoch: " << client->getConnectionEpoch()
+            << " (" << client->getReconnectCount() << " reconnects";
+        if (client->getReconnectCount() > 0) {
+            oss << ", last " << client->getLastReconnectNanos() / 1000000
+                << " ms, max " << client->getMaxReconnectNanos() / 1000000 << " ms";
+        }
+        oss << ")" << (m_lines.size() > 1 && !client->isConnected() ? " DOWN" : "") << std::endl;
+    }
+    if (m_arbiter) {
+        oss << m_arbiter->getSummary();
+    }
+    oss << m_sequenceTracker.getSummary() << std::endl;
+    oss << "Ticks Processed: " << m_ticksProcessed.load(std::memory_order_relaxed) << std::endl;
+    #ifdef __linux__
+    const MemoryUsage memory = MemoryLock::usage();
+    oss << "Memory: RSS " << memory.residentBytes / (1024 * 1024) << " MiB, "
+        << memory.majorFaults - std::min(memory.majorFaults, m_startupMemory.majorFaults)
+        << " major faults since startup" << std::endl;
+    #endif
+    oss << "Ticks Dropped: " << lineTotal(TicksDropped) << std::endl;
+    if (m_ticksIgnored.load(std::memory_order_relaxed) > 0) {
+        oss << "Ticks Ignored (unknown product): " << m_ticksIgnored.load(std::memory_order_relaxed) << std::endl;
+    }
+    if (lineTotal(TradesEnqueued) > 0) {
+        oss << "Trades Processed: " << m_tradesProcessed.load(std::memory_order_relaxed)
+            << " (dropped " << lineTotal(TradesDropped) << ")";
+        if (m_barLogger) {
+            oss << ", " << m_barLogger->getWritten() << " bars written to " << m_barLogger->getFilename();
+        }
+        oss << std::endl;
+    }
+    if (!m_ohlcvLoggers.empty()) {
+        oss << "OHLCV Bars Written:";
+        for (const auto& logger : m_ohlcvLoggers) {
+            oss << " " << logger->getWritten() << " to " << logger->getFilename();
+            if (&logger != &m_ohlcvLoggers.back()) {
+                oss << ",";
+            }
+        }
+        oss << std::endl;
+    }
+    if (lineTotal(BookChunksEnqueued) > 0) {
+        oss << "Book Changes Applied: " << m_bookChanges.load(std::memory_order_relaxed)
+            << " (queue stalls " << lineTotal(BookQueueStalls) << ")" << std::endl;
+    }
+    #ifdef __linux__
+    if (m_feedCapture) {
+        oss << "Frames Captured: " << m_feedCapture->getFramesRecorded()
+            << " (dropped " << m_feedCapture->getFramesDropped() << ")" << std::endl;
+    }
+    if (m_feedReplayer) {
+        oss << m_feedReplayer->getSummary() << std::endl;
+    }
+    #endif
+    
+    for (const auto& context : m_products) {
+        const std::string prefix = m_products.size() > 1 ? context->productId + " " : std::string();
+        // One seqlock copy, so the price and both EMAs come from the same tick
+        const ProductSnapshot state = context->snapshot.load();
+        if (state.ticks > 0) {
+            oss << prefix << "Last: " << state.price << " (bid " << state.best_bid << " / ask "
+                << state.best_ask << ", " << state.ticks << " ticks)" << std::endl;
+        }
+        oss << prefix << "Price EMA: " << state.price_ema << std::endl;
+        oss << prefix << "Mid-Price EMA: " << state.mid_price_ema << std::endl;
+        const PriceStats stats = context->latestStats.load();
+        if (stats.price.count > 0) {
+            oss << prefix << "Price " << stats.price.window_ns / 1000000000LL << "s: mean " << stats.price.mean
+                << " stddev " << stats.price.stddev << " range " << stats.price.min << " - " << stats.price.max
+                << " (" << stats.price.count << " ticks) Volatility: " << stats.volatility
+                << " Z-Score: " << stats.zscore << std::endl;
+        }
+        const IndicatorSnapshot indicators = context->latestIndicators.load();
+        if (indicators.count > 0) {
+            oss << prefix << "Indicators:";
+            for (size_t i = 0; i < indicators.count; ++i) {
+                oss << " " << context->indicators.getOutputName(i) << " ";
+                if (indicators.ready[i]) {
+                    oss << indicators.values[i];
+                } else {
+                    oss << "-";
+                }
+            }
+            oss << std::endl;
+        }
+        const VwapSnapshot vwap = context->latestVwap.load();
+        if (vwap.count > 0 && vwap.windows[vwap.count - 1].trades > 0) {
+            oss << prefix << "VWAP:";
+            for (size_t i = 0; i < vwap.count; ++i) {
+                const VwapWindowStats& window = vwap.windows[i];
+                oss << " " << window.window_ns / 1000000000LL << "s " << window.vwap
+                    << " (" << window.volume << " in " << window.trades << " trades)";
+            }
+            oss << std::endl;
+        }
+        // Seqlock copy: consistent even while the processing thread updates the book
+        const BookTop top = context->top.load();
+        if (top.bid_depth > 0 || top.ask_depth > 0) {
+            oss << prefix << "Book: " << OrderBook::toDouble(top.bid_size) << " @ "
+                << OrderBook::toDouble(top.bid_price) << " / "
+                << OrderBook::toDouble(top.ask_size) << " @ " << OrderBook::toDouble(top.ask_price)
+                << " (" << top.bid_depth << " bid / " << top.ask_depth << " ask levels)" << std::endl;
+            const BookSignalValues signals = context->latestSignals.load();
+            if (signals.valid) {
+                oss << prefix << "Microprice: " << signals.microprice
+                    << " (EMA " << context->micropriceEma.get() << ")"
+                    << " Imbalance: " << signals.imbalance
+                    << " (EMA " << context->imbalanceEma.get() << ")"
+                    << " Depth-Weighted Mid: " << signals.depth_weighted_mid
+                    << " Spread: " << signals.spread_bps << " bps" << std::endl;
+            }
+        }
+    }
     
-    if (m_emaCalculator) {
-        oss << "Price EMA: " << m_emaCalculator->getPriceEMA() << std::endl;
-        oss << "Mid-Price EMA: " << m_emaCalculator->getMidPriceEMA() << std::endl;
+    // Seqlock copy of the whole matrix: rows are never mixed from different buckets
+    const CorrelationSnapshot correlation = m_latestCorrelation.load();
+    if (correlation.samples >= 2) {
+        oss << "Correlation (" << correlation.samples << " x " << m_correlationBucketMillis
+            << " ms returns, beta vs " << m_productIds[correlation.benchmark] << "):" << std::endl;
+        for (size_t i = 0; i < correlation.count; ++i) {
+            oss << "  " << m_productIds[i] << " beta " << correlation.beta[i]
+                << " vol " << correlation.volatility[i] << " corr";
+            for (size_t j = 0; j < correlation.count; ++j) {
+                oss << " " << correlation.get(i, j);
+            }
+            oss << std::endl;
+        }
     }
     
     return oss.str();
 }
+
+std::string CoinbaseTickerAnalyzer::getMetrics() const {
+    return m_metrics ? m_metrics->render() : std::string();
+}
+
+bool CoinbaseTickerAnalyzer::getProductSnapshot(const std::string& productId, ProductSnapshot& snapshot) const {
+    const int productIndex = findProduct(productId);
+    if (productIndex < 0) {
+        return false;
+    }
+    snapshot = m_products[productIndex]->snapshot.load();
+    return true;
+}
+
+std::unique_ptr<PipelineLatency> CoinbaseTickerAnalyzer::getPipelineLatency() const {
+    auto merged = std::make_unique<PipelineLatency>();
+    merged->merge(m_latency);
+    for (const auto& line : m_lines) {
+        merged->merge(line->latency);
+    }
+    return merged;
+}
+
+std::string CoinbaseTickerAnalyzer::getLatencyReport() const {
+    return getPipelineLatency()->report();
+}
@@ -0,0 +1,149 @@
+/**
+ * @file ConsoleMonitor.cpp
+ * @brief Implementation of the asynchronous console monitor
+ */
+
+#include "ConsoleMonitor.h"
+#include "HighResTimer.h"
+#include "ThreadUtils.h"
+#include "BranchPrediction.h"
+#include <cstdarg>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    /// How often the monitor wakes to print posted events
+    constexpr int64_t POLL_MICROS = 20000;
+    /// Nice value of the monitor thread: console output is best effort
+    constexpr int MONITOR_NICE = 10;
+}
+
+ConsoleMonitor::ConsoleMonitor(const std::vector<std::string>& productIds, SnapshotReader reader,
+                               int64_t intervalMillis)
+    : m_productIds(productIds)
+    , m_reader(std::move(reader))
+    , m_intervalMillis(intervalMillis > 0 ? intervalMillis : 0)
+    , m_lastTicks(productIds.size(), 0)
+    , m_lastTableNanos(0) {
+}
+
+ConsoleMonitor::~ConsoleMonitor() {
+    stop();
+}
+
+void ConsoleMonitor::start() {
+    if (m_running.load()) {
+        return;
+    }
+    m_running.store(true);
+    m_thread = std::thread(&ConsoleMonitor::monitorLoop, this);
+}
+
+void ConsoleMonitor::stop() {
+    m_running.store(false);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    // Events posted after the thread's last pass (the processing thread has stopped by now)
+    drainEvents();
+}
+
+bool ConsoleMonitor::post(bool error, const char* format, ...) {
+    ConsoleEvent event;
+    event.error = error;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(event.text, sizeof(event.text), format, args);
+    va_end(args);
+    // A full queue means the console is far behind; losing a line beats stalling the feed
+    if (UNLIKELY(!m_events.push(event))) {
+        m_eventsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void ConsoleMonitor::monitorLoop() {
+    // Unpinned and niced: the console gets whatever time the pinned threads leave
+    ThreadUtils::setThreadName("Console");
+#ifdef __linux__
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), MONITOR_NICE);
+#endif
+
+    m_lastTableNanos = HighResTimer::nowNanos();
+    while (m_running.load(std::memory_order_relaxed)) {
+        HighResTimer::sleepMicros(POLL_MICROS);
+        drainEvents();
+        if (m_intervalMillis > 0 &&
+            HighResTimer::nowNanos() - m_lastTableNanos >= m_intervalMillis * 1000000LL) {
+            printTable();
+        }
+    }
+}
+
+void ConsoleMonitor::drainEvents() {
+    ConsoleEvent event;
+    bool printedOut = false;
+    while (m_events.pop(event)) {
+        if (event.error) {
+            std::cerr << event.text << '\n';
+        } else {
+            std::cout << event.text << '\n';
+            printedOut = true;
+        }
+    }
+    // One flush per batch instead of one per line (std::cerr is unbuffered)
+    if (printedOut) {
+        std::cout << std::flush;
+    }
+}
+
+void ConsoleMonitor::printTable() {
+    const int64_t now = HighResTimer::nowNanos();
+    const double seconds = static_cast<double>(now - m_lastTableNanos) * 1e-9;
+    m_lastTableNanos = now;
+
+    std::vector<ProductSnapshot> snapshots;
+    std::vector<double> rates;
+    snapshots.reserve(m_productIds.size());
+    rates.reserve(m_productIds.size());
+    for (size_t i = 0; i < m_productIds.size(); ++i) {
+        snapshots.push_back(m_reader(i));
+        const uint64_t ticks = snapshots.back().ticks;
+        rates.push_back(seconds > 0.0 ? static_cast<double>(ticks - m_lastTicks[i]) / seconds : 0.0);
+        m_lastTicks[i] = ticks;
+    }
+    std::cout << formatTable(snapshots, rates) << std::flush;
+}
+
+std::string ConsoleMonitor::formatTable(const std::vector<ProductSnapshot>& snapshots,
+                                        const std::vector<double>& rates) const {
+    std::ostringstream oss;
+    oss << std::left << std::setw(12) << "product" << std::right
+        << std::setw(10) << "ticks" << std::setw(9) << "ticks/s"
+        << std::setw(14) << "price" << std::setw(14) << "bid" << std::setw(14) << "ask"
+        << std::setw(14) << "price ema" << std::setw(14) << "mid ema"
+        << std::setw(9) << "z-score" << std::setw(12) << "volatility" << '\n';
+    oss << std::fixed;
+    for (size_t i = 0; i < snapshots.size() && i < m_productIds.size(); ++i) {
+        const ProductSnapshot& state = snapshots[i];
+        oss << std::left << std::setw(12) << m_productIds[i] << std::right
+            << std::setw(10) << state.ticks
+            << std::setprecision(1) << std::setw(9) << (i < rates.size() ? rates[i] : 0.0)
+            << std::setprecision(2)
+            << std::setw(14) << state.price << std::setw(14) << state.best_bid << std::setw(14) << state.best_ask
+            << std::setw(14) << state.price_ema << std::setw(14) << state.mid_price_ema
+            << std::setw(9) << state.price_zscore
+            << std::scientific << std::setprecision(2) << std::setw(12) << state.price_volatility << std::fixed
+            << '\n';
+    }
+    return oss.str();
+}
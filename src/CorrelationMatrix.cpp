@@ -0,0 +1,134 @@
+/**
+ * @file CorrelationMatrix.cpp
+ * @brief Implementation of the return synchronizer and rolling covariance matrix
+ */
+
+#include "CorrelationMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include "BranchPrediction.h"
+
+ReturnSynchronizer::ReturnSynchronizer(size_t products, int64_t bucketNanos)
+    : m_bucketNanos(bucketNanos > 0 ? bucketNanos : 1)
+    , m_last(products, 0.0)
+    , m_previous(products, 0.0)
+    , m_returns(products, 0.0)
+    , m_bucket(0)
+    , m_started(false) {
+}
+
+bool ReturnSynchronizer::computeReturns() {
+    bool complete = true;
+    for (size_t i = 0; i < m_last.size(); ++i) {
+        complete = complete && m_last[i] > 0.0 && m_previous[i] > 0.0;
+    }
+    // Until every product has a price at two closes, only move the start prices forward
+    if (!complete) {
+        m_previous = m_last;
+        return false;
+    }
+    for (size_t i = 0; i < m_last.size(); ++i) {
+        m_returns[i] = std::log(m_last[i] / m_previous[i]);
+        m_previous[i] = m_last[i];
+    }
+    return true;
+}
+
+RollingCovariance::RollingCovariance(size_t products, size_t window)
+    : m_products(std::min(products, CorrelationSnapshot::MAX_PRODUCTS))
+    , m_window(std::max<size_t>(window, 2))
+    , m_ring(m_window * m_products, 0.0)
+    , m_sum(m_products, 0.0)
+    , m_cross(m_products * m_products, 0.0)
+    , m_count(0)
+    , m_pos(0)
+    , m_lastBucketEnd(0) {
+}
+
+void RollingCovariance::add(const double* returns, int64_t bucketEndNanos) {
+    const size_t n = m_products;
+    double* __restrict slot = &m_ring[m_pos * n];
+    double* __restrict sum = m_sum.data();
+    double* __restrict cross = m_cross.data();
+
+    if (LIKELY(m_count == m_window)) {
+        // Rank-1 update with the new vector and rank-1 downdate with the one it replaces
+        for (size_t i = 0; i < n; ++i) {
+            const double ri = returns[i];
+            const double oi = slot[i];
+            double* __restrict row = cross + i * n;
+            for (size_t j = 0; j < n; ++j) {
+                row[j] += ri * returns[j] - oi * slot[j];
+            }
+            sum[i] += ri - oi;
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            const double ri = returns[i];
+            double* __restrict row = cross + i * n;
+            for (size_t j = 0; j < n; ++j) {
+                row[j] += ri * returns[j];
+            }
+            sum[i] += ri;
+        }
+        m_count++;
+    }
+    std::copy(returns, returns + n, slot);
+    m_pos = m_pos + 1 == m_window ? 0 : m_pos + 1;
+    m_lastBucketEnd = bucketEndNanos;
+
+    // Once per window, rebuild from the ring so update/downdate rounding cannot accumulate
+    if (UNLIKELY(m_pos == 0)) {
+        resum();
+    }
+}
+
+void RollingCovariance::resum() {
+    const size_t n = m_products;
+    std::fill(m_sum.begin(), m_sum.end(), 0.0);
+    std::fill(m_cross.begin(), m_cross.end(), 0.0);
+    for (size_t s = 0; s < m_count; ++s) {
+        const double* vector = &m_ring[s * n];
+        for (size_t i = 0; i < n; ++i) {
+            double* row = &m_cross[i * n];
+            for (size_t j = 0; j < n; ++j) {
+                row[j] += vector[i] * vector[j];
+            }
+            m_sum[i] += vector[i];
+        }
+    }
+}
+
+double RollingCovariance::covariance(size_t i, size_t j) const {
+    if (m_count < 2) {
+        return 0.0;
+    }
+    const double count = static_cast<double>(m_count);
+    return (m_cross[i * m_products + j] - m_sum[i] * m_sum[j] / count) / (count - 1.0);
+}
+
+double RollingCovariance::correlation(size_t i, size_t j) const {
+    const double denominator = covariance(i, i) * covariance(j, j);
+    return denominator > 0.0 ? covariance(i, j) / std::sqrt(denominator) : 0.0;
+}
+
+double RollingCovariance::beta(size_t i, size_t benchmark) const {
+    const double variance = covariance(benchmark, benchmark);
+    return variance > 0.0 ? covariance(i, benchmark) / variance : 0.0;
+}
+
+CorrelationSnapshot RollingCovariance::snapshot(size_t benchmark) const {
+    CorrelationSnapshot result;
+    result.count = m_products;
+    result.benchmark = benchmark;
+    result.samples = m_count;
+    result.bucket_end_ns = m_lastBucketEnd;
+    for (size_t i = 0; i < m_products; ++i) {
+        result.volatility[i] = std::sqrt(std::max(covariance(i, i), 0.0));
+        result.beta[i] = beta(i, benchmark);
+        for (size_t j = 0; j < m_products; ++j) {
+            result.correlation[i * CorrelationSnapshot::MAX_PRODUCTS + j] = correlation(i, j);
+        }
+    }
+    return result;
+}
@@ -7,94 +7,70 @@
 #include <algorithm>
 #include <cmath>
 
-EMACalculator::EMACalculator(int intervalSeconds) 
+IntervalEMA::IntervalEMA(int intervalSeconds)
     : m_interval(std::chrono::seconds(intervalSeconds))
-    , m_priceEMA(0.0)
-    , m_midPriceEMA(0.0)
+    , m_value(0.0)
     , m_alpha(calculateAlpha(intervalSeconds))
-    , m_priceInitialized(false)
-    , m_midPriceInitialized(false) {
+    , m_initialized(false) {
 }
 
-double EMACalculator::calculateAlpha(int intervalSeconds) const {
+double IntervalEMA::calculateAlpha(int intervalSeconds) {
     // For EMA: alpha = 2 / (n + 1)
     // For 5-second interval, we use n = 5
     return 2.0 / (intervalSeconds + 1.0);
 }
 
-bool EMACalculator::shouldUpdatePrice(const std::chrono::system_clock::time_point& currentTime) const {
-    if (!m_priceInitialized) {
-        return true;
+double IntervalEMA::update(double value, const std::chrono::system_clock::time_point& currentTime) {
+    if (!m_initialized.load(std::memory_order_relaxed)) {
+        m_value.store(value);
+        m_initialized.store(true, std::memory_order_release);
+    } else if (currentTime - m_lastUpdate >= m_interval) {
+        double currentEMA = m_value.load();
+        double newEMA = m_alpha * value + (1.0 - m_alpha) * currentEMA;
+        m_value.store(newEMA);
+    } else {
+        return m_value.load();
     }
-    
-    auto timeDiff = currentTime - m_priceLastUpdate;
-    return timeDiff >= m_interval;
+
+    m_lastUpdate = currentTime;
+    return m_value.load();
 }
 
-bool EMACalculator::shouldUpdateMidPrice(const std::chrono::system_clock::time_point& currentTime) const {
-    if (!m_midPriceInitialized) {
-        return true;
-    }
-    
-    auto timeDiff = currentTime - m_midPriceLastUpdate;
-    return timeDiff >= m_interval;
+void IntervalEMA::reset() {
+    m_initialized.store(false, std::memory_order_release);
+    m_value.store(0.0);
+}
+
+EMACalculator::EMACalculator(int intervalSeconds)
+    : m_priceEMA(intervalSeconds)
+    , m_midPriceEMA(intervalSeconds) {
 }
 
 double EMACalculator::updatePriceEMA(double price, const std::chrono::system_clock::time_point& currentTime) {
-    if (!shouldUpdatePrice(currentTime)) {
-        return m_priceEMA.load();
-    }
-    
-    if (!m_priceInitialized) {
-        m_priceEMA.store(price);
-        m_priceInitialized = true;
-    } else {
-        double currentEMA = m_priceEMA.load();
-        double newEMA = m_alpha * price + (1.0 - m_alpha) * currentEMA;
-        m_priceEMA.store(newEMA);
-    }
-    
-    m_priceLastUpdate = currentTime;
-    return m_priceEMA.load();
+    return m_priceEMA.update(price, currentTime);
 }
 
 double EMACalculator::updateMidPriceEMA(double midPrice, const std::chrono::system_clock::time_point& currentTime) {
-    if (!shouldUpdateMidPrice(currentTime)) {
-        return m_midPriceEMA.load();
-    }
-    
-    if (!m_midPriceInitialized) {
-        m_midPriceEMA.store(midPrice);
-        m_midPriceInitialized = true;
-    } else {
-        double currentEMA = m_midPriceEMA.load();
-        double newEMA = m_alpha * midPrice + (1.0 - m_alpha) * currentEMA;
-        m_midPriceEMA.store(newEMA);
-    }
-    
-    m_midPriceLastUpdate = currentTime;
-    return m_midPriceEMA.load();
+    return m_midPriceEMA.update(midPrice, currentTime);
 }
 
 double EMACalculator::getPriceEMA() const {
-    return m_priceEMA.load();
+    return m_priceEMA.get();
 }
 
 double EMACalculator::getMidPriceEMA() const {
-    return m_midPriceEMA.load();
+    return m_midPriceEMA.get();
 }
 
 void EMACalculator::reset() {
-    m_priceEMA.store(0.0);
-    m_midPriceEMA.store(0.0);
-    m_priceInitialized = false;
-    m_midPriceInitialized = false;
+    m_priceEMA.reset();
+    m_midPriceEMA.reset();
 }
 
 bool EMACalculator::isPriceInitialized() const {
-    return m_priceInitialized;
+    return m_priceEMA.isInitialized();
 }
 
 bool EMACalculator::isMidPriceInitialized() const {
-    return m_midPriceInitialized;
+    return m_midPriceEMA.isInitialized();
 }
@@ -0,0 +1,126 @@
+/**
+ * @file FeedArbiter.cpp
+ * @brief Implementation of A/B line arbitration
+ */
+
+#include "FeedArbiter.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "HighResTimer.h"
+#include "BranchPrediction.h"
+
+FeedArbiter::FeedArbiter(size_t lineCount)
+    : m_lineCount(std::min(std::max<size_t>(lineCount, 1), MAX_LINES)) {
+    for (size_t i = 0; i < m_lineCount; ++i) {
+        m_lineStats[i] = std::make_unique<LineStats>();
+    }
+}
+
+void FeedArbiter::insert(Window& window, uint64_t sequence, size_t line, uint64_t receiveTsc) {
+    window.sequences[window.head] = sequence;
+    window.receiveTsc[window.head] = receiveTsc;
+    window.lines[window.head] = static_cast<uint8_t>(line);
+    window.head = (window.head + 1) & WINDOW_MASK;
+    window.count = std::min(window.count + 1, WINDOW_SIZE);
+    window.newest = std::max(window.newest, sequence);
+}
+
+bool FeedArbiter::accept(const std::string& productId, uint64_t sequence, size_t line, uint64_t receiveTsc) {
+    // Unsequenced messages cannot be matched up
+    if (UNLIKELY(sequence == 0 || line >= m_lineCount)) {
+        m_forwarded.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    LineStats& stats = *m_lineStats[line];
+    stats.copies.fetch_add(1, std::memory_order_relaxed);
+
+    Window& window = m_windows[productId];
+    // Lines deliver in order, so the leading copy is always beyond the newest sequence
+    if (LIKELY(sequence > window.newest)) {
+        insert(window, sequence, line, receiveTsc);
+        stats.wins.fetch_add(1, std::memory_order_relaxed);
+        m_forwarded.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Trailing copy: search newest to oldest, the match is usually a few slots back
+    for (size_t i = 1; i <= window.count; ++i) {
+        const size_t slot = (window.head - i) & WINDOW_MASK;
+        if (window.sequences[slot] != sequence) {
+            continue;
+        }
+        m_duplicates.fetch_add(1, std::memory_order_relaxed);
+        const size_t winner = window.lines[slot];
+        if (winner == line) {
+            // Resent on the same line (e.g. after a reconnect): no race to score
+            return false;
+        }
+        if (LIKELY(receiveTsc >= window.receiveTsc[slot])) {
+            stats.lag.record(static_cast<uint64_t>(HighResTimer::cyclesToNanos(receiveTsc - window.receiveTsc[slot])));
+        } else {
+            // Dequeued second but received first: this line won the race on the wire
+            m_lineStats[winner]->lag.record(
+                static_cast<uint64_t>(HighResTimer::cyclesToNanos(window.receiveTsc[slot] - receiveTsc)));
+            m_lineStats[winner]->wins.fetch_sub(1, std::memory_order_relaxed);
+            stats.wins.fetch_add(1, std::memory_order_relaxed);
+            window.receiveTsc[slot] = receiveTsc;
+            window.lines[slot] = static_cast<uint8_t>(line);
+        }
+        return false;
+    }
+
+    // Older than everything remembered: too late to tell, drop it
+    const size_t oldest = (window.head - window.count) & WINDOW_MASK;
+    if (window.count > 0 && sequence < window.sequences[oldest]) {
+        m_stale.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // A message the leading line missed: the trailing line fills the hole
+    insert(window, sequence, line, receiveTsc);
+    stats.wins.fetch_add(1, std::memory_order_relaxed);
+    m_forwarded.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+uint64_t FeedArbiter::getWins(size_t line) const {
+    return line < m_lineCount ? m_lineStats[line]->wins.load(std::memory_order_relaxed) : 0;
+}
+
+const LatencyHistogram& FeedArbiter::getLagHistogram(size_t line) const {
+    return m_lineStats[std::min(line, m_lineCount - 1)]->lag;
+}
+
+uint64_t FeedArbiter::getForwarded() const {
+    return m_forwarded.load(std::memory_order_relaxed);
+}
+
+std::string FeedArbiter::getSummary() const {
+    const uint64_t forwarded = getForwarded();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "Arbiter: " << forwarded << " forwarded, "
+        << m_duplicates.load(std::memory_order_relaxed) << " duplicates, "
+        << m_stale.load(std::memory_order_relaxed) << " stale" << std::endl;
+    oss << "  " << std::left << std::setw(8) << "line"
+        << std::right << std::setw(12) << "copies"
+        << std::setw(12) << "wins"
+        << std::setw(10) << "win %"
+        << std::setw(14) << "lag p50 us"
+        << std::setw(14) << "lag p99 us"
+        << std::setw(14) << "lag max us" << std::endl;
+    for (size_t i = 0; i < m_lineCount; ++i) {
+        const LineStats& stats = *m_lineStats[i];
+        const uint64_t wins = stats.wins.load(std::memory_order_relaxed);
+        const LatencySummary lag = stats.lag.summarize();
+        oss << "  " << std::left << std::setw(8) << i
+            << std::right << std::setw(12) << stats.copies.load(std::memory_order_relaxed)
+            << std::setw(12) << wins
+            << std::setw(10) << (forwarded > 0 ? 100.0 * wins / forwarded : 0.0)
+            << std::setw(14) << lag.p50 / 1000.0
+            << std::setw(14) << lag.p99 / 1000.0
+            << std::setw(14) << lag.max / 1000.0 << std::endl;
+    }
+    return oss.str();
+}
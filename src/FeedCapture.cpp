@@ -0,0 +1,132 @@
+/**
+ * @file FeedCapture.cpp
+ * @brief Implementation of asynchronous raw feed recorder
+ */
+
+#include "FeedCapture.h"
+#include "HighResTimer.h"
+#include "ThreadUtils.h"
+#include "BranchPrediction.h"
+#include <iostream>
+
+#ifdef __linux__
+
+FeedCapture::FeedCapture(const std::string& filename)
+    : m_filename(filename) {
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    // File open success is likely
+    if (UNLIKELY(!m_file.is_open())) {
+        std::cerr << "Error: Could not open capture file: " << filename << std::endl;
+        return;
+    }
+
+    m_file.write(FeedCaptureFormat::MAGIC, sizeof(FeedCaptureFormat::MAGIC));
+
+    m_running.store(true);
+    m_writerThread = std::thread(&FeedCapture::writerThreadFunction, this);
+}
+
+FeedCapture::~FeedCapture() {
+    close();
+}
+
+bool FeedCapture::record(const std::string& payload, uint64_t receiveTsc) {
+    // Running check - unlikely to be false after construction
+    if (UNLIKELY(!m_running.load(std::memory_order_relaxed))) {
+        return false;
+    }
+
+    CapturedFrame frame;
+    frame.receiveTsc = receiveTsc;
+    frame.payload = payload;
+
+    // Push success is likely in normal operation
+    if (UNLIKELY(!m_queue.push(std::move(frame)))) {
+        m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void FeedCapture::writeFrame(const CapturedFrame& frame) {
+    FeedCaptureFormat::FrameHeader header;
+    // Convert to the wall clock here, off the I/O thread
+    header.receiveWallNanos = HighResTimer::cyclesToWallNanos(frame.receiveTsc);
+    header.length = static_cast<uint32_t>(frame.payload.size());
+    header.reserved = 0;
+
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(frame.payload.data(), static_cast<std::streamsize>(frame.payload.size()));
+    m_framesRecorded.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FeedCapture::writerThreadFunction() {
+    // Background thread: named but deliberately not pinned to a hot core
+    ThreadUtils::setThreadName("FeedCapture");
+
+    int64_t lastFlushTime = HighResTimer::nowMicros();
+    const int64_t FLUSH_INTERVAL_MICROS = 100000; // Flush every 100ms
+
+    while (LIKELY(m_running.load())) {
+        CapturedFrame frame;
+        bool hadData = false;
+
+        // Batch write everything that is queued
+        while (LIKELY(m_queue.pop(frame))) {
+            writeFrame(frame);
+            hadData = true;
+        }
+
+        int64_t now = HighResTimer::nowMicros();
+        if (UNLIKELY(now - lastFlushTime >= FLUSH_INTERVAL_MICROS)) {
+            m_file.flush();
+            lastFlushTime = now;
+        }
+
+        // Brief pause if no data to prevent busy waiting
+        if (UNLIKELY(!hadData)) {
+            HighResTimer::sleepMicros(100);
+        }
+    }
+
+    // Drain remaining frames before shutdown
+    CapturedFrame frame;
+    while (m_queue.pop(frame)) {
+        writeFrame(frame);
+    }
+    m_file.flush();
+}
+
+bool FeedCapture::isReady() const {
+    return m_running.load() && m_file.is_open();
+}
+
+void FeedCapture::close() {
+    bool expected = true;
+    if (!m_running.compare_exchange_strong(expected, false)) {
+        return; // Already closed
+    }
+
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    if (m_file.is_open()) {
+        m_file.flush();
+        m_file.close();
+    }
+}
+
+uint64_t FeedCapture::getFramesRecorded() const {
+    return m_framesRecorded.load(std::memory_order_relaxed);
+}
+
+uint64_t FeedCapture::getFramesDropped() const {
+    return m_framesDropped.load(std::memory_order_relaxed);
+}
+
+std::string FeedCapture::getFilename() const {
+    return m_filename;
+}
+
+#endif // __linux__
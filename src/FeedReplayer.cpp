@@ -0,0 +1,204 @@
+/**
+ * @file FeedReplayer.cpp
+ * @brief Implementation of recorded feed replay
+ */
+
+#include "FeedReplayer.h"
+#include "FeedCapture.h"
+#include "HighResTimer.h"
+#include "ThreadUtils.h"
+#include "BranchPrediction.h"
+#include "MemoryLock.h"
+#include "TraceRing.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    /// Remaining wait below which the replay thread spins instead of sleeping
+    constexpr int64_t SPIN_THRESHOLD_NANOS = 50000;
+}
+
+FeedReplayer::FeedReplayer(const std::string& filename, double speed)
+    : m_filename(filename)
+    , m_speed(speed > 0.0 ? speed : 0.0)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_cpuCore(-1) {
+}
+
+FeedReplayer::~FeedReplayer() {
+    stop();
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+}
+
+bool FeedReplayer::open() {
+    int fd = ::open(m_filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open replay file: " << m_filename << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FeedCaptureFormat::MAGIC)) {
+        std::cerr << "Error: Replay file is empty or unreadable: " << m_filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Error: Could not map replay file: " << m_filename << std::endl;
+        m_size = 0;
+        return false;
+    }
+    m_data = static_cast<const char*>(mapped);
+
+    // Frames are read front to back exactly once
+    madvise(mapped, m_size, MADV_SEQUENTIAL);
+
+    if (std::memcmp(m_data, FeedCaptureFormat::MAGIC, sizeof(FeedCaptureFormat::MAGIC)) != 0) {
+        std::cerr << "Error: Not a feed capture file: " << m_filename << std::endl;
+        munmap(mapped, m_size);
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool FeedReplayer::start(FrameCallback callback, int cpuCore) {
+    if (m_data == nullptr && !open()) {
+        return false;
+    }
+    if (m_running.load()) {
+        return false;
+    }
+
+    m_cpuCore = cpuCore;
+    m_finished.store(false);
+    m_running.store(true);
+    m_replayThread = std::thread(&FeedReplayer::replayThreadFunction, this, std::move(callback));
+    return true;
+}
+
+void FeedReplayer::stop() {
+    m_running.store(false);
+    if (m_replayThread.joinable()) {
+        m_replayThread.join();
+    }
+}
+
+void FeedReplayer::waitUntil(int64_t targetNanos) const {
+    int64_t remaining = targetNanos - HighResTimer::nowNanos();
+    // Sleep for the bulk of long gaps, spin for the tail to keep pacing tight
+    if (remaining > SPIN_THRESHOLD_NANOS) {
+        HighResTimer::sleepNanos(remaining - SPIN_THRESHOLD_NANOS);
+    }
+    while (HighResTimer::nowNanos() < targetNanos && LIKELY(m_running.load(std::memory_order_relaxed))) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+void FeedReplayer::replayThreadFunction(FrameCallback callback) {
+    // Replay thread stands in for the WebSocket I/O thread
+    if (m_cpuCore >= 0) {
+        ThreadUtils::optimizeForHFT("FeedReplay", m_cpuCore, 99);
+    } else {
+        ThreadUtils::setThreadName("FeedReplay");
+    }
+    TraceRecorder::attachThread("FeedReplay");
+    MemoryLock::prefaultStack(MemoryLock::STACK_PREFAULT_BYTES);
+    MemoryLock::prefaultHeap(MemoryLock::THREAD_HEAP_PREFAULT_BYTES);
+
+    const bool paced = m_speed > 0.0;
+    const int64_t startNanos = HighResTimer::nowNanos();
+    int64_t firstFrameWallNanos = 0;
+    bool haveFirstFrame = false;
+
+    std::string payload;
+    size_t offset = sizeof(FeedCaptureFormat::MAGIC);
+
+    while (LIKELY(m_running.load(std::memory_order_relaxed))) {
+        // Truncated trailing frame (e.g. capture killed mid-write) ends the replay
+        if (UNLIKELY(offset + sizeof(FeedCaptureFormat::FrameHeader) > m_size)) {
+            break;
+        }
+        FeedCaptureFormat::FrameHeader header;
+        std::memcpy(&header, m_data + offset, sizeof(header));
+        offset += sizeof(header);
+        if (UNLIKELY(offset + header.length > m_size)) {
+            std::cerr << "Warning: Truncated frame at end of replay file" << std::endl;
+            break;
+        }
+
+        if (paced) {
+            if (UNLIKELY(!haveFirstFrame)) {
+                firstFrameWallNanos = header.receiveWallNanos;
+                haveFirstFrame = true;
+            }
+            const double gapNanos = static_cast<double>(header.receiveWallNanos - firstFrameWallNanos);
+            waitUntil(startNanos + static_cast<int64_t>(gapNanos / m_speed));
+        }
+
+        payload.assign(m_data + offset, header.length);
+        offset += header.length;
+
+        // Stamp at hand-off so pipeline stage latencies stay meaningful
+        callback(payload, HighResTimer::nowCycles());
+
+        m_framesReplayed.fetch_add(1, std::memory_order_relaxed);
+        m_bytesReplayed.fetch_add(header.length, std::memory_order_relaxed);
+    }
+
+    m_elapsedNanos.store(HighResTimer::nowNanos() - startNanos);
+    m_finished.store(true);
+}
+
+bool FeedReplayer::isFinished() const {
+    return m_finished.load();
+}
+
+uint64_t FeedReplayer::getFramesReplayed() const {
+    return m_framesReplayed.load(std::memory_order_relaxed);
+}
+
+uint64_t FeedReplayer::getBytesReplayed() const {
+    return m_bytesReplayed.load(std::memory_order_relaxed);
+}
+
+std::string FeedReplayer::getSummary() const {
+    const uint64_t frames = getFramesReplayed();
+    const uint64_t bytes = getBytesReplayed();
+    const int64_t elapsedNanos = m_elapsedNanos.load();
+    const double seconds = static_cast<double>(elapsedNanos) / 1e9;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Replayed " << frames << " frames (" << bytes << " bytes) in " << seconds << " s";
+    if (seconds > 0.0) {
+        oss << std::setprecision(0)
+            << " - " << static_cast<double>(frames) / seconds << " msgs/sec, "
+            << std::setprecision(1)
+            << static_cast<double>(bytes) / seconds / (1024.0 * 1024.0) << " MiB/sec";
+    }
+    oss << (m_speed > 0.0 ? " (paced)" : " (max speed)");
+    return oss.str();
+}
+
+#endif // __linux__
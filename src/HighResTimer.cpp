@@ -4,13 +4,19 @@
  */
 
 #include "HighResTimer.h"
+#include "LatencyHistogram.h"
 #include "BranchPrediction.h"
 #include <iostream>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 
 #if HAVE_RDTSC
 #include <immintrin.h>  // For _mm_pause()
+#include <cpuid.h>      // For __get_cpuid()
 #endif
 
 #ifdef __linux__
@@ -19,114 +25,374 @@
 #include <sys/syscall.h>
 #endif
 
+namespace {
+// Recalibration tuning
+constexpr int CLOCK_PAIR_SAMPLES = 7;               // Bracketed reads per sample, tightest wins
+constexpr double SLOPE_SMOOTHING = 0.2;             // EWMA gain for the measured TSC slope
+constexpr double MAX_SLEW_FRACTION = 500e-6;        // Max slew correction (500 ppm of the slope)
+constexpr int64_t STEP_THRESHOLD_NANOS = 1000000;   // Errors above 1 ms are stepped, not slewed
+
+// Recalibration state (touched by the recalibration thread only)
+uint64_t g_prevSampleTsc = 0;
+int64_t g_prevSampleNanos = 0;
+double g_smoothedNanosPerCycle = 0.0;
+
+// One-time calibration (first callers of initialize() may race)
+std::once_flag g_initializeOnce;
+
+// Background thread control
+std::thread g_recalibrationThread;
+std::mutex g_recalibrationMutex;
+std::condition_variable g_recalibrationCv;
+bool g_recalibrationRunning = false;
+}
+
 // Static members
-bool HighResTimer::s_initialized = false;
-double HighResTimer::s_tscFrequencyGHz = 0.0;
-int64_t HighResTimer::s_tscOffset = 0;
+std::atomic<bool> HighResTimer::s_initialized{false};
+#ifdef __linux__
+int HighResTimer::s_wallClockId = CLOCK_REALTIME;
+#else
+int HighResTimer::s_wallClockId = 0;
+#endif
+std::atomic<bool> HighResTimer::s_invariantTsc{false};
+std::atomic<bool> HighResTimer::s_useTsc{false};
+std::atomic<double> HighResTimer::s_tscFrequencyGHz{0.0};
+SeqLocked<HighResTimer::TscCalibration> HighResTimer::s_calibration;
+std::atomic<int64_t> HighResTimer::s_lastErrorNanos{0};
 
 void HighResTimer::initialize() {
     // Already initialized check - unlikely after first call
-    if (UNLIKELY(s_initialized)) {
+    if (UNLIKELY(s_initialized.load(std::memory_order_acquire))) {
         return;
     }
     
-    initializeRDTSC();
-    s_initialized = true;
+    // Calibration state is written before the release store, so an acquire
+    // load of s_initialized makes all of it visible
+    std::call_once(g_initializeOnce, []() {
+        initializeRDTSC();
+        s_initialized.store(true, std::memory_order_release);
+    });
 }
 
-void HighResTimer::initializeRDTSC() {
+void HighResTimer::setWallClock(WallClock clock) {
+#ifdef __linux__
+    s_wallClockId = (clock == WallClock::TAI) ? CLOCK_TAI : CLOCK_REALTIME;
+#else
+    (void)clock;
+#endif
+}
+
+bool HighResTimer::detectInvariantTSC() {
 #if HAVE_RDTSC
-    // Calibrate RDTSC by comparing with CLOCK_MONOTONIC_RAW
-    // This gives us the TSC frequency and an offset
-    #ifdef __linux__
-    struct timespec ts1, ts2;
-    uint64_t tsc1, tsc2;
-    
-    // Read TSC and wall clock time
-    tsc1 = readTSC();
-    clock_gettime(CLOCK_MONOTONIC_RAW, &ts1);
-    
-    // Wait a bit (100ms) for accurate calibration
-    usleep(100000);
-    
-    tsc2 = readTSC();
-    clock_gettime(CLOCK_MONOTONIC_RAW, &ts2);
-    
-    // Calculate TSC frequency
-    uint64_t tscDiff = tsc2 - tsc1;
-    int64_t timeDiffNanos = (ts2.tv_sec - ts1.tv_sec) * 1000000000LL + 
-                           (ts2.tv_nsec - ts1.tv_nsec);
-    
-    if (tscDiff > 0 && timeDiffNanos > 0) {
-        // Calculate TSC frequency: cycles per nanosecond
-        s_tscFrequencyGHz = static_cast<double>(tscDiff) / static_cast<double>(timeDiffNanos);
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    
+    // Extended leaf 0x80000007 must be supported
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    
+    // Advanced power management: EDX bit 8 = invariant TSC
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (edx & (1U << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+int64_t HighResTimer::readReferenceNanos() {
+#ifdef __linux__
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == 0) {
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + static_cast<int64_t>(ts.tv_nsec);
+    }
+#endif
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+}
+
+int64_t HighResTimer::readWallNanos() {
+#ifdef __linux__
+    struct timespec ts;
+    if (clock_gettime(s_wallClockId, &ts) == 0) {
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + static_cast<int64_t>(ts.tv_nsec);
+    }
+#endif
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+}
+
+int64_t HighResTimer::measureWallOffset(const TscCalibration& calibration) {
+    // Bracket the wall clock read with two local time reads, keep the tightest
+    int64_t bestWidth = INT64_MAX;
+    int64_t offset = 0;
+    for (int i = 0; i < CLOCK_PAIR_SAMPLES; ++i) {
+        int64_t before, after;
+        int64_t wall;
+        if (s_useTsc.load(std::memory_order_relaxed)) {
+            const uint64_t tscBefore = readTSC();
+            wall = readWallNanos();
+            const uint64_t tscAfter = readTSC();
+            auto toLocal = [&calibration](uint64_t tsc) {
+                return calibration.baseNanos + static_cast<int64_t>(
+                    static_cast<double>(static_cast<int64_t>(tsc - calibration.baseTsc)) * calibration.nanosPerCycle);
+            };
+            before = toLocal(tscBefore);
+            after = toLocal(tscAfter);
+        } else {
+            before = readReferenceNanos();
+            wall = readWallNanos();
+            after = readReferenceNanos();
+        }
         
-        // Calculate offset: what wall clock time corresponds to TSC=0?
-        int64_t wallTime1Nanos = ts1.tv_sec * 1000000000LL + ts1.tv_nsec;
-        s_tscOffset = wallTime1Nanos - static_cast<int64_t>(static_cast<double>(tsc1) / s_tscFrequencyGHz);
-    } else {
-        // Fallback: assume 2.5 GHz (common CPU frequency)
-        s_tscFrequencyGHz = 2.5;
-        s_tscOffset = 0;
-    }
-    #else
-    // Non-Linux: assume 2.5 GHz
-    s_tscFrequencyGHz = 2.5;
-    s_tscOffset = 0;
-    #endif
+        const int64_t width = after - before;
+        if (width < bestWidth) {
+            bestWidth = width;
+            offset = wall - (before + width / 2);
+        }
+    }
+    return offset;
+}
+
+void HighResTimer::sampleClockPair(uint64_t& tsc, int64_t& nanos) {
+    // Bracket the clock read with two TSC reads and keep the tightest bracket,
+    // which rejects samples disturbed by interrupts or preemption
+    uint64_t bestWidth = UINT64_MAX;
+    for (int i = 0; i < CLOCK_PAIR_SAMPLES; ++i) {
+        const uint64_t before = readTSC();
+        const int64_t reference = readReferenceNanos();
+        const uint64_t after = readTSC();
+        
+        const uint64_t width = after - before;
+        if (width < bestWidth) {
+            bestWidth = width;
+            tsc = before + width / 2;
+            nanos = reference;
+        }
+    }
+}
+
+void HighResTimer::initializeRDTSC() {
+#if HAVE_RDTSC
+    s_invariantTsc.store(detectInvariantTSC(), std::memory_order_relaxed);
+    
+    // A TSC that changes rate or stops in deep C-states cannot be converted
+    // with a fixed slope: use the vDSO clock instead
+    if (!s_invariantTsc.load(std::memory_order_relaxed)) {
+        std::cerr << "Warning: TSC is not invariant, using clock_gettime(CLOCK_MONOTONIC_RAW)" << std::endl;
+        s_useTsc.store(false, std::memory_order_relaxed);
+        s_tscFrequencyGHz.store(0.0);
+        s_calibration.store(TscCalibration{0, 0, 1.0, measureWallOffset(TscCalibration{})});
+        return;
+    }
+    
+    // Calibrate RDTSC by comparing with CLOCK_MONOTONIC_RAW over 100ms
+    uint64_t tsc1 = 0, tsc2 = 0;
+    int64_t nanos1 = 0, nanos2 = 0;
+    sampleClockPair(tsc1, nanos1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sampleClockPair(tsc2, nanos2);
+    
+    if (tsc2 <= tsc1 || nanos2 <= nanos1) {
+        std::cerr << "Warning: TSC calibration failed, using clock_gettime(CLOCK_MONOTONIC_RAW)" << std::endl;
+        s_useTsc.store(false, std::memory_order_relaxed);
+        s_tscFrequencyGHz.store(0.0);
+        s_calibration.store(TscCalibration{0, 0, 1.0, measureWallOffset(TscCalibration{})});
+        return;
+    }
+    
+    const double nanosPerCycle = static_cast<double>(nanos2 - nanos1) / static_cast<double>(tsc2 - tsc1);
+    TscCalibration calibration{tsc2, nanos2, nanosPerCycle, 0};
+    s_useTsc.store(true, std::memory_order_relaxed);
+    calibration.wallOffsetNanos = measureWallOffset(calibration);
+    s_calibration.store(calibration);
+    s_tscFrequencyGHz.store(1.0 / nanosPerCycle);
+    s_lastErrorNanos.store(0);
+    
+    g_prevSampleTsc = tsc2;
+    g_prevSampleNanos = nanos2;
+    g_smoothedNanosPerCycle = nanosPerCycle;
 #else
     // No RDTSC support
-    s_tscFrequencyGHz = 0.0;
-    s_tscOffset = 0;
+    s_invariantTsc.store(false, std::memory_order_relaxed);
+    s_useTsc.store(false, std::memory_order_relaxed);
+    s_tscFrequencyGHz.store(0.0);
+    s_calibration.store(TscCalibration{0, 0, 1.0, measureWallOffset(TscCalibration{})});
 #endif
 }
 
+void HighResTimer::recalibrate() {
+    // Recalibration only applies to the RDTSC path (unlikely to be disabled)
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    if (UNLIKELY(!s_useTsc.load(std::memory_order_relaxed))) {
+        // Only the wall clock offset needs tracking on the clock_gettime path
+        TscCalibration next = s_calibration.load();
+        next.wallOffsetNanos = measureWallOffset(next);
+        s_calibration.store(next);
+        return;
+    }
+    
+    uint64_t tsc = 0;
+    int64_t reference = 0;
+    sampleClockPair(tsc, reference);
+    
+    const TscCalibration current = s_calibration.load();
+    const int64_t predicted = current.baseNanos + static_cast<int64_t>(
+        static_cast<double>(static_cast<int64_t>(tsc - current.baseTsc)) * current.nanosPerCycle);
+    const int64_t error = reference - predicted;
+    s_lastErrorNanos.store(error, std::memory_order_relaxed);
+    
+    const uint64_t intervalCycles = tsc - g_prevSampleTsc;
+    const int64_t intervalNanos = reference - g_prevSampleNanos;
+    if (intervalCycles == 0 || intervalNanos <= 0) {
+        return;
+    }
+    
+    // Smooth the frequency estimate: each sample carries tens of ns of jitter
+    const double measured = static_cast<double>(intervalNanos) / static_cast<double>(intervalCycles);
+    g_smoothedNanosPerCycle += SLOPE_SMOOTHING * (measured - g_smoothedNanosPerCycle);
+    
+    TscCalibration next;
+    next.baseTsc = tsc;
+    if (UNLIKELY(std::llabs(error) > STEP_THRESHOLD_NANOS)) {
+        // Large error (suspend/resume, VM migration): step to the reference
+        next.baseNanos = reference;
+        next.nanosPerCycle = g_smoothedNanosPerCycle;
+    } else {
+        // Slew: stay continuous now and absorb the error over the next interval
+        const double maxCorrection = g_smoothedNanosPerCycle * MAX_SLEW_FRACTION;
+        double correction = static_cast<double>(error) / static_cast<double>(intervalCycles);
+        correction = std::max(-maxCorrection, std::min(maxCorrection, correction));
+        next.baseNanos = predicted;
+        next.nanosPerCycle = g_smoothedNanosPerCycle + correction;
+    }
+    
+    next.wallOffsetNanos = measureWallOffset(next);
+    s_calibration.store(next);
+    s_tscFrequencyGHz.store(1.0 / g_smoothedNanosPerCycle, std::memory_order_relaxed);
+    g_prevSampleTsc = tsc;
+    g_prevSampleNanos = reference;
+}
+
+void HighResTimer::recalibrationLoop(int64_t intervalMillis) {
+    std::unique_lock<std::mutex> lock(g_recalibrationMutex);
+    while (g_recalibrationRunning) {
+        g_recalibrationCv.wait_for(lock, std::chrono::milliseconds(intervalMillis));
+        if (!g_recalibrationRunning) {
+            break;
+        }
+        lock.unlock();
+        recalibrate();
+        lock.lock();
+    }
+}
+
+void HighResTimer::startRecalibration(int64_t intervalMillis) {
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    if (intervalMillis <= 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(g_recalibrationMutex);
+    if (g_recalibrationRunning) {
+        return;
+    }
+    g_recalibrationRunning = true;
+    g_recalibrationThread = std::thread(&HighResTimer::recalibrationLoop, intervalMillis);
+}
+
+void HighResTimer::stopRecalibration() {
+    {
+        std::lock_guard<std::mutex> lock(g_recalibrationMutex);
+        g_recalibrationRunning = false;
+    }
+    g_recalibrationCv.notify_all();
+    
+    if (g_recalibrationThread.joinable()) {
+        g_recalibrationThread.join();
+    }
+}
+
+bool HighResTimer::isInvariantTSC() {
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    return s_invariantTsc.load(std::memory_order_relaxed);
+}
+
+bool HighResTimer::isUsingTSC() {
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    return s_useTsc.load(std::memory_order_relaxed);
+}
+
+double HighResTimer::getTscFrequencyGHz() {
+    return s_tscFrequencyGHz.load(std::memory_order_relaxed);
+}
+
+int64_t HighResTimer::getClockErrorNanos() {
+    return s_lastErrorNanos.load(std::memory_order_relaxed);
+}
+
 uint64_t HighResTimer::nowCycles() {
 #if HAVE_RDTSC
     // Initialization check - unlikely after first call
-    if (UNLIKELY(!s_initialized)) {
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
         initialize();
     }
-    return readTSC();
-#else
-    return 0;
+    // RDTSC in use is likely on x86/x86_64
+    if (LIKELY(s_useTsc.load(std::memory_order_relaxed))) {
+        return readTSC();
+    }
 #endif
+    // No usable TSC: hand out nanoseconds so cycle deltas remain meaningful
+    return static_cast<uint64_t>(nowNanos());
 }
 
 int64_t HighResTimer::cyclesToNanos(uint64_t cycles) {
 #if HAVE_RDTSC
     // Initialization check - unlikely after first call
-    if (UNLIKELY(!s_initialized)) {
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
         initialize();
     }
-    // RDTSC available is likely on x86/x86_64
-    if (LIKELY(s_tscFrequencyGHz > 0.0)) {
-        // Convert cycles to nanoseconds: cycles / (cycles per nanosecond)
-        return static_cast<int64_t>(static_cast<double>(cycles) / s_tscFrequencyGHz);
+    // RDTSC in use is likely on x86/x86_64
+    if (LIKELY(s_useTsc.load(std::memory_order_relaxed))) {
+        // Convert cycles to nanoseconds with the current slope
+        return static_cast<int64_t>(static_cast<double>(cycles) * s_calibration.load().nanosPerCycle);
     }
 #endif
-    return 0;
+    // nowCycles() returns nanoseconds when RDTSC is not used
+    return static_cast<int64_t>(cycles);
 }
 
 int64_t HighResTimer::nowNanos() {
 #if HAVE_RDTSC
     // Initialization check - unlikely after first call
-    if (UNLIKELY(!s_initialized)) {
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
         initialize();
     }
     
-    // RDTSC available is likely on x86/x86_64
-    if (LIKELY(s_tscFrequencyGHz > 0.0)) {
-        // Use RDTSC for ultra-low latency (no system call)
-        uint64_t cycles = readTSC();
-        return static_cast<int64_t>(static_cast<double>(cycles) / s_tscFrequencyGHz) + s_tscOffset;
+    // RDTSC in use is likely on x86/x86_64
+    if (LIKELY(s_useTsc.load(std::memory_order_relaxed))) {
+        // Use RDTSC for ultra-low latency (no system call, lock-free seqlock read).
+        // Read the calibration first so the TSC sample is never older than its base.
+        const TscCalibration calibration = s_calibration.load();
+        const uint64_t cycles = readTSC();
+        return calibration.baseNanos + static_cast<int64_t>(
+            static_cast<double>(static_cast<int64_t>(cycles - calibration.baseTsc)) * calibration.nanosPerCycle);
     }
 #endif
 
     // Fallback to clock_gettime
 #ifdef __linux__
     struct timespec ts;
-    // Use CLOCK_MONOTONIC_RAW for maximum precision without NTP adjustments
+    // Use CLOCK_MONOTONIC_RAW (served from the vDSO) for maximum precision without NTP adjustments
     if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == 0) {
         return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + static_cast<int64_t>(ts.tv_nsec);
     }
@@ -141,6 +407,43 @@ int64_t HighResTimer::nowNanos() {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
 }
 
+int64_t HighResTimer::nowWallNanos() {
+#if HAVE_RDTSC
+    // Initialization check - unlikely after first call
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    
+    // RDTSC in use is likely on x86/x86_64
+    if (LIKELY(s_useTsc.load(std::memory_order_relaxed))) {
+        const TscCalibration calibration = s_calibration.load();
+        const uint64_t cycles = readTSC();
+        return calibration.baseNanos + calibration.wallOffsetNanos + static_cast<int64_t>(
+            static_cast<double>(static_cast<int64_t>(cycles - calibration.baseTsc)) * calibration.nanosPerCycle);
+    }
+#endif
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    return nowNanos() + s_calibration.load().wallOffsetNanos;
+}
+
+int64_t HighResTimer::cyclesToWallNanos(uint64_t cycles) {
+    // Initialization check - unlikely after first call
+    if (UNLIKELY(!s_initialized.load(std::memory_order_acquire))) {
+        initialize();
+    }
+    
+    const TscCalibration calibration = s_calibration.load();
+    // RDTSC in use is likely on x86/x86_64
+    if (LIKELY(s_useTsc.load(std::memory_order_relaxed))) {
+        return calibration.baseNanos + calibration.wallOffsetNanos + static_cast<int64_t>(
+            static_cast<double>(static_cast<int64_t>(cycles - calibration.baseTsc)) * calibration.nanosPerCycle);
+    }
+    // nowCycles() returns reference nanoseconds when RDTSC is not used
+    return static_cast<int64_t>(cycles) + calibration.wallOffsetNanos;
+}
+
 int64_t HighResTimer::nowMicros() {
     return nanosToMicros(nowNanos());
 }
@@ -178,10 +481,11 @@ void HighResTimer::sleepNanos(int64_t nanos) {
     // Short sleeps are likely in HFT applications
     if (LIKELY(nanos < 10000)) { // Less than 10 microseconds
 #if HAVE_RDTSC
-        // RDTSC available is likely on x86/x86_64
-        if (LIKELY(s_tscFrequencyGHz > 0.0)) {
+        // RDTSC in use is likely on x86/x86_64
+        if (LIKELY(s_useTsc.load(std::memory_order_relaxed))) {
             // Use RDTSC for precise busy-wait
-            uint64_t targetCycles = static_cast<uint64_t>(static_cast<double>(nanos) * s_tscFrequencyGHz);
+            uint64_t targetCycles = static_cast<uint64_t>(
+                static_cast<double>(nanos) * s_tscFrequencyGHz.load(std::memory_order_relaxed));
             uint64_t startCycles = readTSC();
             uint64_t target = startCycles + targetCycles;
             
@@ -224,11 +528,21 @@ void HighResTimer::sleepMicros(int64_t micros) {
 
 ScopedTimer::ScopedTimer(const char* label)
     : m_start(HighResTimer::nowNanos())
-    , m_label(label) {
+    , m_label(label)
+    , m_histogram(nullptr) {
+}
+
+ScopedTimer::ScopedTimer(LatencyHistogram& histogram)
+    : m_start(HighResTimer::nowNanos())
+    , m_label(nullptr)
+    , m_histogram(&histogram) {
 }
 
 ScopedTimer::~ScopedTimer() {
-    if (m_label) {
+    // Histogram mode is the hot-path use: no I/O
+    if (LIKELY(m_histogram != nullptr)) {
+        m_histogram->recordSigned(elapsedNanos());
+    } else if (m_label) {
         int64_t elapsed = elapsedMicros();
         std::cout << "[ScopedTimer] " << m_label << ": " << elapsed << " us" << std::endl;
     }
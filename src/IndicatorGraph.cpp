@@ -0,0 +1,349 @@
+/**
+ * @file IndicatorGraph.cpp
+ * @brief Implementation of the shared indicator graph
+ */
+
+#include "IndicatorGraph.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include "BranchPrediction.h"
+
+namespace {
+
+// Sma state layout: running sums, fill count, ring position, reference, then the ring
+constexpr uint32_t SMA_SUM = 0;
+constexpr uint32_t SMA_SUM_SQ = 1;
+constexpr uint32_t SMA_COUNT = 2;
+constexpr uint32_t SMA_POS = 3;
+constexpr uint32_t SMA_REFERENCE = 4;
+constexpr uint32_t SMA_RING = 5;
+
+/**
+ * @brief State doubles a node needs
+ */
+uint32_t stateSize(IndicatorOp op, uint32_t period) {
+    switch (op) {
+        case IndicatorOp::Ema:
+        case IndicatorOp::Wilder:
+            return 1;   // Seeded flag
+        case IndicatorOp::Sma:
+            return SMA_RING + period;
+        case IndicatorOp::Delta:
+        case IndicatorOp::TrueRange:
+            return 2;   // Previous value, has previous
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+IndicatorGraph::IndicatorGraph()
+    : m_samples(0) {
+}
+
+uint32_t IndicatorGraph::node(IndicatorOp op, uint32_t a, uint32_t b, uint32_t c,
+                              uint32_t period, double param) {
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const Node& existing = m_nodes[i];
+        if (existing.op == op && existing.a == a && existing.b == b && existing.c == c &&
+            existing.period == period && existing.param == param) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+
+    auto warmupOf = [this](uint32_t input) { return input == NONE ? 0u : m_nodes[input].warmup; };
+    const uint32_t inputs = std::max({warmupOf(a), warmupOf(b), warmupOf(c)});
+    Node added{op, a, b, c, period, param, static_cast<uint32_t>(m_state.size()), 1};
+    switch (op) {
+        case IndicatorOp::Ema:
+        case IndicatorOp::Wilder:
+        case IndicatorOp::Sma:
+            added.warmup = inputs + period - 1;
+            break;
+        case IndicatorOp::Delta:
+        case IndicatorOp::TrueRange:
+            added.warmup = inputs + 1;
+            break;
+        case IndicatorOp::Close:
+        case IndicatorOp::High:
+        case IndicatorOp::Low:
+            break;
+        default:
+            added.warmup = inputs;
+            break;
+    }
+    m_state.resize(m_state.size() + stateSize(op, period), 0.0);
+    m_nodes.push_back(added);
+    m_values.push_back(0.0);
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void IndicatorGraph::output(const std::string& name, uint32_t node) {
+    m_outputs.push_back(Output{name, node});
+}
+
+bool IndicatorGraph::addIndicator(const std::string& name, const std::vector<double>& args) {
+    // Defaults per indicator; periods must be whole and positive
+    std::vector<double> values = args;
+    auto defaults = [&values](std::initializer_list<double> list) {
+        size_t i = 0;
+        for (double value : list) {
+            if (i++ >= values.size()) {
+                values.push_back(value);
+            }
+        }
+        return values.size() == list.size();
+    };
+    auto period = [&values](size_t i) -> uint32_t {
+        const double value = values[i];
+        return value >= 1.0 && value == std::floor(value) && value < 1000000.0 ? static_cast<uint32_t>(value) : 0;
+    };
+
+    bool valid;
+    if (name == "ema" || name == "sma" || name == "rsi" || name == "atr") {
+        valid = defaults({14}) && period(0) != 0;
+    } else if (name == "macd") {
+        valid = defaults({12, 26, 9}) && period(0) != 0 && period(1) != 0 && period(2) != 0;
+    } else if (name == "cross") {
+        valid = defaults({12, 26}) && period(0) != 0 && period(1) != 0;
+    } else if (name == "bb" || name == "bollinger") {
+        valid = defaults({20, 2}) && period(0) != 0 && values[1] > 0.0;
+    } else {
+        std::cerr << "Error: unknown indicator: " << name << std::endl;
+        return false;
+    }
+    if (!valid) {
+        std::cerr << "Error: invalid arguments for indicator: " << name << std::endl;
+        return false;
+    }
+
+    std::ostringstream label;
+    label << name << "(";
+    for (size_t i = 0; i < values.size(); ++i) {
+        label << (i > 0 ? "," : "") << values[i];
+    }
+    label << ")";
+    const std::string prefix = label.str();
+
+    const uint32_t close = node(IndicatorOp::Close);
+    if (name == "ema") {
+        output(prefix, node(IndicatorOp::Ema, close, NONE, NONE, period(0)));
+    } else if (name == "sma") {
+        output(prefix, node(IndicatorOp::Sma, close, NONE, NONE, period(0)));
+    } else if (name == "macd") {
+        const uint32_t fast = node(IndicatorOp::Ema, close, NONE, NONE, period(0));
+        const uint32_t slow = node(IndicatorOp::Ema, close, NONE, NONE, period(1));
+        const uint32_t line = node(IndicatorOp::Sub, fast, slow);
+        const uint32_t signal = node(IndicatorOp::Ema, line, NONE, NONE, period(2));
+        output(prefix, line);
+        output(prefix + ".signal", signal);
+        output(prefix + ".hist", node(IndicatorOp::Sub, line, signal));
+    } else if (name == "cross") {
+        const uint32_t fast = node(IndicatorOp::Ema, close, NONE, NONE, period(0));
+        const uint32_t slow = node(IndicatorOp::Ema, close, NONE, NONE, period(1));
+        output(prefix, node(IndicatorOp::Sign, node(IndicatorOp::Sub, fast, slow)));
+    } else if (name == "rsi") {
+        const uint32_t delta = node(IndicatorOp::Delta, close);
+        const uint32_t gain = node(IndicatorOp::Wilder, node(IndicatorOp::Gain, delta), NONE, NONE, period(0));
+        const uint32_t loss = node(IndicatorOp::Wilder, node(IndicatorOp::Loss, delta), NONE, NONE, period(0));
+        output(prefix, node(IndicatorOp::Rsi, gain, loss));
+    } else if (name == "bb" || name == "bollinger") {
+        const uint32_t middle = node(IndicatorOp::Sma, close, NONE, NONE, period(0));
+        const uint32_t deviation = node(IndicatorOp::StdDev, middle);
+        output(prefix + ".upper", node(IndicatorOp::AddScaled, middle, deviation, NONE, 0, values[1]));
+        output(prefix + ".middle", middle);
+        output(prefix + ".lower", node(IndicatorOp::AddScaled, middle, deviation, NONE, 0, -values[1]));
+    } else {
+        const uint32_t range = node(IndicatorOp::TrueRange, node(IndicatorOp::High), node(IndicatorOp::Low), close);
+        output(prefix, node(IndicatorOp::Wilder, range, NONE, NONE, period(0)));
+    }
+    return true;
+}
+
+bool IndicatorGraph::configure(const std::string& spec) {
+    m_nodes.clear();
+    m_values.clear();
+    m_state.clear();
+    m_outputs.clear();
+    m_samples = 0;
+
+    // Split on commas outside parentheses: "macd(12,26,9),rsi(14)"
+    size_t start = 0;
+    int depth = 0;
+    for (size_t i = 0; i <= spec.size(); ++i) {
+        if (i < spec.size() && spec[i] != ',') {
+            depth += spec[i] == '(' ? 1 : spec[i] == ')' ? -1 : 0;
+            continue;
+        }
+        if (i < spec.size() && depth > 0) {
+            continue;
+        }
+
+        std::string item = spec.substr(start, i - start);
+        start = i + 1;
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        std::transform(item.begin(), item.end(), item.begin(), ::tolower);
+
+        std::vector<double> args;
+        const size_t open = item.find('(');
+        const std::string name = item.substr(0, open);
+        if (open != std::string::npos) {
+            if (item.back() != ')') {
+                std::cerr << "Error: malformed indicator: " << item << std::endl;
+                return false;
+            }
+            const std::string list = item.substr(open + 1, item.size() - open - 2);
+            size_t argStart = 0;
+            while (argStart < list.size()) {
+                size_t comma = list.find(',', argStart);
+                if (comma == std::string::npos) {
+                    comma = list.size();
+                }
+                const std::string arg = list.substr(argStart, comma - argStart);
+                char* end = nullptr;
+                const double value = std::strtod(arg.c_str(), &end);
+                if (arg.empty() || *end != '\0') {
+                    std::cerr << "Error: malformed indicator argument: " << item << std::endl;
+                    return false;
+                }
+                args.push_back(value);
+                argStart = comma + 1;
+            }
+        }
+        if (!addIndicator(name, args)) {
+            return false;
+        }
+    }
+
+    if (m_outputs.size() > IndicatorSnapshot::MAX_OUTPUTS) {
+        std::cerr << "Error: too many indicator outputs (" << m_outputs.size() << ", max "
+                  << IndicatorSnapshot::MAX_OUTPUTS << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void IndicatorGraph::update(double high, double low, double close) {
+    m_samples++;
+    double* values = m_values.data();
+    for (const Node& n : m_nodes) {
+        double* state = m_state.data() + n.state;
+        double& out = values[&n - m_nodes.data()];
+        switch (n.op) {
+            case IndicatorOp::Close:
+                out = close;
+                break;
+            case IndicatorOp::High:
+                out = high;
+                break;
+            case IndicatorOp::Low:
+                out = low;
+                break;
+            case IndicatorOp::Ema:
+            case IndicatorOp::Wilder: {
+                const double input = values[n.a];
+                // First sample seeds the average (unlikely after startup)
+                if (UNLIKELY(state[0] == 0.0)) {
+                    out = input;
+                    state[0] = 1.0;
+                } else {
+                    const double alpha = n.op == IndicatorOp::Ema ? 2.0 / (n.period + 1.0) : 1.0 / n.period;
+                    out += alpha * (input - out);
+                }
+                break;
+            }
+            case IndicatorOp::Sma: {
+                // Values relative to the first sample keep the sum of squares well conditioned
+                if (UNLIKELY(state[SMA_COUNT] == 0.0)) {
+                    state[SMA_REFERENCE] = values[n.a];
+                }
+                const double x = values[n.a] - state[SMA_REFERENCE];
+                double* ring = state + SMA_RING;
+                const uint32_t pos = static_cast<uint32_t>(state[SMA_POS]);
+                if (LIKELY(state[SMA_COUNT] == n.period)) {
+                    state[SMA_SUM] -= ring[pos];
+                    state[SMA_SUM_SQ] -= ring[pos] * ring[pos];
+                } else {
+                    state[SMA_COUNT] += 1.0;
+                }
+                ring[pos] = x;
+                state[SMA_SUM] += x;
+                state[SMA_SUM_SQ] += x * x;
+                const uint32_t next = pos + 1 == n.period ? 0 : pos + 1;
+                state[SMA_POS] = next;
+                // Once per period, resum the ring so add/remove rounding cannot accumulate
+                if (UNLIKELY(next == 0)) {
+                    double sum = 0.0, sumSq = 0.0;
+                    for (uint32_t i = 0; i < n.period; ++i) {
+                        sum += ring[i];
+                        sumSq += ring[i] * ring[i];
+                    }
+                    state[SMA_SUM] = sum;
+                    state[SMA_SUM_SQ] = sumSq;
+                }
+                out = state[SMA_REFERENCE] + state[SMA_SUM] / state[SMA_COUNT];
+                break;
+            }
+            case IndicatorOp::StdDev: {
+                const double* sma = m_state.data() + m_nodes[n.a].state;
+                const double count = sma[SMA_COUNT];
+                const double mean = sma[SMA_SUM] / count;
+                out = std::sqrt(std::max(sma[SMA_SUM_SQ] / count - mean * mean, 0.0));
+                break;
+            }
+            case IndicatorOp::Delta:
+            case IndicatorOp::TrueRange: {
+                const double current = n.op == IndicatorOp::Delta ? values[n.a] : values[n.c];
+                const double previous = state[1] != 0.0 ? state[0] : current;
+                if (n.op == IndicatorOp::Delta) {
+                    out = current - previous;
+                } else {
+                    out = std::max(values[n.a], previous) - std::min(values[n.b], previous);
+                }
+                state[0] = current;
+                state[1] = 1.0;
+                break;
+            }
+            case IndicatorOp::Gain:
+                out = std::max(values[n.a], 0.0);
+                break;
+            case IndicatorOp::Loss:
+                out = std::max(-values[n.a], 0.0);
+                break;
+            case IndicatorOp::Sub:
+                out = values[n.a] - values[n.b];
+                break;
+            case IndicatorOp::AddScaled:
+                out = values[n.a] + n.param * values[n.b];
+                break;
+            case IndicatorOp::Rsi: {
+                const double gain = values[n.a];
+                const double loss = values[n.b];
+                out = loss > 0.0 ? 100.0 - 100.0 / (1.0 + gain / loss) : (gain > 0.0 ? 100.0 : 50.0);
+                break;
+            }
+            case IndicatorOp::Sign:
+                out = values[n.a] > 0.0 ? 1.0 : (values[n.a] < 0.0 ? -1.0 : 0.0);
+                break;
+        }
+    }
+}
+
+IndicatorSnapshot IndicatorGraph::snapshot() const {
+    IndicatorSnapshot result;
+    result.count = m_outputs.size();
+    for (size_t i = 0; i < m_outputs.size(); ++i) {
+        const Node& n = m_nodes[m_outputs[i].node];
+        result.values[i] = m_values[m_outputs[i].node];
+        result.ready[i] = m_samples >= n.warmup;
+    }
+    return result;
+}
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
+#include "BranchPrediction.h"
 
 bool JSONParser::parseTickerMessage(const std::string& jsonString, TickerData& tickerData) {
     try {
@@ -20,6 +22,7 @@ bool JSONParser::parseTickerMessage(const std::string& jsonString, TickerData& t
         // Parse all fields
         tickerData.type = getStringValue(json, "type");
         tickerData.sequence = getStringValue(json, "sequence");
+        tickerData.sequence_number = getUInt64Value(json, "sequence");
         tickerData.product_id = getStringValue(json, "product_id");
         tickerData.price = getStringValue(json, "price");
         tickerData.open_24h = getStringValue(json, "open_24h");
@@ -37,8 +40,13 @@ bool JSONParser::parseTickerMessage(const std::string& jsonString, TickerData& t
         // Calculate mid-price
         tickerData.mid_price = tickerData.calculateMidPrice();
         
-        // Parse timestamp
-        tickerData.timestamp = parseTimestamp(tickerData.time);
+        // Parse timestamp (exchange time, UTC)
+        tickerData.exchange_time_ns = parseTimestampNanos(tickerData.time);
+        tickerData.timestamp = tickerData.exchange_time_ns != 0
+            ? std::chrono::system_clock::time_point(
+                  std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                      std::chrono::nanoseconds(tickerData.exchange_time_ns)))
+            : parseTimestamp(tickerData.time);
         
         return true;
     } catch (const std::exception& e) {
@@ -48,14 +56,159 @@ bool JSONParser::parseTickerMessage(const std::string& jsonString, TickerData& t
 }
 
 std::string JSONParser::createSubscriptionMessage(const std::string& productId) {
+    return createSubscriptionMessage(std::vector<std::string>{productId}, std::vector<std::string>{"ticker"});
+}
+
+std::string JSONParser::createSubscriptionMessage(const std::vector<std::string>& productIds,
+                                                  const std::vector<std::string>& channels) {
     nlohmann::json subscription;
     subscription["type"] = "subscribe";
-    subscription["product_ids"] = nlohmann::json::array({productId});
-    subscription["channels"] = nlohmann::json::array({"ticker"});
+    subscription["product_ids"] = productIds;
+    subscription["channels"] = channels;
     
     return subscription.dump();
 }
 
+FeedMessageType JSONParser::getMessageType(const std::string& message) {
+    // Coinbase puts "type" first, so this is usually a match at offset 1
+    size_t pos = message.find("\"type\"");
+    if (UNLIKELY(pos == std::string::npos)) {
+        return FeedMessageType::Other;
+    }
+    pos += 6;
+    while (pos < message.size() && (message[pos] == ' ' || message[pos] == ':')) {
+        ++pos;
+    }
+    if (UNLIKELY(pos >= message.size() || message[pos] != '"')) {
+        return FeedMessageType::Other;
+    }
+    const size_t start = pos + 1;
+    const size_t end = message.find('"', start);
+    if (UNLIKELY(end == std::string::npos)) {
+        return FeedMessageType::Other;
+    }
+    
+    const char* type = message.data() + start;
+    const size_t length = end - start;
+    auto is = [type, length](const char* name) {
+        return std::strlen(name) == length && std::memcmp(type, name, length) == 0;
+    };
+    if (LIKELY(is("ticker"))) return FeedMessageType::Ticker;
+    if (is("l2update")) return FeedMessageType::L2Update;
+    if (is("snapshot")) return FeedMessageType::Snapshot;
+    if (is("match") || is("last_match")) return FeedMessageType::Match;
+    if (is("heartbeat")) return FeedMessageType::Heartbeat;
+    if (is("subscriptions")) return FeedMessageType::Subscriptions;
+    if (is("error")) return FeedMessageType::Error;
+    return FeedMessageType::Other;
+}
+
+bool JSONParser::parseFixedPoint(const char* text, size_t length, int64_t& value) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < length && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+    
+    int64_t integer = 0;
+    size_t digits = 0;
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; ++i, ++digits) {
+        integer = integer * 10 + (text[i] - '0');
+    }
+    
+    int64_t fraction = 0;
+    int64_t scale = OrderBook::SCALE;
+    if (i < length && text[i] == '.') {
+        for (++i; i < length && text[i] >= '0' && text[i] <= '9'; ++i, ++digits) {
+            // Digits beyond 1e-8 are truncated
+            if (scale > 1) {
+                scale /= 10;
+                fraction = fraction * 10 + (text[i] - '0');
+            }
+        }
+    }
+    if (UNLIKELY(digits == 0 || i != length)) {
+        return false;
+    }
+    
+    const int64_t fixed = integer * OrderBook::SCALE + fraction * scale;
+    value = negative ? -fixed : fixed;
+    return true;
+}
+
+bool JSONParser::parseLevel2Message(const std::string& jsonString, Level2Message& message) {
+    try {
+        nlohmann::json json = nlohmann::json::parse(jsonString);
+        
+        const std::string type = getStringValue(json, "type");
+        message.snapshot = type == "snapshot";
+        if (!message.snapshot && type != "l2update") {
+            return false;
+        }
+        message.product_id = getStringValue(json, "product_id");
+        message.exchange_time_ns = parseTimestampNanos(getStringValue(json, "time"));
+        message.changes.clear();
+        
+        // Both layouts carry [price, size] strings; l2update prefixes the side
+        auto addLevel = [&message](BookSide side, const nlohmann::json& price, const nlohmann::json& size) {
+            const std::string& priceText = price.get_ref<const std::string&>();
+            const std::string& sizeText = size.get_ref<const std::string&>();
+            BookChange change;
+            change.side = side;
+            if (parseFixedPoint(priceText.data(), priceText.size(), change.price) &&
+                parseFixedPoint(sizeText.data(), sizeText.size(), change.size)) {
+                message.changes.push_back(change);
+            }
+        };
+        
+        if (message.snapshot) {
+            for (const auto& level : json.value("bids", nlohmann::json::array())) {
+                addLevel(BookSide::Bid, level.at(0), level.at(1));
+            }
+            for (const auto& level : json.value("asks", nlohmann::json::array())) {
+                addLevel(BookSide::Ask, level.at(0), level.at(1));
+            }
+        } else {
+            for (const auto& change : json.value("changes", nlohmann::json::array())) {
+                const std::string& side = change.at(0).get_ref<const std::string&>();
+                addLevel(side == "buy" ? BookSide::Bid : BookSide::Ask, change.at(1), change.at(2));
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Level2 parsing error: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool JSONParser::parseTradeMessage(const std::string& jsonString, TradeData& trade) {
+    try {
+        nlohmann::json json = nlohmann::json::parse(jsonString);
+        
+        const std::string type = getStringValue(json, "type");
+        if (type != "match" && type != "last_match") {
+            return false;
+        }
+        
+        const std::string& priceText = json.at("price").get_ref<const std::string&>();
+        const std::string& sizeText = json.at("size").get_ref<const std::string&>();
+        if (UNLIKELY(!parseFixedPoint(priceText.data(), priceText.size(), trade.price) ||
+                     !parseFixedPoint(sizeText.data(), sizeText.size(), trade.size))) {
+            return false;
+        }
+        trade.product_id = getStringValue(json, "product_id");
+        trade.trade_id = getUInt64Value(json, "trade_id");
+        trade.sequence_number = getUInt64Value(json, "sequence");
+        trade.maker_side = getStringValue(json, "side") == "buy" ? BookSide::Bid : BookSide::Ask;
+        trade.exchange_time_ns = parseTimestampNanos(getStringValue(json, "time"));
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Trade parsing error: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool JSONParser::isTickerMessage(const std::string& jsonString) {
     try {
         nlohmann::json json = nlohmann::json::parse(jsonString);
@@ -86,6 +239,24 @@ std::string JSONParser::getStringValue(const nlohmann::json& json,
     return defaultValue;
 }
 
+uint64_t JSONParser::getUInt64Value(const nlohmann::json& json, 
+                                    const std::string& key, 
+                                    uint64_t defaultValue) {
+    try {
+        if (json.contains(key)) {
+            // Read integers directly; going through double loses precision above 2^53
+            if (json[key].is_number_unsigned() || json[key].is_number_integer()) {
+                return json[key].get<uint64_t>();
+            } else if (json[key].is_string()) {
+                return std::stoull(json[key].get<std::string>());
+            }
+        }
+    } catch (const std::exception&) {
+        // Return default value on any error
+    }
+    return defaultValue;
+}
+
 double JSONParser::getDoubleValue(const nlohmann::json& json, 
                                 const std::string& key, 
                                 double defaultValue) {
@@ -103,6 +274,75 @@ double JSONParser::getDoubleValue(const nlohmann::json& json,
     return defaultValue;
 }
 
+namespace {
+/**
+ * @brief Parse a fixed number of decimal digits
+ * @return Parsed value, or -1 if a non-digit is found
+ */
+inline int parseDigits(const char* p, int count) {
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        const unsigned digit = static_cast<unsigned>(p[i] - '0');
+        if (digit > 9) {
+            return -1;
+        }
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return value;
+}
+
+/**
+ * @brief Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+ */
+inline int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;
+    const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+}
+
+int64_t JSONParser::parseTimestampNanos(const std::string& timeString) {
+    // Expected layout: YYYY-MM-DDTHH:MM:SS[.fffffffff]Z
+    if (timeString.size() < 19) {
+        return 0;
+    }
+    const char* p = timeString.c_str();
+    if (p[4] != '-' || p[7] != '-' || (p[10] != 'T' && p[10] != ' ') || p[13] != ':' || p[16] != ':') {
+        return 0;
+    }
+    
+    const int year = parseDigits(p, 4);
+    const int month = parseDigits(p + 5, 2);
+    const int day = parseDigits(p + 8, 2);
+    const int hour = parseDigits(p + 11, 2);
+    const int minute = parseDigits(p + 14, 2);
+    const int second = parseDigits(p + 17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return 0;
+    }
+    
+    // Optional fraction, up to nanosecond precision (extra digits are ignored)
+    int64_t fractionNanos = 0;
+    size_t pos = 19;
+    if (pos < timeString.size() && p[pos] == '.') {
+        ++pos;
+        int64_t scale = 100000000;
+        while (pos < timeString.size() && p[pos] >= '0' && p[pos] <= '9') {
+            fractionNanos += (p[pos] - '0') * scale;
+            scale /= 10;
+            ++pos;
+        }
+    }
+    
+    const int64_t days = daysFromCivil(year, month, day);
+    const int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    return seconds * 1000000000LL + fractionNanos;
+}
+
 std::chrono::system_clock::time_point JSONParser::parseTimestamp(const std::string& timeString) {
     try {
         // Parse ISO 8601 timestamp (e.g., "2024-01-01T12:00:00.000Z")
@@ -0,0 +1,186 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Implementation of lock-free log-linear latency histogram
+ */
+
+#include "LatencyHistogram.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) noexcept {
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<uint64_t>(index);
+    }
+
+    // Invert bucketIndex(): block number gives the shift, remainder the mantissa
+    const uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+    const uint64_t mantissa = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+    const uint64_t lower = mantissa << shift;
+    return lower + (1ULL << shift) - 1;
+}
+
+uint64_t LatencyHistogram::getCount() const noexcept {
+    return m_totalCount.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMax() const noexcept {
+    return m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    // Take a local copy so the total and the buckets are consistent with each other
+    std::array<uint64_t, BUCKET_COUNT> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    const uint64_t maxValue = getMax();
+    const uint64_t rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total))));
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        cumulative += counts[i];
+        if (cumulative >= rank) {
+            return std::min(bucketUpperBound(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+LatencySummary LatencyHistogram::summarize() const {
+    LatencySummary summary;
+
+    std::array<uint64_t, BUCKET_COUNT> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    summary.count = total;
+    summary.max = getMax();
+    if (total == 0) {
+        return summary;
+    }
+    summary.mean = static_cast<double>(m_sum.load(std::memory_order_relaxed)) /
+                   static_cast<double>(m_totalCount.load(std::memory_order_relaxed));
+
+    const uint64_t rank50 = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(0.50 * total)));
+    const uint64_t rank99 = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(0.99 * total)));
+    const uint64_t rank999 = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(0.999 * total)));
+
+    // Single pass over the buckets for all three percentiles
+    uint64_t cumulative = 0;
+    bool have50 = false, have99 = false;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        cumulative += counts[i];
+        const uint64_t value = std::min(bucketUpperBound(i), summary.max);
+        if (!have50 && cumulative >= rank50) {
+            summary.p50 = value;
+            have50 = true;
+        }
+        if (!have99 && cumulative >= rank99) {
+            summary.p99 = value;
+            have99 = true;
+        }
+        if (cumulative >= rank999) {
+            summary.p999 = value;
+            break;
+        }
+    }
+
+    return summary;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        const uint64_t count = other.m_counts[i].load(std::memory_order_relaxed);
+        if (count != 0) {
+            m_counts[i].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    m_totalCount.fetch_add(other.m_totalCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    const uint64_t otherMax = other.getMax();
+    uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+    while (otherMax > currentMax &&
+           !m_max.compare_exchange_weak(currentMax, otherMax, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() noexcept {
+    for (auto& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    m_totalCount.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+const char* PipelineLatency::stageName(LatencyStage stage) noexcept {
+    switch (stage) {
+        case LatencyStage::ExchangeToReceive: return "exchange->recv";
+        case LatencyStage::ReceiveToParse: return "recv->parse";
+        case LatencyStage::ParseToEnqueue: return "parse->enqueue";
+        case LatencyStage::DequeueToEMA:   return "dequeue->ema";
+        case LatencyStage::EMAToLogWrite:  return "ema->write";
+        case LatencyStage::ReceiveToBook:  return "recv->book";
+        default:                           return "unknown";
+    }
+}
+
+std::string PipelineLatency::report() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "Stage latency (us):" << std::endl;
+    oss << "  " << std::left << std::setw(16) << "stage"
+        << std::right << std::setw(12) << "count"
+        << std::setw(12) << "mean"
+        << std::setw(12) << "p50"
+        << std::setw(12) << "p99"
+        << std::setw(12) << "p99.9"
+        << std::setw(12) << "max" << std::endl;
+
+    for (size_t i = 0; i < static_cast<size_t>(LatencyStage::Count); ++i) {
+        const LatencyStage s = static_cast<LatencyStage>(i);
+        const LatencySummary summary = stage(s).summarize();
+        oss << "  " << std::left << std::setw(16) << stageName(s)
+            << std::right << std::setw(12) << summary.count
+            << std::setw(12) << summary.mean / 1000.0
+            << std::setw(12) << summary.p50 / 1000.0
+            << std::setw(12) << summary.p99 / 1000.0
+            << std::setw(12) << summary.p999 / 1000.0
+            << std::setw(12) << summary.max / 1000.0 << std::endl;
+    }
+    return oss.str();
+}
+
+void PipelineLatency::merge(const PipelineLatency& other) noexcept {
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        m_stages[i].merge(other.m_stages[i]);
+    }
+}
+
+void PipelineLatency::reset() noexcept {
+    for (auto& histogram : m_stages) {
+        histogram.reset();
+    }
+}
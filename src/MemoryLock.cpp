@@ -0,0 +1,152 @@
+/**
+ * @file MemoryLock.cpp
+ * @brief Implementation of memory locking, pre-faulting and residency reporting
+ */
+
+#include "MemoryLock.h"
+
+#ifdef __linux__
+
+#include "NUMAUtils.h"
+#include <alloca.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+namespace {
+    std::atomic<bool> g_locked{false};
+    /// CAP_IPC_LOCK from linux/capability.h
+    constexpr unsigned CAP_IPC_LOCK_BIT = 14;
+
+    /**
+     * @brief Read a "Name:   1234 kB" field of /proc/self/status
+     * @return Value in bytes (0 if missing)
+     */
+    uint64_t readStatusBytes(const std::string& status, const char* field) {
+        const size_t at = status.find(field);
+        if (at == std::string::npos) {
+            return 0;
+        }
+        return std::strtoull(status.c_str() + at + std::strlen(field), nullptr, 10) * 1024;
+    }
+
+    std::string mebibytes(uint64_t bytes) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MiB";
+        return oss.str();
+    }
+
+    /**
+     * @brief Check CAP_IPC_LOCK in the effective capability set (exempts from RLIMIT_MEMLOCK)
+     */
+    bool hasIpcLock() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 7, "CapEff:") == 0) {
+                const uint64_t capabilities = std::strtoull(line.c_str() + 7, nullptr, 16);
+                return (capabilities >> CAP_IPC_LOCK_BIT) & 1;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Touch stack pages in a frame below the caller's
+     */
+    __attribute__((noinline)) void touchStack(size_t bytes) {
+        char* stack = static_cast<char*>(alloca(bytes));
+        NUMAUtils::touchMemory(stack, bytes);
+        // Keep the frame (and the touches) from being optimized away
+        asm volatile("" : : "r"(stack) : "memory");
+    }
+}
+
+bool MemoryLock::lockAll() {
+    // With MCL_FUTURE a limited RLIMIT_MEMLOCK turns later allocations into failures
+    // (malloc, thread stacks), so only lock when the limit cannot be hit
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY && !hasIpcLock()) {
+        std::cerr << "Warning: not locking memory: RLIMIT_MEMLOCK is " << limit.rlim_cur / 1024
+                  << " KiB; run with ulimit -l unlimited or CAP_IPC_LOCK (memory is still pre-faulted)" << std::endl;
+        return false;
+    }
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "Warning: mlockall failed (" << std::strerror(errno)
+                  << "); memory is pre-faulted but not locked. Raise RLIMIT_MEMLOCK (ulimit -l) or grant CAP_IPC_LOCK"
+                  << std::endl;
+        return false;
+    }
+    g_locked.store(true);
+    return true;
+}
+
+bool MemoryLock::isLocked() {
+    return g_locked.load();
+}
+
+void MemoryLock::retainHeap() {
+    // Never give freed heap back to the kernel, and serve large blocks from the heap too
+    // (mmap-backed blocks are unmapped on free and fault again on the next allocation)
+    ::mallopt(M_TRIM_THRESHOLD, -1);
+    ::mallopt(M_MMAP_MAX, 0);
+}
+
+void MemoryLock::prefaultHeap(size_t bytes) {
+    void* block = std::malloc(bytes);
+    if (block == nullptr) {
+        return;
+    }
+    NUMAUtils::touchMemory(block, bytes);
+    // Freed into the arena, which retainHeap() keeps resident
+    std::free(block);
+}
+
+void MemoryLock::prefaultStack(size_t bytes) {
+    pthread_attr_t attributes;
+    if (::pthread_getattr_np(::pthread_self(), &attributes) == 0) {
+        size_t stackSize = 0;
+        if (::pthread_attr_getstacksize(&attributes, &stackSize) == 0 && stackSize > 0) {
+            bytes = std::min(bytes, stackSize / 2);
+        }
+        ::pthread_attr_destroy(&attributes);
+    }
+    touchStack(bytes);
+}
+
+MemoryUsage MemoryLock::usage() {
+    MemoryUsage usage;
+    std::ifstream file("/proc/self/status");
+    const std::string status((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    usage.residentBytes = readStatusBytes(status, "VmRSS:");
+    usage.lockedBytes = readStatusBytes(status, "VmLck:");
+
+    rusage resources{};
+    if (::getrusage(RUSAGE_SELF, &resources) == 0) {
+        usage.majorFaults = static_cast<uint64_t>(resources.ru_majflt);
+        usage.minorFaults = static_cast<uint64_t>(resources.ru_minflt);
+    }
+    return usage;
+}
+
+std::string MemoryLock::formatStartup(const MemoryUsage& before, const MemoryUsage& after) {
+    std::ostringstream oss;
+    oss << "Memory: RSS " << mebibytes(before.residentBytes) << " -> " << mebibytes(after.residentBytes)
+        << ", " << (after.lockedBytes > 0 ? mebibytes(after.lockedBytes) + " locked" : std::string("not locked"))
+        << ", " << after.majorFaults << " major faults, "
+        << after.minorFaults - before.minorFaults << " pages faulted in at startup" << std::endl;
+    return oss.str();
+}
+
+#endif // __linux__
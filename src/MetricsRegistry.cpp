@@ -0,0 +1,140 @@
+/**
+ * @file MetricsRegistry.cpp
+ * @brief Implementation of the sharded metrics registry
+ */
+
+#include "MetricsRegistry.h"
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Append a label set, merging in an extra label
+ */
+void writeLabels(std::ostringstream& out, const std::string& labels, const std::string& extra = std::string()) {
+    if (labels.empty() && extra.empty()) {
+        return;
+    }
+    out << '{' << labels;
+    if (!labels.empty() && !extra.empty()) {
+        out << ',';
+    }
+    out << extra << '}';
+}
+
+} // namespace
+
+MetricsShard::MetricsShard() {
+    for (auto& value : m_values) {
+        value.store(0, std::memory_order_relaxed);
+    }
+}
+
+MetricsRegistry::MetricsRegistry()
+    : m_counterCount(0) {
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, MetricType type) {
+    for (Family& existing : m_families) {
+        if (existing.name == name) {
+            return existing;
+        }
+    }
+    m_families.push_back(Family{name, help, type, SIZE_MAX, {}});
+    return m_families.back();
+}
+
+size_t MetricsRegistry::addCounter(const std::string& name, const std::string& help) {
+    if (m_counterCount == MetricsShard::MAX_COUNTERS) {
+        return SIZE_MAX;
+    }
+    family(name, help, MetricType::Counter).counter = m_counterCount;
+    return m_counterCount++;
+}
+
+void MetricsRegistry::addShard(const std::string& thread, const MetricsShard* shard) {
+    m_shards.push_back(ShardEntry{thread, shard});
+}
+
+void MetricsRegistry::addSampled(const std::string& name, const std::string& help, MetricType type,
+                                 const std::string& labels, std::function<double()> sample) {
+    family(name, help, type).series.push_back(Series{labels, std::move(sample), {}});
+}
+
+void MetricsRegistry::addLatency(const std::string& name, const std::string& help, const std::string& labels,
+                                 const LatencyHistogram& histogram) {
+    addLatency(name, help, labels, std::vector<const LatencyHistogram*>{&histogram});
+}
+
+void MetricsRegistry::addLatency(const std::string& name, const std::string& help, const std::string& labels,
+                                 std::vector<const LatencyHistogram*> histograms) {
+    family(name, help, MetricType::Summary).series.push_back(Series{labels, nullptr, std::move(histograms)});
+}
+
+uint64_t MetricsRegistry::total(size_t counter) const {
+    uint64_t sum = 0;
+    for (const ShardEntry& entry : m_shards) {
+        sum += entry.shard->get(counter);
+    }
+    return sum;
+}
+
+std::string MetricsRegistry::render() const {
+    static const char* const TYPE_NAMES[] = {"counter", "gauge", "summary"};
+    std::ostringstream out;
+    out << std::setprecision(12);
+
+    for (const Family& metric : m_families) {
+        out << "# HELP " << metric.name << ' ' << metric.help << '\n';
+        out << "# TYPE " << metric.name << ' ' << TYPE_NAMES[static_cast<size_t>(metric.type)] << '\n';
+
+        // Sharded counters: one series per writing thread
+        if (metric.counter != SIZE_MAX) {
+            for (const ShardEntry& entry : m_shards) {
+                out << metric.name;
+                writeLabels(out, "thread=\"" + entry.label + "\"");
+                out << ' ' << entry.shard->get(metric.counter) << '\n';
+            }
+        }
+        for (const Series& series : metric.series) {
+            if (!series.histograms.empty()) {
+                // Per-thread histograms are summed here, off the recording threads
+                LatencySummary summary;
+                if (series.histograms.size() == 1) {
+                    summary = series.histograms.front()->summarize();
+                } else {
+                    const auto merged = std::make_unique<LatencyHistogram>();
+                    for (const LatencyHistogram* histogram : series.histograms) {
+                        merged->merge(*histogram);
+                    }
+                    summary = merged->summarize();
+                }
+                // Nanosecond histograms are exported in seconds, the Prometheus base unit
+                const std::pair<const char*, uint64_t> quantiles[] = {
+                    {"quantile=\"0.5\"", summary.p50},
+                    {"quantile=\"0.99\"", summary.p99},
+                    {"quantile=\"0.999\"", summary.p999},
+                };
+                for (const auto& quantile : quantiles) {
+                    out << metric.name;
+                    writeLabels(out, series.labels, quantile.first);
+                    out << ' ' << static_cast<double>(quantile.second) * 1e-9 << '\n';
+                }
+                out << metric.name << "_sum";
+                writeLabels(out, series.labels);
+                out << ' ' << summary.mean * static_cast<double>(summary.count) * 1e-9 << '\n';
+                out << metric.name << "_count";
+                writeLabels(out, series.labels);
+                out << ' ' << summary.count << '\n';
+            } else {
+                out << metric.name;
+                writeLabels(out, series.labels);
+                out << ' ' << series.sample() << '\n';
+            }
+        }
+    }
+    return out.str();
+}
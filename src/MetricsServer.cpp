@@ -0,0 +1,163 @@
+/**
+ * @file MetricsServer.cpp
+ * @brief Implementation of the /metrics HTTP endpoint
+ */
+
+#include "MetricsServer.h"
+#include "MetricsRegistry.h"
+#include "ThreadUtils.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    /// How often the accept loop checks for stop()
+    constexpr int POLL_TIMEOUT_MILLIS = 200;
+    /// Largest request read; scrapers send a few hundred bytes
+    constexpr size_t MAX_REQUEST_BYTES = 4096;
+    /// Nice value of the server thread: it must never compete with the feed
+    constexpr int SERVER_NICE = 10;
+
+    /**
+     * @brief Write a whole buffer, retrying short writes
+     */
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+MetricsServer::MetricsServer(const MetricsRegistry& registry)
+    : m_registry(registry)
+    , m_listenFd(-1)
+    , m_port(0) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(uint16_t port) {
+    if (m_running.load()) {
+        return false;
+    }
+
+    m_listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        std::cerr << "Metrics server: socket failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    const int reuse = 1;
+    ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Localhost only: the endpoint is for a local scraper or an SSH tunnel
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(m_listenFd, 8) < 0) {
+        std::cerr << "Metrics server: cannot listen on 127.0.0.1:" << port << ": "
+                  << std::strerror(errno) << std::endl;
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    m_port = ntohs(address.sin_port);
+
+    m_running.store(true);
+    m_thread = std::thread(&MetricsServer::serveLoop, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    m_running.store(false);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        m_listenFd = -1;
+    }
+}
+
+void MetricsServer::serveLoop() {
+    // Default scheduling, no pinning, lowered priority: scrapes run in whatever time is left over
+    ThreadUtils::setThreadName("Metrics");
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), SERVER_NICE);
+
+    pollfd listener{m_listenFd, POLLIN, 0};
+    while (m_running.load(std::memory_order_relaxed)) {
+        const int ready = ::poll(&listener, 1, POLL_TIMEOUT_MILLIS);
+        if (ready <= 0 || !(listener.revents & POLLIN)) {
+            continue;
+        }
+        const int clientFd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd < 0) {
+            continue;
+        }
+        serveClient(clientFd);
+        ::close(clientFd);
+    }
+}
+
+void MetricsServer::serveClient(int clientFd) {
+    // A stalled client must not hold up the next scrape for long
+    timeval timeout{1, 0};
+    ::setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.size() < MAX_REQUEST_BYTES && request.find("\r\n\r\n") == std::string::npos) {
+        const ssize_t n = ::recv(clientFd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    std::string status;
+    std::string body;
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0) {
+        status = "200 OK";
+        body = m_registry.render();
+        m_scrapes.fetch_add(1, std::memory_order_relaxed);
+    } else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        body = "Metrics are served at /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    }
+
+    const std::string header = "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n";
+    if (sendAll(clientFd, header)) {
+        sendAll(clientFd, body);
+    }
+}
+
+#endif // __linux__
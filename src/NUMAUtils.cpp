@@ -194,13 +194,18 @@ bool NUMAUtils::setMemoryPolicy(int nodeId) {
 }
 
 void NUMAUtils::touchMemory(void* ptr, size_t size) {
-    // Touch each page to ensure it's allocated on the correct NUMA node
+    // Write each page: a read of untouched anonymous memory only maps the shared
+    // zero page, so the real page (and its node) would still be chosen on first write.
+    // An atomic OR with 0 dirties the page without changing its contents, even if
+    // another thread is using the memory.
     const size_t pageSize = getpagesize();
     char* p = static_cast<char*>(ptr);
     
     for (size_t i = 0; i < size; i += pageSize) {
-        volatile char c = p[i];
-        (void)c; // Suppress unused variable warning
+        __atomic_fetch_or(p + i, 0, __ATOMIC_RELAXED);
+    }
+    if (size > 0) {
+        __atomic_fetch_or(p + size - 1, 0, __ATOMIC_RELAXED);
     }
 }
 
@@ -0,0 +1,320 @@
+/**
+ * @file NicLocality.cpp
+ * @brief Implementation of the NIC locality and interrupt affinity report
+ */
+
+#include "NicLocality.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <climits>
+#include <dirent.h>
+
+namespace {
+    std::string lowercase(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    /**
+     * @brief IRQ numbers the NIC's PCI function registered (MSI/MSI-X vectors)
+     *
+     * Virtio NICs sit one level below their PCI function, which holds the vectors.
+     */
+    std::set<int> readMsiIrqs(const std::string& deviceDir) {
+        std::set<int> irqs;
+        DIR* dir = ::opendir((deviceDir + "/msi_irqs").c_str());
+        if (dir == nullptr) {
+            dir = ::opendir((deviceDir + "/../msi_irqs").c_str());
+        }
+        if (dir == nullptr) {
+            return irqs;
+        }
+        while (dirent* entry = ::readdir(dir)) {
+            if (std::isdigit(static_cast<unsigned char>(entry->d_name[0]))) {
+                irqs.insert(std::atoi(entry->d_name));
+            }
+        }
+        ::closedir(dir);
+        return irqs;
+    }
+
+    /**
+     * @brief Receive queues show up as ...rx..., virtio "input" or mlx5 completion vectors
+     */
+    bool looksLikeRx(const std::string& name) {
+        const std::string lower = lowercase(name);
+        return lower.find("rx") != std::string::npos || lower.find("input") != std::string::npos ||
+               lower.find("comp") != std::string::npos;
+    }
+
+    /**
+     * @brief Kernel name of the NIC's device (e.g. virtio3), used in its IRQ names
+     */
+    std::string deviceName(const std::string& deviceDir) {
+        char resolved[PATH_MAX];
+        if (::realpath(deviceDir.c_str(), resolved) == nullptr) {
+            return std::string();
+        }
+        const std::string path = resolved;
+        return path.substr(path.find_last_of('/') + 1);
+    }
+
+    /**
+     * @brief IRQ names of an interface: "eth1", "eth1-TxRx-0" or "eth1@pci:..." (never eth10's)
+     */
+    bool belongsToInterface(const std::string& irqName, const std::string& interface) {
+        if (irqName.compare(0, interface.size(), interface) != 0) {
+            return false;
+        }
+        return irqName.size() == interface.size() || irqName[interface.size()] == '-' ||
+               irqName[interface.size()] == '@';
+    }
+
+    std::string joinCpus(const std::vector<int>& cpus) {
+        std::string text;
+        for (int cpu : cpus) {
+            text += (text.empty() ? "" : ",") + std::to_string(cpu);
+        }
+        return text;
+    }
+
+    /**
+     * @brief CPU and its hyperthread siblings
+     */
+    std::vector<int> coreOf(const CpuTopology& topology, int cpu) {
+        const CpuInfo* info = topology.find(cpu);
+        if (info == nullptr || info->core < 0) {
+            return {cpu};
+        }
+        return topology.cores[static_cast<size_t>(info->core)];
+    }
+}
+
+std::vector<int> NicReport::rxCpus(double minShare) const {
+    uint64_t total = 0;
+    for (uint64_t count : rxPerCpu) {
+        total += count;
+    }
+    std::vector<int> cpus;
+    for (size_t cpu = 0; cpu < rxPerCpu.size() && total > 0; ++cpu) {
+        if (rxPerCpu[cpu] > 0 && static_cast<double>(rxPerCpu[cpu]) >= minShare * static_cast<double>(total)) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+std::string NicReport::format() const {
+    std::ostringstream oss;
+    if (interface.empty()) {
+        oss << "NIC: feed interface not found" << std::endl;
+        return oss.str();
+    }
+    oss << "NIC " << interface << ": node ";
+    if (numaNode >= 0) {
+        oss << numaNode;
+    } else {
+        oss << "unknown";
+    }
+    const size_t rxLines = static_cast<size_t>(std::count_if(irqs.begin(), irqs.end(),
+                                                             [](const NicIrq& irq) { return irq.rx; }));
+    if (irqs.empty()) {
+        oss << ", no interrupt lines found" << std::endl;
+        return oss.str();
+    }
+    oss << ", " << irqs.size() << " interrupt lines (" << rxLines << " RX)" << std::endl;
+
+    uint64_t total = 0;
+    for (uint64_t count : rxPerCpu) {
+        total += count;
+    }
+    oss << "  RX interrupts on CPUs:";
+    const std::vector<int> cpus = rxCpus();
+    if (cpus.empty()) {
+        oss << " none yet";
+    }
+    oss << std::fixed << std::setprecision(0);
+    for (int cpu : cpus) {
+        oss << " " << cpu << " (" << 100.0 * static_cast<double>(rxPerCpu[static_cast<size_t>(cpu)]) /
+                                        static_cast<double>(total) << "%)";
+    }
+    oss << std::endl;
+    return oss.str();
+}
+
+NicReport NicLocality::inspect(const std::string& interfaceOrAddress, const std::string& procRoot,
+                               const std::string& netRoot) {
+    NicReport report;
+    report.interface = ThreadPlacement::resolveInterface(interfaceOrAddress, netRoot);
+    if (report.interface.empty()) {
+        return report;
+    }
+    report.numaNode = ThreadPlacement::nicNumaNode(report.interface, netRoot);
+    const std::string deviceDir = netRoot + "/" + report.interface + "/device";
+    const std::set<int> msiIrqs = readMsiIrqs(deviceDir);
+    const std::string device = deviceName(deviceDir);
+
+    // Header: one column per online CPU, e.g. "CPU0 CPU1 CPU4"
+    std::ifstream interrupts(procRoot + "/interrupts");
+    std::string line;
+    std::vector<int> columns;
+    if (std::getline(interrupts, line)) {
+        std::istringstream header(line);
+        std::string column;
+        while (header >> column) {
+            if (column.compare(0, 3, "CPU") == 0) {
+                columns.push_back(std::atoi(column.c_str() + 3));
+            }
+        }
+    }
+    const int maxCpu = columns.empty() ? -1 : *std::max_element(columns.begin(), columns.end());
+
+    // Rows: "  42:  count...  controller  hwirq  device" (NMI, LOC and other named rows are skipped)
+    while (std::getline(interrupts, line)) {
+        std::istringstream row(line);
+        std::string label;
+        if (!(row >> label) || label.empty() || !std::isdigit(static_cast<unsigned char>(label[0]))) {
+            continue;
+        }
+        NicIrq irq;
+        irq.irq = std::atoi(label.c_str());
+        irq.perCpu.assign(static_cast<size_t>(maxCpu + 1), 0);
+        for (int cpu : columns) {
+            uint64_t count = 0;
+            row >> count;
+            irq.perCpu[static_cast<size_t>(cpu)] = count;
+            irq.total += count;
+        }
+        std::string token;
+        while (row >> token) {
+            irq.name = token;   // The device name is the last column
+        }
+        if (msiIrqs.count(irq.irq) == 0 && !belongsToInterface(irq.name, report.interface) &&
+            (device.empty() || irq.name.compare(0, device.size() + 1, device + "-") != 0)) {
+            continue;
+        }
+        irq.rx = looksLikeRx(irq.name);
+        irq.effectiveCpus = ThreadPlacement::parseCpuList([&]() {
+            std::ifstream file(procRoot + "/irq/" + std::to_string(irq.irq) + "/effective_affinity_list");
+            std::string list;
+            std::getline(file, list);
+            return list;
+        }());
+        report.irqs.push_back(std::move(irq));
+    }
+
+    // Single-vector NICs (and unfamiliar naming): every line may carry receive traffic
+    if (std::none_of(report.irqs.begin(), report.irqs.end(), [](const NicIrq& irq) { return irq.rx; })) {
+        for (NicIrq& irq : report.irqs) {
+            irq.rx = true;
+        }
+    }
+    report.rxPerCpu.assign(static_cast<size_t>(maxCpu + 1), 0);
+    for (const NicIrq& irq : report.irqs) {
+        if (irq.rx) {
+            for (size_t cpu = 0; cpu < irq.perCpu.size(); ++cpu) {
+                report.rxPerCpu[cpu] += irq.perCpu[cpu];
+            }
+        }
+    }
+    return report;
+}
+
+std::vector<std::string> NicLocality::checkPlacement(const NicReport& report, const ThreadAssignment& io,
+                                                     const CpuTopology& topology) {
+    std::vector<std::string> warnings;
+    if (report.interface.empty() || io.cpu < 0) {
+        return warnings;
+    }
+    if (report.numaNode >= 0 && io.node != report.numaNode) {
+        warnings.push_back(io.thread + " runs on node " + std::to_string(io.node) + " but " +
+                           report.interface + " is on node " + std::to_string(report.numaNode) +
+                           ": every packet crosses the interconnect");
+    }
+
+    uint64_t total = 0;
+    for (uint64_t count : report.rxPerCpu) {
+        total += count;
+    }
+    for (int cpu : coreOf(topology, io.cpu)) {
+        const std::string where = cpu == io.cpu ? "CPU " + std::to_string(cpu)
+            : "CPU " + std::to_string(cpu) + " (hyperthread sibling)";
+        // Where the kernel sends RX interrupts now
+        for (const NicIrq& irq : report.irqs) {
+            if (irq.rx && std::find(irq.effectiveCpus.begin(), irq.effectiveCpus.end(), cpu) != irq.effectiveCpus.end()) {
+                warnings.push_back(report.interface + " RX interrupt " + std::to_string(irq.irq) + " (" + irq.name +
+                                   ") is delivered to " + where + " of " + io.thread);
+            }
+        }
+        // Where they have been landing since boot
+        if (total > 0 && static_cast<size_t>(cpu) < report.rxPerCpu.size()) {
+            const double share = static_cast<double>(report.rxPerCpu[static_cast<size_t>(cpu)]) / static_cast<double>(total);
+            if (share >= HEAVY_IRQ_SHARE) {
+                std::ostringstream oss;
+                oss << std::fixed << std::setprecision(0) << where << " of " << io.thread << " serviced "
+                    << share * 100.0 << "% of " << report.interface << " RX interrupts";
+                warnings.push_back(oss.str());
+            }
+        }
+    }
+    return warnings;
+}
+
+std::string NicLocality::recommendAffinity(const NicReport& report, const PlacementPlan& plan,
+                                           const CpuTopology& topology) {
+    std::ostringstream oss;
+    if (report.interface.empty() || report.irqs.empty()) {
+        return oss.str();
+    }
+
+    // Hot threads keep their whole core: no RX interrupts on them or their siblings
+    std::set<int> hot;
+    auto addHot = [&](const ThreadAssignment& thread) {
+        if (thread.cpu >= 0) {
+            for (int cpu : coreOf(topology, thread.cpu)) {
+                hot.insert(cpu);
+            }
+        }
+    };
+    for (const ThreadAssignment& io : plan.feedIo) {
+        addHot(io);
+    }
+    addHot(plan.processing);
+
+    std::vector<int> spare;
+    for (const CpuInfo& info : topology.cpus) {
+        if (hot.count(info.cpu) == 0 && !info.isolated &&
+            (report.numaNode < 0 || info.node == report.numaNode)) {
+            spare.push_back(info.cpu);
+        }
+    }
+    if (spare.empty()) {
+        oss << "# No spare CPU on " << (report.numaNode >= 0 ? "node " + std::to_string(report.numaNode) : "this machine")
+            << " for " << report.interface << " RX interrupts outside the hot cores" << std::endl;
+        return oss.str();
+    }
+
+    oss << "# Suggested " << report.interface << " RX interrupt affinity (hot CPUs "
+        << joinCpus(std::vector<int>(hot.begin(), hot.end())) << " kept free; stop irqbalance or ban these IRQs first):"
+        << std::endl;
+    size_t next = 0;
+    for (const NicIrq& irq : report.irqs) {
+        if (!irq.rx) {
+            continue;
+        }
+        oss << "echo " << spare[next++ % spare.size()] << " > /proc/irq/" << irq.irq
+            << "/smp_affinity_list   # " << irq.name << std::endl;
+    }
+    return oss.str();
+}
+
+#endif // __linux__
@@ -0,0 +1,76 @@
+/**
+ * @file OrderBook.cpp
+ * @brief Implementation of the level2 price-level order book
+ */
+
+#include "OrderBook.h"
+#include <algorithm>
+#ifdef __linux__
+#include "NUMAUtils.h"
+#endif
+
+OrderBook::OrderBook(size_t maxLevelsPerSide)
+    : m_maxLevels(std::max<size_t>(maxLevelsPerSide, 1))
+    , m_updates(0)
+    , m_truncated(0) {
+    m_bids.reserve(m_maxLevels);
+    m_asks.reserve(m_maxLevels);
+}
+
+void OrderBook::clear() {
+    // Keeps the reserved capacity
+    m_bids.clear();
+    m_asks.clear();
+}
+
+void OrderBook::prefault() {
+#ifdef __linux__
+    // Writes preserve contents, so this is also safe on a book that holds levels
+    NUMAUtils::touchMemory(m_bids.data(), m_bids.capacity() * sizeof(BookLevel));
+    NUMAUtils::touchMemory(m_asks.data(), m_asks.capacity() * sizeof(BookLevel));
+#endif
+}
+
+int OrderBook::apply(BookSide side, int64_t price, int64_t size, int64_t& previousSize) {
+    std::vector<BookLevel>& levels = side == BookSide::Bid ? m_bids : m_asks;
+    // Position in storage order: ascending for bids, descending for asks (best at the back)
+    auto it = side == BookSide::Bid
+        ? std::lower_bound(levels.begin(), levels.end(), price,
+                           [](const BookLevel& level, int64_t p) { return level.price < p; })
+        : std::lower_bound(levels.begin(), levels.end(), price,
+                           [](const BookLevel& level, int64_t p) { return level.price > p; });
+
+    const bool found = it != levels.end() && it->price == price;
+    previousSize = found ? it->size : 0;
+    if (LIKELY(found)) {
+        const int distance = static_cast<int>(levels.end() - it) - 1;
+        if (size == 0) {
+            levels.erase(it);
+        } else {
+            it->size = size;
+        }
+        m_updates++;
+        return distance;
+    }
+
+    // Removing a level that is not there (e.g. beyond the kept depth)
+    if (size == 0) {
+        return -1;
+    }
+
+    if (UNLIKELY(levels.size() == m_maxLevels)) {
+        // Full side: drop the level furthest from the touch, or the new one if it is the furthest
+        m_truncated++;
+        if (it == levels.begin()) {
+            return -1;
+        }
+        // Only the levels between the far end and the new one move (over the dropped level)
+        std::move(levels.begin() + 1, it, levels.begin());
+        --it;
+        *it = BookLevel{price, size};
+    } else {
+        it = levels.insert(it, BookLevel{price, size});
+    }
+    m_updates++;
+    return static_cast<int>(levels.end() - it) - 1;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file RollingStats.cpp
+ * @brief Implementation of the rolling window statistics
+ */
+
+#include "RollingStats.h"
+#include <cmath>
+#include "BranchPrediction.h"
+
+RollingStats::RollingStats(int64_t windowNanos, size_t capacity)
+    : m_head(0)
+    , m_tail(0)
+    , m_window_ns(windowNanos)
+    , m_reference(0.0)
+    , m_mean(0.0)
+    , m_m2(0.0)
+    , m_truncated(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_ring.resize(size);
+    m_mask = size - 1;
+    m_min.ring.resize(size);
+    m_max.ring.resize(size);
+}
+
+void RollingStats::setWindow(int64_t windowNanos) {
+    m_window_ns = windowNanos;
+    m_head = 0;
+    m_tail = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_min.front = m_min.back = 0;
+    m_max.front = m_max.back = 0;
+}
+
+void RollingStats::expireOldest() {
+    const double value = m_ring[m_tail & m_mask].value;
+    m_tail++;
+
+    // Inverse Welford step
+    const uint64_t n = m_head - m_tail;
+    if (n == 0) {
+        m_mean = 0.0;
+        m_m2 = 0.0;
+    } else {
+        const double delta = value - m_mean;
+        m_mean -= delta / static_cast<double>(n);
+        m_m2 -= delta * (value - m_mean);
+        // Rounding can leave a tiny negative sum for a near-constant window
+        if (UNLIKELY(m_m2 < 0.0)) {
+            m_m2 = 0.0;
+        }
+    }
+
+    // The expired sample can only be at the front of either deque
+    if (m_min.front != m_min.back && m_min.ring[m_min.front & m_mask] < m_tail) {
+        m_min.front++;
+    }
+    if (m_max.front != m_max.back && m_max.ring[m_max.front & m_mask] < m_tail) {
+        m_max.front++;
+    }
+}
+
+void RollingStats::add(int64_t timeNanos, double value) {
+    // The slot about to be overwritten is still inside the window (unlikely: ring sized for bursts)
+    if (UNLIKELY(m_head - m_tail > m_mask)) {
+        expireOldest();
+        m_truncated++;
+    }
+    const int64_t cutoff = timeNanos - m_window_ns;
+    while (m_tail < m_head && m_ring[m_tail & m_mask].time_ns <= cutoff) {
+        expireOldest();
+    }
+
+    // Empty window: re-center on the new value
+    if (m_head == m_tail) {
+        m_reference = value;
+    }
+    const double x = value - m_reference;
+    m_ring[m_head & m_mask] = Sample{timeNanos, x};
+
+    // Welford step
+    const uint64_t n = m_head - m_tail + 1;
+    const double delta = x - m_mean;
+    m_mean += delta / static_cast<double>(n);
+    m_m2 += delta * (x - m_mean);
+
+    // Samples that can no longer be the extreme leave from the back
+    while (m_min.front != m_min.back && m_ring[m_min.ring[(m_min.back - 1) & m_mask] & m_mask].value >= x) {
+        m_min.back--;
+    }
+    m_min.ring[m_min.back++ & m_mask] = m_head;
+    while (m_max.front != m_max.back && m_ring[m_max.ring[(m_max.back - 1) & m_mask] & m_mask].value <= x) {
+        m_max.back--;
+    }
+    m_max.ring[m_max.back++ & m_mask] = m_head;
+
+    m_head++;
+}
+
+double RollingStats::mean() const {
+    return m_head == m_tail ? 0.0 : m_reference + m_mean;
+}
+
+double RollingStats::variance() const {
+    const uint64_t n = m_head - m_tail;
+    return n < 2 ? 0.0 : m_m2 / static_cast<double>(n - 1);
+}
+
+double RollingStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+double RollingStats::min() const {
+    return m_head == m_tail ? 0.0 : m_reference + m_ring[m_min.ring[m_min.front & m_mask] & m_mask].value;
+}
+
+double RollingStats::max() const {
+    return m_head == m_tail ? 0.0 : m_reference + m_ring[m_max.ring[m_max.front & m_mask] & m_mask].value;
+}
+
+double RollingStats::zScore(double value, double center) const {
+    const double deviation = stddev();
+    return deviation > 0.0 ? (value - center) / deviation : 0.0;
+}
+
+RollingStatsSnapshot RollingStats::snapshot() const {
+    RollingStatsSnapshot result;
+    result.window_ns = m_window_ns;
+    result.count = count();
+    result.mean = mean();
+    result.stddev = stddev();
+    result.min = min();
+    result.max = max();
+    return result;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file RollingVWAP.cpp
+ * @brief Implementation of the rolling multi-window VWAP
+ */
+
+#include "RollingVWAP.h"
+#include <algorithm>
+#include "OrderBook.h"
+#include "BranchPrediction.h"
+
+RollingVWAP::RollingVWAP(size_t capacity)
+    : m_count(0)
+    , m_volume(0)
+    , m_notional(0)
+    , m_windowCount(0)
+    , m_truncated(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_ring.resize(size);
+    m_mask = size - 1;
+}
+
+void RollingVWAP::setWindows(const std::vector<int64_t>& windowNanos) {
+    m_windowCount = std::min(windowNanos.size(), VwapSnapshot::MAX_WINDOWS);
+    for (size_t i = 0; i < m_windowCount; ++i) {
+        m_windows[i] = Window{windowNanos[i], 0};
+    }
+    m_count = 0;
+    m_volume = 0;
+    m_notional = 0;
+}
+
+void RollingVWAP::addTrade(int64_t timeNanos, int64_t price, int64_t size) {
+    const uint64_t capacity = m_ring.size();
+    for (size_t i = 0; i < m_windowCount; ++i) {
+        Window& window = m_windows[i];
+        // The slot about to be overwritten still belongs to this window (unlikely: ring sized for bursts)
+        if (UNLIKELY(m_count - window.tail >= capacity)) {
+            window.tail = m_count - capacity + 1;
+            m_truncated++;
+        }
+    }
+
+    m_ring[m_count & m_mask] = Entry{timeNanos, m_volume, m_notional};
+    m_count++;
+    m_volume += size;
+    m_notional += static_cast<Notional>(price) * size;
+
+    // Expire by the newest trade time; each trade is passed over once per window
+    for (size_t i = 0; i < m_windowCount; ++i) {
+        Window& window = m_windows[i];
+        const int64_t cutoff = timeNanos - window.length_ns;
+        while (window.tail < m_count && m_ring[window.tail & m_mask].time_ns <= cutoff) {
+            window.tail++;
+        }
+    }
+}
+
+VwapWindowStats RollingVWAP::window(size_t index) const {
+    const Window& window = m_windows[index];
+    VwapWindowStats stats;
+    stats.window_ns = window.length_ns;
+    stats.trades = m_count - window.tail;
+    if (stats.trades == 0) {
+        return stats;
+    }
+
+    const Entry& oldest = m_ring[window.tail & m_mask];
+    const int64_t volume = m_volume - oldest.volumeBefore;
+    const Notional notional = m_notional - oldest.notionalBefore;
+    const double scale = static_cast<double>(OrderBook::SCALE);
+    stats.volume = static_cast<double>(volume) / scale;
+    stats.notional = static_cast<double>(notional) / scale / scale;
+    if (LIKELY(volume > 0)) {
+        stats.vwap = static_cast<double>(notional) / static_cast<double>(volume) / scale;
+    }
+    return stats;
+}
+
+VwapSnapshot RollingVWAP::snapshot() const {
+    VwapSnapshot result;
+    result.count = m_windowCount;
+    for (size_t i = 0; i < m_windowCount; ++i) {
+        result.windows[i] = window(i);
+    }
+    return result;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file SequenceTracker.cpp
+ * @brief Implementation of per-product sequence number tracking
+ */
+
+#include "SequenceTracker.h"
+#include <sstream>
+#include <iomanip>
+#include "BranchPrediction.h"
+
+SequenceTracker::SequenceTracker()
+    : m_lastSkipped(0) {
+}
+
+SequenceResult SequenceTracker::onMessage(const std::string& productId, uint64_t sequence, uint64_t epoch) {
+    m_lastSkipped = 0;
+    // Unsequenced messages carry nothing to check
+    if (UNLIKELY(sequence == 0)) {
+        return SequenceResult::InOrder;
+    }
+    m_messages.fetch_add(1, std::memory_order_relaxed);
+
+    ProductState& state = m_products[productId];
+    // New products are unlikely after the first few messages
+    if (UNLIKELY(state.lastSequence == 0)) {
+        state.lastSequence = sequence;
+        state.epoch = epoch;
+        return SequenceResult::First;
+    }
+
+    // Messages older than the last one seen (including replays after a reconnect).
+    // The epoch stays put, so the first in-order message still reports Resumed.
+    if (UNLIKELY(sequence <= state.lastSequence)) {
+        if (sequence == state.lastSequence) {
+            m_duplicates.fetch_add(1, std::memory_order_relaxed);
+            return SequenceResult::Duplicate;
+        }
+        m_outOfOrder.fetch_add(1, std::memory_order_relaxed);
+        return SequenceResult::OutOfOrder;
+    }
+
+    const uint64_t skipped = sequence - state.lastSequence - 1;
+    state.lastSequence = sequence;
+    m_lastSkipped = skipped;
+
+    // First in-order message on a new connection. The ticker channel skips
+    // sequence numbers by design, so the jump bounds the loss but is not one
+    if (UNLIKELY(epoch != state.epoch)) {
+        state.epoch = epoch;
+        m_resumptions.fetch_add(1, std::memory_order_relaxed);
+        m_reconnectAdvance.fetch_add(skipped, std::memory_order_relaxed);
+        return SequenceResult::Resumed;
+    }
+    return SequenceResult::InOrder;
+}
+
+void SequenceTracker::recordRecovery(uint64_t nanos) {
+    m_recoveries.fetch_add(1, std::memory_order_relaxed);
+    m_lastRecoveryNanos.store(nanos, std::memory_order_relaxed);
+    // Single writer, so a plain compare is enough
+    if (nanos > m_maxRecoveryNanos.load(std::memory_order_relaxed)) {
+        m_maxRecoveryNanos.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+SequenceStats SequenceTracker::getStats() const {
+    SequenceStats stats;
+    stats.messages = m_messages.load(std::memory_order_relaxed);
+    stats.duplicates = m_duplicates.load(std::memory_order_relaxed);
+    stats.outOfOrder = m_outOfOrder.load(std::memory_order_relaxed);
+    stats.resumptions = m_resumptions.load(std::memory_order_relaxed);
+    stats.reconnectAdvance = m_reconnectAdvance.load(std::memory_order_relaxed);
+    stats.recoveries = m_recoveries.load(std::memory_order_relaxed);
+    stats.lastRecoveryNanos = m_lastRecoveryNanos.load(std::memory_order_relaxed);
+    stats.maxRecoveryNanos = m_maxRecoveryNanos.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::string SequenceTracker::getSummary() const {
+    const SequenceStats stats = getStats();
+    std::ostringstream oss;
+    oss << "Sequence: " << stats.messages << " messages, "
+        << stats.duplicates << " duplicates, "
+        << stats.outOfOrder << " out of order, "
+        << stats.resumptions << " resumed after reconnect (advanced " << stats.reconnectAdvance << " while down)";
+    if (stats.recoveries > 0) {
+        oss << std::endl << "Time to Recover: last " << std::fixed << std::setprecision(1)
+            << stats.lastRecoveryNanos / 1e6 << " ms, max "
+            << stats.maxRecoveryNanos / 1e6 << " ms over "
+            << stats.recoveries << " reconnect(s)";
+    }
+    return oss.str();
+}
@@ -0,0 +1,447 @@
+/**
+ * @file ThreadPlacement.cpp
+ * @brief Implementation of the topology-aware thread placement planner
+ */
+
+#include "ThreadPlacement.h"
+
+#ifdef __linux__
+
+#include "NUMAUtils.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <dirent.h>
+#include <ifaddrs.h>
+#include <netdb.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    const char* const DEFAULT_CPU_ROOT = "/sys/devices/system/cpu";
+
+    /**
+     * @brief Read the first line of a sysfs file
+     * @return Line without the newline (empty if the file is missing)
+     */
+    std::string readLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    bool readInt(const std::string& path, int& value) {
+        const std::string line = readLine(path);
+        if (line.empty()) {
+            return false;
+        }
+        value = std::atoi(line.c_str());
+        return true;
+    }
+
+    /**
+     * @brief Find the NUMA node of a CPU from its cpuN/nodeK entry
+     * @return Node, or -1 if the kernel exposes none
+     */
+    int readCpuNode(const std::string& cpuDir) {
+        int node = -1;
+        DIR* dir = ::opendir(cpuDir.c_str());
+        if (dir == nullptr) {
+            return node;
+        }
+        while (dirent* entry = ::readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                name.find_first_not_of("0123456789", 4) == std::string::npos) {
+                node = std::atoi(name.c_str() + 4);
+                break;
+            }
+        }
+        ::closedir(dir);
+        return node;
+    }
+
+    /**
+     * @brief Interface of the IPv4 default route
+     */
+    std::string defaultRouteInterface() {
+        std::ifstream routes("/proc/net/route");
+        std::string line;
+        std::getline(routes, line);  // Header
+        while (std::getline(routes, line)) {
+            std::istringstream fields(line);
+            std::string iface;
+            std::string destination;
+            if (fields >> iface >> destination && destination == "00000000") {
+                return iface;
+            }
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief Mutable state of one planning run
+     */
+    struct Planner {
+        const CpuTopology& topology;
+        std::map<int, size_t> index;                        // CPU id -> position in topology.cpus
+        std::vector<std::vector<ThreadAssignment*>> users;  // Threads on each CPU
+        std::vector<ThreadAssignment*> coreOwner;           // Hot thread holding each whole core
+
+        explicit Planner(const CpuTopology& topo)
+            : topology(topo)
+            , users(topo.cpus.size())
+            , coreOwner(topo.cores.size(), nullptr) {
+            for (size_t i = 0; i < topo.cpus.size(); ++i) {
+                index[topo.cpus[i].cpu] = i;
+            }
+        }
+
+        const CpuInfo& cpu(int id) const { return topology.cpus[index.at(id)]; }
+        size_t load(int id) const { return users[index.at(id)].size(); }
+
+        /// Every sibling of the core is in the cpuset and idle
+        bool coreFree(size_t core) const {
+            for (int id : topology.cores[core]) {
+                if (!cpu(id).allowed || load(id) != 0) {
+                    return false;
+                }
+            }
+            return coreOwner[core] == nullptr;
+        }
+
+        bool coreIsolated(size_t core) const {
+            for (int id : topology.cores[core]) {
+                if (!cpu(id).isolated) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void assign(ThreadAssignment& thread, int id, const std::string& note) {
+            thread.cpu = id;
+            thread.node = cpu(id).node;
+            thread.note = note;
+            auto& onCpu = users[index.at(id)];
+            if (!onCpu.empty()) {
+                thread.shared = true;
+                for (ThreadAssignment* other : onCpu) {
+                    other->shared = true;
+                    other->dedicated = false;
+                }
+            }
+            onCpu.push_back(&thread);
+        }
+
+        /**
+         * @brief Take a whole free core (lowest key wins); returns false if none is left
+         */
+        template<typename Key>
+        bool takeCore(ThreadAssignment& thread, Key key, const std::string& note) {
+            size_t best = SIZE_MAX;
+            for (size_t core = 0; core < topology.cores.size(); ++core) {
+                if (coreFree(core) && (best == SIZE_MAX || key(core) < key(best))) {
+                    best = core;
+                }
+            }
+            if (best == SIZE_MAX) {
+                return false;
+            }
+            coreOwner[best] = &thread;
+            thread.dedicated = true;
+            assign(thread, topology.cores[best].front(), note);
+            return true;
+        }
+
+        /**
+         * @brief Take an idle CPU (lowest key wins); its core's owner loses its dedicated core
+         */
+        template<typename Key>
+        bool takeIdleCpu(ThreadAssignment& thread, Key key, const std::string& note) {
+            int best = -1;
+            for (const CpuInfo& info : topology.cpus) {
+                if (info.allowed && load(info.cpu) == 0 && (best < 0 || key(info) < key(cpu(best)))) {
+                    best = info.cpu;
+                }
+            }
+            if (best < 0) {
+                return false;
+            }
+            ThreadAssignment* owner = coreOwner[cpu(best).core];
+            if (owner != nullptr && owner != &thread) {
+                owner->dedicated = false;
+                owner->note += owner->note.empty() ? "sibling in use" : ", sibling in use";
+            }
+            assign(thread, best, note);
+            return true;
+        }
+
+        /**
+         * @brief Share the least loaded CPU (ties: lowest key)
+         */
+        template<typename Key>
+        void shareCpu(ThreadAssignment& thread, Key key) {
+            int best = -1;
+            for (const CpuInfo& info : topology.cpus) {
+                if (!info.allowed) {
+                    continue;
+                }
+                if (best < 0 || load(info.cpu) < load(best) ||
+                    (load(info.cpu) == load(best) && key(info) < key(cpu(best)))) {
+                    best = info.cpu;
+                }
+            }
+            if (best >= 0) {
+                assign(thread, best, "not enough CPUs");
+            }
+        }
+
+        /**
+         * @brief Place a latency-critical thread, preferring a node
+         */
+        void placeHot(ThreadAssignment& thread, int preferredNode) {
+            thread.hot = true;
+            const auto offNode = [&](int node) { return preferredNode >= 0 && node != preferredNode; };
+            // Isolated cores first, then cores other than CPU 0 (housekeeping, timers, IRQs)
+            const auto coreKey = [&](size_t core) {
+                const std::vector<int>& siblings = topology.cores[core];
+                return std::make_tuple(offNode(cpu(siblings.front()).node), !coreIsolated(core),
+                                       std::find(siblings.begin(), siblings.end(), 0) != siblings.end(),
+                                       siblings.front());
+            };
+            const auto cpuKey = [&](const CpuInfo& info) {
+                return std::make_tuple(coreOwner[info.core] != nullptr, offNode(info.node),
+                                       !info.isolated, info.cpu == 0, info.cpu);
+            };
+            if (takeCore(thread, coreKey, "")) {
+                thread.note = coreIsolated(static_cast<size_t>(cpu(thread.cpu).core)) ? "isolated core" : "";
+            } else if (!takeIdleCpu(thread, cpuKey, "hyperthread only")) {
+                shareCpu(thread, cpuKey);
+            }
+            if (thread.cpu >= 0 && offNode(thread.node)) {
+                thread.note += thread.note.empty() ? "off NIC node" : ", off NIC node";
+            }
+        }
+
+        /**
+         * @brief Place the logger away from the hot threads
+         */
+        void placeLogger(ThreadAssignment& thread, int hotNode) {
+            // Isolated cores are kept for hot threads; another node keeps the hot node's L3 to itself;
+            // high CPU numbers stay clear of where the hot threads start
+            const auto coreKey = [&](size_t core) {
+                const int first = topology.cores[core].front();
+                return std::make_tuple(coreIsolated(core), cpu(first).node == hotNode && topology.numNodes > 1,
+                                       -first);
+            };
+            const auto cpuKey = [&](const CpuInfo& info) {
+                return std::make_tuple(coreOwner[info.core] != nullptr, info.isolated, -info.cpu);
+            };
+            if (!takeCore(thread, coreKey, "") && !takeIdleCpu(thread, cpuKey, "hyperthread only")) {
+                shareCpu(thread, cpuKey);
+            }
+        }
+    };
+}
+
+const CpuInfo* CpuTopology::find(int cpu) const {
+    for (const CpuInfo& info : cpus) {
+        if (info.cpu == cpu) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+std::string PlacementPlan::format() const {
+    std::ostringstream oss;
+    oss << "Thread placement:" << std::endl;
+    auto line = [&oss](const ThreadAssignment& thread) {
+        oss << "  " << std::left << std::setw(16) << thread.thread << std::right;
+        if (thread.cpu < 0) {
+            oss << "unpinned" << std::endl;
+            return;
+        }
+        oss << "CPU " << std::setw(3) << thread.cpu << "  node " << thread.node << "  "
+            << (thread.shared ? "shared CPU" : thread.dedicated ? "dedicated core" : "hyperthread");
+        if (!thread.note.empty()) {
+            oss << " (" << thread.note << ")";
+        }
+        oss << std::endl;
+    };
+    if (!feedIo.empty()) {
+        line(feedIo.front());
+    }
+    line(processing);
+    for (size_t i = 1; i < feedIo.size(); ++i) {
+        line(feedIo[i]);
+    }
+    line(logger);
+    return oss.str();
+}
+
+CpuTopology ThreadPlacement::readTopology(const std::string& cpuRoot) {
+    CpuTopology topology;
+
+    std::vector<int> online = parseCpuList(readLine(cpuRoot + "/online"));
+    if (online.empty()) {
+        for (long cpu = 0; cpu < ::sysconf(_SC_NPROCESSORS_ONLN); ++cpu) {
+            online.push_back(static_cast<int>(cpu));
+        }
+    }
+    std::sort(online.begin(), online.end());
+    const std::vector<int> isolated = parseCpuList(readLine(cpuRoot + "/isolated"));
+
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    const bool haveAffinity = ::sched_getaffinity(0, sizeof(affinity), &affinity) == 0;
+
+    // Cores are keyed by their sibling list, which names the same CPUs for every sibling
+    std::map<std::vector<int>, int> coreIndex;
+    bool haveNodes = false;
+    for (int id : online) {
+        const std::string dir = cpuRoot + "/cpu" + std::to_string(id);
+        CpuInfo info;
+        info.cpu = id;
+        readInt(dir + "/topology/physical_package_id", info.package);
+        info.node = readCpuNode(dir);
+        haveNodes |= info.node >= 0;
+        info.isolated = std::find(isolated.begin(), isolated.end(), id) != isolated.end();
+        info.allowed = !haveAffinity || (id < CPU_SETSIZE && CPU_ISSET(id, &affinity));
+
+        std::vector<int> siblings = parseCpuList(readLine(dir + "/topology/thread_siblings_list"));
+        siblings.erase(std::remove_if(siblings.begin(), siblings.end(), [&online](int sibling) {
+            return !std::binary_search(online.begin(), online.end(), sibling);
+        }), siblings.end());
+        if (std::find(siblings.begin(), siblings.end(), id) == siblings.end()) {
+            siblings = {id};
+        }
+        std::sort(siblings.begin(), siblings.end());
+        auto found = coreIndex.find(siblings);
+        if (found == coreIndex.end()) {
+            found = coreIndex.emplace(siblings, static_cast<int>(topology.cores.size())).first;
+            topology.cores.push_back(siblings);
+        }
+        info.core = found->second;
+        topology.cpus.push_back(info);
+    }
+
+    // Kernels without the cpuN/nodeK links: take the node map from libnuma
+    if (!haveNodes && cpuRoot == DEFAULT_CPU_ROOT && NUMAUtils::isAvailable()) {
+        const NUMATopology numa = NUMAUtils::getTopology();
+        for (int node = 0; node < static_cast<int>(numa.nodeCpus.size()); ++node) {
+            for (int id : numa.nodeCpus[node]) {
+                for (CpuInfo& info : topology.cpus) {
+                    if (info.cpu == id) {
+                        info.node = node;
+                    }
+                }
+            }
+        }
+    }
+    topology.numNodes = 1;
+    for (CpuInfo& info : topology.cpus) {
+        info.node = std::max(info.node, 0);
+        topology.numNodes = std::max(topology.numNodes, info.node + 1);
+    }
+    return topology;
+}
+
+PlacementPlan ThreadPlacement::plan(const CpuTopology& topology, const std::vector<int>& lineNodes,
+                                    const std::string& ioThreadName) {
+    PlacementPlan plan;
+    // Sized up front: the planner keeps pointers to the assignments
+    plan.feedIo.resize(std::max<size_t>(lineNodes.size(), 1));
+    for (size_t i = 0; i < plan.feedIo.size(); ++i) {
+        plan.feedIo[i].thread = ioThreadName + (plan.feedIo.size() > 1 ? std::to_string(i) : std::string());
+    }
+    plan.processing.thread = "DataProcessor";
+    plan.logger.thread = "AsyncCSVLogger";
+    if (topology.cpus.empty()) {
+        return plan;
+    }
+
+    Planner planner(topology);
+    // Line 0 first on its NIC's node; processing shares its node (and L3), then the other lines
+    const int primaryNode = lineNodes.empty() ? -1 : lineNodes[0];
+    planner.placeHot(plan.feedIo[0], primaryNode);
+    const int hotNode = plan.feedIo[0].cpu >= 0 ? plan.feedIo[0].node : primaryNode;
+    planner.placeHot(plan.processing, hotNode);
+    for (size_t i = 1; i < plan.feedIo.size(); ++i) {
+        planner.placeHot(plan.feedIo[i], lineNodes[i] >= 0 ? lineNodes[i] : hotNode);
+    }
+    planner.placeLogger(plan.logger, hotNode);
+    return plan;
+}
+
+std::string ThreadPlacement::resolveInterface(const std::string& interfaceOrAddress, const std::string& netRoot) {
+    if (interfaceOrAddress.empty()) {
+        return defaultRouteInterface();
+    }
+    if (::access((netRoot + "/" + interfaceOrAddress).c_str(), F_OK) == 0) {
+        return interfaceOrAddress;
+    }
+
+    // A local address: find the interface that carries it
+    std::string name;
+    ifaddrs* addresses = nullptr;
+    if (::getifaddrs(&addresses) != 0) {
+        return name;
+    }
+    for (ifaddrs* entry = addresses; entry != nullptr && name.empty(); entry = entry->ifa_next) {
+        if (entry->ifa_addr == nullptr ||
+            (entry->ifa_addr->sa_family != AF_INET && entry->ifa_addr->sa_family != AF_INET6)) {
+            continue;
+        }
+        char host[NI_MAXHOST];
+        const socklen_t length = entry->ifa_addr->sa_family == AF_INET ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
+        if (::getnameinfo(entry->ifa_addr, length, host, sizeof(host), nullptr, 0, NI_NUMERICHOST) == 0 &&
+            interfaceOrAddress == host) {
+            name = entry->ifa_name;
+        }
+    }
+    ::freeifaddrs(addresses);
+    return name;
+}
+
+int ThreadPlacement::nicNumaNode(const std::string& interfaceOrAddress, const std::string& netRoot) {
+    const std::string name = resolveInterface(interfaceOrAddress, netRoot);
+    int node = -1;
+    if (name.empty()) {
+        return -1;
+    }
+    // Virtio NICs sit below the PCI function that carries the node
+    const std::string deviceDir = netRoot + "/" + name + "/device";
+    if (!readInt(deviceDir + "/numa_node", node) && !readInt(deviceDir + "/../numa_node", node)) {
+        return -1;
+    }
+    return node;
+}
+
+std::vector<int> ThreadPlacement::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range.find_first_not_of(" \t\n") == std::string::npos) {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        const int first = std::atoi(range.c_str());
+        const int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+#endif // __linux__
@@ -57,7 +57,9 @@ std::string TickerData::toCSV() const {
         << escapeField(last_size) << ","
         << std::fixed << std::setprecision(8) << price_ema << ","
         << std::fixed << std::setprecision(8) << mid_price_ema << ","
-        << std::fixed << std::setprecision(8) << mid_price;
+        << std::fixed << std::setprecision(8) << mid_price << ","
+        << std::fixed << std::setprecision(8) << price_zscore << ","
+        << std::fixed << std::setprecision(8) << price_volatility;
     
     return oss.str();
 }
@@ -0,0 +1,118 @@
+/**
+ * @file TimeBars.cpp
+ * @brief Implementation of the multi-timeframe OHLCV aggregator
+ */
+
+#include "TimeBars.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include "OrderBook.h"
+#include "BranchPrediction.h"
+
+const char* OhlcvBar::csvHeader() {
+    return "product_id,timeframe_s,start_time_ns,end_time_ns,open,high,low,close,volume,ticks";
+}
+
+std::string OhlcvBar::toCSV() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(8);
+    oss << product_id << ","
+        << timeframe_s << ","
+        << start_time_ns << ","
+        << end_time_ns << ","
+        << OrderBook::toDouble(open) << ","
+        << OrderBook::toDouble(high) << ","
+        << OrderBook::toDouble(low) << ","
+        << OrderBook::toDouble(close) << ","
+        << OrderBook::toDouble(volume) << ","
+        << ticks;
+    return oss.str();
+}
+
+TimeBarEngine::TimeBarEngine(const std::vector<std::string>& products,
+                             const std::vector<int64_t>& timeframeSeconds,
+                             Sink sink)
+    : m_products(products)
+    , m_wheel(products.size() * std::min(timeframeSeconds.size(), MAX_TIMEFRAMES), WHEEL_RESOLUTION_NS, WHEEL_SLOTS)
+    , m_sink(std::move(sink))
+    , m_completed(0) {
+    for (size_t i = 0; i < timeframeSeconds.size() && i < MAX_TIMEFRAMES; ++i) {
+        m_timeframes.push_back(std::max<int64_t>(timeframeSeconds[i], 1) * WHEEL_RESOLUTION_NS);
+    }
+    m_bars.resize(m_products.size() * m_timeframes.size());
+}
+
+void TimeBarEngine::closeBar(size_t index) {
+    OpenBar& open = m_bars[index];
+    const size_t timeframe = index % m_timeframes.size();
+
+    OhlcvBar bar;
+    bar.product_id = m_products[index / m_timeframes.size()];
+    bar.timeframe_s = m_timeframes[timeframe] / WHEEL_RESOLUTION_NS;
+    bar.start_time_ns = open.start;
+    bar.end_time_ns = open.end;
+    bar.open = open.open;
+    bar.high = open.high;
+    bar.low = open.low;
+    bar.close = open.close;
+    bar.volume = open.volume;
+    bar.ticks = open.ticks;
+    open.ticks = 0;
+    m_completed++;
+    if (m_sink) {
+        m_sink(bar, timeframe);
+    }
+}
+
+void TimeBarEngine::onTick(size_t product, int64_t price, int64_t size, int64_t timeNanos) {
+    const size_t timeframes = m_timeframes.size();
+    OpenBar* bars = &m_bars[product * timeframes];
+    for (size_t i = 0; i < timeframes; ++i) {
+        OpenBar& bar = bars[i];
+        const size_t index = product * timeframes + i;
+        // Tick past the bar end before the wheel got there (feed clock ahead of ours): close now
+        if (UNLIKELY(bar.ticks != 0 && timeNanos >= bar.end)) {
+            m_wheel.cancel(static_cast<uint32_t>(index));
+            closeBar(index);
+        }
+        // First tick of a bar (likely only once per timeframe)
+        if (UNLIKELY(bar.ticks == 0)) {
+            const int64_t length = m_timeframes[i];
+            bar.start = timeNanos - timeNanos % length;
+            bar.end = bar.start + length;
+            bar.open = bar.high = bar.low = price;
+            bar.volume = 0;
+            m_wheel.schedule(static_cast<uint32_t>(index), bar.end);
+        }
+        bar.high = std::max(bar.high, price);
+        bar.low = std::min(bar.low, price);
+        bar.close = price;
+        bar.volume += size;
+        bar.ticks++;
+    }
+}
+
+void TimeBarEngine::advance(int64_t nowNanos) {
+    m_wheel.advance(nowNanos, [this](uint32_t timer) {
+        closeBar(timer);
+    });
+}
+
+std::vector<int64_t> TimeBarEngine::getTimeframeSeconds() const {
+    std::vector<int64_t> seconds;
+    for (int64_t length : m_timeframes) {
+        seconds.push_back(length / WHEEL_RESOLUTION_NS);
+    }
+    return seconds;
+}
+
+std::string TimeBarEngine::timeframeLabel(int64_t seconds) {
+    if (seconds % 3600 == 0) {
+        return std::to_string(seconds / 3600) + "h";
+    }
+    if (seconds % 60 == 0) {
+        return std::to_string(seconds / 60) + "m";
+    }
+    return std::to_string(seconds) + "s";
+}
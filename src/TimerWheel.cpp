@@ -0,0 +1,62 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief Implementation of the hashed timer wheel
+ */
+
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(size_t timers, int64_t resolutionNanos, size_t slots)
+    : m_nodes(timers)
+    , m_resolutionNanos(resolutionNanos > 0 ? resolutionNanos : 1)
+    , m_currentTick(0)
+    , m_started(false) {
+    size_t size = 1;
+    while (size < slots) {
+        size <<= 1;
+    }
+    m_slots.assign(size, NONE);
+    m_mask = size - 1;
+}
+
+void TimerWheel::link(uint32_t timer, size_t slot) {
+    Node& node = m_nodes[timer];
+    node.prev = NONE;
+    node.next = m_slots[slot];
+    if (node.next != NONE) {
+        m_nodes[node.next].prev = timer;
+    }
+    m_slots[slot] = timer;
+    node.armed = true;
+}
+
+void TimerWheel::unlink(uint32_t timer) {
+    Node& node = m_nodes[timer];
+    if (node.prev != NONE) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_slots[static_cast<size_t>(node.deadlineSlot) & m_mask] = node.next;
+    }
+    if (node.next != NONE) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.prev = NONE;
+    node.next = NONE;
+    node.armed = false;
+}
+
+void TimerWheel::schedule(uint32_t timer, int64_t deadlineNanos) {
+    if (m_nodes[timer].armed) {
+        unlink(timer);
+    }
+    Node& node = m_nodes[timer];
+    node.deadlineTick = deadlineNanos / m_resolutionNanos;
+    // Already due: put it where the next advance() looks first
+    node.deadlineSlot = m_started && node.deadlineTick <= m_currentTick ? m_currentTick + 1 : node.deadlineTick;
+    link(timer, static_cast<size_t>(node.deadlineSlot) & m_mask);
+}
+
+void TimerWheel::cancel(uint32_t timer) {
+    if (m_nodes[timer].armed) {
+        unlink(timer);
+    }
+}
@@ -0,0 +1,236 @@
+/**
+ * @file TraceRing.cpp
+ * @brief Implementation of the trace rings, dumps and Chrome trace conversion
+ */
+
+#include "TraceRing.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace {
+    /// Minimum time between two dumps (a burst of breaches writes one file)
+    constexpr int64_t MIN_DUMP_INTERVAL_NANOS = 1000000000LL;
+    /// Dump file magic and version
+    constexpr char TRACE_MAGIC[8] = {'C', 'B', 'T', 'R', 'A', 'C', 'E', '1'};
+    /// Thread name bytes stored per ring
+    constexpr size_t NAME_BYTES = 16;
+
+    /**
+     * @brief Dump file header
+     */
+    struct TraceFileHeader {
+        char magic[8];              ///< TRACE_MAGIC
+        double nanos_per_cycle;     ///< TSC to nanoseconds at dump time
+        uint32_t rings;             ///< Ring sections that follow
+        uint32_t record_size;       ///< sizeof(TraceRecord)
+    };
+
+    /**
+     * @brief Rings of every thread that ever recorded (never freed)
+     */
+    std::vector<TraceRing*>& rings() {
+        static std::vector<TraceRing*> all;
+        return all;
+    }
+
+    std::mutex& ringsMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+}
+
+std::atomic<bool> TraceRecorder::s_dumpRequested{false};
+int64_t TraceRecorder::s_lastDumpNanos = 0;
+uint64_t TraceRecorder::s_dumpCount = 0;
+
+TraceRing::TraceRing(const std::string& name)
+    : m_head(0)
+    , m_name(name) {
+    // Touch every record now so the first events of a thread do not take page faults
+    std::memset(m_records.data(), 0, sizeof(m_records));
+}
+
+void TraceRing::copy(std::vector<TraceRecord>& out) const {
+    const uint64_t head = m_head.load(std::memory_order_acquire);
+    const uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+    out.clear();
+    out.reserve(static_cast<size_t>(head - first));
+    for (uint64_t i = first; i < head; ++i) {
+        out.push_back(m_records[i & (CAPACITY - 1)]);
+    }
+    // Slots the writer reached during the copy may hold newer, possibly torn records
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t after = m_head.load(std::memory_order_relaxed);
+    const uint64_t firstIntact = after >= CAPACITY ? after - CAPACITY + 1 : 0;
+    if (firstIntact > first) {
+        const size_t lost = static_cast<size_t>(std::min(firstIntact - first, head - first));
+        out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(lost));
+    }
+}
+
+TraceRing* TraceRecorder::createLocal(const std::string& threadName) {
+    std::string name = threadName.empty() ? "thread" : threadName;
+#ifdef __linux__
+    char osName[NAME_BYTES] = {};
+    if (threadName.empty() && pthread_getname_np(pthread_self(), osName, sizeof(osName)) == 0 && osName[0] != '\0') {
+        name = osName;
+    }
+#endif
+    TraceRing* ring = new TraceRing(name);
+    std::lock_guard<std::mutex> lock(ringsMutex());
+    rings().push_back(ring);
+    return ring;
+}
+
+TraceRing& TraceRecorder::attachThread(const std::string& name) {
+    TraceRing*& ring = localSlot();
+    if (ring == nullptr) {
+        ring = createLocal(name);
+    }
+    return *ring;
+}
+
+void TraceRecorder::requestDump() noexcept {
+    s_dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::takeDumpRequest() {
+    if (!s_dumpRequested.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    // Requests during the cooldown stay pending and are served when it ends
+    const int64_t now = HighResTimer::nowNanos();
+    if (s_dumpCount > 0 && now - s_lastDumpNanos < MIN_DUMP_INTERVAL_NANOS) {
+        return false;
+    }
+    s_dumpRequested.store(false, std::memory_order_relaxed);
+    s_lastDumpNanos = now;
+    return true;
+}
+
+std::string TraceRecorder::dump(const std::string& prefix) {
+    const std::string filename = prefix + "_" + std::to_string(++s_dumpCount) + ".trace";
+    return dumpTo(filename) ? filename : std::string();
+}
+
+bool TraceRecorder::dumpTo(const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open trace dump " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<TraceRing*> all;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex());
+        all = rings();
+    }
+
+    TraceFileHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.nanos_per_cycle = static_cast<double>(HighResTimer::cyclesToNanos(1000000000ULL)) / 1e9;
+    header.rings = static_cast<uint32_t>(all.size());
+    header.record_size = sizeof(TraceRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<TraceRecord> records;
+    for (const TraceRing* ring : all) {
+        ring->copy(records);
+        char name[NAME_BYTES] = {};
+        std::strncpy(name, ring->getName().c_str(), NAME_BYTES - 1);
+        const uint64_t count = records.size();
+        file.write(name, NAME_BYTES);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+    }
+    return static_cast<bool>(file);
+}
+
+bool TraceRecorder::convertToChromeTrace(const std::string& input, const std::string& output) {
+    std::ifstream in(input, std::ios::binary);
+    TraceFileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(TraceRecord)) {
+        std::cerr << "Not a trace dump: " << input << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> names(header.rings);
+    std::vector<std::vector<TraceRecord>> records(header.rings);
+    uint64_t origin = UINT64_MAX;
+    for (uint32_t r = 0; r < header.rings; ++r) {
+        char name[NAME_BYTES + 1] = {};
+        uint64_t count = 0;
+        if (!in.read(name, NAME_BYTES) || !in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+            std::cerr << "Truncated trace dump: " << input << std::endl;
+            return false;
+        }
+        names[r] = name;
+        records[r].resize(static_cast<size_t>(count));
+        if (!in.read(reinterpret_cast<char*>(records[r].data()),
+                     static_cast<std::streamsize>(count * sizeof(TraceRecord)))) {
+            std::cerr << "Truncated trace dump: " << input << std::endl;
+            return false;
+        }
+        if (!records[r].empty()) {
+            origin = std::min(origin, records[r].front().tsc);
+        }
+    }
+
+    std::ofstream out(output, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << output << std::endl;
+        return false;
+    }
+    // Timestamps are microseconds from the oldest record; one "thread" per ring
+    const double microsPerCycle = header.nanos_per_cycle / 1000.0;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (uint32_t r = 0; r < header.rings; ++r) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r + 1
+            << ",\"args\":{\"name\":\"" << names[r] << "\"}}";
+        first = false;
+        for (const TraceRecord& record : records[r]) {
+            const double ts = static_cast<double>(record.tsc - origin) * microsPerCycle;
+            const TraceEvent event = static_cast<TraceEvent>(record.event);
+            out << ",\n{\"name\":\"" << eventName(record.event) << "\",\"pid\":1,\"tid\":" << r + 1;
+            // Events that carry a duration end at their timestamp: show them as spans
+            if (event == TraceEvent::Process || event == TraceEvent::LogWrite) {
+                const double duration = static_cast<double>(record.b) / 1000.0;
+                out << ",\"ph\":\"X\",\"ts\":" << ts - duration << ",\"dur\":" << duration;
+            } else {
+                out << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << ts;
+            }
+            out << ",\"args\":{\"a\":" << record.a << ",\"b\":" << record.b << "}}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+const char* TraceRecorder::eventName(uint32_t event) noexcept {
+    switch (static_cast<TraceEvent>(event)) {
+        case TraceEvent::Receive:       return "receive";
+        case TraceEvent::Parse:         return "parse";
+        case TraceEvent::Enqueue:       return "enqueue";
+        case TraceEvent::Dequeue:       return "dequeue";
+        case TraceEvent::Process:       return "process";
+        case TraceEvent::LogWrite:      return "log_write";
+        case TraceEvent::BookApply:     return "book_apply";
+        case TraceEvent::Connect:       return "connect";
+        case TraceEvent::Disconnect:    return "disconnect";
+        case TraceEvent::LatencyBreach: return "latency_breach";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file TradeBars.cpp
+ * @brief Implementation of volume and dollar bars
+ */
+
+#include "TradeBars.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include "BranchPrediction.h"
+
+const char* TradeBar::csvHeader() {
+    return "type,product_id,start_time_ns,end_time_ns,open,high,low,close,volume,notional,vwap,trades";
+}
+
+std::string TradeBar::toCSV() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(8);
+    const double volumeUnits = OrderBook::toDouble(volume);
+    oss << (type == BarType::Volume ? "volume" : "dollar") << ","
+        << product_id << ","
+        << start_time_ns << ","
+        << end_time_ns << ","
+        << OrderBook::toDouble(open) << ","
+        << OrderBook::toDouble(high) << ","
+        << OrderBook::toDouble(low) << ","
+        << OrderBook::toDouble(close) << ","
+        << volumeUnits << ","
+        << notional << ","
+        << (volumeUnits > 0.0 ? notional / volumeUnits : 0.0) << ","
+        << trades;
+    return oss.str();
+}
+
+BarBuilder::BarBuilder(BarType type, double threshold)
+    : m_type(type)
+    , m_threshold(threshold) {
+    m_current.type = type;
+}
+
+void BarBuilder::setThreshold(double threshold) {
+    m_threshold = threshold;
+    m_current = TradeBar{};
+    m_current.type = m_type;
+}
+
+bool BarBuilder::add(const TradeData& trade, TradeBar& completed) {
+    if (UNLIKELY(!isEnabled())) {
+        return false;
+    }
+
+    if (m_current.trades == 0) {
+        m_current.product_id = trade.product_id;
+        m_current.open = m_current.high = m_current.low = trade.price;
+        m_current.start_time_ns = trade.exchange_time_ns;
+    }
+    m_current.high = std::max(m_current.high, trade.price);
+    m_current.low = std::min(m_current.low, trade.price);
+    m_current.close = trade.price;
+    m_current.volume += trade.size;
+    m_current.notional += OrderBook::toDouble(trade.price) * OrderBook::toDouble(trade.size);
+    m_current.trades++;
+    m_current.end_time_ns = trade.exchange_time_ns;
+
+    const double filled = m_type == BarType::Volume ? OrderBook::toDouble(m_current.volume) : m_current.notional;
+    // Most trades only add to the open bar
+    if (LIKELY(filled < m_threshold)) {
+        return false;
+    }
+    completed = m_current;
+    m_current.trades = 0;
+    m_current.volume = 0;
+    m_current.notional = 0.0;
+    return true;
+}
@@ -8,13 +8,14 @@
 #include <chrono>
 #include <thread>
 #include <cstring>
+#include <algorithm>
+#include <vector>
 #include "JSONParser.h"
 #include "ThreadUtils.h"
 #include "HighResTimer.h"
 #include "BranchPrediction.h"
-
-// Static instance for callback access
-static WebSocketClient* g_instance = nullptr;
+#include "MemoryLock.h"
+#include "TraceRing.h"
 
 // Protocol definition
 static struct lws_protocols protocols[] = {
@@ -31,46 +32,105 @@ WebSocketClient::WebSocketClient()
     : m_context(nullptr)
     , m_wsi(nullptr)
     , m_connected(false)
-    , m_running(false) {
-    g_instance = this;
+    , m_running(false)
+    , m_allowSelfSigned(false)
+    , m_ioThreadName("WebSocketIO")
+    , m_ioCpuCore(1)
+    , m_port(0)
+    , m_useSsl(false)
+    , m_writeRequested(false)
+    , m_backoffMillis(DEFAULT_BACKOFF_MILLIS)
+    , m_maxBackoffMillis(DEFAULT_MAX_BACKOFF_MILLIS)
+    , m_staleTimeoutMillis(0)
+    , m_failedAttempts(0)
+    , m_nextAttemptNanos(0)
+    , m_lastReceiveTsc(0)
+    , m_closeRequested(false)
+    , m_connectionEpoch(0)
+    , m_reconnects(0)
+    , m_lastDisconnectTsc(0)
+    , m_lastReconnectNanos(0)
+    , m_maxReconnectNanos(0) {
 }
 
 WebSocketClient::~WebSocketClient() {
     disconnect();
-    g_instance = nullptr;
 }
 
 void WebSocketClient::setMessageCallback(MessageCallback callback) {
     m_messageCallback = callback;
 }
 
+void WebSocketClient::setConnectionCallback(ConnectionCallback callback) {
+    m_connectionCallback = callback;
+}
+
+void WebSocketClient::setInterface(const std::string& iface) {
+    m_interface = iface;
+}
+
+void WebSocketClient::setIoThread(const std::string& threadName, int cpuCore) {
+    m_ioThreadName = threadName;
+    m_ioCpuCore = cpuCore;
+}
+
+void WebSocketClient::setAllowSelfSigned(bool allow) {
+    m_allowSelfSigned = allow;
+}
+
+void WebSocketClient::setReconnectBackoff(int64_t initialMillis, int64_t maxMillis) {
+    m_backoffMillis = std::max<int64_t>(initialMillis, 1);
+    m_maxBackoffMillis = std::max(maxMillis, m_backoffMillis);
+}
+
+void WebSocketClient::setStaleTimeout(int64_t millis) {
+    m_staleTimeoutMillis = std::max<int64_t>(millis, 0);
+}
+
 bool WebSocketClient::connect(const std::string& uri) {
     // Parse URI
-    std::string protocol, host, path;
-    int port = 443;
+    std::string host, path;
+    int port;
+    size_t start;
     
     if (uri.find("wss://") == 0) {
-        protocol = "wss";
-        size_t start = 6; // length of "wss://"
-        size_t slash = uri.find('/', start);
-        if (slash == std::string::npos) {
-            host = uri.substr(start);
-            path = "/";
-        } else {
-            host = uri.substr(start, slash - start);
-            path = uri.substr(slash);
-        }
-        
-        // Check for port
-        size_t colon = host.find(':');
-        if (colon != std::string::npos) {
-            port = std::stoi(host.substr(colon + 1));
-            host = host.substr(0, colon);
-        }
+        m_useSsl = true;
+        start = 6; // length of "wss://"
+        port = 443;
+    } else if (uri.find("ws://") == 0) {
+        m_useSsl = false;
+        start = 5; // length of "ws://"
+        port = 80;
     } else {
-        std::cerr << "Only wss:// URLs are supported" << std::endl;
+        std::cerr << "Only ws:// and wss:// URLs are supported" << std::endl;
         return false;
     }
+    
+    size_t slash = uri.find('/', start);
+    if (slash == std::string::npos) {
+        host = uri.substr(start);
+        path = "/";
+    } else {
+        host = uri.substr(start, slash - start);
+        path = uri.substr(slash);
+    }
+    
+    // Check for port
+    size_t colon = host.find(':');
+    if (colon != std::string::npos) {
+        try {
+            port = std::stoi(host.substr(colon + 1));
+        } catch (const std::exception&) {
+            std::cerr << "Invalid port in URI: " << uri << std::endl;
+            return false;
+        }
+        host = host.substr(0, colon);
+    }
+    
+    // Kept for reconnects; lws may refer to these strings while an attempt is in flight
+    m_host = host;
+    m_path = path;
+    m_port = port;
 
     // Create libwebsockets context
     struct lws_context_creation_info info;
@@ -89,22 +149,7 @@ bool WebSocketClient::connect(const std::string& uri) {
         return false;
     }
     
-    // Create WebSocket connection info
-    struct lws_client_connect_info ccinfo;
-    memset(&ccinfo, 0, sizeof(ccinfo));
-    
-    ccinfo.context = m_context;
-    ccinfo.address = host.c_str();
-    ccinfo.port = port;
-    ccinfo.path = path.c_str();
-    ccinfo.host = host.c_str();
-    ccinfo.origin = host.c_str();
-    ccinfo.protocol = "coinbase-protocol";
-    ccinfo.ssl_connection = LCCSCF_USE_SSL;
-    ccinfo.userdata = this;
-    
-    m_wsi = lws_client_connect_via_info(&ccinfo);
-    if (!m_wsi) {
+    if (!openConnection()) {
         std::cerr << "Failed to create WebSocket connection" << std::endl;
         lws_context_destroy(m_context);
         m_context = nullptr;
@@ -116,29 +161,66 @@ bool WebSocketClient::connect(const std::string& uri) {
     // Start I/O thread
     m_ioThread = std::thread(&WebSocketClient::runIO, this);
     
-    // Wait for connection to establish
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    // Wait for the first connection; later drops are handled by the I/O thread
+    const int64_t deadline = HighResTimer::nowMillis() + CONNECT_TIMEOUT_MILLIS;
+    while (!m_connected.load() && HighResTimer::nowMillis() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
     
     return m_connected.load();
 }
 
+bool WebSocketClient::openConnection() {
+    // Create WebSocket connection info
+    struct lws_client_connect_info ccinfo;
+    memset(&ccinfo, 0, sizeof(ccinfo));
+    
+    ccinfo.context = m_context;
+    ccinfo.address = m_host.c_str();
+    ccinfo.port = m_port;
+    ccinfo.path = m_path.c_str();
+    ccinfo.host = m_host.c_str();
+    ccinfo.origin = m_host.c_str();
+    ccinfo.protocol = "coinbase-protocol";
+    if (m_useSsl) {
+        ccinfo.ssl_connection = LCCSCF_USE_SSL;
+        if (m_allowSelfSigned) {
+            ccinfo.ssl_connection |= LCCSCF_ALLOW_SELFSIGNED | LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK;
+        }
+    }
+    ccinfo.userdata = this;
+    if (!m_interface.empty()) {
+        ccinfo.iface = m_interface.c_str();
+    }
+    
+    m_closeRequested = false;
+    m_nextAttemptNanos = 0;
+    m_wsi = lws_client_connect_via_info(&ccinfo);
+    return m_wsi != nullptr;
+}
+
 void WebSocketClient::disconnect() {
     m_running = false;
-    m_connected = false;
+    
+    // The I/O thread is the only user of the context; it must be gone before the context is
+    if (m_context) {
+        lws_cancel_service(m_context);
+    }
+    if (m_ioThread.joinable()) {
+        m_ioThread.join();
+    }
     
     if (m_wsi) {
         lws_close_reason(m_wsi, LWS_CLOSE_STATUS_NORMAL, nullptr, 0);
-        m_wsi = nullptr;
     }
     
     if (m_context) {
+        // Runs the close callbacks on this thread; m_running is false so nothing reconnects
         lws_context_destroy(m_context);
         m_context = nullptr;
     }
-    
-    if (m_ioThread.joinable()) {
-        m_ioThread.join();
-    }
+    m_wsi = nullptr;
+    m_connected = false;
 }
 
 bool WebSocketClient::isConnected() const {
@@ -150,29 +232,115 @@ bool WebSocketClient::isRunning() const {
 }
 
 bool WebSocketClient::sendMessage(const std::string& message) {
-    // Connected and valid WSI are likely in normal operation
-    if (UNLIKELY(!m_connected.load() || !m_wsi)) {
+    // Connected is likely in normal operation
+    if (UNLIKELY(!m_connected.load())) {
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(m_sendMutex);
-    m_pendingMessage = message;
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_pendingMessages.push_back(message);
+    }
     
-    // Trigger write callback
-    lws_callback_on_writable(m_wsi);
+    // The I/O thread asks for the write callback (lws is not thread-safe)
+    m_writeRequested.store(true, std::memory_order_release);
     
     return true;
 }
 
 bool WebSocketClient::subscribeToTicker(const std::string& productId) {
-    std::string subscriptionMsg = JSONParser::createSubscriptionMessage(productId);
-    return sendMessage(subscriptionMsg);
+    return subscribe({productId}, {"ticker"});
+}
+
+bool WebSocketClient::subscribe(const std::vector<std::string>& productIds, const std::vector<std::string>& channels) {
+    std::string subscriptionMsg = JSONParser::createSubscriptionMessage(productIds, channels);
+    bool connected;
+    {
+        // Same critical section as the replay on connect: either the replay sends it or it is queued here
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_subscriptions.push_back(subscriptionMsg);
+        connected = m_connected.load();
+        if (connected) {
+            m_pendingMessages.push_back(subscriptionMsg);
+        }
+    }
+    
+    if (connected) {
+        m_writeRequested.store(true, std::memory_order_release);
+    }
+    return connected;
+}
+
+uint64_t WebSocketClient::getConnectionEpoch() const {
+    return m_connectionEpoch.load(std::memory_order_relaxed);
+}
+
+uint64_t WebSocketClient::getReconnectCount() const {
+    return m_reconnects.load(std::memory_order_relaxed);
+}
+
+uint64_t WebSocketClient::getLastDisconnectTsc() const {
+    return m_lastDisconnectTsc.load(std::memory_order_acquire);
+}
+
+int64_t WebSocketClient::getLastReconnectNanos() const {
+    return m_lastReconnectNanos.load(std::memory_order_relaxed);
+}
+
+int64_t WebSocketClient::getMaxReconnectNanos() const {
+    return m_maxReconnectNanos.load(std::memory_order_relaxed);
+}
+
+void WebSocketClient::scheduleReconnect(bool wasConnected) {
+    m_connected = false;
+    m_wsi = nullptr;
+    
+    if (wasConnected) {
+        // Outage starts here; the first retry is immediate
+        m_lastDisconnectTsc.store(HighResTimer::nowCycles(), std::memory_order_release);
+        m_failedAttempts = 0;
+        if (m_connectionCallback) {
+            m_connectionCallback(false);
+        }
+    } else {
+        m_failedAttempts++;
+    }
+    
+    // Shutting down: the context is being destroyed
+    if (!m_running.load()) {
+        return;
+    }
+    
+    // 0, initial, 2 x initial, ... capped at the maximum
+    int64_t delayMillis = 0;
+    if (m_failedAttempts > 0) {
+        const uint32_t shift = std::min<uint32_t>(m_failedAttempts - 1, 20);
+        delayMillis = std::min(m_backoffMillis << shift, m_maxBackoffMillis);
+    }
+    m_nextAttemptNanos = HighResTimer::nowNanos() + delayMillis * 1000000LL;
+    std::cerr << "WebSocket reconnecting in " << delayMillis << " ms (attempt "
+              << (m_failedAttempts + 1) << ")" << std::endl;
+}
+
+void WebSocketClient::replaySubscriptions() {
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    // Connected inside the lock so a concurrent subscribe() lands either in the replay or after it
+    m_connected = true;
+    // Anything queued for the old connection is superseded by the subscriptions
+    m_pendingMessages.assign(m_subscriptions.begin(), m_subscriptions.end());
+    if (!m_pendingMessages.empty()) {
+        lws_callback_on_writable(m_wsi);
+    }
 }
 
 void WebSocketClient::runIO() {
     #ifdef __linux__
     // Optimize thread for HFT with NUMA awareness
-    ThreadUtils::optimizeForHFT("WebSocketIO", 1, 99);
+    ThreadUtils::optimizeForHFT(m_ioThreadName, m_ioCpuCore, 99);
+    // Trace ring, stack and arena on this thread's node before the first frame arrives
+    TraceRecorder::attachThread(m_ioThreadName);
+    MemoryLock::prefaultStack(MemoryLock::STACK_PREFAULT_BYTES);
+    MemoryLock::prefaultHeap(MemoryLock::THREAD_HEAP_PREFAULT_BYTES);
     #endif
     
     while (LIKELY(m_running.load())) {
@@ -184,6 +352,29 @@ void WebSocketClient::runIO() {
             break;
         }
         
+        // Writes queued by other threads (unlikely per iteration)
+        if (UNLIKELY(m_writeRequested.load(std::memory_order_acquire)) && m_wsi && m_connected.load()) {
+            m_writeRequested.store(false, std::memory_order_relaxed);
+            lws_callback_on_writable(m_wsi);
+        }
+        
+        // Reconnect once the backoff delay has passed (unlikely while healthy)
+        if (UNLIKELY(!m_wsi && m_nextAttemptNanos != 0) && HighResTimer::nowNanos() >= m_nextAttemptNanos) {
+            // lws may already have reported the failure through CLIENT_CONNECTION_ERROR (which scheduled the retry)
+            if (!openConnection() && m_nextAttemptNanos == 0) {
+                scheduleReconnect(false);
+            }
+        }
+        
+        // A silent connection may be half-open; drop it instead of waiting for TCP
+        if (UNLIKELY(m_staleTimeoutMillis > 0 && m_connected.load() && !m_closeRequested) &&
+            HighResTimer::cyclesToNanos(HighResTimer::nowCycles() - m_lastReceiveTsc) >
+                m_staleTimeoutMillis * 1000000LL) {
+            std::cerr << "WebSocket silent for " << m_staleTimeoutMillis << " ms, reconnecting" << std::endl;
+            m_closeRequested = true;
+            lws_callback_on_writable(m_wsi);
+        }
+        
         // Brief pause if no work to prevent busy waiting (unlikely when active)
         if (UNLIKELY(result == 0)) {
             #ifdef __linux__
@@ -197,7 +388,8 @@ void WebSocketClient::runIO() {
 
 int WebSocketClient::callback(struct lws* wsi, enum lws_callback_reasons reason,
                               void* user, void* in, size_t len) {
-    WebSocketClient* client = getInstance(user);
+    (void)user; // No per-session data; the client is found through the context
+    WebSocketClient* client = getInstance(wsi);
     // Client should always be valid
     if (UNLIKELY(!client)) {
         return -1;
@@ -205,49 +397,102 @@ int WebSocketClient::callback(struct lws* wsi, enum lws_callback_reasons reason,
     
     switch (reason) {
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
-            std::cout << "WebSocket connection established" << std::endl;
-            client->m_connected = true;
+            {
+                client->m_wsi = wsi;
+                client->m_failedAttempts = 0;
+                // A message cut off by the previous connection can never complete
+                client->m_assembler.reset();
+                client->m_lastReceiveTsc = HighResTimer::nowCycles();
+                const uint64_t epoch = client->m_connectionEpoch.fetch_add(1, std::memory_order_relaxed) + 1;
+                const uint64_t disconnectTsc = client->m_lastDisconnectTsc.load(std::memory_order_relaxed);
+                if (disconnectTsc != 0) {
+                    const int64_t recoveryNanos = HighResTimer::cyclesToNanos(client->m_lastReceiveTsc - disconnectTsc);
+                    client->m_reconnects.fetch_add(1, std::memory_order_relaxed);
+                    client->m_lastReconnectNanos.store(recoveryNanos, std::memory_order_relaxed);
+                    if (recoveryNanos > client->m_maxReconnectNanos.load(std::memory_order_relaxed)) {
+                        client->m_maxReconnectNanos.store(recoveryNanos, std::memory_order_relaxed);
+                    }
+                    std::cout << "WebSocket reconnected in " << recoveryNanos / 1000000 << " ms (epoch "
+                              << epoch << ")" << std::endl;
+                } else {
+                    std::cout << "WebSocket connection established" << std::endl;
+                }
+                // Marks the connection up together with the replay
+                client->replaySubscriptions();
+                if (client->m_connectionCallback) {
+                    client->m_connectionCallback(true);
+                }
+            }
             break;
             
         case LWS_CALLBACK_CLIENT_RECEIVE:
             // Receive callback is the hot path - most common case
-            if (LIKELY(in && len > 0)) {
-                std::string message(static_cast<char*>(in), len);
-                if (LIKELY(client->m_messageCallback)) {
-                    client->m_messageCallback(message);
+            {
+                // Stamp before any copying so queueing delay is fully visible downstream
+                const uint64_t receiveTsc = HighResTimer::nowCycles();
+                client->m_lastReceiveTsc = receiveTsc;
+                // Messages beyond the rx buffer (level2 snapshots) arrive over several callbacks
+                const bool last = lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0;
+                MessageAssembler& assembler = client->m_assembler;
+                if (assembler.append(static_cast<const char*>(in), len, last, receiveTsc) &&
+                    LIKELY(!assembler.message().empty() && client->m_messageCallback)) {
+                    // Stamped at the first chunk: the whole message was in flight from then on
+                    client->m_messageCallback(assembler.message(), assembler.receiveTsc());
                 }
             }
             break;
             
         case LWS_CALLBACK_CLIENT_WRITEABLE:
             {
-                std::lock_guard<std::mutex> lock(client->m_sendMutex);
-                // Pending message is likely when writeable callback is triggered
-                if (LIKELY(!client->m_pendingMessage.empty())) {
-                    unsigned char* buf = new unsigned char[LWS_PRE + client->m_pendingMessage.length()];
-                    memcpy(buf + LWS_PRE, client->m_pendingMessage.c_str(), client->m_pendingMessage.length());
-                    
-                    int result = lws_write(wsi, buf + LWS_PRE, client->m_pendingMessage.length(), LWS_WRITE_TEXT);
+                // Stale connection: returning -1 makes lws close it (and call CLIENT_CLOSED)
+                if (UNLIKELY(client->m_closeRequested)) {
+                    return -1;
+                }
+                
+                std::string message;
+                bool more = false;
+                {
+                    std::lock_guard<std::mutex> lock(client->m_sendMutex);
+                    // Pending message is likely when writeable callback is triggered
+                    if (LIKELY(!client->m_pendingMessages.empty())) {
+                        message = std::move(client->m_pendingMessages.front());
+                        client->m_pendingMessages.pop_front();
+                        more = !client->m_pendingMessages.empty();
+                    }
+                }
+                
+                if (LIKELY(!message.empty())) {
+                    std::vector<unsigned char> buf(LWS_PRE + message.length());
+                    memcpy(buf.data() + LWS_PRE, message.c_str(), message.length());
                     
-                    delete[] buf;
-                    client->m_pendingMessage.clear();
+                    int result = lws_write(wsi, buf.data() + LWS_PRE, message.length(), LWS_WRITE_TEXT);
                     
                     // Write errors are unlikely
                     if (UNLIKELY(result < 0)) {
                         return -1;
                     }
                 }
+                
+                // One frame per writeable callback; ask again for the rest
+                if (more) {
+                    lws_callback_on_writable(wsi);
+                }
             }
             break;
             
         case LWS_CALLBACK_CLIENT_CLOSED:
             std::cout << "WebSocket connection closed" << std::endl;
-            client->m_connected = false;
+            client->scheduleReconnect(true);
             break;
             
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
-            std::cerr << "WebSocket connection error" << std::endl;
-            client->m_connected = false;
+            std::cerr << "WebSocket connection error";
+            if (in) {
+                std::cerr << ": " << static_cast<const char*>(in);
+            }
+            std::cerr << std::endl;
+            // An established connection can also fail (e.g. TLS error mid-stream)
+            client->scheduleReconnect(client->m_connected.load());
             break;
             
         default:
@@ -257,6 +502,7 @@ int WebSocketClient::callback(struct lws* wsi, enum lws_callback_reasons reason,
     return 0;
 }
 
-WebSocketClient* WebSocketClient::getInstance(void* user) {
-    return g_instance;
-}
\ No newline at end of file
+WebSocketClient* WebSocketClient::getInstance(struct lws* wsi) {
+    // Each client owns its context, so several clients can run side by side
+    return static_cast<WebSocketClient*>(lws_context_user(lws_get_context(wsi)));
+}
@@ -5,10 +5,15 @@
 
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <chrono>
 #include <signal.h>
 #include <memory>
+#include <vector>
+#include <algorithm>
 #include "CoinbaseTickerAnalyzer.h"
 #include "HighResTimer.h"
+#include "TraceRing.h"
 
 // Global analyzer instance for signal handling
 std::unique_ptr<CoinbaseTickerAnalyzer> g_analyzer;
@@ -24,6 +29,27 @@ void signalHandler(int signal) {
     }
 }
 
+/**
+ * @brief SIGUSR1 handler: ask the main loop for a trace dump
+ * @param signal Signal number
+ */
+void traceSignalHandler(int) {
+    TraceRecorder::requestDump();
+}
+
+/**
+ * @brief Write the trace rings if a dump was requested
+ * @param prefix Dump file prefix
+ */
+void serviceTraceDump(const std::string& prefix) {
+    if (TraceRecorder::takeDumpRequest()) {
+        const std::string path = TraceRecorder::dump(prefix);
+        if (!path.empty()) {
+            std::cout << "Trace dumped to " << path << std::endl;
+        }
+    }
+}
+
 /**
  * @brief Print usage information
  * @param programName Name of the program
@@ -31,13 +57,45 @@ void signalHandler(int signal) {
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [options]" << std::endl;
     std::cout << "Options:" << std::endl;
-    std::cout << "  -p, --product <ID>    Product ID to analyze (default: BTC-USD)" << std::endl;
+    std::cout << "  -p, --product <ID>[,<ID>]  Product ID(s) to analyze (default: BTC-USD)" << std::endl;
+    std::cout << "  --channels <list>     Channels to subscribe to, e.g. ticker,level2_batch,matches (default: ticker)" << std::endl;
+    std::cout << "  --vwap-windows <list> Rolling VWAP windows in seconds from matches (default: 60,300,900)" << std::endl;
+    std::cout << "  --volume-bar <size>   Volume per volume bar, written to <output>_bars.csv (default: 10, 0 = off)" << std::endl;
+    std::cout << "  --dollar-bar <value>  Notional per dollar bar (default: 1000000, 0 = off)" << std::endl;
+    std::cout << "  --time-bars <list>    OHLCV bar timeframes in seconds, written to <output>_ohlcv_<tf>.csv (default: 1,60,300, none = off)" << std::endl;
+    std::cout << "  --stats-window <sec>  Window of the rolling price statistics: volatility, z-score, min/max (default: 60)" << std::endl;
+    std::cout << "  --indicators <list>   Per-tick indicators: ema(n),sma(n),macd(f,s,sig),rsi(n),bb(n,k),atr(n),cross(f,s)" << std::endl;
+    std::cout << "                        (default: macd(12,26,9),rsi(14),bb(20,2),atr(14), none = off)" << std::endl;
+    std::cout << "  --corr-bucket <ms>    Return bucket for cross-product correlations and betas (default: 1000, 0 = off)" << std::endl;
+    std::cout << "  --corr-window <n>     Buckets in the correlation window (default: 300)" << std::endl;
     std::cout << "  -o, --output <file>   Output CSV filename (default: ticker_data.csv)" << std::endl;
+    std::cout << "  -l, --latency-report <sec>  Print stage latency percentiles every <sec> seconds (default: 10, 0 = off)" << std::endl;
+    std::cout << "  -m, --monitor <sec>   Print a per-product status table every <sec> seconds (default: 1, 0 = off)" << std::endl;
+    std::cout << "  -e, --endpoint <uri>  Feed WebSocket URI, ws:// or wss:// (default: wss://ws-feed.exchange.coinbase.com)" << std::endl;
+    std::cout << "  --insecure            Accept self-signed TLS certificates (local mock exchange)" << std::endl;
+    std::cout << "  --lines <n>           Open <n> redundant connections, first copy of each message wins (default: 1)" << std::endl;
+    std::cout << "  --iface <if>[,<if>]   Local interface or IP per line (implies one line per entry)" << std::endl;
+    std::cout << "  --stale-timeout <ms>  Reconnect when the feed is silent for <ms> milliseconds (default: 0 = off)" << std::endl;
+    std::cout << "  --irq-plan            Print suggested smp_affinity_list settings for the feed NIC's RX interrupts" << std::endl;
+    std::cout << "  --no-mlock            Skip mlockall() at startup (queues, heap and stacks are still pre-faulted)" << std::endl;
+    std::cout << "  --metrics-port <port> Serve Prometheus metrics on http://127.0.0.1:<port>/metrics (default: 0 = off)" << std::endl;
+    std::cout << "  --trace-prefix <path> Trace dumps (SIGUSR1 or --trace-threshold) go to <path>_<n>.trace (default: trace)" << std::endl;
+    std::cout << "  --trace-threshold <us> Dump the trace rings when a tick's receive->processed latency exceeds <us> (default: 0 = off)" << std::endl;
+    std::cout << "  --trace-to-json <dump> Convert a trace dump to <dump>.json (chrome://tracing, Perfetto) and exit" << std::endl;
+    std::cout << "  --capture <file>      Record raw feed frames to <file> for later replay" << std::endl;
+    std::cout << "  --replay <file>       Feed the pipeline from a capture file instead of the live feed" << std::endl;
+    std::cout << "  --replay-speed <x>    Replay pacing: 0 = max speed (default), 1 = real time, N = N x real time" << std::endl;
     std::cout << "  -h, --help           Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << programName << " -p ETH-USD -o eth_data.csv" << std::endl;
     std::cout << "  " << programName << " --product BTC-USD --output btc_ticker.csv" << std::endl;
+    std::cout << "  " << programName << " -p BTC-USD,ETH-USD --channels ticker,level2_batch" << std::endl;
+    std::cout << "  " << programName << " --endpoint ws://localhost:8080" << std::endl;
+    std::cout << "  " << programName << " --lines 2 --iface eth0,eth1" << std::endl;
+    std::cout << "  " << programName << " --capture btc_feed.bin" << std::endl;
+    std::cout << "  " << programName << " --replay btc_feed.bin --replay-speed 10" << std::endl;
+    std::cout << "  " << programName << " --trace-to-json trace_1.trace" << std::endl;
 }
 
 /**
@@ -52,6 +110,30 @@ int main(int argc, char* argv[]) {
     
     std::string productId = "BTC-USD";
     std::string outputFile = "ticker_data.csv";
+    int latencyReportSeconds = 10;
+    int monitorSeconds = 1;
+    std::string endpoint;
+    bool allowSelfSigned = false;
+    int64_t staleTimeoutMillis = 0;
+    int metricsPort = 0;
+    bool irqPlan = false;
+    bool lockMemory = true;
+    std::string tracePrefix = "trace";
+    int64_t traceThresholdMicros = 0;
+    std::string channels = "ticker";
+    std::vector<int64_t> vwapWindows = {60, 300, 900};
+    double volumeBarSize = 10.0;
+    double dollarBarSize = 1000000.0;
+    std::vector<int64_t> timeBars = {1, 60, 300};
+    int64_t statsWindowSeconds = 60;
+    std::string indicators = "macd(12,26,9),rsi(14),bb(20,2),atr(14)";
+    int64_t correlationBucketMillis = 1000;
+    size_t correlationWindow = 300;
+    size_t feedLines = 1;
+    std::vector<std::string> lineInterfaces;
+    std::string captureFile;
+    std::string replayFile;
+    double replaySpeed = 0.0;
     
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -74,6 +156,213 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: --output requires a value" << std::endl;
                 return 1;
             }
+        } else if (arg == "-l" || arg == "--latency-report") {
+            if (i + 1 < argc) {
+                latencyReportSeconds = std::atoi(argv[++i]);
+            } else {
+                std::cerr << "Error: --latency-report requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-m" || arg == "--monitor") {
+            if (i + 1 < argc) {
+                monitorSeconds = std::max(0, std::atoi(argv[++i]));
+            } else {
+                std::cerr << "Error: --monitor requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-e" || arg == "--endpoint") {
+            if (i + 1 < argc) {
+                endpoint = argv[++i];
+            } else {
+                std::cerr << "Error: --endpoint requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--insecure") {
+            allowSelfSigned = true;
+        } else if (arg == "--lines") {
+            if (i + 1 < argc) {
+                feedLines = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+            } else {
+                std::cerr << "Error: --lines requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--iface") {
+            if (i + 1 < argc) {
+                std::string list = argv[++i];
+                size_t start = 0;
+                while (start <= list.size()) {
+                    size_t comma = list.find(',', start);
+                    if (comma == std::string::npos) {
+                        comma = list.size();
+                    }
+                    // An empty name would silently bind that line to the default route
+                    if (comma == start) {
+                        std::cerr << "Error: --iface has an empty interface name: " << list << std::endl;
+                        return 1;
+                    }
+                    lineInterfaces.push_back(list.substr(start, comma - start));
+                    start = comma + 1;
+                }
+            } else {
+                std::cerr << "Error: --iface requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--channels") {
+            if (i + 1 < argc) {
+                channels = argv[++i];
+            } else {
+                std::cerr << "Error: --channels requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--vwap-windows") {
+            if (i + 1 < argc) {
+                vwapWindows.clear();
+                std::string list = argv[++i];
+                size_t start = 0;
+                while (start < list.size()) {
+                    size_t comma = list.find(',', start);
+                    if (comma == std::string::npos) {
+                        comma = list.size();
+                    }
+                    vwapWindows.push_back(std::max<int64_t>(1, std::atoll(list.substr(start, comma - start).c_str())));
+                    start = comma + 1;
+                }
+            } else {
+                std::cerr << "Error: --vwap-windows requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--volume-bar") {
+            if (i + 1 < argc) {
+                volumeBarSize = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --volume-bar requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--dollar-bar") {
+            if (i + 1 < argc) {
+                dollarBarSize = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --dollar-bar requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--time-bars") {
+            if (i + 1 < argc) {
+                timeBars.clear();
+                std::string list = argv[++i];
+                size_t start = 0;
+                while (list != "none" && start < list.size()) {
+                    size_t comma = list.find(',', start);
+                    if (comma == std::string::npos) {
+                        comma = list.size();
+                    }
+                    timeBars.push_back(std::max<int64_t>(1, std::atoll(list.substr(start, comma - start).c_str())));
+                    start = comma + 1;
+                }
+            } else {
+                std::cerr << "Error: --time-bars requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stats-window") {
+            if (i + 1 < argc) {
+                statsWindowSeconds = std::max<int64_t>(1, std::atoll(argv[++i]));
+            } else {
+                std::cerr << "Error: --stats-window requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--indicators") {
+            if (i + 1 < argc) {
+                indicators = argv[++i];
+                if (indicators == "none") {
+                    indicators.clear();
+                }
+            } else {
+                std::cerr << "Error: --indicators requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--corr-bucket") {
+            if (i + 1 < argc) {
+                correlationBucketMillis = std::max<int64_t>(0, std::atoll(argv[++i]));
+            } else {
+                std::cerr << "Error: --corr-bucket requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--corr-window") {
+            if (i + 1 < argc) {
+                correlationWindow = static_cast<size_t>(std::max(2, std::atoi(argv[++i])));
+            } else {
+                std::cerr << "Error: --corr-window requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stale-timeout") {
+            if (i + 1 < argc) {
+                staleTimeoutMillis = std::atoll(argv[++i]);
+            } else {
+                std::cerr << "Error: --stale-timeout requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--irq-plan") {
+            irqPlan = true;
+        } else if (arg == "--no-mlock") {
+            lockMemory = false;
+        } else if (arg == "--metrics-port") {
+            if (i + 1 < argc) {
+                metricsPort = std::atoi(argv[++i]);
+                if (metricsPort < 0 || metricsPort > 65535) {
+                    std::cerr << "Error: --metrics-port must be 0-65535" << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --metrics-port requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--trace-prefix") {
+            if (i + 1 < argc) {
+                tracePrefix = argv[++i];
+            } else {
+                std::cerr << "Error: --trace-prefix requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--trace-threshold") {
+            if (i + 1 < argc) {
+                traceThresholdMicros = std::max<int64_t>(0, std::atoll(argv[++i]));
+            } else {
+                std::cerr << "Error: --trace-threshold requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--trace-to-json") {
+            if (i + 1 < argc) {
+                const std::string dumpFile = argv[++i];
+                const std::string jsonFile = dumpFile + ".json";
+                if (!TraceRecorder::convertToChromeTrace(dumpFile, jsonFile)) {
+                    return 1;
+                }
+                std::cout << "Wrote " << jsonFile << std::endl;
+                return 0;
+            } else {
+                std::cerr << "Error: --trace-to-json requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--capture") {
+            if (i + 1 < argc) {
+                captureFile = argv[++i];
+            } else {
+                std::cerr << "Error: --capture requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--replay") {
+            if (i + 1 < argc) {
+                replayFile = argv[++i];
+            } else {
+                std::cerr << "Error: --replay requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--replay-speed") {
+            if (i + 1 < argc) {
+                replaySpeed = std::atof(argv[++i]);
+            } else {
+                std::cerr << "Error: --replay-speed requires a value" << std::endl;
+                return 1;
+            }
         } else if (arg == "--") {
             // Docker separator - ignore and continue
             continue;
@@ -84,9 +373,24 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (!captureFile.empty() && !replayFile.empty()) {
+        std::cerr << "Error: --capture and --replay cannot be combined" << std::endl;
+        return 1;
+    }
+    
+    // Keep the TSC conversion locked to CLOCK_MONOTONIC_RAW for the whole session
+    HighResTimer::startRecalibration(1000);
+    if (HighResTimer::isUsingTSC()) {
+        std::cout << "Clock: invariant TSC @ " << HighResTimer::getTscFrequencyGHz()
+                  << " GHz, recalibrating every 1s" << std::endl;
+    } else {
+        std::cout << "Clock: clock_gettime(CLOCK_MONOTONIC_RAW)" << std::endl;
+    }
+    
     // Set up signal handlers for graceful shutdown
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    signal(SIGUSR1, traceSignalHandler);
     
     std::cout << "=== Coinbase Ticker Analyzer ===" << std::endl;
     std::cout << "Product ID: " << productId << std::endl;
@@ -97,22 +401,62 @@ int main(int argc, char* argv[]) {
     try {
         // Create and start the analyzer
         g_analyzer = std::make_unique<CoinbaseTickerAnalyzer>(productId, outputFile);
+        if (!endpoint.empty()) {
+            g_analyzer->setEndpoint(endpoint, allowSelfSigned);
+        }
+        g_analyzer->setChannels(channels);
+        g_analyzer->setTradeAnalytics(vwapWindows, volumeBarSize, dollarBarSize);
+        g_analyzer->setTimeBars(timeBars);
+        g_analyzer->setStatsWindow(statsWindowSeconds);
+        g_analyzer->setIndicators(indicators);
+        g_analyzer->setCorrelation(correlationBucketMillis, correlationWindow);
+        g_analyzer->setFeedLines(feedLines, lineInterfaces);
+        g_analyzer->setStaleTimeout(staleTimeoutMillis);
+        g_analyzer->setMetricsPort(metricsPort);
+        g_analyzer->setMonitorInterval(static_cast<int64_t>(monitorSeconds) * 1000);
+        g_analyzer->setTraceThreshold(traceThresholdMicros);
+        g_analyzer->setIrqPlan(irqPlan);
+        g_analyzer->setMemoryLock(lockMemory);
+        g_analyzer->setCaptureFile(captureFile);
+        g_analyzer->setReplaySource(replayFile, replaySpeed);
         
         if (!g_analyzer->start()) {
             std::cerr << "Failed to start the analyzer" << std::endl;
+            HighResTimer::stopRecalibration();
             return 1;
         }
         
-        // Keep the main thread alive
+        // Keep the main thread alive, periodically dumping stage latencies
+        auto lastReport = std::chrono::steady_clock::now();
         while (g_analyzer->isRunning()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            
+            auto now = std::chrono::steady_clock::now();
+            if (latencyReportSeconds > 0 &&
+                now - lastReport >= std::chrono::seconds(latencyReportSeconds)) {
+                std::cout << g_analyzer->getLatencyReport() << std::flush;
+                lastReport = now;
+            }
+            
+            serviceTraceDump(tracePrefix);
+            
+            // Replay runs end on their own once the whole file went through the pipeline
+            if (g_analyzer->isSourceExhausted()) {
+                g_analyzer->stop();
+                std::cout << g_analyzer->getStatistics();
+                std::cout << g_analyzer->getLatencyReport() << std::flush;
+            }
         }
+        // A breach in the last loop pass still gets its dump
+        serviceTraceDump(tracePrefix);
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
+        HighResTimer::stopRecalibration();
         return 1;
     }
     
+    HighResTimer::stopRecalibration();
     std::cout << "Application terminated successfully" << std::endl;
     return 0;
 }
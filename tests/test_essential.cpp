@@ -6,10 +6,52 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 #include "EMACalculator.h"
 #include "JSONParser.h"
 #include "TickerData.h"
 #include "LockFreeRingBuffer.h"
+#include "LatencyHistogram.h"
+#include "HighResTimer.h"
+#include "FeedCapture.h"
+#include "FeedReplayer.h"
+#include "SequenceTracker.h"
+#include "FeedArbiter.h"
+#include "OrderBook.h"
+#include "BookSignals.h"
+#include "RollingVWAP.h"
+#include "TradeBars.h"
+#include "BarLogger.h"
+#include "TimeBars.h"
+#include "RollingStats.h"
+#include "IndicatorGraph.h"
+#include "IndicatorPipeline.h"
+#include "CorrelationMatrix.h"
+#include "ProductSnapshot.h"
+#include "SeqLock.h"
+#include "MetricsRegistry.h"
+#include "MetricsServer.h"
+#include "ConsoleMonitor.h"
+#include "TraceRing.h"
+#include "ThreadPlacement.h"
+#include "NicLocality.h"
+#include "MemoryLock.h"
+#include "NUMAUtils.h"
+#include "MessageAssembler.h"
 
 // Test EMA Calculator
 TEST(EMATest, BasicCalculation) {
@@ -68,34 +110,38 @@ TEST(EMATest, EMAMathematics) {
 
 // Test Thread Safety - Concurrent Access
 TEST(EMATest, ThreadSafety) {
-    EMACalculator calculator(5);
+    // One updating thread, as documented; readers must never see the flag without the seed
+    IntervalEMA ema(5);
     auto base_time = std::chrono::system_clock::now();
+    std::atomic<bool> done{false};
+    std::atomic<int> badReads{0};
     
-    std::vector<std::thread> threads;
-    std::vector<double> results(10);
-    
-    // Launch multiple threads updating EMA simultaneously
-    for (int i = 0; i < 10; ++i) {
-        threads.emplace_back([&calculator, &results, i, base_time]() {
-            auto thread_time = base_time + std::chrono::seconds(i);
-            results[i] = calculator.updatePriceEMA(100.0 + i, thread_time);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&ema, &done, &badReads]() {
+            while (!done.load(std::memory_order_acquire)) {
+                if (ema.isInitialized()) {
+                    const double value = ema.get();
+                    if (value < 100.0 || value > 200.0) {
+                        badReads.fetch_add(1);
+                    }
+                }
+            }
         });
     }
-    
-    // Wait for all threads
-    for (auto& t : threads) {
+    for (int round = 0; round < 200; ++round) {
+        ema.reset();
+        for (int i = 0; i <= 100; ++i) {
+            ema.update(100.0 + i, base_time + std::chrono::seconds(5 * i));
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) {
         t.join();
     }
     
-    // Should not crash and should have some valid results
-    bool hasValidResults = false;
-    for (double result : results) {
-        if (result > 0) {
-            hasValidResults = true;
-            break;
-        }
-    }
-    EXPECT_TRUE(hasValidResults);
+    EXPECT_EQ(badReads.load(), 0);
+    EXPECT_GT(ema.get(), 100.0);
 }
 
 // Test JSON Parser
@@ -115,8 +161,999 @@ TEST(JSONTest, ParseTickerMessage) {
     EXPECT_EQ(data.price, "50000.00");
     EXPECT_EQ(data.best_bid, "49999.50");
     EXPECT_EQ(data.best_ask, "50000.50");
+    EXPECT_EQ(data.sequence_number, 12345u);
+}
+
+// Test exchange timestamp parsing (UTC, sub-second precision)
+TEST(JSONTest, ParseTimestampNanos) {
+    EXPECT_EQ(JSONParser::parseTimestampNanos("1970-01-01T00:00:00Z"), 0);
+    EXPECT_EQ(JSONParser::parseTimestampNanos("2024-01-01T12:00:00.000Z"), 1704110400000000000LL);
+    EXPECT_EQ(JSONParser::parseTimestampNanos("2024-02-29T23:59:59.123456Z"), 1709251199123456000LL);
+    EXPECT_EQ(JSONParser::parseTimestampNanos("not a timestamp"), 0);
+}
+
+// Test reassembly of a level2 snapshot delivered in rx-buffer sized chunks
+TEST(MessageAssemblerTest, SnapshotAcrossChunks) {
+    // 1000 levels per side, well beyond one 4 KB receive chunk
+    std::string snapshot = R"({"type":"snapshot","product_id":"BTC-USD","bids":[)";
+    for (int i = 0; i < 1000; ++i) {
+        snapshot += (i ? "," : "") + std::string("[\"") + std::to_string(50000 - i) + ".00\",\"0.125\"]";
+    }
+    snapshot += R"(],"asks":[)";
+    for (int i = 0; i < 1000; ++i) {
+        snapshot += (i ? "," : "") + std::string("[\"") + std::to_string(50001 + i) + ".00\",\"0.250\"]";
+    }
+    snapshot += "]}";
+    const size_t chunk = 4096;
+    ASSERT_GT(snapshot.size(), 4 * chunk);
+    
+    MessageAssembler assembler(1024);
+    // A message cut off by a dropped connection is discarded
+    EXPECT_FALSE(assembler.append(snapshot.data(), chunk, false, 1));
+    EXPECT_TRUE(assembler.inProgress());
+    assembler.reset();
+    
+    size_t completed = 0;
+    for (size_t offset = 0; offset < snapshot.size(); offset += chunk) {
+        const size_t len = std::min(chunk, snapshot.size() - offset);
+        const bool last = offset + len == snapshot.size();
+        // No chunk but the last one is a message of its own
+        EXPECT_EQ(assembler.append(snapshot.data() + offset, len, last, 100 + offset), last);
+        completed += last;
+    }
+    ASSERT_EQ(completed, 1u);
+    EXPECT_EQ(assembler.message(), snapshot);
+    EXPECT_EQ(assembler.receiveTsc(), 100u);
+    
+    Level2Message parsed;
+    ASSERT_TRUE(JSONParser::parseLevel2Message(assembler.message(), parsed));
+    EXPECT_TRUE(parsed.snapshot);
+    EXPECT_EQ(parsed.changes.size(), 2000u);
+    
+    // The next single-chunk message replaces it, stamped on its own
+    const std::string ticker = R"({"type":"ticker","sequence":1})";
+    EXPECT_TRUE(assembler.append(ticker.data(), ticker.size(), true, 7));
+    EXPECT_EQ(assembler.message(), ticker);
+    EXPECT_EQ(assembler.receiveTsc(), 7u);
+}
+
+#ifdef __linux__
+// Test capture/replay round trip: payloads, order and relative timing survive
+TEST(FeedCaptureTest, ReplayRoundTrip) {
+    const std::string path = "/tmp/test_feed_capture_" + std::to_string(::getpid()) + ".bin";
+    const std::vector<std::string> payloads = {
+        R"({"type":"ticker","sequence":1})", "", std::string("bin\0ary", 7), R"({"type":"ticker","sequence":4})"
+    };
+    const int64_t gapNanos = 20000000;
+    HighResTimer::initialize();
+    const double cyclesPerNano = HighResTimer::isUsingTSC() ? HighResTimer::getTscFrequencyGHz() : 1.0;
+    
+    {
+        FeedCapture capture(path);
+        ASSERT_TRUE(capture.isReady());
+        const uint64_t base = HighResTimer::nowCycles();
+        for (size_t i = 0; i < payloads.size(); ++i) {
+            const uint64_t tsc = base + static_cast<uint64_t>(static_cast<double>(i * gapNanos) * cyclesPerNano);
+            ASSERT_TRUE(capture.record(payloads[i], tsc));
+        }
+        capture.close();
+        EXPECT_EQ(capture.getFramesRecorded(), payloads.size());
+        EXPECT_EQ(capture.getFramesDropped(), 0u);
+    }
+    
+    std::vector<std::string> replayed;
+    std::vector<int64_t> replayedAt;
+    FeedReplayer replayer(path, 1.0);
+    ASSERT_TRUE(replayer.open());
+    ASSERT_TRUE(replayer.start([&](const std::string& payload, uint64_t) {
+        replayed.push_back(payload);
+        replayedAt.push_back(HighResTimer::nowNanos());
+    }));
+    while (!replayer.isFinished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    replayer.stop();
+    
+    EXPECT_EQ(replayed, payloads);
+    ASSERT_EQ(replayedAt.size(), payloads.size());
+    EXPECT_EQ(replayer.getFramesReplayed(), payloads.size());
+    // Real-time pacing: never early, and late only by scheduling delay
+    for (size_t i = 1; i < replayedAt.size(); ++i) {
+        const int64_t offset = replayedAt[i] - replayedAt[0];
+        EXPECT_GE(offset, static_cast<int64_t>(i) * gapNanos - 500000) << "frame " << i;
+        EXPECT_LE(offset, static_cast<int64_t>(i) * gapNanos + 10000000) << "frame " << i;
+    }
+    std::remove(path.c_str());
+}
+#endif
+
+// Test sequence tracking within and across connections
+TEST(SequenceTrackerTest, ResumptionsAcrossReconnects) {
+    SequenceTracker tracker;
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 100, 1), SequenceResult::First);
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 101, 1), SequenceResult::InOrder);
+    EXPECT_EQ(tracker.onMessage("ETH-USD", 7, 1), SequenceResult::First);
+    // The ticker channel skips sequence numbers by design
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 105, 1), SequenceResult::InOrder);
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 105, 1), SequenceResult::Duplicate);
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 103, 1), SequenceResult::OutOfOrder);
+    
+    // Stale frames replayed right after a reconnect do not hide the resumption
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 104, 2), SequenceResult::OutOfOrder);
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 105, 2), SequenceResult::Duplicate);
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 120, 2), SequenceResult::Resumed);
+    EXPECT_EQ(tracker.getLastSkipped(), 14u);
+    EXPECT_EQ(tracker.onMessage("BTC-USD", 121, 2), SequenceResult::InOrder);
+    EXPECT_EQ(tracker.onMessage("ETH-USD", 8, 2), SequenceResult::Resumed);
+    EXPECT_EQ(tracker.getLastSkipped(), 0u);
+    
+    SequenceStats stats = tracker.getStats();
+    EXPECT_EQ(stats.messages, 11u);
+    EXPECT_EQ(stats.duplicates, 2u);
+    EXPECT_EQ(stats.outOfOrder, 2u);
+    EXPECT_EQ(stats.resumptions, 2u);
+    EXPECT_EQ(stats.reconnectAdvance, 14u);
+}
+
+// Test A/B line arbitration: first copy wins, duplicates dropped
+TEST(FeedArbiterTest, FirstCopyWins) {
+    FeedArbiter arbiter(2);
+    EXPECT_TRUE(arbiter.accept("BTC-USD", 100, 0, 1000));
+    EXPECT_FALSE(arbiter.accept("BTC-USD", 100, 1, 1500));
+    EXPECT_TRUE(arbiter.accept("BTC-USD", 101, 1, 2000));
+    EXPECT_FALSE(arbiter.accept("BTC-USD", 101, 0, 2500));
+    
+    // Line 0 missed 102; line 1's late copy fills the hole
+    EXPECT_TRUE(arbiter.accept("BTC-USD", 103, 0, 3000));
+    EXPECT_TRUE(arbiter.accept("BTC-USD", 102, 1, 3100));
+    EXPECT_FALSE(arbiter.accept("BTC-USD", 103, 1, 3200));
+    
+    // Dequeued second but stamped first: the win moves to line 1
+    EXPECT_TRUE(arbiter.accept("BTC-USD", 104, 0, 4000));
+    EXPECT_FALSE(arbiter.accept("BTC-USD", 104, 1, 3900));
+    
+    // Products are independent
+    EXPECT_TRUE(arbiter.accept("ETH-USD", 100, 1, 5000));
+    
+    EXPECT_EQ(arbiter.getForwarded(), 6u);
+    EXPECT_EQ(arbiter.getWins(0) + arbiter.getWins(1), 6u);
+    EXPECT_EQ(arbiter.getWins(1), 4u);
+    EXPECT_EQ(arbiter.getLagHistogram(1).getCount(), 2u);
+    EXPECT_EQ(arbiter.getLagHistogram(0).getCount(), 2u);
+    
+    // Copies older than the window are dropped
+    for (uint64_t seq = 200; seq < 200 + FeedArbiter::WINDOW_SIZE; ++seq) {
+        arbiter.accept("BTC-USD", seq, 0, 6000 + seq);
+    }
+    EXPECT_FALSE(arbiter.accept("BTC-USD", 150, 1, 9000));
+}
+
+// Test the level2 book and its fixed-point feed parsing
+TEST(OrderBookTest, LevelsAndTruncation) {
+    int64_t value = 0;
+    EXPECT_TRUE(JSONParser::parseFixedPoint("50000.12", 8, value));
+    EXPECT_EQ(value, 5000012000000LL);
+    EXPECT_TRUE(JSONParser::parseFixedPoint("0.000000019", 11, value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(JSONParser::parseFixedPoint("1.2x", 4, value));
+    
+    Level2Message message;
+    ASSERT_TRUE(JSONParser::parseLevel2Message(
+        R"({"type":"l2update","product_id":"BTC-USD","changes":[["buy","100.5","2"],["sell","101","0"]]})", message));
+    ASSERT_EQ(message.changes.size(), 2u);
+    EXPECT_EQ(message.changes[0].side, BookSide::Bid);
+    EXPECT_EQ(message.changes[1].size, 0);
+    
+    const int64_t unit = OrderBook::SCALE;
+    OrderBook book(3);
+    EXPECT_EQ(book.apply(BookSide::Bid, 100 * unit, unit), 0);
+    EXPECT_EQ(book.apply(BookSide::Bid, 99 * unit, unit), 1);
+    EXPECT_EQ(book.apply(BookSide::Bid, 101 * unit, 2 * unit), 0);
+    EXPECT_EQ(book.apply(BookSide::Ask, 103 * unit, unit), 0);
+    EXPECT_EQ(book.apply(BookSide::Ask, 102 * unit, unit), 0);
+    EXPECT_EQ(book.bestBid().price, 101 * unit);
+    EXPECT_EQ(book.bestAsk().price, 102 * unit);
+    EXPECT_EQ(book.level(BookSide::Bid, 2).price, 99 * unit);
+    
+    // Full side: the worst level makes room, a level worse than all of them is not kept
+    EXPECT_EQ(book.apply(BookSide::Bid, 98 * unit, unit), -1);
+    EXPECT_EQ(book.apply(BookSide::Bid, 100 * unit + unit / 2, unit), 1);
+    EXPECT_EQ(book.depth(BookSide::Bid), 3u);
+    EXPECT_EQ(book.level(BookSide::Bid, 2).price, 100 * unit);
+    EXPECT_EQ(book.getTruncatedCount(), 2u);
+    
+    // Size 0 removes; removing an unknown level changes nothing
+    EXPECT_EQ(book.apply(BookSide::Ask, 102 * unit, 0), 0);
+    EXPECT_EQ(book.apply(BookSide::Ask, 105 * unit, 0), -1);
+    const BookTop top = book.top();
+    EXPECT_EQ(top.ask_price, 103 * unit);
+    EXPECT_EQ(top.bid_size, 2 * unit);
+    EXPECT_EQ(top.ask_depth, 1u);
+}
+
+// Test incremental book signals against a full rescan
+TEST(BookSignalsTest, IncrementalMatchesRebuild) {
+    const int64_t unit = OrderBook::SCALE;
+    OrderBook book;
+    BookSignals signals(2);
+    auto apply = [&](BookSide side, int64_t price, int64_t size) {
+        int64_t previousSize;
+        const int distance = book.apply(side, price, size, previousSize);
+        signals.onApply(book, side, price, previousSize, size, distance);
+    };
+    apply(BookSide::Bid, 100 * unit, 1 * unit);
+    apply(BookSide::Ask, 101 * unit, 3 * unit);
+    apply(BookSide::Bid, 99 * unit, 2 * unit);
+    apply(BookSide::Bid, 98 * unit, 4 * unit);   // Beyond the top 2
+    apply(BookSide::Ask, 102 * unit, 1 * unit);
+    
+    BookSignalValues values = signals.compute(book);
+    ASSERT_TRUE(values.valid);
+    EXPECT_DOUBLE_EQ(values.microprice, (100.0 * 3 + 101.0 * 1) / 4);
+    EXPECT_DOUBLE_EQ(values.imbalance, (3.0 - 4.0) / 7.0);
+    EXPECT_NEAR(values.spread_bps, 1.0 / 100.5 * 10000.0, 1e-9);
+    
+    // Top-N set shifts: inserting 99.5 pushes 99 out, removing 100 pulls 99 back in, then an in-place resize
+    apply(BookSide::Bid, 99 * unit + unit / 2, 1 * unit);
+    apply(BookSide::Bid, 100 * unit, 0);
+    apply(BookSide::Ask, 102 * unit, 5 * unit);
+    const int64_t bidTop = signals.getTopSize(BookSide::Bid);
+    const BookSignalValues incremental = signals.compute(book);
+    EXPECT_EQ(bidTop, 3 * unit);
+    
+    signals.rebuild(book);
+    EXPECT_EQ(signals.getTopSize(BookSide::Bid), bidTop);
+    values = signals.compute(book);
+    EXPECT_DOUBLE_EQ(values.imbalance, incremental.imbalance);
+    EXPECT_DOUBLE_EQ(values.depth_weighted_mid, incremental.depth_weighted_mid);
+    EXPECT_NEAR(values.depth_weighted_mid, ((99.5 * 1 + 99.0 * 2) / 3 + (101.0 * 3 + 102.0 * 5) / 8) / 2, 1e-9);
+}
+
+// Test rolling VWAP expiry and volume bars from matches
+TEST(TradeAnalyticsTest, RollingVwapAndBars) {
+    TradeData trade;
+    ASSERT_TRUE(JSONParser::parseTradeMessage(
+        R"({"type":"match","trade_id":7,"sequence":50,"product_id":"BTC-USD","price":"400.5","size":"2","side":"sell","time":"2024-01-01T00:00:00.000000Z"})", trade));
+    EXPECT_EQ(trade.trade_id, 7u);
+    EXPECT_EQ(trade.price, 40050000000LL);
+    EXPECT_EQ(trade.maker_side, BookSide::Ask);
+    
+    const int64_t unit = OrderBook::SCALE;
+    const int64_t second = 1000000000LL;
+    RollingVWAP vwap(4);
+    vwap.setWindows({2 * second, 10 * second});
+    vwap.addTrade(1 * second, 100 * unit, 1 * unit);
+    vwap.addTrade(2 * second, 110 * unit, 3 * unit);
+    vwap.addTrade(3 * second, 120 * unit, 1 * unit);
+    
+    // 2 s window at t=3 s holds the trades after t=1 s
+    VwapWindowStats shortWindow = vwap.window(0);
+    EXPECT_EQ(shortWindow.trades, 2u);
+    EXPECT_DOUBLE_EQ(shortWindow.volume, 4.0);
+    EXPECT_DOUBLE_EQ(shortWindow.vwap, (110.0 * 3 + 120.0) / 4);
+    EXPECT_DOUBLE_EQ(vwap.window(1).vwap, (100.0 + 110.0 * 3 + 120.0) / 5);
+    
+    // Ring of 4: the 10 s window loses its oldest trade early
+    vwap.addTrade(4 * second, 100 * unit, 1 * unit);
+    vwap.addTrade(5 * second, 100 * unit, 1 * unit);
+    EXPECT_EQ(vwap.window(1).trades, 4u);
+    EXPECT_EQ(vwap.getTruncatedCount(), 1u);
+    
+    BarBuilder bars(BarType::Volume, 3.0);
+    TradeBar bar;
+    trade.size = 2 * unit;
+    EXPECT_FALSE(bars.add(trade, bar));
+    trade.price = 401 * unit;
+    EXPECT_TRUE(bars.add(trade, bar));
+    EXPECT_EQ(bar.trades, 2u);
+    EXPECT_EQ(bar.open, 40050000000LL);
+    EXPECT_EQ(bar.high, 401 * unit);
+    EXPECT_EQ(bar.volume, 4 * unit);
+    EXPECT_EQ(BarLogger<TradeBar>::barsFilename("out/ticker_data.csv", "bars"), "out/ticker_data_bars.csv");
+}
+
+// Test OHLCV time bars: clock-aligned buckets, ticks past the end, wheel expiry
+TEST(TimeBarsTest, BoundariesAndWheelExpiry) {
+    const int64_t unit = OrderBook::SCALE;
+    const int64_t second = 1000000000LL;
+    const int64_t base = 1704067200LL * second;   // Minute boundary
+    std::vector<OhlcvBar> bars;
+    TimeBarEngine engine({"BTC-USD", "ETH-USD"}, {1, 60},
+        [&bars](const OhlcvBar& bar, size_t) { bars.push_back(bar); });
+    EXPECT_EQ(TimeBarEngine::timeframeLabel(60), "1m");
+    EXPECT_EQ(TimeBarEngine::timeframeLabel(90), "90s");
+    
+    engine.advance(base + 100000000LL);
+    engine.onTick(0, 100 * unit, 1 * unit, base + 200000000LL);
+    engine.onTick(0, 103 * unit, 2 * unit, base + 500000000LL);
+    engine.onTick(0, 99 * unit, 1 * unit, base + 900000000LL);
+    engine.onTick(1, 5 * unit, 1 * unit, base + 900000000LL);
+    EXPECT_TRUE(bars.empty());
+    
+    // Wheel closes both 1s bars at the boundary with no further tick
+    engine.advance(base + second + 1000);
+    ASSERT_EQ(bars.size(), 2u);
+    const OhlcvBar& btc = bars[0].product_id == "BTC-USD" ? bars[0] : bars[1];
+    EXPECT_EQ(btc.timeframe_s, 1);
+    EXPECT_EQ(btc.start_time_ns, base);
+    EXPECT_EQ(btc.end_time_ns, base + second);
+    EXPECT_EQ(btc.open, 100 * unit);
+    EXPECT_EQ(btc.high, 103 * unit);
+    EXPECT_EQ(btc.low, 99 * unit);
+    EXPECT_EQ(btc.close, 99 * unit);
+    EXPECT_EQ(btc.volume, 4 * unit);
+    EXPECT_EQ(btc.ticks, 3u);
+    
+    // A tick past the end closes the bar before the wheel gets there
+    bars.clear();
+    engine.onTick(0, 101 * unit, 1 * unit, base + 2 * second + 1);
+    engine.onTick(0, 102 * unit, 1 * unit, base + 3 * second + 1);
+    ASSERT_EQ(bars.size(), 1u);
+    EXPECT_EQ(bars[0].start_time_ns, base + 2 * second);
+    EXPECT_EQ(bars[0].close, 101 * unit);
+    
+    // Jumping past the minute closes the rest exactly once, 1m bars spanning every tick
+    bars.clear();
+    engine.advance(base + 61 * second);
+    ASSERT_EQ(bars.size(), 3u);
+    for (const OhlcvBar& bar : bars) {
+        if (bar.timeframe_s == 60 && bar.product_id == "BTC-USD") {
+            EXPECT_EQ(bar.end_time_ns, base + 60 * second);
+            EXPECT_EQ(bar.ticks, 5u);
+            EXPECT_EQ(bar.close, 102 * unit);
+        }
+    }
+    engine.advance(base + 120 * second);
+    EXPECT_EQ(bars.size(), 3u);
+    EXPECT_EQ(engine.getCompletedCount(), 6u);
+}
+
+// Test rolling statistics against a brute-force recomputation of the window
+TEST(RollingStatsTest, MatchesBruteForce) {
+    const int64_t second = 1000000000LL;
+    RollingStats stats(10 * second, 64);
+    std::vector<std::pair<int64_t, double>> samples;
+    uint64_t state = 12345;
+    int64_t time = 0;
+    for (int i = 0; i < 500; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        time += static_cast<int64_t>(state >> 60) * second / 4;   // 0 - 3.75 s apart
+        const double value = 50000.0 + static_cast<double>((state >> 33) % 1000) / 10.0;
+        stats.add(time, value);
+        samples.emplace_back(time, value);
+        
+        // Window: samples after time - 10 s, at most the 64 newest
+        size_t first = samples.size() > 64 ? samples.size() - 64 : 0;
+        while (samples[first].first <= time - 10 * second) {
+            first++;
+        }
+        double sum = 0.0, low = samples[first].second, high = low;
+        for (size_t j = first; j < samples.size(); ++j) {
+            sum += samples[j].second;
+            low = std::min(low, samples[j].second);
+            high = std::max(high, samples[j].second);
+        }
+        const double n = static_cast<double>(samples.size() - first);
+        const double mean = sum / n;
+        double squares = 0.0;
+        for (size_t j = first; j < samples.size(); ++j) {
+            squares += (samples[j].second - mean) * (samples[j].second - mean);
+        }
+        ASSERT_EQ(stats.count(), samples.size() - first);
+        EXPECT_NEAR(stats.mean(), mean, 1e-6);
+        EXPECT_NEAR(stats.variance(), n > 1 ? squares / (n - 1) : 0.0, 1e-4);
+        EXPECT_DOUBLE_EQ(stats.min(), low);
+        EXPECT_DOUBLE_EQ(stats.max(), high);
+    }
+    
+    // Burst of same-time samples overflows the ring: oldest dropped and counted
+    for (int i = 0; i < 100; ++i) {
+        stats.add(time, 1.0 * i);
+    }
+    EXPECT_EQ(stats.count(), 64u);
+    EXPECT_GT(stats.getTruncatedCount(), 0u);
+    EXPECT_DOUBLE_EQ(stats.min(), 36.0);
+    EXPECT_DOUBLE_EQ(stats.max(), 99.0);
+    EXPECT_NEAR(stats.zScore(stats.mean() + stats.stddev(), stats.mean()), 1.0, 1e-9);
+}
+
+// Test indicator graph: shared nodes and values against direct formulas
+TEST(IndicatorGraphTest, SharedNodesAndValues) {
+    IndicatorGraph graph;
+    ASSERT_TRUE(graph.configure("macd(3,5,2), cross(3,5), ema(3), rsi(3), bb(4,2), atr(3)"));
+    // close, ema3, ema5, sub, ema2(sub), sub | sign | - | delta, gain, wilder, loss, wilder, rsi |
+    // sma4, stddev, upper, lower | high, low, truerange, wilder
+    EXPECT_EQ(graph.getNodeCount(), 21u);
+    ASSERT_EQ(graph.getOutputCount(), 10u);
+    EXPECT_EQ(graph.getOutputName(1), "macd(3,5,2).signal");
+    EXPECT_EQ(graph.getOutputName(6), "bb(4,2).upper");
+    
+    const double prices[] = {100, 102, 101, 105, 104, 103, 108, 107, 110, 109};
+    double fast = 0, slow = 0, signal = 0, gain = 0, loss = 0, atr = 0, previous = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        const double p = prices[i];
+        graph.update(p, p, p);
+        const double change = i == 0 ? 0.0 : p - previous;
+        const double range = i == 0 ? 0.0 : std::fabs(p - previous);
+        if (i == 0) {
+            fast = slow = p;
+            signal = 0.0;
+            gain = loss = atr = 0.0;
+        } else {
+            fast += 0.5 * (p - fast);
+            slow += (1.0 / 3.0) * (p - slow);
+            signal += (2.0 / 3.0) * ((fast - slow) - signal);
+            gain += (std::max(change, 0.0) - gain) / 3.0;
+            loss += (std::max(-change, 0.0) - loss) / 3.0;
+            atr += (range - atr) / 3.0;
+        }
+        previous = p;
+        EXPECT_NEAR(graph.value(0), fast - slow, 1e-9);
+        EXPECT_NEAR(graph.value(1), signal, 1e-9);
+        EXPECT_NEAR(graph.value(2), fast - slow - signal, 1e-9);
+        EXPECT_DOUBLE_EQ(graph.value(3), fast > slow ? 1.0 : (fast < slow ? -1.0 : 0.0));
+        EXPECT_NEAR(graph.value(4), fast, 1e-9);
+        if (loss > 0) {
+            EXPECT_NEAR(graph.value(5), 100.0 - 100.0 / (1.0 + gain / loss), 1e-9);
+        }
+        EXPECT_NEAR(graph.value(9), atr, 1e-9);
+    }
+    
+    // Bollinger over the last 4 prices: 107, 110, 109 and 108
+    const double mean = (108.0 + 107.0 + 110.0 + 109.0) / 4.0;
+    const double deviation = std::sqrt(((108 - mean) * (108 - mean) + (107 - mean) * (107 - mean) +
+                                        (110 - mean) * (110 - mean) + (109 - mean) * (109 - mean)) / 4.0);
+    EXPECT_NEAR(graph.value(7), mean, 1e-9);
+    EXPECT_NEAR(graph.value(6), mean + 2 * deviation, 1e-9);
+    EXPECT_NEAR(graph.value(8), mean - 2 * deviation, 1e-9);
+    const IndicatorSnapshot snapshot = graph.snapshot();
+    EXPECT_EQ(snapshot.count, 10u);
+    EXPECT_TRUE(snapshot.ready[0]);
+    
+    EXPECT_FALSE(graph.configure("macd(12,26"));
+    EXPECT_FALSE(graph.configure("rsi(0)"));
+    EXPECT_FALSE(graph.configure("vwma(5)"));
+    EXPECT_TRUE(graph.configure(""));
+    EXPECT_EQ(graph.getOutputCount(), 0u);
+}
+
+// Test compile-time pipeline against the runtime graph on the same indicators
+TEST(IndicatorPipelineTest, MatchesGraph) {
+    static_assert(Smoother<2, 6>::ALPHA == 2.0 / 6.0, "alpha is constexpr");
+    Pipeline<EMA<5>, MACD<3, 5, 2>, RSI<3>, Bollinger<4, 2>, ATR<3>, MidPrice, Spread> pipeline;
+    IndicatorGraph graph;
+    ASSERT_TRUE(graph.configure("ema(5),macd(3,5,2),rsi(3),bb(4,2),atr(3)"));
+    
+    const double prices[] = {100, 102, 101, 105, 104, 103, 108, 107, 110, 109, 111, 106};
+    for (double price : prices) {
+        pipeline.update(PipelineInput::fromTick(price, price - 0.5, price + 1.0));
+        graph.update(price, price, price);
+        EXPECT_NEAR(pipeline.get<0>().value(), graph.value(0), 1e-9);
+        EXPECT_NEAR(pipeline.get<1>().value(), graph.value(1), 1e-9);
+        EXPECT_NEAR(pipeline.get<1>().signal(), graph.value(2), 1e-9);
+        EXPECT_NEAR(pipeline.get<1>().histogram(), graph.value(3), 1e-9);
+        EXPECT_NEAR(pipeline.get<2>().value(), graph.value(4), 1e-9);
+        EXPECT_NEAR(pipeline.get<3>().upper(), graph.value(5), 1e-9);
+        EXPECT_NEAR(pipeline.get<3>().value(), graph.value(6), 1e-9);
+        EXPECT_NEAR(pipeline.get<3>().lower(), graph.value(7), 1e-9);
+        EXPECT_NEAR(pipeline.get<4>().value(), graph.value(8), 1e-9);
+        EXPECT_DOUBLE_EQ(pipeline.get<MidPrice>().value(), price + 0.25);
+        EXPECT_DOUBLE_EQ(pipeline.get<Spread>().value(), 1.5);
+    }
+    const auto values = pipeline.values();
+    EXPECT_EQ(values.size(), 7u);
+    EXPECT_DOUBLE_EQ(values[6], 1.5);
+}
+
+// Test aligned returns and the rolling covariance matrix against brute force
+TEST(CorrelationTest, AlignedReturnsAndBeta) {
+    const int64_t second = 1000000000LL;
+    ReturnSynchronizer sync(3, second);
+    RollingCovariance covariance(3, 16);
+    std::vector<std::vector<double>> emitted;
+    auto onReturns = [&](const double* returns, int64_t) {
+        covariance.add(returns, 0);
+        emitted.emplace_back(returns, returns + 3);
+    };
+    
+    // B moves twice as much as A (in log terms), C is unrelated; ticks land at different times
+    uint64_t state = 7;
+    double a = 100.0, c = 10.0;
+    for (int bucket = 0; bucket < 40; ++bucket) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const double move = static_cast<double>(static_cast<int>((state >> 40) % 21) - 10) / 1000.0;
+        const double noise = static_cast<double>(static_cast<int>((state >> 20) % 21) - 10) / 1000.0;
+        a *= std::exp(move);
+        c *= std::exp(noise);
+        const int64_t start = bucket * second;
+        sync.onPrice(0, start + 100, a, onReturns, 16);
+        sync.onPrice(2, start + 200000000LL, c, onReturns, 16);
+        sync.onPrice(1, start + 900000000LL, 50.0 * a * a / 10000.0, onReturns, 16);
+    }
+    // The first close only sets start prices
+    ASSERT_EQ(emitted.size(), 38u);
+    EXPECT_EQ(covariance.count(), 16u);
+    EXPECT_NEAR(covariance.correlation(0, 1), 1.0, 1e-9);
+    EXPECT_NEAR(covariance.beta(1, 0), 2.0, 1e-9);
+    
+    // Brute force over the last 16 vectors
+    double sum[3] = {0, 0, 0};
+    for (size_t k = emitted.size() - 16; k < emitted.size(); ++k) {
+        for (int i = 0; i < 3; ++i) sum[i] += emitted[k][i];
+    }
+    double cov02 = 0.0;
+    for (size_t k = emitted.size() - 16; k < emitted.size(); ++k) {
+        cov02 += (emitted[k][0] - sum[0] / 16) * (emitted[k][2] - sum[2] / 16);
+    }
+    EXPECT_NEAR(covariance.covariance(0, 2), cov02 / 15, 1e-12);
+    
+    const CorrelationSnapshot snapshot = covariance.snapshot(0);
+    EXPECT_EQ(snapshot.count, 3u);
+    EXPECT_NEAR(snapshot.get(1, 0), 1.0, 1e-9);
+    EXPECT_DOUBLE_EQ(snapshot.get(0, 2), snapshot.get(2, 0));
+    EXPECT_NEAR(snapshot.beta[1], 2.0, 1e-9);
+    
+    // A silent gap emits zero returns for the empty buckets, capped by maxBuckets
+    emitted.clear();
+    sync.onPrice(0, 100 * second, a, onReturns, 5);
+    ASSERT_EQ(emitted.size(), 5u);
+    EXPECT_DOUBLE_EQ(emitted[4][0], 0.0);
+}
+
+// Test seqlock publication of product state: readers never see fields from two updates
+TEST(ProductSnapshotTest, TornFreeReads) {
+    // Update 0 is published before any reader starts
+    ProductSnapshot state;
+    state.price_ema = 0.5;
+    state.mid_price_ema = 0.25;
+    SeqLocked<ProductSnapshot> published(state);
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<int> tornReads{0};
+    
+    // Every field of update n derives from n, so a mix of two updates is detectable
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t lastTicks = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const ProductSnapshot snapshot = published.load();
+                const double n = static_cast<double>(snapshot.ticks);
+                if (snapshot.sequence != snapshot.ticks * 2 || snapshot.price != n ||
+                    snapshot.price_ema != n + 0.5 || snapshot.mid_price_ema != n + 0.25 ||
+                    snapshot.imbalance_ema != -n || snapshot.published_tsc != snapshot.ticks ||
+                    snapshot.ticks < lastTicks) {
+                    tornReads.fetch_add(1);
+                }
+                lastTicks = snapshot.ticks;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (uint64_t n = 1; n <= 200000; ++n) {
+        state.ticks = n;
+        state.sequence = n * 2;
+        state.price = static_cast<double>(n);
+        state.price_ema = static_cast<double>(n) + 0.5;
+        state.mid_price_ema = static_cast<double>(n) + 0.25;
+        state.imbalance_ema = -static_cast<double>(n);
+        state.published_tsc = n;
+        published.store(state);
+    }
+    // Let the readers see the final state before stopping them
+    while (reads.load(std::memory_order_relaxed) < 1000) {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) {
+        t.join();
+    }
+    
+    EXPECT_EQ(tornReads.load(), 0);
+    EXPECT_EQ(published.load().ticks, 200000u);
+}
+
+// Test per-thread metric shards, the Prometheus rendering and the /metrics endpoint
+TEST(MetricsTest, ShardsAndEndpoint) {
+    MetricsRegistry registry;
+    const size_t frames = registry.addCounter("frames_total", "Frames");
+    const size_t drops = registry.addCounter("drops_total", "Drops");
+    EXPECT_EQ(frames, 0u);
+    EXPECT_EQ(drops, 1u);
+    
+    // Two writers, one shard each, running concurrently
+    MetricsShard line0;
+    MetricsShard line1;
+    registry.addShard("line0", &line0);
+    registry.addShard("line1", &line1);
+    std::thread writer0([&]() { for (int i = 0; i < 100000; ++i) line0.add(frames); });
+    std::thread writer1([&]() { for (int i = 0; i < 50000; ++i) line1.add(frames); line1.add(drops, 3); });
+    writer0.join();
+    writer1.join();
+    EXPECT_EQ(registry.total(frames), 150000u);
+    EXPECT_EQ(registry.total(drops), 3u);
+    
+    double depth = 7.0;
+    registry.addSampled("depth", "Depth", MetricType::Gauge, "queue=\"a\"", [&depth]() { return depth; });
+    LatencyHistogram histogram;
+    for (uint64_t ns = 1; ns <= 1000; ++ns) {
+        histogram.record(ns * 1000);
+    }
+    registry.addLatency("latency_seconds", "Latency", "stage=\"x\"", histogram);
+    // One series recorded by two threads into their own histograms, merged on render
+    LatencyHistogram io;
+    LatencyHistogram processing;
+    std::thread ioWriter([&]() { for (uint64_t ns = 1; ns <= 300; ++ns) io.record(ns); });
+    std::thread processingWriter([&]() { for (uint64_t ns = 1; ns <= 100; ++ns) processing.record(ns * 1000); });
+    ioWriter.join();
+    processingWriter.join();
+    registry.addLatency("merged_seconds", "Merged", "", {&io, &processing});
+    
+    const std::string text = registry.render();
+    EXPECT_NE(text.find("# TYPE frames_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("frames_total{thread=\"line0\"} 100000\n"), std::string::npos);
+    EXPECT_NE(text.find("frames_total{thread=\"line1\"} 50000\n"), std::string::npos);
+    EXPECT_NE(text.find("drops_total{thread=\"line1\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE depth gauge\ndepth{queue=\"a\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE latency_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds{stage=\"x\",quantile=\"0.5\"} 0.0005"), std::string::npos);
+    EXPECT_NE(text.find("latency_seconds_count{stage=\"x\"} 1000\n"), std::string::npos);
+    EXPECT_NE(text.find("merged_seconds_count 400\n"), std::string::npos);
+    EXPECT_NE(text.find("merged_seconds{quantile=\"0.5\"} 2.03e-07\n"), std::string::npos);
+    EXPECT_EQ(io.getCount(), 300u);
+    
+#ifdef __linux__
+    MetricsServer server(registry);
+    ASSERT_TRUE(server.start(0));
+    ASSERT_GT(server.getPort(), 0);
+    auto fetch = [&server](const std::string& request) {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(server.getPort());
+        std::string response;
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            ::send(fd, request.data(), request.size(), 0);
+            char buffer[4096];
+            ssize_t n;
+            while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+                response.append(buffer, static_cast<size_t>(n));
+            }
+        }
+        ::close(fd);
+        return response;
+    };
+    depth = 9.0;
+    const std::string ok = fetch("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(ok.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+    EXPECT_NE(ok.find("depth{queue=\"a\"} 9\n"), std::string::npos);
+    const std::string missing = fetch("GET / HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(missing.compare(0, 22, "HTTP/1.1 404 Not Found"), 0);
+    EXPECT_EQ(server.getScrapeCount(), 1u);
+    server.stop();
+#endif
+}
+
+// Test console monitor: events queue without stdio, overflow drops, table formatting
+TEST(ConsoleMonitorTest, EventsAndTable) {
+    ProductSnapshot btc;
+    btc.ticks = 42;
+    btc.price = 50000.25;
+    btc.best_bid = 50000.0;
+    btc.best_ask = 50000.5;
+    ConsoleMonitor monitor({"BTC-USD"}, [&btc](size_t) { return btc; }, 0);
+    
+    // Nothing drains before start(), so the queue fills and the rest is counted as dropped
+    size_t accepted = 0;
+    for (int i = 0; i < 300; ++i) {
+        if (monitor.post(false, "event %d", i)) {
+            accepted++;
+        }
+    }
+    EXPECT_GT(accepted, 200u);
+    EXPECT_LT(accepted, 300u);
+    EXPECT_EQ(monitor.getEventsDropped(), 300u - accepted);
+    
+    // stop() prints what is queued, in order
+    testing::internal::CaptureStdout();
+    monitor.start();
+    monitor.stop();
+    const std::string out = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(out.find("event 0\nevent 1\n"), 0u);
+    EXPECT_NE(out.find("event " + std::to_string(accepted - 1) + "\n"), std::string::npos);
+    EXPECT_EQ(out.find("event " + std::to_string(accepted) + "\n"), std::string::npos);
+    
+    // Over-long lines are truncated, not overflowed
+    const std::string longText(500, 'x');
+    EXPECT_TRUE(monitor.post(false, "%s", longText.c_str()));
+    testing::internal::CaptureStdout();
+    monitor.stop();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), std::string(ConsoleEvent::MAX_TEXT - 1, 'x') + "\n");
+    
+    const std::string table = monitor.formatTable({btc}, {4.0});
+    EXPECT_EQ(table.find("product"), 0u);
+    EXPECT_NE(table.find("BTC-USD"), std::string::npos);
+    EXPECT_NE(table.find("50000.25"), std::string::npos);
+    EXPECT_NE(table.find("4.0"), std::string::npos);
 }
 
+#ifdef __linux__
+/**
+ * @brief Private temporary directory for tests that write files (fake sysfs/procfs trees, dumps)
+ *
+ * Each test gets its own directory, so parallel ctest runs do not collide,
+ * and TearDown() removes it even when an assertion ends the test early.
+ */
+class TempDirTest : public ::testing::Test {
+protected:
+    std::filesystem::path root;
+
+    void SetUp() override {
+        char pattern[] = "/tmp/test_essential_XXXXXX";
+        ASSERT_NE(::mkdtemp(pattern), nullptr);
+        root = pattern;
+    }
+
+    void TearDown() override {
+        std::error_code ignored;
+        std::filesystem::remove_all(root, ignored);
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& text) const {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << text << "\n";
+    }
+};
+using TraceRingTest = TempDirTest;
+using ThreadPlacementTest = TempDirTest;
+using NicLocalityTest = TempDirTest;
+
+// Test trace rings: wraparound keeps the newest records, dump and Chrome trace conversion
+TEST_F(TraceRingTest, WrapDumpAndConvert) {
+    auto ring = std::make_unique<TraceRing>("wrap");
+    const uint64_t total = TraceRing::CAPACITY + 100;
+    for (uint64_t i = 0; i < total; ++i) {
+        ring->record(TraceEvent::Enqueue, 1000 + i, i, 0);
+    }
+    std::vector<TraceRecord> records;
+    ring->copy(records);
+    // The oldest slot is the one a concurrent writer would overwrite next, so it is left out
+    ASSERT_EQ(records.size(), TraceRing::CAPACITY - 1);
+    EXPECT_EQ(records.front().a, total - TraceRing::CAPACITY + 1);
+    EXPECT_EQ(records.back().a, total - 1);
+    for (size_t i = 1; i < records.size(); ++i) {
+        ASSERT_EQ(records[i].a, records[i - 1].a + 1);
+    }
+    
+    // Each thread records into its own ring; the dump holds both threads
+    std::thread worker([]() {
+        // Attached at thread start, so recording finds the ring already there
+        TraceRing& attached = TraceRecorder::attachThread("TraceWorker");
+        EXPECT_EQ(&TraceRecorder::local(), &attached);
+        EXPECT_EQ(&TraceRecorder::attachThread("ignored"), &attached);
+        EXPECT_EQ(attached.getName(), "TraceWorker");
+        TraceRecorder::record(TraceEvent::Dequeue, 7, 1);
+        TraceRecorder::record(TraceEvent::Process, 7, 2500);
+    });
+    worker.join();
+    TraceRecorder::record(TraceEvent::Receive, 0, 512);
+    
+    const std::string dumpFile = (root / "test.trace").string();
+    const std::string jsonFile = dumpFile + ".json";
+    ASSERT_TRUE(TraceRecorder::dumpTo(dumpFile));
+    ASSERT_TRUE(TraceRecorder::convertToChromeTrace(dumpFile, jsonFile));
+    std::ifstream json(jsonFile);
+    const std::string text((std::istreambuf_iterator<char>(json)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(text.find("{\"displayTimeUnit\""), 0u);
+    EXPECT_NE(text.find("\"thread_name\""), std::string::npos);
+    EXPECT_NE(text.find("TraceWorker"), std::string::npos);
+    EXPECT_NE(text.find("\"name\":\"dequeue\""), std::string::npos);
+    EXPECT_NE(text.find("\"name\":\"process\",\"pid\":1"), std::string::npos);
+    EXPECT_NE(text.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(text.find("\"name\":\"receive\""), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 4), "\n]}\n");
+    
+    // Anything else is rejected
+    EXPECT_FALSE(TraceRecorder::convertToChromeTrace(jsonFile, jsonFile + ".bad"));
+}
+
+// Test thread placement on a fake two-node, hyperthreaded topology
+TEST_F(ThreadPlacementTest, PlansFromSysfs) {
+    namespace fs = std::filesystem;
+    // Node 0: cores {0,8} {1,9} {2,10} {3,11}; node 1: cores {4,12} ... {7,15}; isolcpus=2-3,10-11
+    writeFile(root / "cpu/online", "0-15");
+    writeFile(root / "cpu/isolated", "2-3,10-11");
+    for (int cpu = 0; cpu < 16; ++cpu) {
+        const fs::path dir = root / "cpu" / ("cpu" + std::to_string(cpu));
+        const int core = cpu % 8;
+        writeFile(dir / "topology/physical_package_id", std::to_string(core / 4));
+        writeFile(dir / "topology/thread_siblings_list", std::to_string(core) + "," + std::to_string(core + 8));
+        fs::create_directories(dir / ("node" + std::to_string(core / 4)));
+    }
+    writeFile(root / "net/feed0/device/numa_node", "1");
+    
+    EXPECT_EQ(ThreadPlacement::parseCpuList("0-2,5,7-8"), (std::vector<int>{0, 1, 2, 5, 7, 8}));
+    EXPECT_EQ(ThreadPlacement::nicNumaNode("feed0", (root / "net").string()), 1);
+    EXPECT_EQ(ThreadPlacement::nicNumaNode("no-such-if0", (root / "net").string()), -1);
+    
+    CpuTopology topology = ThreadPlacement::readTopology((root / "cpu").string());
+    for (CpuInfo& cpu : topology.cpus) {
+        cpu.allowed = true;     // Independent of the cpuset the test runs in
+    }
+    ASSERT_EQ(topology.cpus.size(), 16u);
+    EXPECT_EQ(topology.cores.size(), 8u);
+    EXPECT_EQ(topology.numNodes, 2);
+    EXPECT_EQ(topology.find(12)->node, 1);
+    EXPECT_TRUE(topology.find(10)->isolated);
+    
+    // NIC on node 1 (no isolated cores there): both hot threads on node 1, logger on node 0
+    PlacementPlan plan = ThreadPlacement::plan(topology, {1}, "WebSocketIO");
+    EXPECT_EQ(plan.feedIo[0].thread, "WebSocketIO");
+    EXPECT_EQ(plan.feedIo[0].cpu, 4);
+    EXPECT_EQ(plan.processing.cpu, 5);
+    EXPECT_TRUE(plan.feedIo[0].dedicated && plan.processing.dedicated);
+    EXPECT_EQ(plan.logger.node, 0);
+    EXPECT_FALSE(topology.find(plan.logger.cpu)->isolated);
+    
+    // NIC on node 0: isolated cores first, CPU 0 avoided, no hyperthread siblings shared
+    plan = ThreadPlacement::plan(topology, {0, 0}, "WebSocketIO");
+    EXPECT_EQ(plan.feedIo[0].cpu, 2);
+    EXPECT_EQ(plan.processing.cpu, 3);
+    EXPECT_EQ(plan.feedIo[1].thread, "WebSocketIO1");
+    EXPECT_EQ(plan.feedIo[1].cpu, 1);
+    EXPECT_EQ(plan.logger.node, 1);
+    
+    // One core in the cpuset: hot threads split its hyperthreads, the logger has to share
+    for (CpuInfo& cpu : topology.cpus) {
+        cpu.allowed = cpu.cpu == 0 || cpu.cpu == 8;
+    }
+    plan = ThreadPlacement::plan(topology, {-1}, "FeedReplay");
+    EXPECT_EQ(plan.feedIo[0].cpu, 0);
+    EXPECT_EQ(plan.processing.cpu, 8);
+    EXPECT_FALSE(plan.feedIo[0].dedicated);
+    EXPECT_TRUE(plan.logger.shared);
+    const std::string text = plan.format();
+    EXPECT_NE(text.find("FeedReplay"), std::string::npos);
+    EXPECT_NE(text.find("shared CPU"), std::string::npos);
+}
+
+// Test NIC interrupt discovery, I/O thread placement warnings and the smp_affinity suggestion
+TEST_F(NicLocalityTest, InterruptsAndPlacement) {
+    namespace fs = std::filesystem;
+    writeFile(root / "proc/interrupts",
+        "           CPU0       CPU1       CPU2       CPU3       CPU4       CPU5\n"
+        "  0:         10          0          0          0          0          0   IO-APIC   2-edge      timer\n"
+        " 40:       1000          0       9000          0          0          0   PCI-MSI 524288-edge      feed0-TxRx-0\n"
+        " 41:          0       5000          0          0          0          0   PCI-MSI 524289-edge      feed0-TxRx-1\n"
+        " 42:          5          0          0          0          0          0   PCI-MSI 524290-edge      feed0\n"
+        " 50:          0          0          0          0         70          0   PCI-MSI 1048576-edge      other0-rx-0\n"
+        "NMI:          0          0          0          0          0          0   Non-maskable interrupts");
+    writeFile(root / "proc/irq/40/effective_affinity_list", "2");
+    writeFile(root / "proc/irq/41/effective_affinity_list", "1");
+    writeFile(root / "net/feed0/device/numa_node", "0");
+    for (const char* irq : {"40", "41", "42"}) {
+        fs::create_directories(root / "net/feed0/device/msi_irqs" / irq);
+    }
+    
+    const NicReport report = NicLocality::inspect("feed0", (root / "proc").string(), (root / "net").string());
+    EXPECT_EQ(report.interface, "feed0");
+    EXPECT_EQ(report.numaNode, 0);
+    ASSERT_EQ(report.irqs.size(), 3u);
+    EXPECT_TRUE(report.irqs[0].rx && report.irqs[1].rx);
+    EXPECT_FALSE(report.irqs[2].rx);
+    EXPECT_EQ(report.rxCpus(), (std::vector<int>{0, 1, 2}));
+    EXPECT_NE(report.format().find("NIC feed0: node 0, 3 interrupt lines (2 RX)"), std::string::npos);
+    
+    // Cores {0,1} and {2,3} on node 0, {4,5} on node 1
+    CpuTopology topology;
+    for (int cpu = 0; cpu < 6; ++cpu) {
+        CpuInfo info;
+        info.cpu = cpu;
+        info.core = cpu / 2;
+        info.node = cpu < 4 ? 0 : 1;
+        topology.cpus.push_back(info);
+    }
+    topology.cores = {{0, 1}, {2, 3}, {4, 5}};
+    topology.numNodes = 2;
+    
+    ThreadAssignment io;
+    io.thread = "WebSocketIO";
+    io.cpu = 2;
+    io.node = 0;
+    std::vector<std::string> warnings = NicLocality::checkPlacement(report, io, topology);
+    ASSERT_EQ(warnings.size(), 2u);     // IRQ 40 delivered to CPU 2, and 60% of RX interrupts there
+    EXPECT_NE(warnings[0].find("interrupt 40"), std::string::npos);
+    EXPECT_NE(warnings[1].find("60%"), std::string::npos);
+    
+    io.cpu = 4;
+    io.node = 1;
+    warnings = NicLocality::checkPlacement(report, io, topology);
+    ASSERT_EQ(warnings.size(), 1u);
+    EXPECT_NE(warnings[0].find("node 1"), std::string::npos);
+    
+    // RX interrupts go to node 0 CPUs outside the hot core {2,3}
+    PlacementPlan plan;
+    plan.feedIo.resize(1);
+    plan.feedIo[0].cpu = 2;
+    plan.processing.cpu = 3;
+    const std::string commands = NicLocality::recommendAffinity(report, plan, topology);
+    EXPECT_NE(commands.find("echo 0 > /proc/irq/40/smp_affinity_list"), std::string::npos);
+    EXPECT_NE(commands.find("echo 1 > /proc/irq/41/smp_affinity_list"), std::string::npos);
+    EXPECT_EQ(commands.find("/proc/irq/42/"), std::string::npos);
+    
+    // Lines are matched by whole interface name: eth1 does not get eth10's queues
+    writeFile(root / "proc-eth/interrupts",
+        "           CPU0       CPU1\n"
+        " 60:        100          0   PCI-MSI 1-edge      eth1-TxRx-0\n"
+        " 61:          0        200   PCI-MSI 2-edge      eth10-TxRx-0\n"
+        " 62:          3          0   PCI-MSI 3-edge      eth1\n"
+        " 63:          0          4   PCI-MSI 4-edge      eth10\n"
+        " 64:          0          5   PCI-MSI 5-edge      eth1@pci:0000:3b:00.1\n");
+    writeFile(root / "net/eth1/device/numa_node", "0");
+    const NicReport eth1 = NicLocality::inspect("eth1", (root / "proc-eth").string(), (root / "net").string());
+    ASSERT_EQ(eth1.irqs.size(), 3u);
+    EXPECT_EQ(eth1.irqs[0].irq, 60);
+    EXPECT_EQ(eth1.irqs[1].irq, 62);
+    EXPECT_EQ(eth1.irqs[2].irq, 64);
+    EXPECT_EQ(eth1.rxCpus(), (std::vector<int>{0}));
+}
+
+// Test pre-faulting: touchMemory makes untouched pages resident without changing them
+TEST(MemoryLockTest, PrefaultAndUsage) {
+    const size_t size = 8 * 1024 * 1024;
+    char* region = static_cast<char*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_NE(region, MAP_FAILED);
+    // Base pages only: with transparent_hugepage=always one fault would map 2 MiB
+    madvise(region, size, MADV_NOHUGEPAGE);
+    region[0] = 'x';
+    region[size - 1] = 'y';
+    
+    const MemoryUsage before = MemoryLock::usage();
+    EXPECT_GT(before.residentBytes, 0u);
+    NUMAUtils::touchMemory(region, size);
+    const MemoryUsage after = MemoryLock::usage();
+    // A read-only touch would have mapped the shared zero page and left RSS flat
+    EXPECT_GE(after.residentBytes, before.residentBytes + size / 2);
+    EXPECT_GE(after.minorFaults, before.minorFaults + size / static_cast<size_t>(getpagesize()) / 2);
+    EXPECT_EQ(region[0], 'x');
+    EXPECT_EQ(region[size - 1], 'y');
+    munmap(region, size);
+    
+    // Stack and arena pre-faults as a pinned thread runs them (exited threads release their stack pages)
+    MemoryLock::retainHeap();
+    uint64_t stackGrowth = 0;
+    long heapFaults = -1;
+    std::thread([&stackGrowth, &heapFaults]() {
+        const uint64_t start = MemoryLock::usage().residentBytes;
+        MemoryLock::prefaultStack(MemoryLock::STACK_PREFAULT_BYTES);
+        stackGrowth = MemoryLock::usage().residentBytes - start;
+        
+        // The freed arena stays resident, so the same allocation afterwards takes (almost) no faults
+        MemoryLock::prefaultHeap(MemoryLock::THREAD_HEAP_PREFAULT_BYTES);
+        rusage faults{};
+        getrusage(RUSAGE_THREAD, &faults);
+        const long faultsBefore = faults.ru_minflt;
+        char* block = static_cast<char*>(std::malloc(MemoryLock::THREAD_HEAP_PREFAULT_BYTES));
+        std::memset(block, 1, MemoryLock::THREAD_HEAP_PREFAULT_BYTES);
+        std::free(block);
+        getrusage(RUSAGE_THREAD, &faults);
+        heapFaults = faults.ru_minflt - faultsBefore;
+    }).join();
+    EXPECT_GE(stackGrowth, MemoryLock::STACK_PREFAULT_BYTES / 2);
+    EXPECT_GE(heapFaults, 0);
+    EXPECT_LT(heapFaults, 16);
+    EXPECT_EQ(MemoryLock::formatStartup(before, after).find("Memory: RSS "), 0u);
+    
+    // Pre-faulting a book keeps its levels
+    OrderBook book(4);
+    book.apply(BookSide::Bid, 100, 5);
+    book.prefault();
+    EXPECT_EQ(book.bestBid().price, 100);
+    EXPECT_EQ(book.bestBid().size, 5);
+}
+#endif
+
 // Test TickerData 
 TEST(TickerDataTest, MidPriceCalculation) {
     TickerData data;
@@ -207,6 +1244,84 @@ TEST(LockFreeRingBufferTest, ThreadSafety) {
     EXPECT_GT(pop_count.load(), 0);
 }
 
+// Test LatencyHistogram bucket mapping
+TEST(LatencyHistogramTest, BucketBounds) {
+    // Small values are exact, larger values stay within ~3% of their bucket bound
+    for (uint64_t v : {0ULL, 1ULL, 31ULL, 32ULL, 63ULL, 64ULL, 1000ULL, 123456ULL, 987654321ULL}) {
+        size_t index = LatencyHistogram::bucketIndex(v);
+        ASSERT_LT(index, LatencyHistogram::BUCKET_COUNT);
+        uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+        EXPECT_GE(upper, v);
+        EXPECT_LE(static_cast<double>(upper - v), v * (1.0 / LatencyHistogram::SUB_BUCKET_COUNT) + 1.0);
+    }
+    
+    // Out-of-range values clamp to the last bucket
+    EXPECT_EQ(LatencyHistogram::bucketIndex(UINT64_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+// Test LatencyHistogram percentiles
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 10000; ++v) {
+        histogram.record(v);
+    }
+    
+    LatencySummary summary = histogram.summarize();
+    EXPECT_EQ(summary.count, 10000u);
+    EXPECT_EQ(summary.max, 10000u);
+    EXPECT_NEAR(summary.mean, 5000.5, 0.01);
+    EXPECT_NEAR(static_cast<double>(summary.p50), 5000.0, 5000.0 * 0.04);
+    EXPECT_NEAR(static_cast<double>(summary.p99), 9900.0, 9900.0 * 0.04);
+    EXPECT_NEAR(static_cast<double>(summary.p999), 9990.0, 9990.0 * 0.04);
+    EXPECT_EQ(histogram.getPercentile(100.0), 10000u);
+    
+    histogram.reset();
+    EXPECT_EQ(histogram.getCount(), 0u);
+}
+
+#ifdef __linux__
+// Test TSC detection and recalibration against CLOCK_MONOTONIC_RAW
+TEST(HighResTimerTest, RecalibrationStaysMonotonicAndBounded) {
+    HighResTimer::initialize();
+    // The fast path needs an invariant TSC, and the kernel reports the same CPUID bit
+    if (HighResTimer::isUsingTSC()) {
+        EXPECT_TRUE(HighResTimer::isInvariantTSC());
+        EXPECT_GT(HighResTimer::getTscFrequencyGHz(), 0.0);
+    }
+#if HAVE_RDTSC
+    if (HighResTimer::isInvariantTSC()) {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        const std::string text((std::istreambuf_iterator<char>(cpuinfo)), std::istreambuf_iterator<char>());
+        EXPECT_NE(text.find(" nonstop_tsc"), std::string::npos);
+    }
+#endif
+    
+    // Errors up to 1 ms are slewed, larger ones stepped: either way nowNanos()
+    // stays within 1 ms of the reference and never goes back
+    const int64_t bound = 1000000;
+    auto reference = []() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    };
+    int64_t last = HighResTimer::nowNanos();
+    for (int step = 0; step < 20; ++step) {
+        HighResTimer::recalibrate();
+        for (int i = 0; i < 1000; ++i) {
+            const int64_t before = reference();
+            const int64_t now = HighResTimer::nowNanos();
+            const int64_t after = reference();
+            ASSERT_GE(now, last) << "step " << step;
+            EXPECT_GE(now, before - bound);
+            EXPECT_LE(now, after + bound);
+            last = now;
+        }
+        EXPECT_LT(std::llabs(HighResTimer::getClockErrorNanos()), bound);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+#endif
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,437 @@
+/**
+ * @file MockExchange.cpp
+ * @brief Local Coinbase-compatible WebSocket feed simulator for load testing
+ *
+ * Serves ticker, matches and level2 messages in Coinbase format over ws:// or
+ * wss:// (self-signed certificate, see generate_cert.sh) at a configurable
+ * per-connection rate, so socket-to-disk throughput of the analyzer can be
+ * measured without the public feed:
+ *
+ * @code
+ *   ./mock_exchange --port 8080 --rate 100000
+ *   ./CoinbaseTickerAnalyzer --endpoint ws://localhost:8080
+ * @endcode
+ */
+
+#include <libwebsockets.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <signal.h>
+#include "MockFeedGenerator.h"
+#include "HighResTimer.h"
+#include "ThreadUtils.h"
+#include "BranchPrediction.h"
+
+namespace {
+
+/**
+ * @brief Command line configuration
+ */
+struct ServerConfig {
+    int port = 8080;                                   ///< Listen port
+    bool tls = false;                                  ///< Serve wss:// instead of ws://
+    std::string certFile = "mock_exchange_cert.pem";   ///< TLS certificate (PEM)
+    std::string keyFile = "mock_exchange_key.pem";     ///< TLS private key (PEM)
+    double rate = 1000.0;                              ///< Messages per second per connection (0 = unlimited)
+    uint64_t seed = 42;                                ///< Generator seed (same seed = same stream)
+    size_t depth = 500;                                ///< Level2 book depth per side (snapshots span several 4 KB receive chunks, like real ones)
+    size_t maxBatch = 256;                             ///< Max messages written per writeable callback
+    int durationSeconds = 0;                           ///< Stop after N seconds (0 = until Ctrl+C)
+    int cpuCore = -1;                                  ///< CPU core for the server thread (-1 = no pinning)
+};
+
+/**
+ * @brief Per-connection state
+ */
+struct Session {
+    std::unique_ptr<MockFeedGenerator> generator;      ///< Feed generator (null until subscribed)
+    std::deque<std::string> control;                   ///< Pending subscriptions ack / snapshots
+    int64_t startNanos = 0;                            ///< Start of the rate schedule
+    uint64_t sent = 0;                                 ///< Stream messages sent since startNanos
+    std::vector<unsigned char> buffer;                 ///< Write buffer (LWS_PRE + message)
+};
+
+constexpr size_t MAX_MESSAGE_SIZE = 4096;              ///< Largest generated stream message
+
+ServerConfig g_config;
+std::atomic<bool> g_running{true};
+uint64_t g_messagesSent = 0;                           ///< Service thread only
+uint64_t g_bytesSent = 0;                              ///< Service thread only
+uint64_t g_scheduleSlips = 0;                          ///< Times a client fell > 1 s behind schedule
+int g_clients = 0;                                     ///< Connected clients
+
+void signalHandler(int) {
+    g_running.store(false);
+}
+
+/**
+ * @brief Parse a subscribe request into a generator
+ * @param message Raw subscribe message
+ * @param session Session to (re)configure
+ * @return True if the message was a valid subscribe
+ */
+bool handleSubscribe(const std::string& message, Session& session) {
+    nlohmann::json request;
+    try {
+        request = nlohmann::json::parse(message);
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring malformed client message: " << e.what() << std::endl;
+        return false;
+    }
+
+    if (request.value("type", "") != "subscribe") {
+        return false;
+    }
+
+    std::vector<std::string> products;
+    if (request.contains("product_ids") && request["product_ids"].is_array()) {
+        for (const auto& id : request["product_ids"]) {
+            products.push_back(id.get<std::string>());
+        }
+    }
+
+    std::vector<MockChannel> channels;
+    if (request.contains("channels") && request["channels"].is_array()) {
+        for (const auto& channel : request["channels"]) {
+            // Channels are either names or {"name": ..., "product_ids": [...]}
+            std::string name = channel.is_string() ? channel.get<std::string>() : channel.value("name", "");
+            if (channel.is_object() && channel.contains("product_ids")) {
+                for (const auto& id : channel["product_ids"]) {
+                    if (std::find(products.begin(), products.end(), id.get<std::string>()) == products.end()) {
+                        products.push_back(id.get<std::string>());
+                    }
+                }
+            }
+            if (name == "ticker") {
+                channels.push_back(MockChannel::Ticker);
+            } else if (name == "matches") {
+                channels.push_back(MockChannel::Matches);
+            } else if (name == "level2" || name == "level2_batch") {
+                channels.push_back(MockChannel::Level2);
+            }
+        }
+    }
+
+    if (products.empty() || channels.empty()) {
+        std::cerr << "Subscribe without products or supported channels ignored" << std::endl;
+        return false;
+    }
+
+    session.generator = std::make_unique<MockFeedGenerator>(products, channels, g_config.seed, g_config.depth);
+    session.control.clear();
+    session.control.push_back(session.generator->subscriptionsMessage());
+    if (session.generator->hasLevel2()) {
+        for (size_t i = 0; i < session.generator->productCount(); ++i) {
+            session.control.push_back(session.generator->snapshotMessage(i));
+        }
+    }
+    session.startNanos = HighResTimer::nowNanos();
+    session.sent = 0;
+    return true;
+}
+
+/**
+ * @brief Write one raw text frame
+ * @return False on write error
+ */
+bool writeFrame(struct lws* wsi, Session& session, const char* data, size_t length) {
+    if (session.buffer.size() < LWS_PRE + length) {
+        session.buffer.resize(LWS_PRE + length);
+    }
+    std::memcpy(session.buffer.data() + LWS_PRE, data, length);
+    int written = lws_write(wsi, session.buffer.data() + LWS_PRE, length, LWS_WRITE_TEXT);
+    // Write errors are unlikely
+    if (UNLIKELY(written < static_cast<int>(length))) {
+        return false;
+    }
+    g_bytesSent += length;
+    return true;
+}
+
+/**
+ * @brief Send stream messages that are due according to the rate schedule
+ * @return False on write error
+ */
+bool writeDueMessages(struct lws* wsi, Session& session) {
+    size_t due = g_config.maxBatch;
+    if (g_config.rate > 0.0) {
+        const int64_t elapsed = HighResTimer::nowNanos() - session.startNanos;
+        const uint64_t expected = static_cast<uint64_t>(static_cast<double>(elapsed) * g_config.rate / 1e9);
+        if (expected <= session.sent) {
+            return true;
+        }
+        // A client more than a second behind would get an unbounded burst; drop the backlog instead
+        if (UNLIKELY(expected - session.sent > static_cast<uint64_t>(g_config.rate))) {
+            session.sent = expected - std::min<uint64_t>(expected, g_config.maxBatch);
+            g_scheduleSlips++;
+        }
+        due = static_cast<size_t>(std::min<uint64_t>(expected - session.sent, g_config.maxBatch));
+    }
+
+    if (session.buffer.size() < LWS_PRE + MAX_MESSAGE_SIZE) {
+        session.buffer.resize(LWS_PRE + MAX_MESSAGE_SIZE);
+    }
+    char* out = reinterpret_cast<char*>(session.buffer.data() + LWS_PRE);
+
+    for (size_t i = 0; i < due; ++i) {
+        size_t length = session.generator->next(out, MAX_MESSAGE_SIZE);
+        if (UNLIKELY(length == 0)) {
+            break;
+        }
+        int written = lws_write(wsi, reinterpret_cast<unsigned char*>(out), length, LWS_WRITE_TEXT);
+        if (UNLIKELY(written < static_cast<int>(length))) {
+            return false;
+        }
+        session.sent++;
+        g_messagesSent++;
+        g_bytesSent += length;
+
+        // Stop before the kernel send buffer forces lws to buffer internally
+        if (lws_send_pipe_choked(wsi)) {
+            break;
+        }
+    }
+    return true;
+}
+
+int callback(struct lws* wsi, enum lws_callback_reasons reason,
+             void* user, void* in, size_t len) {
+    Session** slot = static_cast<Session**>(user);
+
+    switch (reason) {
+        case LWS_CALLBACK_ESTABLISHED:
+            *slot = new Session();
+            g_clients++;
+            std::cout << "Client connected (" << g_clients << " total)" << std::endl;
+            break;
+
+        case LWS_CALLBACK_RECEIVE:
+            if (*slot && in && len > 0) {
+                if (handleSubscribe(std::string(static_cast<const char*>(in), len), **slot)) {
+                    lws_callback_on_writable(wsi);
+                }
+            }
+            break;
+
+        case LWS_CALLBACK_SERVER_WRITEABLE:
+            {
+                Session* session = *slot;
+                if (!session || !session->generator) {
+                    break;
+                }
+                // Subscriptions ack and snapshots go out first, one per callback
+                if (!session->control.empty()) {
+                    const std::string message = std::move(session->control.front());
+                    session->control.pop_front();
+                    if (!writeFrame(wsi, *session, message.data(), message.size())) {
+                        return -1;
+                    }
+                    lws_callback_on_writable(wsi);
+                    break;
+                }
+                if (!writeDueMessages(wsi, *session)) {
+                    return -1;
+                }
+            }
+            break;
+
+        case LWS_CALLBACK_CLOSED:
+            if (*slot) {
+                delete *slot;
+                *slot = nullptr;
+                g_clients--;
+                std::cout << "Client disconnected (" << g_clients << " total)" << std::endl;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+struct lws_protocols g_protocols[] = {
+    {
+        "coinbase-protocol",
+        callback,
+        sizeof(Session*),
+        4096,
+    },
+    { nullptr, nullptr, 0, 0 } // terminator
+};
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --port <n>        Listen port (default: 8080)" << std::endl;
+    std::cout << "  --rate <n>        Messages per second per connection, 0 = unlimited (default: 1000)" << std::endl;
+    std::cout << "  --tls             Serve wss:// using --cert / --key (see generate_cert.sh)" << std::endl;
+    std::cout << "  --cert <file>     TLS certificate (default: mock_exchange_cert.pem)" << std::endl;
+    std::cout << "  --key <file>      TLS private key (default: mock_exchange_key.pem)" << std::endl;
+    std::cout << "  --seed <n>        Generator seed; equal seeds give equal streams (default: 42)" << std::endl;
+    std::cout << "  --depth <n>       Level2 book depth per side (default: 500)" << std::endl;
+    std::cout << "  --batch <n>       Max messages per write callback (default: 256)" << std::endl;
+    std::cout << "  --duration <sec>  Stop after <sec> seconds (default: run until Ctrl+C)" << std::endl;
+    std::cout << "  --cpu <n>         Pin the server thread to CPU <n>" << std::endl;
+    std::cout << "  -h, --help        Show this help message" << std::endl;
+}
+
+/**
+ * @brief Parse command line into g_config
+ * @return -1 to continue, otherwise the exit code
+ */
+int parseArguments(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << name << " requires a value" << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* v = nullptr;
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--tls") {
+            g_config.tls = true;
+        } else if (arg == "--port") {
+            if (!(v = value("--port"))) return 1;
+            g_config.port = std::atoi(v);
+        } else if (arg == "--rate") {
+            if (!(v = value("--rate"))) return 1;
+            g_config.rate = std::atof(v);
+        } else if (arg == "--cert") {
+            if (!(v = value("--cert"))) return 1;
+            g_config.certFile = v;
+        } else if (arg == "--key") {
+            if (!(v = value("--key"))) return 1;
+            g_config.keyFile = v;
+        } else if (arg == "--seed") {
+            if (!(v = value("--seed"))) return 1;
+            g_config.seed = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--depth") {
+            if (!(v = value("--depth"))) return 1;
+            g_config.depth = static_cast<size_t>(std::atoi(v));
+        } else if (arg == "--batch") {
+            if (!(v = value("--batch"))) return 1;
+            g_config.maxBatch = static_cast<size_t>(std::max(1, std::atoi(v)));
+        } else if (arg == "--duration") {
+            if (!(v = value("--duration"))) return 1;
+            g_config.durationSeconds = std::atoi(v);
+        } else if (arg == "--cpu") {
+            if (!(v = value("--cpu"))) return 1;
+            g_config.cpuCore = std::atoi(v);
+        } else {
+            std::cerr << "Error: Unknown argument " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    HighResTimer::initialize();
+
+    int exitCode = parseArguments(argc, argv);
+    if (exitCode >= 0) {
+        return exitCode;
+    }
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+    lws_set_log_level(LLL_ERR | LLL_WARN, nullptr);
+
+    struct lws_context_creation_info info;
+    memset(&info, 0, sizeof(info));
+    info.port = g_config.port;
+    info.protocols = g_protocols;
+    info.gid = -1;
+    info.uid = -1;
+    if (g_config.tls) {
+        info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+        info.ssl_cert_filepath = g_config.certFile.c_str();
+        info.ssl_private_key_filepath = g_config.keyFile.c_str();
+    }
+
+    struct lws_context* context = lws_create_context(&info);
+    if (!context) {
+        std::cerr << "Failed to create libwebsockets server context" << std::endl;
+        return 1;
+    }
+
+    if (g_config.cpuCore >= 0) {
+        ThreadUtils::pinToCpu(g_config.cpuCore);
+    }
+    ThreadUtils::setThreadName("MockExchange");
+
+    std::cout << "Mock exchange listening on " << (g_config.tls ? "wss" : "ws")
+              << "://localhost:" << g_config.port << std::endl;
+    std::cout << "Rate: ";
+    if (g_config.rate > 0.0) {
+        std::cout << g_config.rate << " msgs/sec per connection" << std::endl;
+    } else {
+        std::cout << "unlimited" << std::endl;
+    }
+
+    // Low rates would spin the service loop for nothing; sleep for one message interval
+    const int64_t idleSleepMicros = (g_config.rate > 0.0 && g_config.rate < 100000.0)
+        ? static_cast<int64_t>(1e6 / g_config.rate) : 0;
+
+    const int64_t startMillis = HighResTimer::nowMillis();
+    int64_t lastReportMillis = startMillis;
+    uint64_t lastMessages = 0;
+    uint64_t lastBytes = 0;
+
+    while (g_running.load()) {
+        // Service errors are unlikely
+        if (UNLIKELY(lws_service(context, 0) < 0)) {
+            std::cerr << "libwebsockets service error" << std::endl;
+            break;
+        }
+        lws_callback_on_writable_all_protocol(context, &g_protocols[0]);
+
+        if (idleSleepMicros > 0) {
+            HighResTimer::sleepMicros(idleSleepMicros);
+        }
+
+        const int64_t nowMillis = HighResTimer::nowMillis();
+        if (nowMillis - lastReportMillis >= 1000) {
+            const double seconds = static_cast<double>(nowMillis - lastReportMillis) / 1000.0;
+            std::cout << std::fixed << std::setprecision(0)
+                      << "clients: " << g_clients
+                      << "  msgs/sec: " << static_cast<double>(g_messagesSent - lastMessages) / seconds
+                      << std::setprecision(2)
+                      << "  MiB/sec: " << static_cast<double>(g_bytesSent - lastBytes) / seconds / (1024.0 * 1024.0)
+                      << "  total: " << g_messagesSent
+                      << "  slips: " << g_scheduleSlips << std::endl;
+            lastReportMillis = nowMillis;
+            lastMessages = g_messagesSent;
+            lastBytes = g_bytesSent;
+        }
+
+        if (g_config.durationSeconds > 0 && nowMillis - startMillis >= g_config.durationSeconds * 1000LL) {
+            break;
+        }
+    }
+
+    lws_context_destroy(context);
+    std::cout << "Mock exchange stopped after sending " << g_messagesSent << " messages ("
+              << g_bytesSent << " bytes)" << std::endl;
+    return 0;
+}
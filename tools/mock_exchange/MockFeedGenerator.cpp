@@ -0,0 +1,276 @@
+/**
+ * @file MockFeedGenerator.cpp
+ * @brief Implementation of the deterministic Coinbase-format feed generator
+ */
+
+#include "MockFeedGenerator.h"
+#include <cinttypes>
+#include <iterator>
+
+namespace {
+    const char* channelName(MockChannel channel) {
+        switch (channel) {
+            case MockChannel::Ticker:  return "ticker";
+            case MockChannel::Matches: return "matches";
+            case MockChannel::Level2:  return "level2";
+        }
+        return "ticker";
+    }
+
+    /// Starting price (in dollars) for well-known products, 100 for the rest
+    int64_t initialPrice(const std::string& productId) {
+        if (productId.compare(0, 4, "BTC-") == 0) return 50000;
+        if (productId.compare(0, 4, "ETH-") == 0) return 3000;
+        if (productId.compare(0, 4, "SOL-") == 0) return 150;
+        return 100;
+    }
+}
+
+MockFeedGenerator::MockFeedGenerator(const std::vector<std::string>& productIds,
+                                     const std::vector<MockChannel>& channels,
+                                     uint64_t seed, size_t depth)
+    : m_depth(depth > 0 ? depth : 1)
+    , m_rng(seed) {
+    m_books.resize(productIds.size());
+    for (size_t i = 0; i < productIds.size(); ++i) {
+        m_books[i].productId = productIds[i];
+        seedBook(m_books[i], initialPrice(productIds[i]) * TICK_SCALE);
+    }
+
+    // Interleave products within each channel so every product advances evenly
+    for (MockChannel channel : channels) {
+        for (size_t i = 0; i < m_books.size(); ++i) {
+            m_streams.push_back({i, channel});
+        }
+    }
+}
+
+void MockFeedGenerator::seedBook(ProductBook& book, int64_t midTicks) {
+    for (size_t i = 0; i < m_depth; ++i) {
+        book.bids[midTicks - 1 - static_cast<int64_t>(i)] = randomSize();
+        book.asks[midTicks + 1 + static_cast<int64_t>(i)] = randomSize();
+    }
+    book.lastTradePrice = midTicks;
+    book.lastTradeSize = randomSize();
+    book.open24h = midTicks;
+    book.low24h = midTicks;
+    book.high24h = midTicks;
+}
+
+bool MockFeedGenerator::hasLevel2() const {
+    for (const Stream& stream : m_streams) {
+        if (stream.channel == MockChannel::Level2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int MockFeedGenerator::formatPrice(char* out, size_t size, int64_t ticks) {
+    return std::snprintf(out, size, "%" PRId64 ".%02" PRId64, ticks / TICK_SCALE, ticks % TICK_SCALE);
+}
+
+int MockFeedGenerator::formatSize(char* out, size_t size, int64_t units) {
+    return std::snprintf(out, size, "%" PRId64 ".%08" PRId64, units / 100000000, units % 100000000);
+}
+
+int MockFeedGenerator::formatTime(char* out, size_t size) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    // gmtime/strftime only once per second, the rest is a cheap suffix
+    if (ts.tv_sec != m_cachedSecond) {
+        struct tm tmUtc;
+        gmtime_r(&ts.tv_sec, &tmUtc);
+        std::strftime(m_timePrefix, sizeof(m_timePrefix), "%Y-%m-%dT%H:%M:%S", &tmUtc);
+        m_cachedSecond = ts.tv_sec;
+    }
+    return std::snprintf(out, size, "%s.%06ldZ", m_timePrefix, ts.tv_nsec / 1000);
+}
+
+void MockFeedGenerator::applyRandomTrade(ProductBook& book) {
+    // Trades print at the touch but never modify the book; only l2updates do,
+    // so a level2 subscriber can always rebuild the exact book.
+    book.lastTradeBuy = random(2) == 0;
+    const int64_t touchSize = book.lastTradeBuy ? book.asks.begin()->second : book.bids.begin()->second;
+    book.lastTradePrice = book.lastTradeBuy ? book.asks.begin()->first : book.bids.begin()->first;
+    book.lastTradeSize = 1 + static_cast<int64_t>(random(static_cast<uint64_t>(touchSize)));
+    book.tradeId++;
+    book.volume24h += book.lastTradeSize;
+    if (book.lastTradePrice < book.low24h) book.low24h = book.lastTradePrice;
+    if (book.lastTradePrice > book.high24h) book.high24h = book.lastTradePrice;
+}
+
+void MockFeedGenerator::applyRandomUpdate(ProductBook& book, bool& isBuy, int64_t& price, int64_t& size) {
+    isBuy = random(2) == 0;
+    const int64_t bestBid = book.bids.begin()->first;
+    const int64_t bestAsk = book.asks.begin()->first;
+    const size_t levels = isBuy ? book.bids.size() : book.asks.size();
+    const uint64_t action = random(100);
+
+    if (action < 15 && levels > m_depth / 2 && levels > 1) {
+        // Remove a level (never empties the side)
+        size_t k = static_cast<size_t>(random(levels));
+        price = isBuy ? std::next(book.bids.begin(), static_cast<long>(k))->first
+                      : std::next(book.asks.begin(), static_cast<long>(k))->first;
+        size = 0;
+        if (isBuy) book.bids.erase(price); else book.asks.erase(price);
+        return;
+    }
+
+    if (action < 30 && levels < m_depth * 2) {
+        // Add a level: improve the touch when the spread allows, else extend the book
+        size = randomSize();
+        if (bestAsk - bestBid > 1) {
+            price = isBuy ? bestBid + 1 : bestAsk - 1;
+        } else {
+            price = isBuy ? book.bids.rbegin()->first - 1 : book.asks.rbegin()->first + 1;
+        }
+        if (isBuy) book.bids[price] = size; else book.asks[price] = size;
+        return;
+    }
+
+    // Resize an existing level, biased towards the touch
+    size_t k = static_cast<size_t>(random(levels < 10 ? levels : 10));
+    if (random(4) == 0) {
+        k = static_cast<size_t>(random(levels));
+    }
+    size = randomSize();
+    if (isBuy) {
+        auto it = std::next(book.bids.begin(), static_cast<long>(k));
+        price = it->first;
+        it->second = size;
+    } else {
+        auto it = std::next(book.asks.begin(), static_cast<long>(k));
+        price = it->first;
+        it->second = size;
+    }
+}
+
+int MockFeedGenerator::writeTicker(ProductBook& book, char* out, size_t size) {
+    applyRandomTrade(book);
+
+    char price[32], open[32], low[32], high[32], volume[32], bid[32], bidSize[32], ask[32], askSize[32], lastSize[32], time[48];
+    formatPrice(price, sizeof(price), book.lastTradePrice);
+    formatPrice(open, sizeof(open), book.open24h);
+    formatPrice(low, sizeof(low), book.low24h);
+    formatPrice(high, sizeof(high), book.high24h);
+    formatSize(volume, sizeof(volume), book.volume24h);
+    formatPrice(bid, sizeof(bid), book.bids.begin()->first);
+    formatSize(bidSize, sizeof(bidSize), book.bids.begin()->second);
+    formatPrice(ask, sizeof(ask), book.asks.begin()->first);
+    formatSize(askSize, sizeof(askSize), book.asks.begin()->second);
+    formatSize(lastSize, sizeof(lastSize), book.lastTradeSize);
+    formatTime(time, sizeof(time));
+
+    return std::snprintf(out, size,
+        "{\"type\":\"ticker\",\"sequence\":%" PRIu64 ",\"product_id\":\"%s\",\"price\":\"%s\","
+        "\"open_24h\":\"%s\",\"volume_24h\":\"%s\",\"low_24h\":\"%s\",\"high_24h\":\"%s\","
+        "\"volume_30d\":\"%s\",\"best_bid\":\"%s\",\"best_bid_size\":\"%s\",\"best_ask\":\"%s\","
+        "\"best_ask_size\":\"%s\",\"side\":\"%s\",\"time\":\"%s\",\"trade_id\":%" PRIu64 ",\"last_size\":\"%s\"}",
+        ++book.sequence, book.productId.c_str(), price, open, volume, low, high, volume,
+        bid, bidSize, ask, askSize, book.lastTradeBuy ? "buy" : "sell", time, book.tradeId, lastSize);
+}
+
+int MockFeedGenerator::writeMatch(ProductBook& book, char* out, size_t size) {
+    applyRandomTrade(book);
+
+    char price[32], tradeSize[32], time[48];
+    formatPrice(price, sizeof(price), book.lastTradePrice);
+    formatSize(tradeSize, sizeof(tradeSize), book.lastTradeSize);
+    formatTime(time, sizeof(time));
+
+    // Order IDs are deterministic placeholders derived from the trade ID
+    return std::snprintf(out, size,
+        "{\"type\":\"match\",\"trade_id\":%" PRIu64 ",\"maker_order_id\":\"00000000-0000-0000-0000-%012" PRIx64 "\","
+        "\"taker_order_id\":\"00000000-0000-0000-0001-%012" PRIx64 "\",\"side\":\"%s\",\"size\":\"%s\","
+        "\"price\":\"%s\",\"product_id\":\"%s\",\"sequence\":%" PRIu64 ",\"time\":\"%s\"}",
+        book.tradeId, book.tradeId, book.tradeId,
+        book.lastTradeBuy ? "sell" : "buy", // Coinbase reports the maker side
+        tradeSize, price, book.productId.c_str(), ++book.sequence, time);
+}
+
+int MockFeedGenerator::writeL2Update(ProductBook& book, char* out, size_t size) {
+    bool isBuy;
+    int64_t levelPrice, levelSize;
+    applyRandomUpdate(book, isBuy, levelPrice, levelSize);
+    ++book.sequence;
+
+    char price[32], quantity[32], time[48];
+    formatPrice(price, sizeof(price), levelPrice);
+    formatSize(quantity, sizeof(quantity), levelSize);
+    formatTime(time, sizeof(time));
+
+    return std::snprintf(out, size,
+        "{\"type\":\"l2update\",\"product_id\":\"%s\",\"changes\":[[\"%s\",\"%s\",\"%s\"]],\"time\":\"%s\"}",
+        book.productId.c_str(), isBuy ? "buy" : "sell", price, quantity, time);
+}
+
+std::string MockFeedGenerator::subscriptionsMessage() const {
+    std::string message = "{\"type\":\"subscriptions\",\"channels\":[";
+    bool firstChannel = true;
+    for (MockChannel channel : {MockChannel::Ticker, MockChannel::Matches, MockChannel::Level2}) {
+        bool subscribed = false;
+        for (const Stream& stream : m_streams) {
+            subscribed = subscribed || stream.channel == channel;
+        }
+        if (!subscribed) {
+            continue;
+        }
+        message += firstChannel ? "" : ",";
+        message += "{\"name\":\"";
+        message += channelName(channel);
+        message += "\",\"product_ids\":[";
+        for (size_t i = 0; i < m_books.size(); ++i) {
+            message += (i ? ",\"" : "\"") + m_books[i].productId + "\"";
+        }
+        message += "]}";
+        firstChannel = false;
+    }
+    message += "]}";
+    return message;
+}
+
+std::string MockFeedGenerator::snapshotMessage(size_t product) const {
+    const ProductBook& book = m_books[product];
+    char price[32], quantity[32];
+
+    std::string message = "{\"type\":\"snapshot\",\"product_id\":\"" + book.productId + "\",\"bids\":[";
+    size_t n = 0;
+    for (auto it = book.bids.begin(); it != book.bids.end(); ++it, ++n) {
+        formatPrice(price, sizeof(price), it->first);
+        formatSize(quantity, sizeof(quantity), it->second);
+        message += (n ? ",[\"" : "[\"") + std::string(price) + "\",\"" + quantity + "\"]";
+    }
+    message += "],\"asks\":[";
+    n = 0;
+    for (auto it = book.asks.begin(); it != book.asks.end(); ++it, ++n) {
+        formatPrice(price, sizeof(price), it->first);
+        formatSize(quantity, sizeof(quantity), it->second);
+        message += (n ? ",[\"" : "[\"") + std::string(price) + "\",\"" + quantity + "\"]";
+    }
+    message += "]}";
+    return message;
+}
+
+size_t MockFeedGenerator::next(char* out, size_t size) {
+    if (m_streams.empty()) {
+        return 0;
+    }
+
+    const Stream stream = m_streams[m_nextStream];
+    m_nextStream = (m_nextStream + 1) % m_streams.size();
+
+    ProductBook& book = m_books[stream.product];
+    int written = 0;
+    switch (stream.channel) {
+        case MockChannel::Ticker:  written = writeTicker(book, out, size); break;
+        case MockChannel::Matches: written = writeMatch(book, out, size); break;
+        case MockChannel::Level2:  written = writeL2Update(book, out, size); break;
+    }
+
+    if (written < 0 || static_cast<size_t>(written) >= size) {
+        return 0;
+    }
+    return static_cast<size_t>(written);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file MockFeedGenerator.h
+ * @brief Deterministic Coinbase-format market data generator for the mock exchange
+ *
+ * Produces ticker, match, level2 snapshot and l2update messages from one
+ * internally consistent (never crossed) order book per product. Two generators
+ * built with the same seed and subscription emit identical streams, apart from
+ * the "time" field which is taken at send time.
+ */
+
+#ifndef MOCKFEEDGENERATOR_H
+#define MOCKFEEDGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <functional>
+
+/**
+ * @brief Market data channels served by the mock exchange
+ */
+enum class MockChannel {
+    Ticker,     ///< "ticker" channel
+    Matches,    ///< "matches" channel
+    Level2      ///< "level2" channel (snapshot + l2update)
+};
+
+/**
+ * @brief Per-connection feed generator
+ */
+class MockFeedGenerator {
+private:
+    static constexpr int64_t TICK_SCALE = 100;                 ///< Price ticks per dollar (0.01 tick)
+
+    /**
+     * @brief Simulated state of one product
+     */
+    struct ProductBook {
+        std::string productId;                                 ///< Product ID
+        std::map<int64_t, int64_t, std::greater<int64_t>> bids; ///< Bid levels: price ticks -> size (1e-8 units)
+        std::map<int64_t, int64_t> asks;                       ///< Ask levels: price ticks -> size (1e-8 units)
+        uint64_t sequence = 0;                                 ///< Last sequence number
+        uint64_t tradeId = 0;                                  ///< Last trade ID
+        int64_t lastTradePrice = 0;                            ///< Last trade price (ticks)
+        int64_t lastTradeSize = 0;                             ///< Last trade size (1e-8 units)
+        bool lastTradeBuy = true;                              ///< Last trade aggressor side
+        int64_t open24h = 0;                                   ///< Opening price (ticks)
+        int64_t low24h = 0;                                    ///< Session low (ticks)
+        int64_t high24h = 0;                                   ///< Session high (ticks)
+        int64_t volume24h = 0;                                 ///< Session volume (1e-8 units)
+    };
+
+    /**
+     * @brief One (product, channel) message stream
+     */
+    struct Stream {
+        size_t product;                                        ///< Index into m_books
+        MockChannel channel;                                   ///< Channel of the stream
+    };
+
+    std::vector<ProductBook> m_books;                          ///< One book per subscribed product
+    std::vector<Stream> m_streams;                             ///< (product, channel) pairs, served round-robin
+    size_t m_nextStream = 0;                                   ///< Next stream to emit
+    size_t m_depth;                                            ///< Book depth per side
+    std::mt19937_64 m_rng;                                     ///< Deterministic random source
+
+    time_t m_cachedSecond = 0;                                 ///< Second of the cached time prefix
+    char m_timePrefix[32] = {0};                               ///< "YYYY-MM-DDTHH:MM:SS" of m_cachedSecond
+
+    /// Uniform random integer in [0, bound)
+    uint64_t random(uint64_t bound) { return m_rng() % bound; }
+
+    /// Random level / trade size between 0.01 and 5.01 (1e-8 units)
+    int64_t randomSize() { return static_cast<int64_t>(1000000 + random(500000000)); }
+
+    static int formatPrice(char* out, size_t size, int64_t ticks);   ///< Ticks -> "50000.00"
+    static int formatSize(char* out, size_t size, int64_t units);    ///< 1e-8 units -> "0.01000000"
+    int formatTime(char* out, size_t size);                          ///< Wall clock -> ISO 8601 with microseconds
+
+    /**
+     * @brief Fill both sides of a book with m_depth one-tick levels around a mid price
+     * @param book Book to seed
+     * @param midTicks Mid price in ticks
+     */
+    void seedBook(ProductBook& book, int64_t midTicks);
+
+    /**
+     * @brief Mutate one level of the book without ever crossing or emptying it
+     * @param book Book to mutate
+     * @param isBuy Output: side of the changed level
+     * @param price Output: price of the changed level (ticks)
+     * @param size Output: new size of the level (0 = removed)
+     */
+    void applyRandomUpdate(ProductBook& book, bool& isBuy, int64_t& price, int64_t& size);
+
+    /**
+     * @brief Print a trade at the touch and update the 24h statistics
+     * @param book Book to trade against
+     */
+    void applyRandomTrade(ProductBook& book);
+
+    int writeTicker(ProductBook& book, char* out, size_t size);      ///< Trade + "ticker" message
+    int writeMatch(ProductBook& book, char* out, size_t size);       ///< Trade + "match" message
+    int writeL2Update(ProductBook& book, char* out, size_t size);    ///< Book change + "l2update" message
+
+public:
+    /**
+     * @brief Constructor
+     * @param productIds Subscribed products
+     * @param channels Subscribed channels
+     * @param seed Random seed (same seed = same stream)
+     * @param depth Book depth per side (level2 snapshot size)
+     */
+    MockFeedGenerator(const std::vector<std::string>& productIds,
+                      const std::vector<MockChannel>& channels,
+                      uint64_t seed, size_t depth = 500);
+
+    /**
+     * @brief Check whether any level2 stream is subscribed
+     * @return True if snapshots must be sent before streaming
+     */
+    bool hasLevel2() const;
+
+    /**
+     * @brief Build the "subscriptions" acknowledgement
+     * @return JSON message
+     */
+    std::string subscriptionsMessage() const;
+
+    /**
+     * @brief Build the level2 snapshot of a product
+     * @param product Product index (0 .. productCount() - 1)
+     * @return JSON message
+     */
+    std::string snapshotMessage(size_t product) const;
+
+    /**
+     * @brief Number of subscribed products
+     * @return Product count
+     */
+    size_t productCount() const { return m_books.size(); }
+
+    /**
+     * @brief Write the next message of the round-robin stream
+     * @param out Output buffer
+     * @param size Output buffer size
+     * @return Message length, 0 if nothing is subscribed
+     */
+    size_t next(char* out, size_t size);
+};
+
+#endif // MOCKFEEDGENERATOR_H
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Generate a self-signed certificate for serving wss:// from the mock exchange
+# Usage: ./generate_cert.sh [output_dir]
+
+set -e
+
+OUT_DIR="${1:-.}"
+mkdir -p "$OUT_DIR"
+
+openssl req -x509 -newkey rsa:2048 -nodes -days 365 \
+    -keyout "$OUT_DIR/mock_exchange_key.pem" \
+    -out "$OUT_DIR/mock_exchange_cert.pem" \
+    -subj "/CN=localhost" \
+    -addext "subjectAltName=DNS:localhost,IP:127.0.0.1"
+
+echo "Certificate: $OUT_DIR/mock_exchange_cert.pem"
+echo "Private key: $OUT_DIR/mock_exchange_key.pem"
+echo "Serve with:   ./mock_exchange --tls --port 8443 --cert $OUT_DIR/mock_exchange_cert.pem --key $OUT_DIR/mock_exchange_key.pem"
+echo "Connect with: ./CoinbaseTickerAnalyzer --endpoint wss://localhost:8443 --insecure"